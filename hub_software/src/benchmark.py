@@ -0,0 +1,193 @@
+################################################################################
+# File Name         : benchmark.py
+# Description       : Runs the BLE benchmark of the vent firmware (BENCH_CTRL,
+#                     BENCH_DATA and BENCH_RESULT in custom service 0) against
+#                     one vent and prints the throughput and the write to
+#                     notification latency seen by the hub.
+#
+#                     Usage: python benchmark.py ADDRESS [--duration S]
+#                                                [--payload N] [--pings N]
+#
+# Author            : Pierino Zindel
+# Date              : October 19, 2026
+# Last Revision     : N/A
+# Version           : 1.0.0
+################################################################################
+
+
+# LIBRARIES
+# Standard Libraries
+import argparse
+import asyncio
+import json
+import os
+import struct
+from time import perf_counter
+
+# 3rd Party Libraries
+from bleak import BleakClient
+
+
+# GLOBAL VARIABLES
+CURRENT_DIR = os.path.dirname(os.path.abspath(__file__))
+# BLE configuration filepath
+BLE_CONFIG_FP = os.path.join(CURRENT_DIR, "config", "ble_config.json")
+
+# Command opcodes (app_bench.h)
+BENCH_OP_STOP = 0x00
+BENCH_OP_THROUGHPUT = 0x01
+BENCH_OP_PING = 0x02
+BENCH_OP_RESET = 0x03
+
+# BENCH_RESULT layout (BENCH_RESULT_LENGTH in app_bench.h)
+RESULT_FORMAT = "<BBHHIIIIII"
+RESULT_FIELDS = ("state", "conidx", "payload", "mtu", "packets", "bytes",
+                 "elapsed_ms", "failed", "pings", "ping_max_us")
+
+
+# FUNCTIONS
+def load_uuids() -> dict:
+    """
+    Returns the benchmark characteristic UUIDs from the BLE configuration.
+    """
+    with open(BLE_CONFIG_FP, "r") as file:
+        uuids = json.load(file)["UUIDS"]
+
+    return {key: uuids["UUID_BENCH_" + key] for key in ("CTRL", "DATA", "RESULT")}
+
+
+def percentile(values: list, fraction: float) -> float:
+    """
+    Returns the nearest-rank percentile of a non-empty list.
+    """
+    ordered = sorted(values)
+    rank = max(0, min(len(ordered) - 1, round(fraction * len(ordered)) - 1))
+
+    return ordered[rank]
+
+
+async def read_result(client: BleakClient, uuids: dict) -> dict:
+    """
+    Reads and unpacks the BENCH_RESULT characteristic.
+    """
+    data = await client.read_gatt_char(uuids["RESULT"])
+
+    return dict(zip(RESULT_FIELDS, struct.unpack(RESULT_FORMAT, bytes(data))))
+
+
+async def run_throughput(client: BleakClient, uuids: dict, duration: int,
+                         payload: int):
+    """
+    Runs a throughput test and prints the device and hub figures.
+    """
+    received = {"packets": 0, "bytes": 0, "first": None, "last": None}
+
+    def on_data(_, data: bytearray):
+        now = perf_counter()
+        received["first"] = received["first"] or now
+        received["last"] = now
+        received["packets"] += 1
+        received["bytes"] += len(data)
+
+    await client.start_notify(uuids["DATA"], on_data)
+    await client.write_gatt_char(uuids["CTRL"],
+                                 bytes([BENCH_OP_THROUGHPUT, duration, payload, 0]),
+                                 response=True)
+
+    # The device stops on its own, poll until its last completion
+    await asyncio.sleep(duration)
+    result = await read_result(client, uuids)
+    while result["state"] != 0:
+        await asyncio.sleep(0.2)
+        result = await read_result(client, uuids)
+
+    await client.stop_notify(uuids["DATA"])
+
+    elapsed_s = max(result["elapsed_ms"], 1) / 1000
+    print("Throughput: payload {} bytes, ATT MTU {}".format(result["payload"], result["mtu"]))
+    print("  device : {} notifications, {} bytes in {:.3f} s, {:.1f} kbit/s, {} failed"
+          .format(result["packets"], result["bytes"], elapsed_s,
+                  result["bytes"] * 8 / elapsed_s / 1000, result["failed"]))
+
+    if received["packets"] > 1:
+        hub_s = received["last"] - received["first"]
+        print("  hub    : {} notifications, {} bytes in {:.3f} s, {:.1f} kbit/s"
+              .format(received["packets"], received["bytes"], hub_s,
+                      received["bytes"] * 8 / max(hub_s, 1e-3) / 1000))
+
+
+async def run_ping(client: BleakClient, uuids: dict, count: int):
+    """
+    Sends pings one at a time and prints the round trip percentiles.
+    """
+    replies = asyncio.Queue()
+    samples = []
+
+    def on_data(_, data: bytearray):
+        replies.put_nowait((perf_counter(), bytes(data)))
+
+    await client.write_gatt_char(uuids["CTRL"], bytes([BENCH_OP_RESET, 0, 0, 0]),
+                                 response=True)
+    await client.start_notify(uuids["DATA"], on_data)
+
+    for seq in range(count):
+        command = bytes([BENCH_OP_PING]) + struct.pack("<H", seq) + b"\0"
+        start = perf_counter()
+        # Write without response, the write response would add a round trip
+        await client.write_gatt_char(uuids["CTRL"], command, response=False)
+
+        try:
+            while True:
+                stamp, data = await asyncio.wait_for(replies.get(), timeout=2.0)
+                if data[:3] == command[:3]:
+                    samples.append((stamp - start) * 1000)
+                    break
+        except asyncio.TimeoutError:
+            print("  ping {} lost".format(seq))
+
+    await client.stop_notify(uuids["DATA"])
+    result = await read_result(client, uuids)
+
+    if not samples:
+        print("Ping: no replies")
+        return
+
+    print("Ping: {} of {} answered (round trip, ms)".format(len(samples), count))
+    print("  p50 {:.1f}  p90 {:.1f}  p99 {:.1f}  max {:.1f}"
+          .format(percentile(samples, 0.50), percentile(samples, 0.90),
+                  percentile(samples, 0.99), max(samples)))
+    print("  device turnaround max {} us over {} pings"
+          .format(result["ping_max_us"], result["pings"]))
+
+
+async def run(address: str, duration: int, payload: int, pings: int):
+    """
+    Connects to a vent and runs the tests.
+    """
+    uuids = load_uuids()
+
+    async with BleakClient(address) as client:
+        if duration:
+            await run_throughput(client, uuids, duration, payload)
+        if pings:
+            await run_ping(client, uuids, pings)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark the BLE link of a vent.")
+    parser.add_argument("address", help="MAC address of the vent")
+    parser.add_argument("--duration", type=int, default=10,
+                        help="throughput test length in s, 0 to skip (max 60)")
+    parser.add_argument("--payload", type=int, default=0,
+                        help="notification payload in bytes, 0 = ATT MTU - 3")
+    parser.add_argument("--pings", type=int, default=100,
+                        help="number of pings, 0 to skip")
+    args = parser.parse_args()
+
+    asyncio.run(run(args.address, min(args.duration, 60),
+                    min(args.payload, 255), args.pings))
+
+
+# MAIN PROGRAM
+if __name__ == "__main__":
+    main()
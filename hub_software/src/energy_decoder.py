@@ -0,0 +1,191 @@
+################################################################################
+# File Name         : energy_decoder.py
+# Description       : Decodes the Energy diagnostics characteristic of the vent
+#                     firmware (ENERGY_INFO_LENGTH in app_energy.h) and prints
+#                     the charge, share and duty cycle of each energy account,
+#                     largest first, with the average current and the battery
+#                     life it gives.
+#
+#                     The account names and currents are read from
+#                     ENERGY_ACCOUNT_TABLE in app_energy.h, so the decoder
+#                     follows the firmware table order.
+#
+#                     Usage: python energy_decoder.py ADDRESS [--capacity MAH]
+#                            python energy_decoder.py --hex VALUE [--capacity MAH]
+#                     (--hex decodes a value captured elsewhere)
+#
+# Author            : Pierino Zindel
+# Date              : October 19, 2026
+# Last Revision     : N/A
+# Version           : 1.0.0
+################################################################################
+
+
+# LIBRARIES
+# Standard Libraries
+import argparse
+import asyncio
+import json
+import os
+import re
+import struct
+
+
+# GLOBAL VARIABLES
+CURRENT_DIR = os.path.dirname(os.path.abspath(__file__))
+# BLE configuration filepath
+BLE_CONFIG_FP = os.path.join(CURRENT_DIR, "config", "ble_config.json")
+# Firmware header holding the account table
+ENERGY_HEADER_FP = os.path.join(CURRENT_DIR, "..", "..", "vent_firmware", "Zephyr",
+                                "include", "app_energy.h")
+
+# Characteristic layout: count, uptime, then (charge mC, active s) per account
+HEADER_FORMAT = "<BI"
+ACCOUNT_FORMAT = "<II"
+
+# X(name, current_uA) rows of ENERGY_ACCOUNT_TABLE
+TABLE_RE = re.compile(r"#define\s+ENERGY_ACCOUNT_TABLE\(X\)(.*?)\n\s*\n", re.S)
+ACCOUNT_RE = re.compile(r"X\(\s*(\w+)\s*,")
+
+# Default battery capacity (BATT_CAPACITY_MAH, alkaline)
+DEFAULT_CAPACITY_MAH = 2400
+
+
+# FUNCTIONS
+def load_account_names(path: str) -> list:
+    """
+    Returns the account names of ENERGY_ACCOUNT_TABLE, in table order.
+
+    Parameters
+    ----------
+    path : str
+        The path of app_energy.h.
+
+    Returns
+    -------
+    list
+        The account names.
+    """
+    with open(path, "r") as file:
+        text = file.read()
+
+    match = TABLE_RE.search(text)
+    if match is None:
+        raise ValueError("ENERGY_ACCOUNT_TABLE not found in " + path)
+
+    return ACCOUNT_RE.findall(match.group(1))
+
+
+def decode(data: bytes, names: list) -> tuple:
+    """
+    Unpacks the characteristic value.
+
+    Parameters
+    ----------
+    data : bytes
+        The characteristic value.
+    names : list
+        The account names, in table order.
+
+    Returns
+    -------
+    tuple
+        The uptime (s) and a list of (name, charge mC, active s).
+    """
+    count, uptime_s = struct.unpack_from(HEADER_FORMAT, data, 0)
+    offset = struct.calcsize(HEADER_FORMAT)
+
+    if count != len(names):
+        print("Warning: {} accounts reported, {} in {}".format(count, len(names),
+                                                               ENERGY_HEADER_FP))
+
+    accounts = []
+    for i in range(count):
+        charge_mc, active_s = struct.unpack_from(ACCOUNT_FORMAT, data, offset)
+        offset += struct.calcsize(ACCOUNT_FORMAT)
+        name = names[i] if i < len(names) else "#{}".format(i)
+        accounts.append((name, charge_mc, active_s))
+
+    return uptime_s, accounts
+
+
+def report(uptime_s: int, accounts: list, capacity_mah: int) -> None:
+    """
+    Prints the accounts by decreasing charge and the battery life estimate.
+
+    Parameters
+    ----------
+    uptime_s : int
+        The time since the accounts were reset (s).
+    accounts : list
+        The (name, charge mC, active s) of each account.
+    capacity_mah : int
+        The battery capacity (mAh).
+    """
+    total_mc = sum(charge for _, charge, _ in accounts)
+
+    print("{:<8} {:>10} {:>9} {:>7} {:>10} {:>7}".format(
+        "ACCOUNT", "CHARGE mC", "mAh", "SHARE", "ACTIVE s", "DUTY"))
+    for name, charge_mc, active_s in sorted(accounts, key=lambda a: a[1], reverse=True):
+        share = (100.0 * charge_mc / total_mc) if total_mc else 0.0
+        duty = (100.0 * active_s / uptime_s) if uptime_s else 0.0
+        print("{:<8} {:>10} {:>9.3f} {:>6.1f}% {:>10} {:>6.1f}%".format(
+            name, charge_mc, charge_mc / 3600.0, share, active_s, duty))
+
+    if uptime_s == 0:
+        return
+
+    # mC / s = mA
+    average_ua = 1000.0 * total_mc / uptime_s
+    print("\n{} mC in {} s: average {:.1f} uA".format(total_mc, uptime_s, average_ua))
+    if average_ua > 0:
+        days = capacity_mah * 1000.0 / average_ua / 24.0
+        print("{} mAh battery: {:.0f} days at this rate".format(capacity_mah, days))
+
+
+async def read_value(address: str) -> bytes:
+    """
+    Reads the Energy characteristic of a vent.
+
+    Parameters
+    ----------
+    address : str
+        The MAC address of the vent.
+
+    Returns
+    -------
+    bytes
+        The characteristic value.
+    """
+    # Imported here so --hex runs without bleak installed
+    from bleak import BleakClient
+
+    with open(BLE_CONFIG_FP, "r") as file:
+        uuid = json.load(file)["UUIDS"]["UUID_ENERGY"]
+
+    async with BleakClient(address) as client:
+        return bytes(await client.read_gatt_char(uuid))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the vent energy accounts.")
+    parser.add_argument("address", nargs="?", help="MAC address of the vent")
+    parser.add_argument("--hex", help="characteristic value as hex, instead of a read")
+    parser.add_argument("--capacity", type=int, default=DEFAULT_CAPACITY_MAH,
+                        help="battery capacity in mAh")
+    args = parser.parse_args()
+
+    if args.hex:
+        data = bytes.fromhex(args.hex.replace(" ", "").replace(":", ""))
+    elif args.address:
+        data = asyncio.run(read_value(args.address))
+    else:
+        parser.error("an ADDRESS or --hex is required")
+
+    uptime_s, accounts = decode(data, load_account_names(ENERGY_HEADER_FP))
+    report(uptime_s, accounts, args.capacity)
+
+
+# MAIN PROGRAM
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,121 @@
+################################################################################
+# File Name         : gen_ble_config.py
+# Description       : Regenerates the "UUIDS" section of config/ble_config.json
+#                     from the characteristic manifest of the vent firmware
+#                     (CS_SVC0_MANIFEST/CS_SVC1_MANIFEST in app_customss.h), so
+#                     the hub and the firmware cannot drift apart.
+#
+#                     Usage: python gen_ble_config.py [path/to/app_customss.h]
+#
+# Author            : Pierino Zindel
+# Date              : October 19, 2026
+# Last Revision     : N/A
+# Version           : 1.0.0
+################################################################################
+
+
+# LIBRARIES
+# Standard Libraries
+import json
+import os
+import re
+import sys
+
+
+# GLOBAL VARIABLES
+CURRENT_DIR = os.path.dirname(os.path.abspath(__file__))
+# Firmware header holding the manifest
+MANIFEST_FP = os.path.join(CURRENT_DIR, "..", "..", "vent_firmware", "Zephyr",
+                           "include", "app_customss.h")
+# BLE configuration filepath
+BLE_CONFIG_FP = os.path.join(CURRENT_DIR, "config", "ble_config.json")
+
+# CS_UUID(B4, B5) { 0x24, 0xdc, 0x0e, 0x6e, (B4), (B5), ... }
+UUID_BASE_RE = re.compile(r"#define\s+CS_UUID\(B4,\s*B5\)\s*\{([^}]*)\}", re.S)
+# X(svc, name, uuid4, uuid5, perm, length, ccc, callback, "hub_key")
+ENTRY_RE = re.compile(r"X\(\s*(\d+)\s*,\s*(\w+)\s*,\s*(0x[0-9a-fA-F]+)\s*,"
+                      r"\s*(0x[0-9a-fA-F]+)\s*,.*\"(\w*)\"\s*\)")
+
+
+# FUNCTIONS
+def uuid_string(base: list, uuid4: int, uuid5: int) -> str:
+    """
+    Formats a 128-bit UUID given in little endian byte order the way
+    bleak expects it.
+
+    Parameters
+    ----------
+    base : list
+        The 16 bytes of CS_UUID, bytes 4 and 5 are replaced.
+    uuid4 : int
+        Byte 4 of the UUID.
+    uuid5 : int
+        Byte 5 of the UUID.
+
+    Returns
+    -------
+    str
+        The UUID, most significant byte first.
+    """
+    uuid = list(base)
+    uuid[4] = uuid4
+    uuid[5] = uuid5
+    text = "".join("{:02X}".format(b) for b in reversed(uuid))
+
+    return "-".join([text[0:8], text[8:12], text[12:16], text[16:20], text[20:32]])
+
+
+def parse_manifest(path: str) -> dict:
+    """
+    Reads the characteristic manifest and returns the hub UUID keys.
+
+    Parameters
+    ----------
+    path : str
+        The path of app_customss.h.
+
+    Returns
+    -------
+    dict
+        The UUID of every characteristic with a hub key, by key.
+    """
+    with open(path, "r") as file:
+        text = file.read()
+
+    # The macro spans several lines, drop the line continuations first
+    match = UUID_BASE_RE.search(text.replace("\\\n", " "))
+    if match is None:
+        raise ValueError("CS_UUID not found in " + path)
+
+    base = []
+    for token in match.group(1).split(","):
+        token = token.strip().strip("()")
+        base.append(int(token, 16) if token.startswith("0x") else 0)
+
+    uuids = {}
+    for entry in ENTRY_RE.finditer(text):
+        if entry.group(5):
+            uuids[entry.group(5)] = uuid_string(base, int(entry.group(3), 16),
+                                                int(entry.group(4), 16))
+
+    return uuids
+
+
+def main():
+    manifest_fp = sys.argv[1] if len(sys.argv) > 1 else MANIFEST_FP
+
+    with open(BLE_CONFIG_FP, "r") as file:
+        ble_config = json.load(file)
+
+    ble_config["UUIDS"] = parse_manifest(manifest_fp)
+
+    with open(BLE_CONFIG_FP, "w") as file:
+        json.dump(ble_config, file, indent=4)
+        file.write("\n")
+
+    print("Wrote {} UUIDs to {}".format(len(ble_config["UUIDS"]), BLE_CONFIG_FP))
+
+
+# MAIN PROGRAM
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,281 @@
+################################################################################
+# File Name         : group_command.py
+# Description       : Commands every vent of a zone at once with a broadcast
+#                     command advertisement (app_group.h in the vent
+#                     firmware) instead of one connection per vent, then
+#                     listens for the vents confirming the command in their
+#                     telemetry advertisements.
+#
+#                     The group key and the last sequence number are kept in
+#                     config/group_config.json (created on first use). The
+#                     broadcast goes through the raw HCI LE advertising
+#                     commands of BlueZ (hcitool), which needs root.
+#
+#                     Usage: python group_command.py provision ADDRESS ZONE
+#                            python group_command.py vent ZONE STATE
+#                                                     [--repeat S] [--listen S]
+#
+# Author            : Pierino Zindel
+# Date              : October 19, 2026
+# Last Revision     : N/A
+# Version           : 1.0.0
+################################################################################
+
+
+# LIBRARIES
+# Standard Libraries
+import argparse
+import asyncio
+import json
+import os
+import secrets
+import struct
+import subprocess
+import time
+
+# 3rd Party Libraries
+from bleak import BleakClient, BleakScanner
+
+
+# GLOBAL VARIABLES
+CURRENT_DIR = os.path.dirname(os.path.abspath(__file__))
+# BLE configuration filepath
+BLE_CONFIG_FP = os.path.join(CURRENT_DIR, "config", "ble_config.json")
+# Group key and sequence number filepath
+GROUP_CONFIG_FP = os.path.join(CURRENT_DIR, "config", "group_config.json")
+
+# APP_COMPANY_ID in the vent firmware (app.h)
+COMPANY_ID = 0x0362
+
+# Frame types and commands (app_group.h)
+GROUP_FRAME_COMMAND = 0x47
+GROUP_FRAME_TELEMETRY = 0x54
+GROUP_FRAME_RELAY = 0x52
+GROUP_ZONE_ALL = 0xFF
+GROUP_CMD_VENT = 0x01
+
+# Vents listen 40 ms out of every 2.56 s: repeat a frame for more than two
+# scan intervals, at an advertising interval shorter than the scan window
+DEFAULT_REPEAT_S = 6.0
+ADV_INTERVAL = 0x0020           # 20 ms in 0.625 ms units
+
+HCI_DEVICE = "hci0"
+
+
+# FUNCTIONS
+def siphash24(key: bytes, data: bytes) -> int:
+    """
+    Returns the SipHash-2-4 MAC of data (app_siphash.c).
+
+    Parameters
+    ----------
+    key : bytes
+        The 16 byte key.
+    data : bytes
+        The message.
+
+    Returns
+    -------
+    int
+        The 64-bit MAC.
+    """
+    mask = 0xFFFFFFFFFFFFFFFF
+
+    def rotl(x, b):
+        return ((x << b) | (x >> (64 - b))) & mask
+
+    def rounds(v, n):
+        v0, v1, v2, v3 = v
+        for _ in range(n):
+            v0 = (v0 + v1) & mask; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32)
+            v2 = (v2 + v3) & mask; v3 = rotl(v3, 16); v3 ^= v2
+            v0 = (v0 + v3) & mask; v3 = rotl(v3, 21); v3 ^= v0
+            v2 = (v2 + v1) & mask; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32)
+        return [v0, v1, v2, v3]
+
+    k0, k1 = struct.unpack("<QQ", key)
+    v = [k0 ^ 0x736f6d6570736575, k1 ^ 0x646f72616e646f6d,
+         k0 ^ 0x6c7967656e657261, k1 ^ 0x7465646279746573]
+
+    tail = len(data) % 8
+    blocks = [struct.unpack("<Q", data[i:i + 8])[0] for i in range(0, len(data) - tail, 8)]
+    blocks.append(int.from_bytes(data[len(data) - tail:], "little") | ((len(data) & 0xFF) << 56))
+
+    for m in blocks:
+        v[3] ^= m
+        v = rounds(v, 2)
+        v[0] ^= m
+
+    v[2] ^= 0xFF
+    v = rounds(v, 4)
+
+    return v[0] ^ v[1] ^ v[2] ^ v[3]
+
+
+def load_group_config() -> dict:
+    """
+    Returns the group key and last sequence number, creating a new key
+    on first use.
+    """
+    if os.path.exists(GROUP_CONFIG_FP):
+        with open(GROUP_CONFIG_FP, "r") as file:
+            return json.load(file)
+
+    config = {"KEY": secrets.token_hex(16), "SEQ": 0}
+    save_group_config(config)
+    return config
+
+
+def save_group_config(config: dict):
+    """
+    Writes the group configuration.
+    """
+    with open(GROUP_CONFIG_FP, "w") as file:
+        json.dump(config, file, indent=4)
+
+
+def next_sequence(config: dict) -> int:
+    """
+    Returns a sequence number above every one used before and stores it.
+    Seconds since the epoch keep it increasing if the file is lost.
+    """
+    seq = max(config["SEQ"] + 1, int(time.time()))
+    config["SEQ"] = seq
+    save_group_config(config)
+    return seq
+
+
+def build_command(key: bytes, zone: int, command: int, argument: int, seq: int) -> bytes:
+    """
+    Returns the manufacturer data of a command frame, company ID first.
+    """
+    body = struct.pack("<BBBBI", GROUP_FRAME_COMMAND, zone, command, argument, seq)
+    mac = struct.pack("<Q", siphash24(key, body))
+
+    return struct.pack("<H", COMPANY_ID) + body + mac
+
+
+def hci_cmd(ocf: int, payload: bytes):
+    """
+    Sends an LE controller command (OGF 0x08) through hcitool.
+    """
+    args = ["hcitool", "-i", HCI_DEVICE, "cmd", "0x08", "0x{:04x}".format(ocf)]
+    args += ["{:02x}".format(b) for b in payload]
+    subprocess.run(args, check=True, stdout=subprocess.DEVNULL)
+
+
+def broadcast(manufacturer_data: bytes, repeat_s: float):
+    """
+    Advertises a non-connectable frame for repeat_s seconds.
+    """
+    field = bytes([len(manufacturer_data) + 1, 0xFF]) + manufacturer_data
+    adv_data = bytes([len(field)]) + field.ljust(31, b"\0")
+
+    # LE Set Advertising Parameters: ADV_NONCONN_IND on the 3 channels
+    params = struct.pack("<HHBBB6sBB", ADV_INTERVAL, ADV_INTERVAL, 0x03, 0x00,
+                         0x00, bytes(6), 0x07, 0x00)
+    hci_cmd(0x0006, params)
+    hci_cmd(0x0008, adv_data)
+    hci_cmd(0x000A, b"\x01")
+    try:
+        time.sleep(repeat_s)
+    finally:
+        hci_cmd(0x000A, b"\x00")
+
+
+async def collect_telemetry(listen_s: float) -> dict:
+    """
+    Returns the last telemetry frame of every vent heard, by address.
+    Telemetry relayed by other vents (app_relay.h) is taken under the
+    address of its origin, with the hop count it arrived with.
+    """
+    vents = {}
+
+    def on_advert(device, advert):
+        data = advert.manufacturer_data.get(COMPANY_ID)
+        address, hops = device.address, 0
+        # Relay frame: type, hops, TTL, origin (little endian), inner frame
+        if data and len(data) > 9 and data[0] == GROUP_FRAME_RELAY:
+            address = ":".join("{:02X}".format(b) for b in reversed(data[3:9]))
+            hops, data = data[1], data[9:]
+        if data and len(data) == 7 and data[0] == GROUP_FRAME_TELEMETRY:
+            zone, state, seq = struct.unpack("<BBI", data[1:])
+            # Keep the most direct path to each vent
+            if address not in vents or vents[address]["hops"] >= hops:
+                vents[address] = {"zone": zone, "state": state, "seq": seq, "hops": hops}
+
+    async with BleakScanner(on_advert):
+        await asyncio.sleep(listen_s)
+
+    return vents
+
+
+def send_vent(zone: int, state: int, repeat_s: float, listen_s: float):
+    """
+    Broadcasts a vent command to a zone and reports the confirmations.
+    """
+    config = load_group_config()
+    seq = next_sequence(config)
+    frame = build_command(bytes.fromhex(config["KEY"]), zone, GROUP_CMD_VENT, state, seq)
+
+    print("Zone {}: vent state {}, seq {}".format(zone, state, seq))
+    broadcast(frame, repeat_s)
+
+    vents = asyncio.run(collect_telemetry(listen_s))
+    members = {a: v for a, v in vents.items() if zone in (GROUP_ZONE_ALL, v["zone"])}
+    for address, vent in sorted(members.items()):
+        status = "applied" if vent["seq"] >= seq else "MISSED"
+        via = "  ({} hops)".format(vent["hops"]) if vent["hops"] else ""
+        print("  {}  zone {}  state {}  {}{}".format(address, vent["zone"], vent["state"],
+                                                     status, via))
+    print("{} of {} vents heard confirmed".format(
+        sum(v["seq"] >= seq for v in members.values()), len(members)))
+
+
+async def provision(address: str, zone: int):
+    """
+    Writes the zone and the group key to a bonded vent. The key goes with
+    the last sequence number used, the vent refuses the frames sent before.
+    """
+    with open(BLE_CONFIG_FP, "r") as file:
+        uuids = json.load(file)["UUIDS"]
+    config = load_group_config()
+    key = bytes.fromhex(config["KEY"]) + struct.pack("<I", config["SEQ"])
+
+    async with BleakClient(address) as client:
+        # Both characteristics need an encrypted link
+        await client.pair()
+        await client.write_gatt_char(uuids["UUID_GROUP_KEY"], key, response=True)
+        await client.write_gatt_char(uuids["UUID_ZONE_ID"], bytes([zone]), response=True)
+
+    print("{}: zone {}, key set".format(address, zone))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Command a zone of vents without connecting.")
+    sub = parser.add_subparsers(dest="action", required=True)
+
+    prov = sub.add_parser("provision", help="set the zone and group key of a vent")
+    prov.add_argument("address", help="MAC address of the vent")
+    prov.add_argument("zone", type=int, help="zone ID, 1 to 254")
+
+    vent = sub.add_parser("vent", help="open or close every vent of a zone")
+    vent.add_argument("zone", type=int, help="zone ID, 255 for every zone")
+    vent.add_argument("state", type=int, choices=(0, 1), help="0 open, 1 closed")
+    vent.add_argument("--repeat", type=float, default=DEFAULT_REPEAT_S,
+                      help="broadcast time in s")
+    vent.add_argument("--listen", type=float, default=10.0,
+                      help="time to collect confirmations in s")
+    args = parser.parse_args()
+
+    if args.action == "provision":
+        if not 1 <= args.zone <= 254:
+            parser.error("zone must be 1 to 254")
+        asyncio.run(provision(args.address, args.zone))
+    else:
+        send_vent(args.zone & 0xFF, args.state, args.repeat, args.listen)
+
+
+# MAIN PROGRAM
+if __name__ == "__main__":
+    main()
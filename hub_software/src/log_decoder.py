@@ -0,0 +1,252 @@
+################################################################################
+# File Name         : log_decoder.py
+# Description       : Decodes the tokenized binary log of the vent firmware
+#                     (app_log.h) with the format strings kept in the
+#                     .applog_fmt section of the firmware ELF.
+#
+#                     The records are read either from a UART capture, where
+#                     each record is a "#L <hex words>" line (firmware built
+#                     with APP_LOG_UART), or with --binary from a dump of the
+#                     STREAM_SRC_LOG stream source.
+#
+#                     Usage: python log_decoder.py [--binary] firmware.elf [capture]
+#                     (the capture is read from stdin when omitted)
+#
+# Author            : Pierino Zindel
+# Date              : October 19, 2026
+# Last Revision     : N/A
+# Version           : 1.0.0
+################################################################################
+
+
+# LIBRARIES
+# Standard Libraries
+import argparse
+import re
+import struct
+import sys
+
+
+# GLOBAL VARIABLES
+# Record header fields (see app_log.h)
+HDR_TOKEN_SHIFT = 8
+HDR_LEVEL_SHIFT = 5
+HDR_LEVEL_MASK = 0x7
+HDR_BUFFER = 1 << 4
+HDR_NARGS_MASK = 0xF
+
+LEVEL_NAMES = {1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG"}
+
+FMT_SECTION = ".applog_fmt"
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+# printf conversion: flags, width, precision, length modifier, conversion
+CONVERSION_RE = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diouxXcfFeEgGsp%])")
+LINE_RE = re.compile(r"#L((?:\s+[0-9a-fA-F]{8})+)")
+
+
+# CLASSES
+class FirmwareImage:
+    """
+    The sections of the firmware ELF needed to render log records.
+    """
+
+    def __init__(self, path: str):
+        with open(path, "rb") as file:
+            data = file.read()
+
+        if data[:4] != b"\x7fELF":
+            raise ValueError(path + " is not an ELF file")
+
+        is_64 = data[4] == 2
+        endian = "<" if data[5] == 1 else ">"
+
+        if is_64:
+            shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x3A)
+            entry = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x2E)
+            entry = endian + "IIIIIIIIII"
+
+        headers = [struct.unpack_from(entry, data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx]
+        names = data[names[4]:names[4] + names[5]]
+
+        # name, address, flags, contents
+        self.sections = []
+        for name, sh_type, flags, addr, offset, size, *_ in headers:
+            name = names[name:names.index(b"\0", name)].decode()
+            contents = b"" if sh_type == SHT_NOBITS else data[offset:offset + size]
+            self.sections.append((name, addr, flags, contents))
+
+        self.formats = next((s for s in self.sections if s[0] == FMT_SECTION), None)
+        if self.formats is None:
+            raise ValueError(FMT_SECTION + " not found in " + path)
+
+    @staticmethod
+    def _string(section: tuple, address: int) -> str:
+        start = address - section[1]
+        end = section[3].index(b"\0", start)
+
+        return section[3][start:end].decode(errors="replace")
+
+    def format_string(self, token: int) -> str:
+        """
+        Returns the format string of a token.
+        """
+        if not 0 <= token - self.formats[1] < len(self.formats[3]):
+            return None
+
+        return self._string(self.formats, token)
+
+    def const_string(self, address: int) -> str:
+        """
+        Returns a constant string of the loaded image (a %s argument).
+        """
+        for section in self.sections:
+            if (section[2] & SHF_ALLOC) and section[3] \
+                    and 0 <= address - section[1] < len(section[3]):
+                return self._string(section, address)
+
+        return "<0x{:08x}>".format(address)
+
+
+# FUNCTIONS
+def render(image: FirmwareImage, fmt: str, args: list) -> str:
+    """
+    Renders a printf format string with raw 32-bit argument words.
+
+    Parameters
+    ----------
+    image : FirmwareImage
+        The firmware image, for %s arguments.
+    fmt : str
+        The format string.
+    args : list
+        The argument words.
+
+    Returns
+    -------
+    str
+        The formatted text.
+    """
+    args = list(args)
+
+    def convert(match):
+        spec, _, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if not args:
+            return "<?>"
+
+        word = args.pop(0)
+        if conv in "di":
+            value = word - (1 << 32) if word & 0x80000000 else word
+        elif conv in "fFeEgG":
+            value = struct.unpack("<f", struct.pack("<I", word))[0]
+        elif conv == "s":
+            value = image.const_string(word)
+        elif conv == "p":
+            conv, value = "x", word
+            spec = "#" + spec
+        else:
+            value = word
+
+        return ("%" + spec + conv) % value
+
+    return CONVERSION_RE.sub(convert, fmt)
+
+
+def decode_record(image: FirmwareImage, words: list) -> str:
+    """
+    Decodes one record.
+
+    Parameters
+    ----------
+    image : FirmwareImage
+        The firmware image.
+    words : list
+        The header word followed by the argument words.
+
+    Returns
+    -------
+    str
+        The log line, without line ending.
+    """
+    header = words[0]
+    level = LEVEL_NAMES.get((header >> HDR_LEVEL_SHIFT) & HDR_LEVEL_MASK, "?")
+    token = header >> HDR_TOKEN_SHIFT
+    args = words[1:]
+
+    fmt = image.format_string(token)
+    if fmt is None:
+        return "[{}] unknown token 0x{:06x} {}".format(
+            level, token, " ".join("{:08x}".format(w) for w in args))
+
+    if header & HDR_BUFFER:
+        length = args[0] if args else 0
+        data = b"".join(struct.pack("<I", w) for w in args[1:])[:length]
+        text = render(image, fmt, [length]) + " " + data.hex(" ")
+    else:
+        text = render(image, fmt, args)
+
+    return "[{}] {}".format(level, text.strip())
+
+
+def read_text(stream):
+    """
+    Yields the records of a UART capture, other lines are skipped.
+    """
+    for line in stream:
+        match = LINE_RE.search(line)
+        if match:
+            yield [int(w, 16) for w in match.group(1).split()]
+
+
+def read_binary(data: bytes):
+    """
+    Yields the records of a STREAM_SRC_LOG dump.
+    """
+    offset = 0
+    while offset + 4 <= len(data):
+        header, = struct.unpack_from("<I", data, offset)
+        count = 1 + (header & HDR_NARGS_MASK)
+        if offset + 4 * count > len(data):
+            break
+
+        yield list(struct.unpack_from("<{}I".format(count), data, offset))
+        offset += 4 * count
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the vent firmware log.")
+    parser.add_argument("--binary", action="store_true",
+                        help="capture is a STREAM_SRC_LOG dump")
+    parser.add_argument("elf", help="firmware ELF the capture was taken with")
+    parser.add_argument("capture", nargs="?", help="capture file (default stdin)")
+    args = parser.parse_args()
+
+    image = FirmwareImage(args.elf)
+
+    if args.binary:
+        if args.capture:
+            with open(args.capture, "rb") as file:
+                records = list(read_binary(file.read()))
+        else:
+            records = list(read_binary(sys.stdin.buffer.read()))
+    elif args.capture:
+        with open(args.capture, "r", errors="replace") as file:
+            records = list(read_text(file))
+    else:
+        records = read_text(sys.stdin)
+
+    for record in records:
+        print(decode_record(image, record))
+
+
+# MAIN PROGRAM
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,302 @@
+################################################################################
+# File Name         : mesh_sim.py
+# Description       : Discrete-time simulator of the vent-to-vent relay
+#                     (app_relay.h in the vent firmware). Builds synthetic
+#                     floor plans of rooms, places one vent per room and the
+#                     hub in one of them, then simulates the telemetry
+#                     advertisements, the relay scan windows, the
+#                     deduplication cache, the queue and the token bucket.
+#
+#                     Reports the coverage (vents whose telemetry reaches the
+#                     hub, directly or through relays) and the airtime spent
+#                     by each relay. Collisions between advertisements are
+#                     not modelled.
+#
+#                     Usage: python mesh_sim.py [--rooms CxR] [--floors N]
+#                                               [--relays F] [--trials N]
+#                                               [--duration S] [--seed N]
+#
+# Author            : Pierino Zindel
+# Date              : October 19, 2026
+# Last Revision     : N/A
+# Version           : 1.0.0
+################################################################################
+
+
+# LIBRARIES
+# Standard Libraries
+import argparse
+import math
+import random
+from collections import deque
+
+
+# GLOBAL VARIABLES
+# Simulation step, the relay advertising interval (RELAY_ADV_INTV)
+STEP_S = 0.1
+
+# Vent telemetry advertising, slow phase (ADV_SLOW_INTV)
+VENT_ADV_INTV_S = 1.0225
+
+# Scan duty cycles (GROUP_SCAN_WINDOW / GROUP_SCAN_INTV); the hub scans
+# continuously
+VENT_SCAN_DUTY = 64 / 4096
+RELAY_SCAN_DUTY = 1024 / 4096
+HUB_SCAN_DUTY = 1.0
+
+# Relay parameters (app_relay.h)
+RELAY_TTL = 3
+RELAY_BURST_EVENTS = 3
+RELAY_QUEUE_LENGTH = 4
+RELAY_CACHE_LENGTH = 32
+RELAY_TICK_S = 5
+RELAY_BUCKET_SIZE = 8
+RELAY_REFILL_TOKENS = 1
+RELAY_DEDUPE_TICKS = 60
+
+# On-air time of one legacy advertising event on the 3 channels:
+# preamble, access address, header, AdvA, 31 byte payload and CRC at 1 Mbps
+ADV_EVENT_S = 3 * (1 + 4 + 2 + 6 + 31 + 3) * 8e-6
+
+# Radio model: log-distance path loss with wall and floor losses and
+# log-normal shadowing per advertising event
+TX_POWER_DBM = 0                # DEF_TX_POWER
+PATH_LOSS_1M_DB = 40.0
+PATH_LOSS_EXPONENT = 2.2
+WALL_LOSS_DB = 6.0
+FLOOR_LOSS_DB = 15.0
+SHADOWING_DB = 4.0
+VENT_SENSITIVITY_DBM = -94.0
+HUB_SENSITIVITY_DBM = -90.0
+
+ROOM_SIZE_M = 4.0
+FLOOR_HEIGHT_M = 3.0
+
+
+# CLASSES
+class Node:
+    """
+    A vent or the hub at a position in the floor plan.
+    """
+    def __init__(self, name, room, position, relay=False, hub=False):
+        self.name = name
+        self.room = room                # (column, row, floor)
+        self.position = position        # (x, y, z) in m
+        self.relay = relay
+        self.hub = hub
+
+        # Relay state
+        self.queue = deque(maxlen=RELAY_QUEUE_LENGTH)
+        self.seen = {}                  # (origin, content) -> age in ticks
+        self.tokens = RELAY_BUCKET_SIZE
+        self.burst = None               # (frame, events left)
+        self.forwarded = 0
+        self.duplicates = 0
+        self.dropped = 0
+        self.airtime_s = 0.0
+
+    def scan_duty(self):
+        if self.hub:
+            return HUB_SCAN_DUTY
+        return RELAY_SCAN_DUTY if self.relay else VENT_SCAN_DUTY
+
+
+# FUNCTIONS
+def build_floorplan(rng, columns, rows, floors, relay_fraction):
+    """
+    Returns the hub and the vents of a floor plan of columns x rows rooms
+    per floor, one vent per room at a random spot, the hub in a random
+    ground floor room.
+    """
+    vents = []
+    for f in range(floors):
+        for r in range(rows):
+            for c in range(columns):
+                position = ((c + rng.random()) * ROOM_SIZE_M,
+                            (r + rng.random()) * ROOM_SIZE_M,
+                            f * FLOOR_HEIGHT_M)
+                vents.append(Node("V{}-{}-{}".format(f, r, c), (c, r, f), position,
+                                  relay=rng.random() < relay_fraction))
+
+    room = (rng.randrange(columns), rng.randrange(rows), 0)
+    hub = Node("HUB", room, ((room[0] + 0.5) * ROOM_SIZE_M, (room[1] + 0.5) * ROOM_SIZE_M, 1.0),
+               hub=True)
+
+    return hub, vents
+
+
+def mean_rssi(a, b):
+    """
+    Returns the mean RSSI in dBm of a transmission from a to b.
+    """
+    distance = max(math.dist(a.position, b.position), 1.0)
+    walls = abs(a.room[0] - b.room[0]) + abs(a.room[1] - b.room[1])
+    floors = abs(a.room[2] - b.room[2])
+
+    loss = (PATH_LOSS_1M_DB + 10 * PATH_LOSS_EXPONENT * math.log10(distance)
+            + WALL_LOSS_DB * walls + FLOOR_LOSS_DB * floors)
+
+    return TX_POWER_DBM - loss
+
+
+def link_probability(a, b):
+    """
+    Returns the probability that b receives one advertising event of a
+    while scanning.
+    """
+    sensitivity = HUB_SENSITIVITY_DBM if b.hub else VENT_SENSITIVITY_DBM
+    margin = mean_rssi(a, b) - sensitivity
+
+    return 0.5 * math.erfc(-margin / (SHADOWING_DB * math.sqrt(2)))
+
+
+def relay_receive(node, origin, content, hops):
+    """
+    Applies Relay_Forward to a frame heard by a relay.
+    """
+    if hops >= RELAY_TTL or origin == node.name:
+        return
+
+    key = (origin, content)
+    if key in node.seen:
+        node.duplicates += 1
+        return
+
+    # Cache full: the oldest entry is replaced
+    if len(node.seen) >= RELAY_CACHE_LENGTH:
+        del node.seen[max(node.seen, key=node.seen.get)]
+    node.seen[key] = 0
+
+    if len(node.queue) == node.queue.maxlen:
+        node.dropped += 1
+    node.queue.append((origin, content, hops + 1))
+
+
+def relay_tick(node):
+    """
+    Refills the token bucket and ages the deduplication cache.
+    """
+    node.tokens = min(node.tokens + RELAY_REFILL_TOKENS, RELAY_BUCKET_SIZE)
+    for key in list(node.seen):
+        node.seen[key] += 1
+        if node.seen[key] >= RELAY_DEDUPE_TICKS:
+            del node.seen[key]
+
+
+def simulate(rng, hub, vents, duration_s, change_s):
+    """
+    Runs one floor plan. Returns the hops of the most direct path each
+    vent's telemetry reached the hub on (None if it never did).
+    """
+    relays = [v for v in vents if v.relay]
+    listeners = [hub] + relays
+    links = {(a.name, b.name): link_probability(a, b)
+             for a in vents for b in listeners if a is not b}
+
+    phase = {v.name: rng.random() * VENT_ADV_INTV_S for v in vents}
+    content = {v.name: 0 for v in vents}
+    reached = {v.name: None for v in vents}
+
+    def transmit(sender, origin, frame, hops):
+        for listener in listeners:
+            if listener is sender:
+                continue
+            if rng.random() >= listener.scan_duty() * links[(sender.name, listener.name)]:
+                continue
+            if listener.hub:
+                if reached[origin] is None or hops < reached[origin]:
+                    reached[origin] = hops
+            else:
+                relay_receive(listener, origin, frame, hops)
+
+    steps = int(duration_s / STEP_S)
+    tick_steps = int(RELAY_TICK_S / STEP_S)
+    for step in range(steps):
+        t = step * STEP_S
+
+        # Vent telemetry, changing now and then (vent moved, new command)
+        for v in vents:
+            if rng.random() < STEP_S / change_s:
+                content[v.name] += 1
+            events = math.floor((t + STEP_S - phase[v.name]) / VENT_ADV_INTV_S)
+            if events > math.floor((t - phase[v.name]) / VENT_ADV_INTV_S):
+                transmit(v, v.name, content[v.name], 0)
+
+        # Relay bursts, one advertising event per step
+        for r in relays:
+            if r.burst is None and r.queue and r.tokens > 0:
+                r.burst = [r.queue.popleft(), RELAY_BURST_EVENTS]
+                r.tokens -= 1
+                r.forwarded += 1
+            if r.burst is not None:
+                (origin, frame, hops), _ = r.burst
+                transmit(r, origin, frame, hops)
+                r.airtime_s += ADV_EVENT_S
+                r.burst[1] -= 1
+                if r.burst[1] == 0:
+                    r.burst = None
+
+        if step % tick_steps == tick_steps - 1:
+            for r in relays:
+                relay_tick(r)
+
+    return reached
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Simulate the vent relay mesh.")
+    parser.add_argument("--rooms", default="4x3", help="rooms per floor, COLUMNSxROWS")
+    parser.add_argument("--floors", type=int, default=2, help="number of floors")
+    parser.add_argument("--relays", type=float, default=0.3,
+                        help="fraction of vents built with RELAY_ENABLE")
+    parser.add_argument("--trials", type=int, default=20, help="floor plans to simulate")
+    parser.add_argument("--duration", type=float, default=600.0, help="simulated time in s")
+    parser.add_argument("--change", type=float, default=1800.0,
+                        help="mean time between telemetry changes of a vent in s")
+    parser.add_argument("--seed", type=int, default=1, help="random seed")
+    args = parser.parse_args()
+
+    columns, rows = (int(n) for n in args.rooms.lower().split("x"))
+    rng = random.Random(args.seed)
+
+    totals = {"vents": 0, "direct": 0, "covered": 0, "relays": 0,
+              "airtime": 0.0, "worst": 0.0, "forwarded": 0, "duplicates": 0, "dropped": 0}
+    hop_counts = [0] * (RELAY_TTL + 1)
+
+    for _ in range(args.trials):
+        hub, vents = build_floorplan(rng, columns, rows, args.floors, args.relays)
+        reached = simulate(rng, hub, vents, args.duration, args.change)
+        relays = [v for v in vents if v.relay]
+
+        totals["vents"] += len(vents)
+        totals["direct"] += sum(h == 0 for h in reached.values())
+        totals["covered"] += sum(h is not None for h in reached.values())
+        for h in reached.values():
+            if h is not None:
+                hop_counts[h] += 1
+
+        totals["relays"] += len(relays)
+        for r in relays:
+            share = r.airtime_s / args.duration
+            totals["airtime"] += share
+            totals["worst"] = max(totals["worst"], share)
+            totals["forwarded"] += r.forwarded
+            totals["duplicates"] += r.duplicates
+            totals["dropped"] += r.dropped
+
+    print("{} trials, {}x{} rooms x {} floors, {:.0%} relays, {:.0f} s".format(
+        args.trials, columns, rows, args.floors, args.relays, args.duration))
+    print("Coverage      : {:.1%} direct, {:.1%} with relays".format(
+        totals["direct"] / totals["vents"], totals["covered"] / totals["vents"]))
+    print("Hops to hub   : " + ", ".join("{} {}".format(h, n) for h, n in enumerate(hop_counts)))
+    if totals["relays"]:
+        print("Relay airtime : {:.3%} mean, {:.3%} worst relay, {:.3%} total per house".format(
+            totals["airtime"] / totals["relays"], totals["worst"],
+            totals["airtime"] / args.trials))
+        print("Relay frames  : {} forwarded, {} duplicates, {} dropped".format(
+            totals["forwarded"], totals["duplicates"], totals["dropped"]))
+
+
+# MAIN PROGRAM
+if __name__ == "__main__":
+    main()
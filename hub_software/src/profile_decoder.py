@@ -0,0 +1,197 @@
+################################################################################
+# File Name         : profile_decoder.py
+# Description       : Decodes a dump of the STREAM_SRC_DIAG stream source of
+#                     the vent firmware (cycle profiler, app_profile.h) and
+#                     prints the count, minimum, maximum, mean and histogram
+#                     of every probe and message handler called, in cycles
+#                     and microseconds.
+#
+#                     The probe names are read from APP_PROFILE_PROBE_TABLE
+#                     in app_profile.h and the handler names from
+#                     APP_DISPATCH_TABLE in app_dispatch.h, so the decoder
+#                     follows the firmware table order. With --baseline, the
+#                     mean and the maximum are compared with an earlier dump
+#                     and the changes beyond --threshold are flagged.
+#
+#                     Usage: python profile_decoder.py dump [--baseline DUMP]
+#                                                           [--threshold PCT]
+#
+# Author            : Pierino Zindel
+# Date              : October 19, 2026
+# Last Revision     : N/A
+# Version           : 1.0.0
+################################################################################
+
+
+# LIBRARIES
+# Standard Libraries
+import argparse
+import os
+import re
+import struct
+
+
+# GLOBAL VARIABLES
+CURRENT_DIR = os.path.dirname(os.path.abspath(__file__))
+# Firmware headers holding the probe and dispatch tables
+INCLUDE_DIR = os.path.join(CURRENT_DIR, "..", "..", "vent_firmware", "Zephyr", "include")
+PROFILE_HEADER_FP = os.path.join(INCLUDE_DIR, "app_profile.h")
+DISPATCH_HEADER_FP = os.path.join(INCLUDE_DIR, "app_dispatch.h")
+
+# Stream layout: probe count, dispatch rows, core MHz, then one record each
+HEADER_FORMAT = "<BBH"
+BUCKETS = 8
+RECORD_FORMAT = "<IIII{}H".format(BUCKETS)
+
+# X(name) rows of APP_PROFILE_PROBE_TABLE, X(msg_id, handler) rows of
+# APP_DISPATCH_TABLE
+PROBE_TABLE_RE = re.compile(r"#define\s+APP_PROFILE_PROBE_TABLE\(X\)(.*?)\n\s*\n", re.S)
+PROBE_RE = re.compile(r"X\(\s*(\w+)\s*\)")
+DISPATCH_TABLE_RE = re.compile(r"#define\s+APP_DISPATCH_TABLE\(X\)(.*?)\n\s*\n", re.S)
+DISPATCH_RE = re.compile(r"X\(\s*(\w+)\s*,\s*(\w+)\s*\)")
+
+# Upper bound of each histogram bucket (cycles), the last one is open
+BUCKET_LABELS = ["<{}".format(1 << (6 + 2 * i)) for i in range(BUCKETS - 1)] + ["more"]
+
+
+# FUNCTIONS
+def load_names() -> tuple:
+    """
+    Returns the probe and dispatch row names, in table order.
+
+    Returns
+    -------
+    tuple
+        The probe names and the "handler/msg_id" name of each dispatch row.
+    """
+    names = []
+    for path, table_re, row_re in ((PROFILE_HEADER_FP, PROBE_TABLE_RE, PROBE_RE),
+                                   (DISPATCH_HEADER_FP, DISPATCH_TABLE_RE, DISPATCH_RE)):
+        with open(path, "r") as file:
+            text = file.read()
+
+        match = table_re.search(text)
+        if match is None:
+            raise ValueError("table not found in " + path)
+
+        names.append(row_re.findall(match.group(1)))
+
+    probes, rows = names
+    return probes, ["{}/{}".format(handler, msg_id) for msg_id, handler in rows]
+
+
+def decode(data: bytes) -> tuple:
+    """
+    Unpacks a STREAM_SRC_DIAG dump.
+
+    Parameters
+    ----------
+    data : bytes
+        The dump.
+
+    Returns
+    -------
+    tuple
+        The core clock (MHz) and a list of (name, count, min, max, mean,
+        histogram), probes first.
+    """
+    probe_count, row_count, mhz = struct.unpack_from(HEADER_FORMAT, data, 0)
+    offset = struct.calcsize(HEADER_FORMAT)
+    probes, rows = load_names()
+
+    if (probe_count != len(probes)) or (row_count != len(rows)):
+        print("Warning: {} probes and {} dispatch rows reported, {} and {} in the "
+              "headers".format(probe_count, row_count, len(probes), len(rows)))
+
+    names = (probes + ["probe #{}".format(i) for i in range(len(probes), probe_count)])[:probe_count]
+    names += (rows + ["row #{}".format(i) for i in range(len(rows), row_count)])[:row_count]
+
+    entries = []
+    for name in names:
+        if offset + struct.calcsize(RECORD_FORMAT) > len(data):
+            print("Warning: dump truncated after {} records".format(len(entries)))
+            break
+
+        fields = struct.unpack_from(RECORD_FORMAT, data, offset)
+        offset += struct.calcsize(RECORD_FORMAT)
+        entries.append((name,) + fields[:4] + (fields[4:],))
+
+    return mhz, entries
+
+
+def read_dump(path: str) -> tuple:
+    """
+    Reads and decodes a dump file.
+
+    Parameters
+    ----------
+    path : str
+        The dump file.
+
+    Returns
+    -------
+    tuple
+        See decode().
+    """
+    with open(path, "rb") as file:
+        return decode(file.read())
+
+
+def report(mhz: int, entries: list, baseline: dict, threshold: float) -> None:
+    """
+    Prints the entries that were called, and their change from a baseline.
+
+    Parameters
+    ----------
+    mhz : int
+        The core clock (MHz).
+    entries : list
+        The (name, count, min, max, mean, histogram) of each entry.
+    baseline : dict
+        The (mean, max) of each name in an earlier dump, or None.
+    threshold : float
+        The change (%) flagged as a regression.
+    """
+    print("{:<44} {:>7} {:>9} {:>9} {:>9} {:>9}  {}".format(
+        "PROBE", "CALLS", "MIN", "MEAN", "MAX", "MAX us", " ".join(BUCKET_LABELS)))
+
+    for name, count, minimum, maximum, mean, histogram in entries:
+        if count == 0:
+            continue
+
+        line = "{:<44} {:>7} {:>9} {:>9} {:>9} {:>9.1f}  {}".format(
+            name, count, minimum, mean, maximum, maximum / mhz if mhz else 0.0,
+            " ".join(str(h) for h in histogram))
+
+        if baseline and (name in baseline):
+            old_mean, old_max = baseline[name]
+            changes = []
+            for label, old, new in (("mean", old_mean, mean), ("max", old_max, maximum)):
+                if old and (100.0 * (new - old) / old) > threshold:
+                    changes.append("{} +{:.0f}%".format(label, 100.0 * (new - old) / old))
+            if changes:
+                line += "  << " + ", ".join(changes)
+
+        print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the vent cycle profile.")
+    parser.add_argument("dump", help="STREAM_SRC_DIAG dump file")
+    parser.add_argument("--baseline", help="earlier dump to compare with")
+    parser.add_argument("--threshold", type=float, default=20.0,
+                        help="change in percent flagged as a regression")
+    args = parser.parse_args()
+
+    baseline = None
+    if args.baseline:
+        _, old = read_dump(args.baseline)
+        baseline = {e[0]: (e[4], e[3]) for e in old if e[1] != 0}
+
+    mhz, entries = read_dump(args.dump)
+    report(mhz, entries, baseline, args.threshold)
+
+
+# MAIN PROGRAM
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,86 @@
+################################################################################
+# File Name         : test_log_decoder.py
+# Description       : Round trip test of the tokenized log: records written by
+#                     the firmware log module (app_log.c, built for the host
+#                     as vent_firmware/host_test/log_capture) are decoded with
+#                     log_decoder.py and compared with the text printf renders
+#                     from the same format strings and arguments. Fails when
+#                     the record layout of app_log.h and the decoder drift
+#                     apart.
+#
+#                     Usage: python test_log_decoder.py
+#                     (also run by make check in vent_firmware/host_test)
+#
+# Author            : Pierino Zindel
+# Date              : October 19, 2026
+# Last Revision     : N/A
+# Version           : 1.0.0
+################################################################################
+
+
+# LIBRARIES
+# Standard Libraries
+import io
+import os
+import shutil
+import subprocess
+import unittest
+
+# Local Libraries
+import log_decoder
+
+
+# GLOBAL VARIABLES
+CURRENT_DIR = os.path.dirname(os.path.abspath(__file__))
+HOST_TEST_DIR = os.path.join(CURRENT_DIR, "..", "..", "vent_firmware", "host_test")
+CAPTURE_TARGET = os.path.join("build", "log_capture")
+
+
+# CLASSES
+@unittest.skipUnless(shutil.which("make") and shutil.which("cc"),
+                     "make and a host C compiler are needed")
+class LogRoundTrip(unittest.TestCase):
+    """
+    Decodes the records of a host capture of the firmware log.
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        subprocess.run(["make", "-s", "-C", HOST_TEST_DIR, CAPTURE_TARGET], check=True)
+
+        elf = os.path.join(HOST_TEST_DIR, CAPTURE_TARGET)
+        output = subprocess.run([elf], check=True, capture_output=True, text=True).stdout
+
+        cls.image = log_decoder.FirmwareImage(elf)
+        cls.lines = output.splitlines()
+
+    def test_header_layout(self):
+        """
+        The header fields of app_log.h are the ones of the decoder.
+        """
+        constants = [line.split()[1:] for line in self.lines if line.startswith("#C ")]
+        self.assertTrue(constants)
+
+        for name, value in constants:
+            with self.subTest(name=name):
+                self.assertEqual(getattr(log_decoder, name), int(value))
+
+    def test_records(self):
+        """
+        Every record decodes to the text printf renders.
+        """
+        records = list(log_decoder.read_text(io.StringIO("\n".join(self.lines))))
+        expected = ["[{}] {}".format(*line[3:].split(" ", 1))
+                    for line in self.lines if line.startswith("#E ")]
+
+        self.assertTrue(records)
+        self.assertEqual(len(records), len(expected))
+
+        for record, text in zip(records, expected):
+            with self.subTest(text=text):
+                self.assertEqual(log_decoder.decode_record(self.image, record), text)
+
+
+# MAIN PROGRAM
+if __name__ == "__main__":
+    unittest.main()
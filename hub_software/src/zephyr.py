@@ -303,6 +303,20 @@ def manage_vents(ble_config: dict, vent_config: dict, csv_config: dict) -> None:
         # Get the device's current Battery level
         response = asyncio.run(ble_read(device_address, ble_config["UUIDS"]["UUID_BATTERY"]))
         battery_level = int.from_bytes(response, "big")
+
+        # Get the device's battery health estimate (see app_battery.h)
+        response = asyncio.run(ble_read(device_address, ble_config["UUIDS"]["UUID_BATT_HEALTH"]))
+        (rest_mv, sag_mv, move_min_mv, percent, _activity, moves, moves_left) = struct.unpack(
+            "<HHHBBII", response
+        )
+        battery_health = {
+            "rest_mv": rest_mv,
+            "sag_mv": sag_mv,
+            "move_min_mv": move_min_mv,
+            "percent": percent,
+            "moves": moves,
+            "moves_left": moves_left,
+        }
         
         # Get the device's current LED state
         response = asyncio.run(ble_read(device_address, ble_config["UUIDS"]["UUID_LED_STATE"]))
@@ -360,6 +374,7 @@ def manage_vents(ble_config: dict, vent_config: dict, csv_config: dict) -> None:
         device_data["last_temperature"] = temperature
         device_data["last_humidity"] = humidity
         device_data["last_battery_level"] = battery_level
+        device_data["last_battery_health"] = battery_health
         device_data["last_led_state"] = led_state
         device_data["last_button_state"] = button_state
         device_data["temp_upper_threshold"] = new_upper_threshold
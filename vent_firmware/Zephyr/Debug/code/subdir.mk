@@ -4,25 +4,97 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../code/app_adv.c \
 ../code/app_bass.c \
+../code/app_battery.c \
+../code/app_bench.c \
+../code/app_boot.c \
+../code/app_clock.c \
+../code/app_conn_policy.c \
+../code/app_crc.c \
 ../code/app_customss.c \
+../code/app_dispatch.c \
+../code/app_energy.c \
+../code/app_group.c \
+../code/app_history.c \
 ../code/app_init.c \
+../code/app_kv.c \
+../code/app_link.c \
+../code/app_log.c \
 ../code/app_msg_handler.c \
-../code/app_temperature_sensor.c 
+../code/app_ntf_queue.c \
+../code/app_power.c \
+../code/app_profile.c \
+../code/app_relay.c \
+../code/app_sched.c \
+../code/app_sensor.c \
+../code/app_siphash.c \
+../code/app_snapshot.c \
+../code/app_stream.c \
+../code/app_temperature_sensor.c \
+../code/app_timer.c 
 
 OBJS += \
+./code/app_adv.o \
 ./code/app_bass.o \
+./code/app_battery.o \
+./code/app_bench.o \
+./code/app_boot.o \
+./code/app_clock.o \
+./code/app_conn_policy.o \
+./code/app_crc.o \
 ./code/app_customss.o \
+./code/app_dispatch.o \
+./code/app_energy.o \
+./code/app_group.o \
+./code/app_history.o \
 ./code/app_init.o \
+./code/app_kv.o \
+./code/app_link.o \
+./code/app_log.o \
 ./code/app_msg_handler.o \
-./code/app_temperature_sensor.o 
+./code/app_ntf_queue.o \
+./code/app_power.o \
+./code/app_profile.o \
+./code/app_relay.o \
+./code/app_sched.o \
+./code/app_sensor.o \
+./code/app_siphash.o \
+./code/app_snapshot.o \
+./code/app_stream.o \
+./code/app_temperature_sensor.o \
+./code/app_timer.o 
 
 C_DEPS += \
+./code/app_adv.d \
 ./code/app_bass.d \
+./code/app_battery.d \
+./code/app_bench.d \
+./code/app_boot.d \
+./code/app_clock.d \
+./code/app_conn_policy.d \
+./code/app_crc.d \
 ./code/app_customss.d \
+./code/app_dispatch.d \
+./code/app_energy.d \
+./code/app_group.d \
+./code/app_history.d \
 ./code/app_init.d \
+./code/app_kv.d \
+./code/app_link.d \
+./code/app_log.d \
 ./code/app_msg_handler.d \
-./code/app_temperature_sensor.d 
+./code/app_ntf_queue.d \
+./code/app_power.d \
+./code/app_profile.d \
+./code/app_relay.d \
+./code/app_sched.d \
+./code/app_sensor.d \
+./code/app_siphash.d \
+./code/app_snapshot.d \
+./code/app_stream.d \
+./code/app_temperature_sensor.d \
+./code/app_timer.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
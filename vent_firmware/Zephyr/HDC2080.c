@@ -23,10 +23,183 @@
 #include "HDC2080.h"
 
 
+/* ----------------------------------------------------------------------------
+ * Private Global Variables
+ * --------------------------------------------------------------------------*/
+// Set by the I2C interrupt, signalled once the transfer is over
+static volatile bool BusError;
+
+// Bus speed not derived from the current clock, retried after a transfer
+static bool SpeedStale;
+
+// Bus error signal
+static struct app_timer_t ErrorTimer;
+static uint8_t ErrorToggles;
+
+// Called from the I2C interrupt when an asynchronous write ends
+static void (*volatile AsyncDone)(void);
+static uint8_t AsyncBuffer[2];
+
+// Register configuration, in write order: {register, value}
+static const uint8_t ConfigTable[][2] = {
+	{TEMP_OFFSET_ADJUST,	0x00},		// Temperature Offset Adjustment
+	{HUM_OFFSET_ADJUST,		0x00},		// Humidity Offset Adjustment
+	{TEMP_THR_L,			0x00},		// Temperature Threshold LOW
+	{TEMP_THR_H,			0xFF},		// Temperature Threshold HIGH
+	{RH_THR_L,				0x00},		// Humidity Threshold LOW
+	{RH_THR_H,				0xFF},		// Humidity Threshold HIGH
+	{INTERRUPT_ENABLE,		0x00},		// Interrupt Configuration
+	{INTERRUPT_CONFIG,		0x00},		// Reset and DRDY/INT Configuration
+	{MEASURE_CONFIG,		0x00},		// 14 bit resolution; temp & humidity
+};
+
+#define CONFIG_STEPS			(sizeof(ConfigTable) / sizeof(ConfigTable[0]))
+
+
+/* ----------------------------------------------------------------------------
+ * Private function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : toggle_error_gpio
+ *
+ * Description   : Error timer callback. Toggles the I2C event GPIO until the
+ * 				   bus error signal is complete.
+ *
+ * Parameters    : void *context : Unused
+ *
+ * Returns		 : None
+ */
+static void toggle_error_gpio(void *context)
+{
+	Sys_GPIO_Toggle(APP_I2C_EVENT_GPIO);
+
+	if (--ErrorToggles == 0) {
+		AppTimer_Cancel(&ErrorTimer);
+	}
+
+	return;
+}
+
+/* Function      : i2c_set_speed
+ *
+ * Description   : Derives the bus speed prescaler from SystemCoreClock. The
+ * 				   driver refuses while a transfer runs, so the transfer is
+ * 				   aborted and the setting tried again, I2C_SPEED_TRIES
+ * 				   times at most. On failure the bus error is signalled and
+ * 				   the setting is retried when the next transfer ends.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : bool : true if the bus speed is set
+ */
+static bool i2c_set_speed(void)
+{
+	for (uint8_t tries = 0; tries < I2C_SPEED_TRIES; tries++) {
+		if (i2c->Control(ARM_I2C_BUS_SPEED, I2C_SPEED) == ARM_DRIVER_OK) {
+			SpeedStale = false;
+			return true;
+		}
+
+		i2c->Control(ARM_I2C_ABORT_TRANSFER, 0);
+	}
+
+	if (!SpeedStale) {
+		APP_LOG_ERROR("__I2C bus speed not set at %lu Hz\r\n", SystemCoreClock);
+		SpeedStale = true;
+		BusError = true;
+	}
+
+	return false;
+}
+
+/* Function      : i2c_finish
+ *
+ * Description   : Clears the peripheral after a transfer (aborts it if it is
+ * 				   still running) and signals a bus error on the I2C event
+ * 				   GPIO.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : None
+ */
+static void i2c_finish(void)
+{
+	i2c->Control(ARM_I2C_ABORT_TRANSFER, 0);
+	Energy_End(ENERGY_I2C);
+
+	if (SpeedStale) {
+		i2c_set_speed();
+	}
+
+	/* To signal error, toggle GPIO state very fast
+	 * (10 times for 0.05 seconds each). */
+	if (BusError) {
+		BusError = false;
+		ErrorToggles = I2C_ERROR_TOGGLES;
+		if (!AppTimer_Start(&ErrorTimer, APP_TIMER_MS(I2C_ERROR_TOGGLE_MS),
+							APP_TIMER_MS(I2C_ERROR_TOGGLE_MS), toggle_error_gpio, NULL)) {
+			// The log still tells of the error, the GPIO is left as it is
+			APP_LOG_ERROR("__I2C bus error, no timer to signal it\r\n");
+		}
+	}
+
+	return;
+}
+
+/* Function      : i2c_wait
+ *
+ * Description   : Waits for the current transfer to complete with the core
+ * 				   halted between interrupts, then clears the peripheral. A
+ * 				   transfer running longer than I2C_TRANSFER_TIMEOUT_US is
+ * 				   aborted: SysTick runs with that period during the wait,
+ * 				   so the core wakes at the deadline even if the I2C
+ * 				   interrupt never comes. A bus error is signalled on the
+ * 				   I2C event GPIO.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : None
+ */
+static void i2c_wait(void)
+{
+	uint64_t deadline = AppTimer_Now() + I2C_TRANSFER_TIMEOUT_US;
+
+	Energy_Begin(ENERGY_I2C);
+
+	// Deadline wake, well within the 24-bit reload at any core clock
+	SysTick->LOAD = (SystemCoreClock / 1000000) * I2C_TRANSFER_TIMEOUT_US - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk |
+					SysTick_CTRL_ENABLE_Msk;
+
+	/* Interrupts are masked between the status check and the WFI so the
+	 * transfer interrupt cannot slip in between; a pending interrupt still
+	 * ends the WFI and runs once they are unmasked. */
+	__disable_irq();
+	while (i2c->GetStatus().busy && (AppTimer_Now() < deadline)) {
+		__WFI();
+		__enable_irq();
+		__disable_irq();
+	}
+	__enable_irq();
+
+	SysTick->CTRL = 0;
+	i2c_finish();
+
+	return;
+}
+
+
 /* ----------------------------------------------------------------------------
  * Function definitions
  * --------------------------------------------------------------------------*/
 
+void SysTick_Handler(void)
+{
+	// Only wakes i2c_wait, which checks its deadline itself
+	return;
+}
+
 float adc_to_humidity(uint16_t data)
 {
 	return data / (float) ADC_RESOLUTION * HUMIDITY_SCALING + HUMIDITY_OFFSET;
@@ -43,8 +216,7 @@ void change_to_register(uint8_t reg)
 	i2c->MasterTransmit(HDC_ADDRESS, &reg, 1, false);
 
 	// Wait for the transmission to complete and clear the peripheral
-    MICRO_DELAY(500);
-    i2c->Control(ARM_I2C_ABORT_TRANSFER, 0);
+    i2c_wait();
 
 	return;
 }
@@ -119,6 +291,8 @@ uint16_t get_raw_temperature(void)
 
 void i2c_callback(uint32_t event)
 {
+    void (*done)(void) = AsyncDone;
+
     if (event & ARM_I2C_EVENT_TRANSFER_DONE)
     {
     	i2c->Control(ARM_I2C_ABORT_TRANSFER, 0);
@@ -137,17 +311,11 @@ void i2c_callback(uint32_t event)
         // Go back to SlaveReceive default mode
         //i2c->SlaveReceive(buffer, I2C_BUFFER_SIZE);
 
-        /* To signal error, toggle GPIO state very fast
-         * (10 times for 0.05 seconds each).
-         * Only signal bus errors to the user. */
+        /* Only signal bus errors to the user, from i2c_wait (timers
+         * cannot be started from the interrupt). */
         if (event & ARM_I2C_EVENT_BUS_ERROR)
         {
-            // Toggle GPIO 10 times, with 50ms period.
-        	uint32_t n = 10;
-            while (n-- > 0) {
-				Sys_GPIO_Toggle(APP_I2C_EVENT_GPIO);
-				Sys_Delay((50 * SystemCoreClock) / 1000);
-			}
+            BusError = true;
         }
     }
     else
@@ -159,49 +327,49 @@ void i2c_callback(uint32_t event)
          * ARM_I2C_EVENT_GENERAL_CALL
          * ARM_I2C_EVENT_BUS_CLEAR
          */
+        return;
+    }
+
+    // The asynchronous write is over, either way
+    if (done != NULL)
+    {
+        AsyncDone = NULL;
+        done();
     }
 }
 
 void initialize_hdc2080(void)
 {
-	// Declare a bytes to store the register value data
-	uint8_t reg_value = 0;
-
-	// Setup the Temperature Offset Adjustment register
-	reg_value = 0x00;
-	write_to_register(TEMP_OFFSET_ADJUST, reg_value);
-
-	// Setup the Humidity Offset Adjustment register
-	reg_value = 0x00;
-	write_to_register(HUM_OFFSET_ADJUST, reg_value);
-
-	// Setup the Temperature Threshold LOW register
-	reg_value = 0x00;
-	write_to_register(TEMP_THR_L, reg_value);
+	// Write the register configuration in order
+	for (uint8_t step = 0; step < CONFIG_STEPS; step++) {
+		write_to_register(ConfigTable[step][0], ConfigTable[step][1]);
+	}
 
-	// Setup the Temperature Threshold HIGH register
-	reg_value = 0xFF;
-	write_to_register(TEMP_THR_H, reg_value);
+	return;
+}
 
-	// Setup the Humidity Threshold LOW register
-	reg_value = 0x00;
-	write_to_register(RH_THR_L, reg_value);
+bool configure_hdc2080_step(uint8_t step, void (*done)(void))
+{
+	if (step >= CONFIG_STEPS) {
+		return false;
+	}
 
-	// Setup the Humidity Threshold HIGH register
-	reg_value = 0xFF;
-	write_to_register(RH_THR_H, reg_value);
+	AsyncBuffer[0] = ConfigTable[step][0];
+	AsyncBuffer[1] = ConfigTable[step][1];
+	AsyncDone = done;
 
-	// Setup the Interrupt Configuration register
-	reg_value = 0x00;
-	write_to_register(INTERRUPT_ENABLE, reg_value);
+	// Write slave address (write mode) + register address, return at once
+	Energy_Begin(ENERGY_I2C);
+	i2c->MasterTransmit(HDC_ADDRESS, AsyncBuffer, 2, false);
 
-	// Setup the Reset and DRDY/INT Configuration register
-	reg_value = 0x00;
-	write_to_register(INTERRUPT_CONFIG, reg_value);
+	return true;
+}
 
-	// Setup the Measurement Configuration register
-	reg_value = 0x00;					// Config: 14 bit resolution; temp & humidity
-	write_to_register(MEASURE_CONFIG, reg_value);
+void complete_hdc2080_step(void)
+{
+	// Late interrupt of a timed out write has nothing to call
+	AsyncDone = NULL;
+	i2c_finish();
 
 	return;
 }
@@ -214,9 +382,28 @@ void initialize_i2c_connection(void)
 	error_check(i2c->PowerControl(ARM_POWER_FULL));
 
 	// Configure the I2C bus speed; if bus is busy, abort transfer and try again
-	while (i2c->Control(ARM_I2C_BUS_SPEED, I2C_SPEED) != ARM_DRIVER_OK) {
-		i2c->Control(ARM_I2C_ABORT_TRANSFER, 0);
-	}
+	i2c_set_speed();
+
+	return;
+}
+
+void restore_i2c_connection(void)
+{
+	i2c->PowerControl(ARM_POWER_OFF);
+	initialize_i2c_connection();
+
+	return;
+}
+
+bool i2c_is_busy(void)
+{
+	return (i2c->GetStatus().busy != 0);
+}
+
+void i2c_clock_changed(void)
+{
+	// The driver computes the prescaler from SystemCoreClock
+	i2c_set_speed();
 
 	return;
 }
@@ -230,8 +417,7 @@ uint8_t read_from_register(void)
 	i2c->MasterReceive(HDC_ADDRESS, &data, 1, false);
 
 	// Wait for the transmission to complete and clear the peripheral
-    MICRO_DELAY(500);
-    i2c->Control(ARM_I2C_ABORT_TRANSFER, 0);
+    i2c_wait();
 
 	return data;
 }
@@ -251,8 +437,7 @@ void write_to_register(uint8_t reg, uint8_t data)
 	i2c->MasterTransmit(HDC_ADDRESS, buffer, 2, false);
 
 	// Wait for the transmission to complete and clear the peripheral
-    MICRO_DELAY(500);
-    i2c->Control(ARM_I2C_ABORT_TRANSFER, 0);
+    i2c_wait();
 
 	return;
 }
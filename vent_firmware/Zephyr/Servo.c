@@ -28,11 +28,86 @@
  * --------------------------------------------------------------------------*/
 // Variables to track the vent state
 static uint8_t State;
+static bool Moving;					// PWM running, see servo_is_busy
+static int16_t Pending;				// Angle requested while moving, -1 if none
+static bool ClockWait;				// Pending waits for the lowest clock level
+static bool Configured;				// PWM set up, done by the first move
+static struct app_timer_t TravelTimer;	// Stops the PWM once the travel is over
 #if (CONTINUOUS_SERVO)
  static uint8_t MotorPosition;		// A position in degrees (0-360)
 #endif
 
 
+/* ----------------------------------------------------------------------------
+ * Private function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : configure_servo
+ *
+ * Description   : Configures the PWM channel of the servo (clock, offset and
+ * 				   period).
+ *
+ * Parameters    : None
+ *
+ * Returns		 : None
+ */
+static void configure_servo(void)
+{
+	// Disable the PWM channels
+	PWM->CTRL |= (0x100 << SERVO_PWM_CHANNEL);
+
+	// Configure offset
+	PWM->OFFSET[SERVO_PWM_CHANNEL] = 0x0;
+
+	// Enable PWM offset
+	PWM->OFFSET[SERVO_PWM_CHANNEL] |= PWM_OFFSET_ENABLE;
+
+	// Initialize the PWM driver
+	pwm = &Driver_PWM;
+	pwm->Initialize();
+
+	// Set the clock and prescaler for the PWM
+	pwm->SelectClock(SERVO_CLK_SELECT, SERVO_CLK_PRESCALER);
+
+	// Set the PWM period
+	pwm->SetPeriod(SERVO_PWM_CHANNEL, SERVO_PWM_PERIOD);
+
+	return;
+}
+
+/* Function      : stop_servo
+ *
+ * Description   : Travel timer callback. Disables the servo motor and moves
+ * 				   on to the angle requested during the travel, if any.
+ *
+ * Parameters    : void *context : Unused
+ *
+ * Returns		 : None
+ */
+static void stop_servo(void *context)
+{
+#if (CONTINUOUS_SERVO)
+	PWM->CTRL |= (1 << (SERVO_PWM_CHANNEL + PWM_CTRL_DISABLE_Pos));
+#else
+	pwm->Stop(SERVO_PWM_CHANNEL);
+#endif
+	Moving = false;
+	Battery_MoveEnded();
+	Energy_End(ENERGY_SERVO);
+
+	if (Pending >= 0) {
+		uint8_t angle = (uint8_t)Pending;
+
+		Pending = -1;
+		set_position(angle);
+	} else {
+		Clock_Limit(CLOCK_SERVO, CLOCK_LEVEL_COUNT - 1);
+	}
+
+	return;
+}
+
+
 /* ----------------------------------------------------------------------------
  * Function definitions
  * --------------------------------------------------------------------------*/
@@ -54,42 +129,90 @@ uint8_t get_vent_state(void)
 	return State;
 }
 
-void initialize_servo(void)
+void initialize_servo(uint8_t state)
 {
 	// Initialize the GPIO pin
     //gpio = &Driver_GPIO;
 	//gpio->Initialize((GPIO_SignalEvent_t) 0);
 
-	// Disable the PWM channels
-	PWM->CTRL |= (0x100 << SERVO_PWM_CHANNEL);
+	// The PWM is configured by the first move, off the boot path
+	Configured = false;
 
-	// Configure offset
-	PWM->OFFSET[SERVO_PWM_CHANNEL] = 0x0;
+	// Start from the state the vent was left in, it has not moved since
+	State = (state == VENT_CLOSED_STATE) ? VENT_CLOSED_STATE : VENT_OPEN_STATE;
+	Moving = false;
+	Pending = -1;
+	ClockWait = false;
+#if (CONTINUOUS_SERVO)
+	MotorPosition = (State == VENT_CLOSED_STATE) ? VENT_CLOSED_DEG : VENT_OPEN_DEG;
+#endif
 
-	// Enable PWM offset
-	PWM->OFFSET[SERVO_PWM_CHANNEL] |= PWM_OFFSET_ENABLE;
+	return;
+}
 
-	// Initialize the PWM driver
-	pwm = &Driver_PWM;
-	pwm->Initialize();
+void restore_servo(void)
+{
+	// Nothing to restore before the first move
+	if (Configured) {
+		configure_servo();
+	}
 
-	// Set the clock and prescaler for the PWM
-	pwm->SelectClock(SERVO_CLK_SELECT, SERVO_CLK_PRESCALER);
+	return;
+}
 
-	// Set the PWM period
-	pwm->SetPeriod(SERVO_PWM_CHANNEL, SERVO_PWM_PERIOD);
+bool servo_is_busy(void)
+{
+	return Moving;
+}
 
-	// Set the global status variables
-	State = VENT_OPEN_STATE;
-#if (CONTINUOUS_SERVO)
-	MotorPosition = VENT_OPEN_DEG;
-#endif
+void servo_clock_changed(void)
+{
+	if (SystemCoreClock != SERVO_SYSCLK_HZ) {
+		return;
+	}
+
+	if (Configured) {
+		pwm->SelectClock(SERVO_CLK_SELECT, SERVO_CLK_PRESCALER);
+		pwm->SetPeriod(SERVO_PWM_CHANNEL, SERVO_PWM_PERIOD);
+	}
+
+	if (ClockWait) {
+		uint8_t angle = (uint8_t)Pending;
+
+		ClockWait = false;
+		Pending = -1;
+		set_position(angle);
+	}
 
 	return;
 }
 
 void set_position(uint8_t angle)
 {
+	PROFILE_SCOPE(SET_POSITION);
+
+	// One travel at a time, the latest request is applied when it ends
+	if (Moving) {
+		Pending = angle;
+		return;
+	}
+
+	// The PWM period is only derivable at the lowest clock level; if a busy
+	// subsystem holds the clock, the move starts once it is reached
+	Clock_Limit(CLOCK_SERVO, CLOCK_LEVEL_LOW);
+	if (Clock_GetLevel() != CLOCK_LEVEL_LOW) {
+		Pending = angle;
+		ClockWait = true;
+		return;
+	}
+
+	// First move, set up the PWM deferred from the boot
+	if (!Configured) {
+		configure_servo();
+		Configured = true;
+		Boot_Mark(BOOT_PHASE_SERVO);
+	}
+
 #if (CONTINUOUS_SERVO) // Servo motor is continuous; positioning is based on motor runtime
 	// Compute the time to reach given angle
 	int8_t difference = MotorPosition - angle;
@@ -116,22 +239,19 @@ void set_position(uint8_t angle)
 
 	// Enable the servo motor
 	PWM->CTRL |= (1 << (SERVO_PWM_CHANNEL + PWM_CTRL_ENABLE_Pos));
-
-	// Wait for required travel time
-	if (move_time > 1000000) {
-		move_time = move_time / 1000000;
-		SECOND_DELAY(move_time);
-	} else if (move_time > 1000) {
-		move_time = move_time / 1000;
-		MILLI_DELAY(move_time);
-	} else {
-		MICRO_DELAY(move_time);
+	Moving = true;
+	Battery_MoveStarted();
+	Energy_Begin(ENERGY_SERVO);
+
+	// Disable the servo motor after the required travel time; without a
+	// timer nothing would stop it, so the move is dropped
+	if (!AppTimer_Start(&TravelTimer, APP_TIMER_US(move_time), 0, stop_servo, NULL)) {
+		APP_LOG_ERROR("__SERVO no timer, move to %d deg dropped\r\n", angle);
+		stop_servo(NULL);
+		return;
 	}
 
-	// Disable the servo motor
-	PWM->CTRL |= (1 << (SERVO_PWM_CHANNEL + PWM_CTRL_DISABLE_Pos));
-
-	// Update the current motor position
+	// Update the current motor position (reached when the timer expires)
 	MotorPosition = angle;
 
 #else // Servo motor is not continuous; positioning is based on angle provided
@@ -142,12 +262,16 @@ void set_position(uint8_t angle)
 
 	// Enable the servo motor
 	pwm->Start(SERVO_PWM_CHANNEL);
-
-	// Wait for 500 ms
-	MILLI_DELAY(500);
-
-	// Disable the servo motor
-	pwm->Stop(SERVO_PWM_CHANNEL);
+	Moving = true;
+	Battery_MoveStarted();
+	Energy_Begin(ENERGY_SERVO);
+
+	// Disable the servo motor after 500 ms; without a timer the motor would
+	// stay powered, so it is stopped at once
+	if (!AppTimer_Start(&TravelTimer, APP_TIMER_MS(SERVO_TRAVEL_MS), 0, stop_servo, NULL)) {
+		APP_LOG_ERROR("__SERVO no timer, move to %d deg dropped\r\n", angle);
+		stop_servo(NULL);
+	}
 
 #endif /* if (CONTINUOUE_SERVO) */
 
@@ -44,14 +44,11 @@ DRIVER_PWM_t *pwm;
 
 DRIVER_GPIO_t *gpio;
 
-EncodedFloat temperature_reading;
-EncodedFloat humidity_reading;
 EncodedFloat temperature_upper_threshold;
 EncodedFloat temperature_lower_threshold;
 
 uint8_t vent_state_var;
 uint8_t *vent_state = &vent_state_var;
-uint8_t battery_level;
 
 
 /* ----------------------------------------------------------------------------
@@ -71,34 +68,20 @@ void error_check(uint32_t status)
 
 void sensor_initialization(void)
 {
-	// Initialize the HDC2080 I2C connection
+	// Initialize the HDC2080 I2C connection, the registers are written
+	// in the background by Boot_Start
 	initialize_i2c_connection();
-	initialize_hdc2080();
-
-	return;
-}
-
-void sensor_measurement(void)
-{
-	// Trigger the HDC2080 sensor and store the results
-	trigger_measurement();
-	temperature_reading.value = get_temperature();
-	humidity_reading.value = get_humidity();
-
-	// Retrieve the battery level and store the result
-	battery_level = APP_BASS_ReadBattLevel(0);
-
-	// Auto open/closed the vent if thresholds are active
-	//vent_threshold_check();
 
 	return;
 }
 
 void vent_threshold_check(void)
 {
+    float temperature = Snapshot_Get()->temperature;
+
     // Check if the threshold is active and if vent needs to be closed
     if ((temperature_upper_threshold.value < (THRESHOLD_OFF_LIMIT - THRESHOLD_OFF_DELTA))
-        && (temperature_reading.value >= temperature_upper_threshold.value)
+        && (temperature >= temperature_upper_threshold.value)
         && (*vent_state != VENT_CLOSED_STATE))
     {
         // Update the global variable and the motor
@@ -108,7 +91,7 @@ void vent_threshold_check(void)
 
     // Check if the threshold is active and if the vent needs to be opened
     if ((temperature_lower_threshold.value < (THRESHOLD_OFF_LIMIT - THRESHOLD_OFF_DELTA))
-        && (temperature_reading.value <= temperature_lower_threshold.value)
+        && (temperature <= temperature_lower_threshold.value)
         && (*vent_state != VENT_OPEN_STATE))
     {
         // Update the global variable and the motor
@@ -125,7 +108,8 @@ void vent_initialization(void)
 	// TODO: implement initialization function in motor driver module
 	//initialize_pwm_control();
 	//initialize_motor_pins();
-	initialize_servo();
+	initialize_servo(*vent_state);
+	*vent_state = get_vent_state();
 
 	return;
 }
@@ -133,6 +117,10 @@ void vent_update(void)
 {
 	// Update the vent/motor state to match the variables current value
 	set_vent_state(*vent_state);
+	KV_Set(KV_VENT_STATE, vent_state);
+	// Advertise the new state, let a disconnected hub find the vent quickly
+	Group_RefreshTelemetry();
+	Adv_Kick();
 	return;
 }
 
@@ -170,21 +158,36 @@ int main(void)
 
 	// Initialize main functionalities
     DeviceInit();
+    Boot_Initialize();
     SWMTraceInit();
+    AppLog_Initialize();
+    Boot_Mark(BOOT_PHASE_LOG);
 
     // Print log
-    swmLogInfo("__%s has started.\n", "ble_peripheral_server");
+    APP_LOG_INFO("__%s has started.\n", APP_LOG_STR("ble_peripheral_server"));
 
-    // Initialize peripherals
+    // Restore the configuration saved in flash before the services and the
+    // advertising use it, defaults for what was never set
+    KV_Initialize();
+    *vent_state = 0;
+    temperature_upper_threshold.value = (float)THRESHOLD_OFF_LIMIT;
+    temperature_lower_threshold.value = (float)THRESHOLD_OFF_LIMIT;
+    KV_Get(KV_VENT_STATE, vent_state);
+    KV_Get(KV_UPPER_THRESHOLD, &temperature_upper_threshold.value);
+    KV_Get(KV_LOWER_THRESHOLD, &temperature_lower_threshold.value);
+
+    // Initialize peripherals; the BLE stack reset and database setup run
+    // in the kernel from here, overlapping the sensor configuration
     sensor_initialization();
     vent_initialization();
     ble_initialization();
+    Boot_Mark(BOOT_PHASE_BLE_RESET);
 
     // Initialize global variables
-    sensor_measurement();
-    *vent_state = 0;
-    temperature_upper_threshold.value = (float)THRESHOLD_OFF_LIMIT;
-    temperature_lower_threshold.value = (float)THRESHOLD_OFF_LIMIT;
+    Snapshot_Initialize();
+
+    // Configure the sensor in the background, the first sample follows
+    Boot_Start();
 
     // Enable interrupts and exceptions
     PRIMASK_FAULTMASK_ENABLE_INTERRUPTS();
@@ -198,17 +201,24 @@ void main_loop(void)
     while (1) {
         // Refresh the watchdog timer //
         SYS_WATCHDOG_REFRESH();
+        PROFILE_BEGIN(BLE_KERNEL_PROCESS);
         BLE_Kernel_Process();
+        PROFILE_END(BLE_KERNEL_PROCESS);
+
+        // Run the events posted by interrupts and application code
+        if (AppSched_Run()) {
+            continue;
+        }
 
-        if (GPIO0_Pressed()) {
-        	for (unsigned int i = 0; i < BLE_CONNECTION_MAX; i++) {
-        		if(GAPC_IsConnectionActive(i)) {
-        			ke_msg_send_basic(CUSTOM_BUTTON_NTF, KE_BUILD_ID(TASK_APP, i), KE_BUILD_ID(TASK_APP, i));
-        		}
-            }
-            GPIO0_Pressed_Flag_Clear();
+        // Kernel idle: flush pending log records, sleep once they are out
+        if (AppLog_Drain()) {
+            continue;
         }
 
-        __WFI();
+        // Clock level change held by a busy subsystem
+        Clock_Update();
+
+        // Sleep with retention when nothing is busy, else wait in run mode
+        Power_Idle();
     }
 }
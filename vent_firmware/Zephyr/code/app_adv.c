@@ -0,0 +1,578 @@
+/******************************************************************************
+ * File Name        : app_adv.c
+ * Description      : This module implements the advertising and reconnect
+ *                    policy (see app_adv.h).
+ *
+ *                    The stack only takes the advertising type and interval
+ *                    when the activity is created, so a phase change stops
+ *                    and deletes the activity and creates it again. Every
+ *                    step waits for the stack to complete the previous one;
+ *                    Adv_Step() moves the activity toward the requested
+ *                    phase from whatever state it is in.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <ble_abstraction.h>
+#include <app.h>
+#include <app_adv.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+// Advertising activity states
+enum adv_activity_state
+{
+    ADV_ACTIVITY_NONE,          // not created
+    ADV_ACTIVITY_CREATING,      // create, data and start in progress
+    ADV_ACTIVITY_STARTED,
+    ADV_ACTIVITY_STOPPING,
+    ADV_ACTIVITY_STOPPED,       // created, not advertising
+    ADV_ACTIVITY_DELETING,
+};
+
+#define ADV_NO_CONIDX                   (0xFF)
+
+struct adv_peer_t
+{
+    uint8_t addr[GAP_BD_ADDR_LEN];
+    uint8_t addr_type;
+};
+
+struct adv_env_tag
+{
+    uint8_t activity;           // enum adv_activity_state
+    uint8_t phase;              // phase of the current activity
+    uint8_t target;             // phase requested
+    bool started;               // Adv_Start() called
+    bool data_stale;            // data changed while the activity was created
+
+    // Hub: bonded peer, address it last connected from
+    bool hub_valid;
+    struct adv_peer_t hub;
+    const BondInfo_t *hub_bond;
+    uint8_t hub_conidx;         // ADV_NO_CONIDX while disconnected
+
+    // Address of each connected peer
+    struct adv_peer_t peer[APP_MAX_NB_CON];
+
+    // Connections confirmed from the cached hub bond
+    uint16_t cached_links;
+};
+
+static struct adv_env_tag adv_env;
+
+static GAPM_ActivityStatus_t adv_activity_status;
+
+static const struct gapm_adv_create_param adv_undirected_params =
+{
+#if ADV_EXTENSION == 1
+    .type = GAPM_ADV_TYPE_EXTENDED,
+    .prop = GAPM_EXT_ADV_PROP_UNDIR_CONN_MASK,
+#else  /* if ADV_EXTENSION == 1 */
+    .type = GAPM_ADV_TYPE_LEGACY,
+    .prop = GAPM_ADV_PROP_UNDIR_CONN_MASK,
+#endif /* if ADV_EXTENSION == 1 */
+    .disc_mode = GAPM_ADV_MODE_GEN_DISC,
+    .filter_pol = ADV_ALLOW_SCAN_ANY_CON_ANY,
+    .max_tx_pwr = DEF_TX_POWER,
+    .prim_cfg = {
+        .chnl_map = APP_ADV_CHMAP,
+#if ADV_EXTENSION == 1
+        .phy = GAPM_PHY_TYPE_LE_CODED,
+#else  /* if ADV_EXTENSION == 1 */
+        .phy = GAPM_PHY_TYPE_LE_1M,
+#endif /* if ADV_EXTENSION == 1 */
+    },
+#if ADV_EXTENSION == 1
+    .second_cfg = {
+        .phy = GAPM_PHY_TYPE_LE_CODED,
+        .max_skip = 0,
+        .adv_sid = 0,
+    },
+#endif /* if ADV_EXTENSION == 1 */
+};
+
+struct adv_phase_cfg_t
+{
+    const char *name;
+    uint16_t interval;          // 0.625 ms units, unused when directed
+    uint16_t duration;          // 10 ms units, 0 until a connection
+    uint8_t next;               // phase after the duration
+    uint32_t led_period_ms;     // see ADV_LED_FLASH_MS
+    uint32_t current_ua;        // estimated average current
+};
+
+static const struct adv_phase_cfg_t adv_phase_cfg[] =
+{
+    [ADV_PHASE_DIRECTED] = { "DIRECTED", 0,               ADV_DIRECTED_DURATION, ADV_PHASE_FAST,
+                             0,                        ADV_DIRECTED_CURRENT_UA },
+    [ADV_PHASE_FAST]     = { "FAST",     ADV_FAST_INTV,   ADV_FAST_DURATION,     ADV_PHASE_MEDIUM,
+                             0,                        ADV_CURRENT_UA(ADV_FAST_INTV) },
+    [ADV_PHASE_MEDIUM]   = { "MEDIUM",   ADV_MEDIUM_INTV, ADV_MEDIUM_DURATION,   ADV_PHASE_SLOW,
+                             ADV_MEDIUM_LED_PERIOD_MS, ADV_CURRENT_UA(ADV_MEDIUM_INTV) },
+    [ADV_PHASE_SLOW]     = { "SLOW",     ADV_SLOW_INTV,   ADV_SLOW_DURATION,     ADV_PHASE_SLOW,
+                             ADV_SLOW_LED_PERIOD_MS,   ADV_CURRENT_UA(ADV_SLOW_INTV) },
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Adv_ReconnectPhase
+ *
+ * Description   : Returns the first phase of a reconnect: directed to the
+ *                 hub if one is cached, fast otherwise.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint8_t : advertising phase
+ */
+static uint8_t Adv_ReconnectPhase(void)
+{
+#if ADV_EXTENSION == 0
+    if (adv_env.hub_valid)
+    {
+        return ADV_PHASE_DIRECTED;
+    }
+#endif /* if ADV_EXTENSION == 0 */
+
+    return ADV_PHASE_FAST;
+}
+
+/* Function      : Adv_Create
+ *
+ * Description   : Create the advertising activity of a phase.
+ *
+ * Parameters    : uint8_t phase : advertising phase
+ *
+ * Returns       : None
+ */
+static void Adv_Create(uint8_t phase)
+{
+    struct gapm_adv_create_param params = adv_undirected_params;
+
+    if (phase == ADV_PHASE_DIRECTED)
+    {
+        params.prop = GAPM_ADV_PROP_DIR_CONN_HDC_MASK;
+        params.disc_mode = GAPM_ADV_MODE_NON_DISC;
+        memcpy(params.peer_addr.addr.addr, adv_env.hub.addr, GAP_BD_ADDR_LEN);
+        params.peer_addr.addr_type = adv_env.hub.addr_type;
+    }
+    else
+    {
+        params.prim_cfg.adv_intv_min = adv_phase_cfg[phase].interval;
+        params.prim_cfg.adv_intv_max = adv_phase_cfg[phase].interval;
+    }
+
+    adv_env.phase = phase;
+    adv_env.activity = ADV_ACTIVITY_CREATING;
+    GAPM_ActivityCreateAdvCmd(&adv_activity_status, GAPM_OWN_ADDR_TYPE, &params);
+}
+
+/* Function      : Adv_Run
+ *
+ * Description   : Start the created activity with the duration of its phase.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Adv_Run(void)
+{
+    const struct adv_phase_cfg_t *cfg = &adv_phase_cfg[adv_env.phase];
+
+    adv_env.activity = ADV_ACTIVITY_CREATING;
+    GAPM_AdvActivityStart(adv_activity_status.actv_idx, cfg->duration, 0);
+
+    APP_LOG_INFO("__ADV %s: %lu s, ~%lu uA\r\n", APP_LOG_STR(cfg->name),
+                 (uint32_t)cfg->duration / 100, cfg->current_ua);
+}
+
+/* Function      : Adv_Step
+ *
+ * Description   : Take the next step toward advertising in the requested
+ *                 phase, or toward not advertising once every connection is
+ *                 in use. Does nothing while the stack is completing a
+ *                 previous step.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Adv_Step(void)
+{
+    bool run = adv_env.started && (GAPC_ConnectionCount() < APP_MAX_NB_CON);
+
+    switch (adv_env.activity)
+    {
+        case ADV_ACTIVITY_NONE:
+        {
+            if (run)
+            {
+                Adv_Create(adv_env.target);
+            }
+        }
+        break;
+
+        case ADV_ACTIVITY_STARTED:
+        {
+            if (!run || (adv_env.target != adv_env.phase))
+            {
+                struct gapm_activity_stop_cmd *cmd = KE_MSG_ALLOC(GAPM_STOP_ACTIVITY_CMD,
+                                                                  TASK_GAPM, TASK_APP,
+                                                                  gapm_activity_stop_cmd);
+
+                cmd->operation = GAPM_STOP_ACTIVITY;
+                cmd->actv_idx = adv_activity_status.actv_idx;
+                ke_msg_send(cmd);
+                adv_env.activity = ADV_ACTIVITY_STOPPING;
+            }
+        }
+        break;
+
+        case ADV_ACTIVITY_STOPPED:
+        {
+            if (!run)
+            {
+                break;
+            }
+
+            if (adv_env.target == adv_env.phase)
+            {
+                Adv_Run();
+            }
+            else
+            {
+                struct gapm_activity_delete_cmd *cmd = KE_MSG_ALLOC(GAPM_DELETE_ACTIVITY_CMD,
+                                                                    TASK_GAPM, TASK_APP,
+                                                                    gapm_activity_delete_cmd);
+
+                cmd->operation = GAPM_DELETE_ACTIVITY;
+                cmd->actv_idx = adv_activity_status.actv_idx;
+                ke_msg_send(cmd);
+                adv_env.activity = ADV_ACTIVITY_DELETING;
+            }
+        }
+        break;
+
+        default:
+        {
+            // Wait for the stack
+        }
+        break;
+    }
+}
+
+/* Function      : Adv_Request
+ *
+ * Description   : Request an advertising phase.
+ *
+ * Parameters    : uint8_t phase : advertising phase
+ *
+ * Returns       : None
+ */
+static void Adv_Request(uint8_t phase)
+{
+    adv_env.target = phase;
+    Adv_Step();
+}
+
+/* Function      : Adv_CacheHub
+ *
+ * Description   : Remember a bonded peer as the hub.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : None
+ */
+static void Adv_CacheHub(uint8_t conidx)
+{
+    const BondInfo_t *bond = Adv_GetBondInfo(conidx);
+
+    if (bond == NULL)
+    {
+        return;
+    }
+
+    adv_env.hub = adv_env.peer[conidx];
+    adv_env.hub_bond = bond;
+    adv_env.hub_conidx = conidx;
+    adv_env.hub_valid = true;
+}
+
+void Adv_Initialize(void)
+{
+    memset(&adv_env, 0, sizeof(adv_env));
+    adv_env.activity = ADV_ACTIVITY_NONE;
+    adv_env.target = ADV_PHASE_FAST;
+    adv_env.hub_conidx = ADV_NO_CONIDX;
+}
+
+void Adv_Start(void)
+{
+    adv_env.started = true;
+    Adv_Request(ADV_PHASE_FAST);
+
+    ke_timer_set(APP_LED_TIMEOUT, TASK_APP, TIMER_SETTING_S(2));    /* Start LED blinking */
+}
+
+void Adv_Kick(void)
+{
+    if ((adv_env.hub_valid && (adv_env.hub_conidx != ADV_NO_CONIDX)) ||
+        (adv_env.target == ADV_PHASE_DIRECTED) || (adv_env.target == ADV_PHASE_FAST))
+    {
+        return;
+    }
+
+    Adv_Request(ADV_PHASE_FAST);
+}
+
+void Adv_RefreshData(void)
+{
+    // Directed advertising carries no data; an activity still to be
+    // created takes the new data then
+    if ((adv_env.phase == ADV_PHASE_DIRECTED) ||
+        (adv_env.activity == ADV_ACTIVITY_NONE) ||
+        (adv_env.activity == ADV_ACTIVITY_DELETING))
+    {
+        return;
+    }
+
+    // The data of an activity being created may already be set
+    if (adv_env.activity == ADV_ACTIVITY_CREATING)
+    {
+        adv_env.data_stale = true;
+        return;
+    }
+
+    adv_env.data_stale = false;
+    GAPM_SetAdvDataCmd(GAPM_SET_ADV_DATA, adv_activity_status.actv_idx,
+                       app_adv_data_len, app_adv_data);
+}
+
+uint32_t Adv_GetLedPeriod(void)
+{
+    return adv_phase_cfg[adv_env.phase].led_period_ms;
+}
+
+bool Adv_MatchHub(uint8_t conidx, const uint8_t *addr, uint8_t addr_type)
+{
+    if (conidx >= APP_MAX_NB_CON)
+    {
+        return false;
+    }
+
+    memcpy(adv_env.peer[conidx].addr, addr, GAP_BD_ADDR_LEN);
+    adv_env.peer[conidx].addr_type = addr_type;
+    adv_env.cached_links &= ~(1U << conidx);
+
+    if (!adv_env.hub_valid || (addr_type != adv_env.hub.addr_type) ||
+        memcmp(addr, adv_env.hub.addr, GAP_BD_ADDR_LEN))
+    {
+        return false;
+    }
+
+    adv_env.cached_links |= (1U << conidx);
+    return true;
+}
+
+const BondInfo_t * Adv_GetBondInfo(uint8_t conidx)
+{
+    if (GAPC_IsBonded(conidx))
+    {
+        return GAPC_GetBondInfo(conidx);
+    }
+
+    if ((conidx < APP_MAX_NB_CON) && (adv_env.cached_links & (1U << conidx)))
+    {
+        return adv_env.hub_bond;
+    }
+
+    return NULL;
+}
+
+void Adv_ForgetHub(void)
+{
+    adv_env.hub_valid = false;
+    adv_env.hub_bond = NULL;
+    adv_env.hub_conidx = ADV_NO_CONIDX;
+    adv_env.cached_links = 0;
+}
+
+void Adv_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                    ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    // The scan and relay activities (app_group.c, app_relay.c) complete the
+    // same operations
+    if (((dest_id == GROUP_TASK) || (dest_id == RELAY_TASK)) &&
+        ((msg_id == GAPM_CMP_EVT) || (msg_id == GAPM_ACTIVITY_CREATED_IND) ||
+         (msg_id == GAPM_ACTIVITY_STOPPED_IND)))
+    {
+        return;
+    }
+
+    switch (msg_id)
+    {
+        case GAPM_ACTIVITY_CREATED_IND:
+        {
+            if (adv_env.phase == ADV_PHASE_DIRECTED)
+            {
+                // Directed advertising carries no data
+                Adv_Run();
+                break;
+            }
+
+            /* Request the stack to set the advertising and scan response data.
+             * The stack sends back a GAPM_CMP_EVT: operation = GAPM_SET_ADV_DATA. */
+#if ADV_EXTENSION == 0
+            GAPM_SetAdvDataCmd(GAPM_SET_SCAN_RSP_DATA, adv_activity_status.actv_idx,
+                               app_scan_rsp_data_len, app_scan_rsp_data);
+#endif /* if ADV_EXTENSION == 0 */
+            GAPM_SetAdvDataCmd(GAPM_SET_ADV_DATA, adv_activity_status.actv_idx,
+                               app_adv_data_len, app_adv_data);
+        }
+        break;
+
+        case GAPM_CMP_EVT:
+        {
+            const struct gapm_cmp_evt *p = param;
+
+            switch (p->operation)
+            {
+                case GAPM_SET_ADV_DATA:
+                {
+                    // Data refreshed while advertising needs no start
+                    if (adv_env.activity == ADV_ACTIVITY_CREATING)
+                    {
+                        Adv_Run();
+                    }
+                }
+                break;
+
+                case GAPM_START_ACTIVITY:
+                {
+                    adv_env.activity = (p->status == GAP_ERR_NO_ERROR) ?
+                                       ADV_ACTIVITY_STARTED : ADV_ACTIVITY_STOPPED;
+                    if (p->status == GAP_ERR_NO_ERROR)
+                    {
+                        // Radio share of the phase estimate, the floor is SLEEP
+                        Energy_SetCurrent(ENERGY_ADV, adv_phase_cfg[adv_env.phase].current_ua -
+                                                      ADV_SLEEP_CURRENT_UA);
+                        Boot_Mark(BOOT_PHASE_ADV);
+                    }
+                    if (adv_env.data_stale)
+                    {
+                        Adv_RefreshData();
+                    }
+                    Adv_Step();
+                }
+                break;
+
+                case GAPM_STOP_ACTIVITY:
+                {
+                    // Failed if the activity stopped on its own first
+                    if ((p->status != GAP_ERR_NO_ERROR) &&
+                        (adv_env.activity == ADV_ACTIVITY_STOPPING))
+                    {
+                        adv_env.activity = ADV_ACTIVITY_STOPPED;
+                        Adv_Step();
+                    }
+                }
+                break;
+
+                case GAPM_DELETE_ACTIVITY:
+                {
+                    adv_env.activity = ADV_ACTIVITY_NONE;
+                    Adv_Step();
+                }
+                break;
+
+                case GAPM_CREATE_ADV_ACTIVITY:
+                {
+                    if (p->status != GAP_ERR_NO_ERROR)
+                    {
+                        APP_LOG_WARN("__ADV create failed: %d\r\n", p->status);
+                        adv_env.activity = ADV_ACTIVITY_NONE;
+                    }
+                }
+                break;
+            }
+        }
+        break;
+
+        case GAPM_ACTIVITY_STOPPED_IND:
+        {
+            const struct gapm_activity_stopped_ind *p = param;
+            bool requested = (adv_env.activity == ADV_ACTIVITY_STOPPING);
+
+            adv_env.activity = ADV_ACTIVITY_STOPPED;
+            Energy_SetCurrent(ENERGY_ADV, 0);
+
+            if (requested)
+            {
+                Adv_Step();
+            }
+            else if (p->reason == GAP_ERR_NO_ERROR)
+            {
+                // A central connected, keep accepting others slowly
+                Adv_Request(ADV_PHASE_SLOW);
+            }
+            else
+            {
+                // Phase duration elapsed
+                Adv_Request(adv_phase_cfg[adv_env.phase].next);
+            }
+        }
+        break;
+
+        case GAPC_BOND_IND:
+        {
+            const struct gapc_bond_ind *p = param;
+
+            if (p->info == GAPC_PAIRING_SUCCEED)
+            {
+                Adv_CacheHub(KE_IDX_GET(src_id));
+            }
+        }
+        break;
+
+        case GAPC_ENCRYPT_IND:
+        {
+            Adv_CacheHub(KE_IDX_GET(src_id));
+        }
+        break;
+
+        case GAPC_DISCONNECT_IND:
+        {
+            uint8_t conidx = KE_IDX_GET(src_id);
+
+            if (conidx < APP_MAX_NB_CON)
+            {
+                adv_env.cached_links &= ~(1U << conidx);
+            }
+
+            if (adv_env.hub_valid && (conidx == adv_env.hub_conidx))
+            {
+                adv_env.hub_conidx = ADV_NO_CONIDX;
+                Adv_Request(Adv_ReconnectPhase());
+            }
+            else
+            {
+                // A connection freed up
+                Adv_Step();
+            }
+        }
+        break;
+    }
+}
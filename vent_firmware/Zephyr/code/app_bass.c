@@ -15,6 +15,7 @@
  * @endparblock
  */
 
+#include <string.h>
 #include <app.h>
 #include <app_bass.h>
 #include <hw.h>
@@ -32,11 +33,135 @@ static struct F_LSAD_TRIM g_f_lsad_gain_offset[LSAD_CHANNEL_NUM];
 /* Default trim value sector. */
 static TRIM_Type *trims = TRIM;
 
+/* ----------------------------------------------------------------------------
+ * Function      : uint32_t APP_BASS_CodeToMilliVolts(uint32_t code)
+ * ----------------------------------------------------------------------------
+ * Description   : Convert an averaged VBAT channel code to the battery
+ *                 voltage, with the trim gain and offset when available
+ * Inputs        : - code           - LSAD code of the VBAT channel
+ * Outputs       : Battery voltage in mV
+ * Assumptions   : None
+ * ------------------------------------------------------------------------- */
+
+static uint32_t APP_BASS_CodeToMilliVolts(uint32_t code)
+{
+    struct F_LSAD_TRIM *gain_offset = &g_f_lsad_gain_offset[LSAD_VBAT_CHANNEL];
+    float lsad_result;
+
+    /* Calculating voltage using gain and offset and multiplying by 2 since
+     * VBAT is divided by 2 when measured by the LSAD. */
+    if (gain_offset->hf_gain != 0)
+    {
+        /* Computing LSAD result using the LSAD full scale of 2.0V and LSAD resolution
+         * of 14 bits */
+        lsad_result = CONVERT(code) / V_TO_MV_F;
+
+        /* Applying offset and gain compensation to calculated voltage value */
+        return (uint32_t)(((lsad_result - gain_offset->hf_offset) /
+                           gain_offset->hf_gain * V_TO_MV) * LSAD_VBAT_FACTOR);
+    }
+
+    /* Calculating voltage using only reference voltage and LSAD data if gain is 0 */
+    return ((LSAD_VOLTAGE_RANGE_MV * LSAD_VBAT_FACTOR * code) / (LSAD_MAX_SIZE));
+}
+
+/* ----------------------------------------------------------------------------
+ * Function      : void APP_BASS_LsadStart(void)
+ * ----------------------------------------------------------------------------
+ * Description   : Start the LSAD for one more user (battery burst, servo
+ *                 move capture); it keeps running until every user stopped
+ * Inputs        : None
+ * Outputs       : None
+ * Assumptions   : Called from the application task. The first conversion
+ *                 of a channel is ready LSAD_READ_INTERVAL_MS after the start
+ * ------------------------------------------------------------------------- */
+
+void APP_BASS_LsadStart(void)
+{
+    if (app_batt_read.lsad_users++ > 0)
+    {
+        return;
+    }
+
+    Energy_Begin(ENERGY_LSAD);
+
+#if RSL15_CID == 202
+    LSAD->CFG = LSAD_NORMAL               /* Normal mode, all 8 channels sampled */
+                | LSAD_PRESCALE_1280H;    /* Sample rate is SLOWCLK/1280 */
+#else  /* if RSL15_CID == 202 */
+    LSAD->CFG = VBAT_DIV2_ENABLE          /* Enable VBAT voltage divider */
+                | LSAD_NORMAL             /* Normal mode, all 8 channels sampled */
+                | LSAD_PRESCALE_1280H;    /* Sample rate is SLOWCLK/1280 */
+#endif /* if RSL15_CID == 202 */
+}
+
+/* ----------------------------------------------------------------------------
+ * Function      : void APP_BASS_LsadStop(void)
+ * ----------------------------------------------------------------------------
+ * Description   : Release the LSAD, disabled once the last user stopped
+ * Inputs        : None
+ * Outputs       : None
+ * Assumptions   : Paired with APP_BASS_LsadStart
+ * ------------------------------------------------------------------------- */
+
+void APP_BASS_LsadStop(void)
+{
+    if ((app_batt_read.lsad_users > 0) && (--app_batt_read.lsad_users == 0))
+    {
+        LSAD->CFG = LSAD_DISABLE;
+        Energy_End(ENERGY_LSAD);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Function      : uint32_t APP_BASS_SampleBattVoltage(void)
+ * ----------------------------------------------------------------------------
+ * Description   : Returns the battery voltage of the last conversion of the
+ *                 VBAT channel
+ * Inputs        : None
+ * Outputs       : Battery voltage in mV
+ * Assumptions   : The LSAD is running (APP_BASS_LsadStart)
+ * ------------------------------------------------------------------------- */
+
+uint32_t APP_BASS_SampleBattVoltage(void)
+{
+    return APP_BASS_CodeToMilliVolts(LSAD->DATA_TRIM_CH[LSAD_VBAT_CHANNEL]);
+}
+
+/* ----------------------------------------------------------------------------
+ * Function      : void APP_BASS_RequestBattLevel(void)
+ * ----------------------------------------------------------------------------
+ * Description   : Start a burst of LSAD_READS_NUM battery readings, unless
+ *                 one is running. The LSAD is started and the first reading
+ *                 taken once every channel has been converted.
+ * Inputs        : None
+ * Outputs       : None
+ * Assumptions   : Called from the application task
+ * ------------------------------------------------------------------------- */
+
+void APP_BASS_RequestBattLevel(void)
+{
+    if (app_batt_read.busy)
+    {
+        return;
+    }
+
+    app_batt_read.busy = true;
+    app_batt_read.lsad_sum_code = 0;
+    app_batt_read.read_cnt = 0;
+    app_batt_read.activity = BATTERY_ACTIVITY_IDLE;
+
+    APP_BASS_LsadStart();
+    ke_timer_set(APP_BATT_LEVEL_READ_TIMEOUT, TASK_APP, TIMER_SETTING_MS(LSAD_READ_INTERVAL_MS));
+}
+
 /* ----------------------------------------------------------------------------
  * Function      : void APP_BASS_ReadBattLevel(uint8_t bas_nb)
  * ----------------------------------------------------------------------------
- * Description   : Calculate the current battery level by mapping the measured
- *                 voltage from [MIN_VOLTAGE_MV, MAX_VOLTAGE_MV] to [0, 100]
+ * Description   : Returns the battery level estimated from the bursts (see
+ *                 app_battery.h). A new burst is started when the last one
+ *                 is older than BATT_MAX_AGE_S (or there is none yet); its
+ *                 result is returned by the following calls.
  * Inputs        : uint8_t bas_nb   - Battery instance. Note that the
  *                                    ble_peripheral_server sample code is
  *                                    only designed to work with one battery
@@ -51,47 +176,13 @@ static TRIM_Type *trims = TRIM;
 
 uint8_t APP_BASS_ReadBattLevel(uint8_t bas_nb)
 {
-    uint8_t batt_lvl_percent;
-    uint32_t batt_lvl_mV;
-
-    if (app_batt_read.read_cnt == LSAD_READS_NUM)
-    {
-        /* Average reads */
-        batt_lvl_mV = (uint32_t)(app_batt_read.lsad_sum_mV / LSAD_READS_NUM);
-
-        /* If batt_lvl_mV is less than MIN_VOLTAGE_MV then set bat_lvl_percent to 0, since
-         * the value would overflow otherwise */
-        if (batt_lvl_mV < MIN_VOLTAGE_MV)
-        {
-            batt_lvl_percent = 0;
-        }
-        else
-        {
-            /* Calculating bat_lvl_percent using average voltage measured. The
-             * voltage is scaled from [MIN_VOLTAGE_MV, MAX_VOLTAGE_MV] to [0, 100] */
-            batt_lvl_percent = (uint8_t)(((batt_lvl_mV - MIN_VOLTAGE_MV) * 100) /
-                                         (MAX_VOLTAGE_MV - MIN_VOLTAGE_MV));
-
-            /* If measured voltage is less than MIN_VOLTAGE_MV set bat_lvl_percent to 100 */
-            batt_lvl_percent = (batt_lvl_percent <= 100) ? batt_lvl_percent : 100;
-        }
-
-        app_batt_read.prev_batt_lvl_percent = batt_lvl_percent;
-
-        /* Set to 0 before next set of LSAD readings are taken in BattLevelReadHandler */
-        app_batt_read.lsad_sum_mV = 0;
-
-        /* Set to 0 to begin next set of LSAD readings in BattLevelReadHandler */
-        app_batt_read.read_cnt = 0;
-    }
-    else
+    if (!app_batt_read.valid ||
+        ((AppTimer_Now() - app_batt_read.read_time) > APP_TIMER_S(BATT_MAX_AGE_S)))
     {
-        /* Return the last battery level calculated if a set of LSAD readings has not been
-         * completed since the last time the function was called */
-        batt_lvl_percent = app_batt_read.prev_batt_lvl_percent;
+        APP_BASS_RequestBattLevel();
     }
 
-    return batt_lvl_percent;
+    return Battery_GetState()->percent;
 }
 
 /* ----------------------------------------------------------------------------
@@ -100,7 +191,12 @@ uint8_t APP_BASS_ReadBattLevel(uint8_t bas_nb)
  *                                           ke_task_id_t const dest_id,
  *                                           ke_task_id_t const src_id)
  * ----------------------------------------------------------------------------
- * Description   : Handles APP_BATT_LEVEL_READ_TIMEOUT event
+ * Description   : Handles APP_BATT_LEVEL_READ_TIMEOUT event: add one reading
+ *                 to the burst, or once LSAD_READS_NUM are summed, release
+ *                 the LSAD and hand their average to the battery estimator.
+ *                 Readings taken while the servo moves are left out (the
+ *                 burst takes one more), the burst is tagged with the
+ *                 busiest activity seen.
  * Inputs        : - msg_id     - Kernel message ID number
  *                 - param      - Message parameter
  *                 - dest_id    - Destination task ID number
@@ -114,41 +210,84 @@ void BattLevelReadHandler(ke_msg_id_t const msg_id,
                           ke_task_id_t const dest_id,
                           ke_task_id_t const src_id)
 {
-    struct F_LSAD_TRIM *gain_offset = &g_f_lsad_gain_offset[LSAD_VBAT_CHANNEL];
-    float lsad_result = 0.0f;
-    uint32_t voltage;
+    uint8_t activity = Battery_Activity();
+    uint32_t batt_lvl_mV;
 
-    /* Set timer to call BattLevelReadHandler to take another LSAD reading if needed */
-    ke_timer_set(APP_BATT_LEVEL_READ_TIMEOUT,
-                 TASK_APP,
-                 TIMER_SETTING_MS(LSAD_READ_INTERVAL_MS));
+    if (!app_batt_read.busy)
+    {
+        return;
+    }
 
-    if (app_batt_read.read_cnt < LSAD_READS_NUM)
+    if (activity > app_batt_read.activity)
     {
-        /* Calculating voltage using gain and offset and multiplying by 2 since
-         * VBAT is divided by 2 when measured by the LSAD. */
-        if (gain_offset->hf_gain != 0)
-        {
-            /* Computing LSAD result using the LSAD full scale of 2.0V and LSAD resolution
-             * of 14 bits */
-            lsad_result = CONVERT(LSAD->DATA_TRIM_CH[LSAD_VBAT_CHANNEL]) / V_TO_MV_F;
-
-            /* Applying offset and gain compensation to calculated voltage value */
-            voltage = (uint32_t)(((lsad_result - gain_offset->hf_offset) /
-                                  gain_offset->hf_gain * V_TO_MV) * LSAD_VBAT_FACTOR);
-        }
-
-        /* Calculating voltage using only reference voltage and LSAD data if gain is 0 */
-        else
-        {
-            voltage = ((LSAD_VOLTAGE_RANGE_MV * LSAD_VBAT_FACTOR *
-                        LSAD->DATA_TRIM_CH[LSAD_VBAT_CHANNEL]) / (LSAD_MAX_SIZE));
-        }
-
-        app_batt_read.lsad_sum_mV += voltage;
+        app_batt_read.activity = activity;
+    }
 
+    /* Raw codes are summed, the trim conversion is applied once to the mean */
+    if (activity != BATTERY_ACTIVITY_SERVO)
+    {
+        app_batt_read.lsad_sum_code += LSAD->DATA_TRIM_CH[LSAD_VBAT_CHANNEL];
         app_batt_read.read_cnt++;
     }
+
+    if (app_batt_read.read_cnt < LSAD_READS_NUM)
+    {
+        /* Set timer to take the next reading once the channel is converted again */
+        ke_timer_set(APP_BATT_LEVEL_READ_TIMEOUT,
+                     TASK_APP,
+                     TIMER_SETTING_MS(LSAD_READ_INTERVAL_MS));
+        return;
+    }
+
+    /* Burst complete, the LSAD is not needed until the next one */
+    APP_BASS_LsadStop();
+
+    /* Average reads, rounded */
+    batt_lvl_mV = APP_BASS_CodeToMilliVolts((app_batt_read.lsad_sum_code + (LSAD_READS_NUM / 2)) /
+                                            LSAD_READS_NUM);
+
+    app_batt_read.batt_lvl_mV = batt_lvl_mV;
+    app_batt_read.read_time = AppTimer_Now();
+    app_batt_read.valid = true;
+    app_batt_read.busy = false;
+
+    Battery_Update(batt_lvl_mV, app_batt_read.activity);
+}
+
+/* ----------------------------------------------------------------------------
+ * Function      : bool APP_BASS_IsReading(void)
+ * ----------------------------------------------------------------------------
+ * Description   : Returns true while the LSAD is running for a battery burst
+ *                 or a servo move capture (it must keep sampling)
+ * Inputs        : None
+ * Outputs       : true if the LSAD has a user
+ * Assumptions   : None
+ * ------------------------------------------------------------------------- */
+
+bool APP_BASS_IsReading(void)
+{
+    return (app_batt_read.lsad_users > 0);
+}
+
+/* ----------------------------------------------------------------------------
+ * Function      : uint32_t APP_BASS_GetBattVoltage(uint64_t *read_time)
+ * ----------------------------------------------------------------------------
+ * Description   : Returns the battery voltage of the last burst and when it
+ *                 was measured, without starting a burst
+ * Inputs        : - read_time      - set to the AppTimer_Now value at the
+ *                                    end of the burst, if not NULL
+ * Outputs       : Battery voltage in mV, 0 if no burst has completed
+ * Assumptions   : None
+ * ------------------------------------------------------------------------- */
+
+uint32_t APP_BASS_GetBattVoltage(uint64_t *read_time)
+{
+    if (read_time != NULL)
+    {
+        *read_time = app_batt_read.read_time;
+    }
+
+    return app_batt_read.batt_lvl_mV;
 }
 
 /* ----------------------------------------------------------------------------
@@ -169,9 +308,7 @@ void APP_BASS_ReadBattLevelInit(uint32_t trim_error)
         Sys_LSAD_Gain_Offset(&(trims->lsad_trim), &g_f_lsad_gain_offset[LSAD_VBAT_CHANNEL]);
     }
 
-    app_batt_read.lsad_sum_mV = 0;
-    app_batt_read.prev_batt_lvl_percent = 0;
-    app_batt_read.read_cnt = 0;
+    memset(&app_batt_read, 0, sizeof(app_batt_read));
 }
 
 /* ----------------------------------------------------------------------------
@@ -187,7 +324,22 @@ void APP_BASS_ReadBattLevelInit(uint32_t trim_error)
 void LSAD_ChannelInit(uint32_t trim_error)
 {
     APP_BASS_ReadBattLevelInit(trim_error);
+    LSAD_ChannelConfig();
+}
+
+/* ----------------------------------------------------------------------------
+ * Function      : void LSAD_ChannelConfig(void)
+ * ----------------------------------------------------------------------------
+ * Description   : Configures the LSAD input channels and leaves the LSAD
+ *                 disabled, keeping the battery readings (wakeup from
+ *                 sleep). The LSAD only runs during a battery burst.
+ * Inputs        : None
+ * Outputs       : None
+ * Assumptions   : None
+ * --------------------------------------------------------------------------- */
 
+void LSAD_ChannelConfig(void)
+{
     /* Disable the LSAD and connect all inputs to default values */
     LSAD->CFG = LSAD_DISABLE;
 
@@ -214,13 +366,4 @@ void LSAD_ChannelInit(uint32_t trim_error)
                          LSAD_POS_INPUT_VBAT | LSAD_NEG_INPUT_VBAT,
                          -1, -1);
 #endif /* if RSL15_CID == 202 */
-
-#if RSL15_CID == 202
-    LSAD->CFG = LSAD_NORMAL               /* Normal mode, all 8 channels sampled */
-                | LSAD_PRESCALE_1280H;    /* Sample rate is SLOWCLK/1280 */
-#else  /* if RSL15_CID == 202 */
-    LSAD->CFG = VBAT_DIV2_ENABLE          /* Enable VBAT voltage divider */
-                | LSAD_NORMAL             /* Normal mode, all 8 channels sampled */
-                | LSAD_PRESCALE_1280H;    /* Sample rate is SLOWCLK/1280 */
-#endif /* if RSL15_CID == 202 */
 }
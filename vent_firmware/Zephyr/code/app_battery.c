@@ -0,0 +1,279 @@
+/******************************************************************************
+ * File Name        : app_battery.c
+ * Description      : This module implements the battery state estimator
+ *                    (see app_battery.h).
+ *
+ *                    The filters are exponential with power of two weights,
+ *                    all in integer millivolts: a burst moves the rest
+ *                    voltage by 1/2 of the difference when idle and by 1/8
+ *                    under load, a move moves the drop by 1/4. The charge
+ *                    of a move comes from the measured move duration.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_battery.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+struct battery_curve_point_t
+{
+    uint16_t mV;
+    uint8_t percent;
+};
+
+static const struct battery_curve_point_t battery_curve[] = BATT_CURVE;
+
+#define BATTERY_CURVE_POINTS            (sizeof(battery_curve) / sizeof(battery_curve[0]))
+
+struct battery_env_tag
+{
+    struct battery_state_t state;
+    struct app_timer_t move_timer;      // VBAT sampling during a move
+    uint64_t move_start;                // AppTimer_Now at the move start
+    uint32_t move_us;                   // filtered move duration
+    uint16_t move_min_mV;               // lowest voltage of the current move
+};
+
+static struct battery_env_tag battery_env;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Battery_CurvePercent
+ *
+ * Description   : Returns the charge left at a rest voltage, interpolated on
+ *                 the discharge curve.
+ *
+ * Parameters    : uint32_t mV : rest voltage
+ *
+ * Returns       : uint8_t : charge left (%)
+ */
+static uint8_t Battery_CurvePercent(uint32_t mV)
+{
+    if (mV >= battery_curve[0].mV)
+    {
+        return battery_curve[0].percent;
+    }
+
+    for (uint8_t i = 1; i < BATTERY_CURVE_POINTS; i++)
+    {
+        const struct battery_curve_point_t *hi = &battery_curve[i - 1];
+        const struct battery_curve_point_t *lo = &battery_curve[i];
+
+        if (mV >= lo->mV)
+        {
+            return (uint8_t)(lo->percent + ((mV - lo->mV) * (hi->percent - lo->percent)) /
+                                           (hi->mV - lo->mV));
+        }
+    }
+
+    return battery_curve[BATTERY_CURVE_POINTS - 1].percent;
+}
+
+/* Function      : Battery_Estimate
+ *
+ * Description   : Update the moves remaining from the percentage, the drop
+ *                 and the move duration.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Battery_Estimate(void)
+{
+    struct battery_state_t *state = &battery_env.state;
+    uint8_t floor = Battery_CurvePercent(BATT_MOVE_CUTOFF_MV + state->sag_mV);
+    uint32_t move_us = (battery_env.move_us != 0) ? battery_env.move_us :
+                                                    APP_TIMER_MS(SERVO_TRAVEL_MS);
+    uint64_t usable_uAs;
+
+    if (state->percent <= floor)
+    {
+        state->moves_left = 0;
+        return;
+    }
+
+    // Charge above the floor over the charge of one move, both in mA.us
+    usable_uAs = ((uint64_t)(state->percent - floor) * BATT_CAPACITY_MAH * 3600000000ULL) / 100;
+    state->moves_left = (uint32_t)(usable_uAs / ((uint64_t)BATT_SERVO_CURRENT_MA * move_us));
+}
+
+/* Function      : Battery_MoveSample
+ *
+ * Description   : Move timer callback. Keep the lowest VBAT conversion.
+ *
+ * Parameters    : void *context : Unused
+ *
+ * Returns       : None
+ */
+static void Battery_MoveSample(void *context)
+{
+    uint32_t mV = APP_BASS_SampleBattVoltage();
+
+    if ((battery_env.move_min_mV == 0) || (mV < battery_env.move_min_mV))
+    {
+        battery_env.move_min_mV = (uint16_t)mV;
+    }
+}
+
+void Battery_Initialize(void)
+{
+    memset(&battery_env, 0, sizeof(battery_env));
+    battery_env.state.sag_mV = BATT_SAG_DEFAULT_MV;
+}
+
+uint8_t Battery_Activity(void)
+{
+    if (servo_is_busy())
+    {
+        return BATTERY_ACTIVITY_SERVO;
+    }
+
+    for (unsigned int i = 0; i < BLE_CONNECTION_MAX; i++)
+    {
+        if (GAPC_IsConnectionActive(i))
+        {
+            return BATTERY_ACTIVITY_RADIO;
+        }
+    }
+
+    return BATTERY_ACTIVITY_IDLE;
+}
+
+void Battery_Update(uint32_t mV, uint8_t activity)
+{
+    struct battery_state_t *state = &battery_env.state;
+    uint8_t percent;
+
+    state->activity = activity;
+
+    // The readings of a move are already left out, the ones around it are
+    // taken while the cells recover and no fixed sag corrects them
+    if (activity == BATTERY_ACTIVITY_SERVO)
+    {
+        APP_LOG_INFO("__BATTERY burst %lu mV during a move, not used\r\n", mV);
+        return;
+    }
+
+    if (activity == BATTERY_ACTIVITY_RADIO)
+    {
+        mV += BATT_RADIO_SAG_MV;
+    }
+
+    percent = Battery_CurvePercent(mV);
+
+    if ((state->rest_mV == 0) ||
+        ((activity == BATTERY_ACTIVITY_IDLE) && (percent >= state->percent + BATT_REPLACED_PERCENT)))
+    {
+        // First burst, or new batteries: start over
+        if (state->rest_mV != 0)
+        {
+            APP_LOG_INFO("__BATTERY changed, %u %% after %lu moves\r\n",
+                         percent, state->moves);
+        }
+        state->rest_mV = (uint16_t)mV;
+        state->percent = percent;
+        state->moves = 0;
+        state->sag_mV = BATT_SAG_DEFAULT_MV;
+    }
+    else
+    {
+        int32_t delta = (int32_t)mV - (int32_t)state->rest_mV;
+
+        state->rest_mV += (activity == BATTERY_ACTIVITY_IDLE) ? (delta / 2) : (delta / 8);
+
+        // Recovery after a load must not look like charge coming back
+        percent = Battery_CurvePercent(state->rest_mV);
+        if (percent < state->percent)
+        {
+            state->percent = percent;
+        }
+    }
+
+    Battery_Estimate();
+
+    APP_LOG_INFO("__BATTERY burst %lu mV (activity %u): rest %u mV, %u %%, sag %u mV, "
+                 "%lu moves left\r\n", mV, activity, state->rest_mV, state->percent,
+                 state->sag_mV, state->moves_left);
+}
+
+void Battery_MoveStarted(void)
+{
+    battery_env.move_start = AppTimer_Now();
+    battery_env.move_min_mV = 0;
+
+    // The first conversion is ready one LSAD round after the start
+    APP_BASS_LsadStart();
+    if (!AppTimer_Start(&battery_env.move_timer, APP_TIMER_MS(LSAD_READ_INTERVAL_MS),
+                        APP_TIMER_MS(LSAD_READ_INTERVAL_MS), Battery_MoveSample, NULL))
+    {
+        // Counted without a sag sample, as a short move is; the LSAD is
+        // still released by Battery_MoveEnded
+        APP_LOG_ERROR("__BATTERY no timer, move not sampled\r\n");
+    }
+}
+
+void Battery_MoveEnded(void)
+{
+    struct battery_state_t *state = &battery_env.state;
+    uint32_t move_us = (uint32_t)(AppTimer_Now() - battery_env.move_start);
+
+    AppTimer_Cancel(&battery_env.move_timer);
+    APP_BASS_LsadStop();
+
+    state->moves++;
+    battery_env.move_us = (battery_env.move_us == 0) ? move_us :
+                          (battery_env.move_us - (battery_env.move_us / 4) + (move_us / 4));
+
+    // Moves shorter than one LSAD round have no sample
+    if ((battery_env.move_min_mV != 0) && (state->rest_mV != 0))
+    {
+        uint16_t sag = (battery_env.move_min_mV < state->rest_mV) ?
+                       (state->rest_mV - battery_env.move_min_mV) : 0;
+
+        state->move_min_mV = battery_env.move_min_mV;
+        state->sag_mV = (uint16_t)(state->sag_mV + ((int32_t)sag - (int32_t)state->sag_mV) / 4);
+        APP_LOG_DEBUG("__BATTERY move min %u mV, sag %u mV\r\n",
+                      state->move_min_mV, state->sag_mV);
+    }
+
+    Battery_Estimate();
+}
+
+const struct battery_state_t *Battery_GetState(void)
+{
+    return &battery_env.state;
+}
+
+void Battery_PackHealth(uint8_t *buf)
+{
+    const struct battery_state_t *state = &battery_env.state;
+
+    buf[0] = (uint8_t)(state->rest_mV & 0xFF);
+    buf[1] = (uint8_t)(state->rest_mV >> 8);
+    buf[2] = (uint8_t)(state->sag_mV & 0xFF);
+    buf[3] = (uint8_t)(state->sag_mV >> 8);
+    buf[4] = (uint8_t)(state->move_min_mV & 0xFF);
+    buf[5] = (uint8_t)(state->move_min_mV >> 8);
+    buf[6] = state->percent;
+    buf[7] = state->activity;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        buf[8 + i] = (uint8_t)(state->moves >> (8 * i));
+        buf[12 + i] = (uint8_t)(state->moves_left >> (8 * i));
+    }
+}
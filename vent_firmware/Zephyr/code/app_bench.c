@@ -0,0 +1,420 @@
+/******************************************************************************
+ * File Name        : app_bench.c
+ * Description      : This module implements the BLE benchmark (see
+ *                    app_bench.h). Throughput notifications bypass the
+ *                    notification queue, which coalesces values of the same
+ *                    attribute, and are sent straight to the stack with up
+ *                    to BENCH_MAX_IN_FLIGHT outstanding so every connection
+ *                    event can be filled. Intervals are timed with
+ *                    AppTimer_Now, which keeps counting through sleep and
+ *                    clock changes.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <ble_abstraction.h>
+#include <app.h>
+#include <app_bench.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+struct bench_env_t
+{
+    uint8_t state;
+    uint8_t conidx;
+    uint16_t payload;
+    uint16_t mtu;
+    uint16_t next_seq;
+    uint8_t in_flight;
+    uint32_t sent;              // notifications handed to the stack
+    uint64_t start_us;          // first send (AppTimer_Now)
+    uint64_t last_us;           // last completion
+
+    uint32_t packets;
+    uint32_t bytes;
+    uint32_t elapsed_ms;
+    uint32_t failed;
+    uint32_t pings;
+    uint32_t ping_max_us;
+};
+
+static struct bench_env_t bench_env;
+
+static uint8_t bench_payload[BENCH_PAYLOAD_MAX];
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Bench_PutU16
+ *
+ * Description   : Store a 16-bit value little endian.
+ *
+ * Parameters    : uint8_t *buf   : destination
+ *                 uint16_t value : value
+ *
+ * Returns       : None
+ */
+static void Bench_PutU16(uint8_t *buf, uint16_t value)
+{
+    buf[0] = (uint8_t)(value & 0xFF);
+    buf[1] = (uint8_t)(value >> 8);
+}
+
+/* Function      : Bench_PutU32
+ *
+ * Description   : Store a 32-bit value little endian.
+ *
+ * Parameters    : uint8_t *buf   : destination
+ *                 uint32_t value : value
+ *
+ * Returns       : None
+ */
+static void Bench_PutU32(uint8_t *buf, uint32_t value)
+{
+    Bench_PutU16(buf, (uint16_t)(value & 0xFFFF));
+    Bench_PutU16(&buf[2], (uint16_t)(value >> 16));
+}
+
+/* Function      : Bench_NextSeq
+ *
+ * Description   : Returns the next GATTC sequence number of the benchmark.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint16_t : sequence number
+ */
+static uint16_t Bench_NextSeq(void)
+{
+    return BENCH_SEQ_FLAG | (bench_env.next_seq++ & ~BENCH_SEQ_MASK);
+}
+
+/* Function      : Bench_Fill
+ *
+ * Description   : Hand throughput notifications to the stack until
+ *                 BENCH_MAX_IN_FLIGHT are outstanding.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Bench_Fill(void)
+{
+    uint16_t handle = GATTM_GetHandle(CUST_SVC0, CS_BENCH_DATA_VALUE_VAL0);
+
+    while ((bench_env.state == BENCH_STATE_THROUGHPUT) &&
+           (bench_env.in_flight < BENCH_MAX_IN_FLIGHT))
+    {
+        Bench_PutU32(bench_payload, bench_env.sent);
+        GATTC_SendEvtCmd(bench_env.conidx, GATTC_NOTIFY, Bench_NextSeq(), handle,
+                         bench_env.payload, bench_payload);
+        bench_env.sent++;
+        bench_env.in_flight++;
+    }
+}
+
+/* Function      : Bench_Finish
+ *
+ * Description   : Close the throughput test once the last notification has
+ *                 completed.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Bench_Finish(void)
+{
+    if ((bench_env.state != BENCH_STATE_DRAINING) || (bench_env.in_flight != 0))
+    {
+        return;
+    }
+
+    bench_env.elapsed_ms = (uint32_t)((bench_env.last_us - bench_env.start_us) / 1000);
+    bench_env.state = BENCH_STATE_IDLE;
+
+    APP_LOG_INFO("__BENCH conidx=%d: %lu notifications, %lu bytes in %lu ms, %lu failed\r\n",
+                 bench_env.conidx, bench_env.packets, bench_env.bytes,
+                 bench_env.elapsed_ms, bench_env.failed);
+}
+
+/* Function      : Bench_Stop
+ *
+ * Description   : Stop sending, the test finishes when the outstanding
+ *                 notifications complete.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Bench_Stop(void)
+{
+    if (bench_env.state == BENCH_STATE_THROUGHPUT)
+    {
+        ke_timer_clear(BENCH_TIMEOUT, TASK_APP);
+        bench_env.state = BENCH_STATE_DRAINING;
+        Bench_Finish();
+    }
+}
+
+/* Function      : Bench_Reset
+ *
+ * Description   : Clear the counters.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Bench_Reset(void)
+{
+    bench_env.sent = 0;
+    bench_env.packets = 0;
+    bench_env.bytes = 0;
+    bench_env.elapsed_ms = 0;
+    bench_env.failed = 0;
+    bench_env.pings = 0;
+    bench_env.ping_max_us = 0;
+}
+
+/* Function      : Bench_StartThroughput
+ *
+ * Description   : Start a throughput test on a connection.
+ *
+ * Parameters    : uint8_t conidx     : connection index
+ *                 uint8_t duration_s : test duration (s)
+ *                 uint8_t payload    : payload bytes, 0 for the largest the
+ *                                      ATT MTU allows
+ *
+ * Returns       : None
+ */
+static void Bench_StartThroughput(uint8_t conidx, uint8_t duration_s, uint8_t payload)
+{
+    const struct link_info_t *link = Link_GetInfo(conidx);
+    uint16_t largest = BENCH_PAYLOAD_MAX;
+
+    if (bench_env.state != BENCH_STATE_IDLE)
+    {
+        return;
+    }
+
+    bench_env.mtu = (link != NULL) ? link->mtu : LINK_DEFAULT_MTU;
+    if ((uint16_t)(bench_env.mtu - 3) < largest)
+    {
+        largest = bench_env.mtu - 3;
+    }
+
+    bench_env.payload = ((payload == 0) || (payload > largest)) ? largest : payload;
+    if (bench_env.payload < BENCH_PAYLOAD_MIN)
+    {
+        bench_env.payload = BENCH_PAYLOAD_MIN;
+    }
+
+    Bench_Reset();
+    bench_env.conidx = conidx;
+    bench_env.state = BENCH_STATE_THROUGHPUT;
+    bench_env.start_us = AppTimer_Now();
+    bench_env.last_us = bench_env.start_us;
+
+    ke_timer_set(BENCH_TIMEOUT, TASK_APP, TIMER_SETTING_S(duration_s));
+
+    APP_LOG_INFO("__BENCH conidx=%d: throughput %d s, %d bytes, mtu %d\r\n",
+                 conidx, duration_s, bench_env.payload, bench_env.mtu);
+
+    Bench_Fill();
+}
+
+/* Function      : Bench_Ping
+ *
+ * Description   : Notify a ping command back to the client.
+ *
+ * Parameters    : uint8_t conidx                : connection index
+ *                 const struct bench_cmd_t *cmd : ping command
+ *
+ * Returns       : None
+ */
+static void Bench_Ping(uint8_t conidx, const struct bench_cmd_t *cmd)
+{
+    uint32_t turnaround_us;
+
+    GATTC_SendEvtCmd(conidx, GATTC_NOTIFY, Bench_NextSeq(),
+                     GATTM_GetHandle(CUST_SVC0, CS_BENCH_DATA_VALUE_VAL0),
+                     BENCH_CTRL_LENGTH, cmd->value);
+
+    turnaround_us = (uint32_t)(AppTimer_Now() - cmd->rx_us);
+    bench_env.pings++;
+    if (turnaround_us > bench_env.ping_max_us)
+    {
+        bench_env.ping_max_us = turnaround_us;
+    }
+}
+
+void Bench_Initialize(void)
+{
+    memset(&bench_env, 0, sizeof(bench_env));
+
+    // Recognizable fill, only the first four bytes change per notification
+    for (uint16_t i = 0; i < BENCH_PAYLOAD_MAX; i++)
+    {
+        bench_payload[i] = (uint8_t)i;
+    }
+}
+
+bool Bench_ValidateCommand(const uint8_t *value, uint16_t length)
+{
+    if (length != BENCH_CTRL_LENGTH)
+    {
+        return false;
+    }
+
+    switch (value[0])
+    {
+        case BENCH_OP_THROUGHPUT:
+        {
+            return (value[1] != 0) && (value[1] <= BENCH_DURATION_MAX_S);
+        }
+
+        case BENCH_OP_STOP:
+        case BENCH_OP_PING:
+        case BENCH_OP_RESET:
+        {
+            return true;
+        }
+
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+void Bench_Post(uint8_t conidx, const uint8_t *value)
+{
+    struct bench_cmd_t *cmd = KE_MSG_ALLOC(BENCH_CMD, KE_BUILD_ID(TASK_APP, conidx),
+                                           KE_BUILD_ID(TASK_APP, conidx), bench_cmd_t);
+
+    cmd->rx_us = AppTimer_Now();
+    memcpy(cmd->value, value, BENCH_CTRL_LENGTH);
+    ke_msg_send(cmd);
+}
+
+void Bench_PackResult(uint8_t *buf)
+{
+    buf[0] = bench_env.state;
+    buf[1] = bench_env.conidx;
+    Bench_PutU16(&buf[2], bench_env.payload);
+    Bench_PutU16(&buf[4], bench_env.mtu);
+    Bench_PutU32(&buf[6], bench_env.packets);
+    Bench_PutU32(&buf[10], bench_env.bytes);
+    Bench_PutU32(&buf[14], bench_env.elapsed_ms);
+    Bench_PutU32(&buf[18], bench_env.failed);
+    Bench_PutU32(&buf[22], bench_env.pings);
+    Bench_PutU32(&buf[26], bench_env.ping_max_us);
+}
+
+void Bench_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    switch (msg_id)
+    {
+        case BENCH_CMD:
+        {
+            const struct bench_cmd_t *cmd = param;
+            uint8_t conidx = KE_IDX_GET(dest_id);
+
+            switch (cmd->value[0])
+            {
+                case BENCH_OP_THROUGHPUT:
+                {
+                    Bench_StartThroughput(conidx, cmd->value[1], cmd->value[2]);
+                }
+                break;
+
+                case BENCH_OP_PING:
+                {
+                    // Keeps the throughput completions unambiguous
+                    if (bench_env.state == BENCH_STATE_IDLE)
+                    {
+                        Bench_Ping(conidx, cmd);
+                    }
+                }
+                break;
+
+                case BENCH_OP_STOP:
+                {
+                    Bench_Stop();
+                }
+                break;
+
+                case BENCH_OP_RESET:
+                {
+                    if (bench_env.state == BENCH_STATE_IDLE)
+                    {
+                        Bench_Reset();
+                    }
+                }
+                break;
+            }
+        }
+        break;
+
+        case BENCH_TIMEOUT:
+        {
+            Bench_Stop();
+        }
+        break;
+
+        case GATTC_CMP_EVT:
+        {
+            const struct gattc_cmp_evt *p = param;
+
+            if ((p->operation != GATTC_NOTIFY) ||
+                ((p->seq_num & BENCH_SEQ_MASK) != BENCH_SEQ_FLAG) ||
+                (bench_env.state == BENCH_STATE_IDLE) ||
+                (KE_IDX_GET(src_id) != bench_env.conidx) ||
+                (bench_env.in_flight == 0))
+            {
+                break;
+            }
+
+            bench_env.in_flight--;
+            bench_env.last_us = AppTimer_Now();
+            if (p->status == GAP_ERR_NO_ERROR)
+            {
+                bench_env.packets++;
+                bench_env.bytes += bench_env.payload;
+            }
+            else
+            {
+                bench_env.failed++;
+            }
+
+            Bench_Fill();
+            Bench_Finish();
+        }
+        break;
+
+        case GAPC_DISCONNECT_IND:
+        {
+            if ((bench_env.state != BENCH_STATE_IDLE) &&
+                (KE_IDX_GET(src_id) == bench_env.conidx))
+            {
+                // Nothing else completes on a dropped link
+                ke_timer_clear(BENCH_TIMEOUT, TASK_APP);
+                bench_env.in_flight = 0;
+                bench_env.state = BENCH_STATE_DRAINING;
+                Bench_Finish();
+            }
+        }
+        break;
+    }
+}
@@ -0,0 +1,266 @@
+/******************************************************************************
+ * File Name        : app_boot.c
+ * Description      : This module implements the boot sequencer (see
+ *                    app_boot.h).
+ *
+ *                    Each configuration write is guarded by a one-shot
+ *                    timer of I2C_TRANSFER_TIMEOUT_US; a write that does not
+ *                    end in time is aborted and the next one started, as
+ *                    the blocking driver calls do. The scheduler event
+ *                    carries the write index, so the end of a write that
+ *                    already timed out is ignored.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_boot.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define BOOT_PHASE_NAME(name)           #name,
+
+static const char *const boot_phase_name[BOOT_PHASE_COUNT] =
+{
+    BOOT_PHASE_TABLE(BOOT_PHASE_NAME)
+};
+
+struct boot_env_tag
+{
+    uint32_t phase_us[BOOT_PHASE_COUNT];    // BOOT_PHASE_NONE until reached
+    bool anchored;                          // boot clock on the baseband clock
+    uint32_t anchor_us;                     // boot time at the switch
+    uint64_t anchor_now;                    // AppTimer_Now at the switch
+    uint8_t step;                           // configuration write running
+    uint8_t timeouts;                       // writes aborted
+    bool reported;                          // phases logged
+};
+
+static struct boot_env_tag boot_env;
+
+// Guards the configuration write running
+static struct app_timer_t boot_timer;
+
+static void Boot_SensorStep(void);
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Boot_Now
+ *
+ * Description   : Returns the boot clock.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : microseconds from the end of DeviceInit
+ */
+static uint32_t Boot_Now(void)
+{
+    if (boot_env.anchored)
+    {
+        return boot_env.anchor_us + (uint32_t)(AppTimer_Now() - boot_env.anchor_now);
+    }
+
+    return Cycles_Now() / (SystemCoreClock / 1000000);
+}
+
+/* Function      : Boot_Report
+ *
+ * Description   : Log the time of every phase reached.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Boot_Report(void)
+{
+    for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; phase++)
+    {
+        if (boot_env.phase_us[phase] != BOOT_PHASE_NONE)
+        {
+            APP_LOG_INFO("__BOOT %s at %lu us\r\n",
+                         APP_LOG_STR(boot_phase_name[phase]), boot_env.phase_us[phase]);
+        }
+    }
+
+    APP_LOG_INFO("__BOOT first advertisement after %lu us, %u sensor writes timed out\r\n",
+                 boot_env.phase_us[BOOT_PHASE_ADV], boot_env.timeouts);
+    boot_env.reported = true;
+}
+
+/* Function      : Boot_I2CDone
+ *
+ * Description   : I2C interrupt, a configuration write ended. Hand it to
+ *                 the main loop.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Boot_I2CDone(void)
+{
+    AppSched_Post(APP_SCHED_SENSOR_CONFIG, boot_env.step);
+}
+
+/* Function      : Boot_I2CTimeout
+ *
+ * Description   : Timer callback, a configuration write did not end in time.
+ *                 Abort it and move on to the next one.
+ *
+ * Parameters    : void *context : Unused
+ *
+ * Returns       : None
+ */
+static void Boot_I2CTimeout(void *context)
+{
+    complete_hdc2080_step();
+    boot_env.timeouts++;
+    boot_env.step++;
+    Boot_SensorStep();
+}
+
+/* Function      : Boot_SensorStep
+ *
+ * Description   : Start the configuration write boot_env.step, or start the
+ *                 sampler after the last one.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Boot_SensorStep(void)
+{
+    if (configure_hdc2080_step(boot_env.step, Boot_I2CDone))
+    {
+        if (AppTimer_Start(&boot_timer, APP_TIMER_US(I2C_TRANSFER_TIMEOUT_US), 0,
+                           Boot_I2CTimeout, NULL))
+        {
+            return;
+        }
+
+        // Unguarded, a lost interrupt would stop the boot here: abort the
+        // write and configure with the blocking writes, each bounded by
+        // I2C_TRANSFER_TIMEOUT_US; a late end of this one is ignored
+        APP_LOG_ERROR("__BOOT no timer, sensor configured blocking\r\n");
+        complete_hdc2080_step();
+        boot_env.step++;
+        initialize_hdc2080();
+    }
+
+    Boot_Mark(BOOT_PHASE_SENSOR_CONFIG);
+    Sensor_Start();
+}
+
+void Boot_Initialize(void)
+{
+    Cycles_Initialize();
+
+    memset(&boot_env, 0, sizeof(boot_env));
+    memset(boot_env.phase_us, 0xFF, sizeof(boot_env.phase_us));
+
+    Boot_Mark(BOOT_PHASE_CLOCKS);
+}
+
+void Boot_Mark(uint8_t phase)
+{
+    if ((phase >= BOOT_PHASE_COUNT) || (boot_env.phase_us[phase] != BOOT_PHASE_NONE))
+    {
+        return;
+    }
+
+    boot_env.phase_us[phase] = Boot_Now();
+
+    // The baseband clock runs once the stack is initialized, and across sleep
+    if (phase == BOOT_PHASE_BLE_RESET)
+    {
+        boot_env.anchor_us = boot_env.phase_us[phase];
+        boot_env.anchor_now = AppTimer_Now();
+        boot_env.anchored = true;
+    }
+
+    if (boot_env.reported)
+    {
+        APP_LOG_INFO("__BOOT %s at %lu us\r\n",
+                     APP_LOG_STR(boot_phase_name[phase]), boot_env.phase_us[phase]);
+    }
+    else if ((boot_env.phase_us[BOOT_PHASE_ADV] != BOOT_PHASE_NONE) &&
+             (boot_env.phase_us[BOOT_PHASE_FIRST_SAMPLE] != BOOT_PHASE_NONE))
+    {
+        Boot_Report();
+    }
+}
+
+void Boot_Start(void)
+{
+    boot_env.step = 0;
+    Boot_SensorStep();
+}
+
+void Boot_SensorTask(uint32_t arg)
+{
+    // Ended after its timeout, the next write is already running
+    if (arg != boot_env.step)
+    {
+        return;
+    }
+
+    AppTimer_Cancel(&boot_timer);
+    complete_hdc2080_step();
+    boot_env.step++;
+    Boot_SensorStep();
+}
+
+uint32_t Boot_GetPhase(uint8_t phase)
+{
+    return (phase < BOOT_PHASE_COUNT) ? boot_env.phase_us[phase] : BOOT_PHASE_NONE;
+}
+
+void Boot_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                     ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    switch (msg_id)
+    {
+        case GAPM_CMP_EVT:
+        {
+            const struct gapm_cmp_evt *p = param;
+
+            if (p->operation == GAPM_RESET)
+            {
+                Boot_Mark(BOOT_PHASE_STACK_RESET);
+            }
+            else if ((p->operation == GAPM_SET_DEV_CONFIG) &&
+                     (p->status == GAP_ERR_NO_ERROR))
+            {
+                Boot_Mark(BOOT_PHASE_DEV_CONFIG);
+            }
+        }
+        break;
+
+        case GATTM_ADD_SVC_RSP:
+        {
+            if (GATTM_GetServiceAddedCount() == APP_NUM_CUST_SVC)
+            {
+                Boot_Mark(BOOT_PHASE_SERVICES);
+            }
+        }
+        break;
+
+        case SENSOR_SAMPLE_IND:
+        {
+            Boot_Mark(BOOT_PHASE_FIRST_SAMPLE);
+        }
+        break;
+    }
+}
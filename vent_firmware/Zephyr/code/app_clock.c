@@ -0,0 +1,283 @@
+/******************************************************************************
+ * File Name        : app_clock.c
+ * Description      : This module implements the system clock policy (see
+ *                    app_clock.h).
+ *
+ *                    The RF clock prescaler and the baseband divider are
+ *                    written back to back with interrupts masked, so the
+ *                    baseband clock is off its 1 MHz only for the few
+ *                    cycles between the two writes. The flash timing is
+ *                    set for the higher of the two clocks across the
+ *                    change. A run window of the power manager that spans
+ *                    a change is charged to the energy accounts at the new
+ *                    clock.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_clock.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+struct clock_level_t
+{
+    uint32_t prescale;          // RF clock prescaler
+    uint32_t hz;                // SYSCLK
+    uint32_t bbclk_divider;     // baseband clock divider
+    const char *name;
+};
+
+#define CLOCK_LEVEL_ENTRY(name, prescale, hz, bbclk_divider)    \
+    { (prescale), (hz), (bbclk_divider), #name },
+
+static const struct clock_level_t clock_level[CLOCK_LEVEL_COUNT] =
+{
+    CLOCK_LEVEL_TABLE(CLOCK_LEVEL_ENTRY)
+};
+
+#define CLOCK_HOLD_QUERY(name, query)   query,
+
+static bool (*const clock_hold_query[CLOCK_HOLD_COUNT])(void) =
+{
+    CLOCK_HOLD_TABLE(CLOCK_HOLD_QUERY)
+};
+
+#define CLOCK_NOTIFY_CALL(name, notify) notify();
+
+struct clock_env_tag
+{
+    uint8_t level;                          // enum clock_level applied
+    uint8_t request[CLOCK_CLIENT_COUNT];    // lowest level needed
+    uint8_t limit[CLOCK_CLIENT_COUNT];      // highest level allowed
+    uint64_t since;                         // AppTimer_Now at the last change
+    struct clock_stats_t stats;
+};
+
+static struct clock_env_tag clock_env;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Clock_Target
+ *
+ * Description   : Returns the highest level requested, capped by the lowest
+ *                 limit.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint8_t : enum clock_level
+ */
+static uint8_t Clock_Target(void)
+{
+    uint8_t level = CLOCK_LEVEL_LOW;
+    uint8_t limit = CLOCK_LEVEL_COUNT - 1;
+
+    for (uint8_t i = 0; i < CLOCK_CLIENT_COUNT; i++)
+    {
+        if (clock_env.request[i] > level)
+        {
+            level = clock_env.request[i];
+        }
+        if (clock_env.limit[i] < limit)
+        {
+            limit = clock_env.limit[i];
+        }
+    }
+
+    return (level < limit) ? level : limit;
+}
+
+/* Function      : Clock_Settle
+ *
+ * Description   : Count the time spent at the current level.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Clock_Settle(void)
+{
+    uint64_t now = AppTimer_Now();
+
+    clock_env.stats.residency_us[clock_env.level] += now - clock_env.since;
+    clock_env.since = now;
+}
+
+/* Function      : Clock_Apply
+ *
+ * Description   : Switch the system clock to a level and re-derive the
+ *                 peripheral clocks.
+ *
+ * Parameters    : uint8_t level : enum clock_level
+ *
+ * Returns       : None
+ */
+static void Clock_Apply(uint8_t level)
+{
+    const struct clock_level_t *to = &clock_level[level];
+    bool raise = (level > clock_env.level);
+
+    Clock_Settle();
+
+    // The flash needs its wait states before the clock goes up
+    if (raise)
+    {
+        Flash_Initialize(0, (FlashClockFrequency_t)(to->hz));
+    }
+
+    GLOBAL_INT_DISABLE();
+    Sys_Clocks_XTALClkConfig(to->prescale);
+    BBIF->CTRL = (BB_CLK_ENABLE | to->bbclk_divider);
+
+    // Updates SystemCoreClock, the dividers below are derived from it
+    Sys_Clocks_SystemClkConfig(SYSCLK_CLKSRC_RFCLK);
+    Sys_Clocks_DividerConfig(UART_CLK, SENSOR_CLK, USER_CLK);
+    GLOBAL_INT_RESTORE();
+
+    if (!raise)
+    {
+        Flash_Initialize(0, (FlashClockFrequency_t)(to->hz));
+    }
+
+    clock_env.level = level;
+    clock_env.stats.switches++;
+
+    CLOCK_NOTIFY_TABLE(CLOCK_NOTIFY_CALL)
+}
+
+void Clock_Initialize(void)
+{
+    memset(&clock_env, 0, sizeof(clock_env));
+    memset(clock_env.limit, CLOCK_LEVEL_COUNT - 1, sizeof(clock_env.limit));
+    clock_env.level = CLOCK_LEVEL_LOW;
+    clock_env.since = AppTimer_Now();
+}
+
+void Clock_Request(uint8_t client, uint8_t level)
+{
+    if ((client < CLOCK_CLIENT_COUNT) && (level < CLOCK_LEVEL_COUNT) &&
+        (clock_env.request[client] != level))
+    {
+        clock_env.request[client] = level;
+        Clock_Update();
+    }
+}
+
+void Clock_Limit(uint8_t client, uint8_t level)
+{
+    if ((client < CLOCK_CLIENT_COUNT) && (level < CLOCK_LEVEL_COUNT) &&
+        (clock_env.limit[client] != level))
+    {
+        clock_env.limit[client] = level;
+        Clock_Update();
+    }
+}
+
+void Clock_Update(void)
+{
+    uint8_t level = Clock_Target();
+
+    if (level == clock_env.level)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < CLOCK_HOLD_COUNT; i++)
+    {
+        if (clock_hold_query[i]())
+        {
+            clock_env.stats.deferred[i]++;
+            return;
+        }
+    }
+
+    Clock_Apply(level);
+}
+
+void Clock_Restore(void)
+{
+    // DeviceClockInit and BLERadioInit left the lowest level
+    Clock_Settle();
+    clock_env.level = CLOCK_LEVEL_LOW;
+
+    Clock_Update();
+}
+
+uint8_t Clock_GetLevel(void)
+{
+    return clock_env.level;
+}
+
+const struct clock_stats_t *Clock_GetStats(void)
+{
+    Clock_Settle();
+
+    return &clock_env.stats;
+}
+
+void Clock_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    switch (msg_id)
+    {
+        case GAPC_BOND_REQ_IND:
+        {
+            const struct gapc_bond_req_ind *p = param;
+
+            // Key generation and the DH key check run in the kernel after
+            // the pairing response
+            if (p->request == GAPC_PAIRING_REQ)
+            {
+                Clock_Request(CLOCK_PAIRING, CLOCK_LEVEL_HIGH);
+            }
+        }
+        break;
+
+        case GAPC_BOND_IND:
+        case GAPC_DISCONNECT_IND:
+        {
+            Clock_Request(CLOCK_PAIRING, CLOCK_LEVEL_LOW);
+        }
+        break;
+
+        case POWER_REPORT_TIMEOUT:
+        {
+            const struct clock_stats_t *stats = Clock_GetStats();
+            uint64_t total = 0;
+            uint32_t permille[CLOCK_LEVEL_COUNT];
+
+            for (uint8_t i = 0; i < CLOCK_LEVEL_COUNT; i++)
+            {
+                total += stats->residency_us[i];
+            }
+
+            for (uint8_t i = 0; i < CLOCK_LEVEL_COUNT; i++)
+            {
+                permille[i] = (total == 0) ? 0 :
+                              (uint32_t)((stats->residency_us[i] * 1000) / total);
+            }
+
+            APP_LOG_INFO("__CLOCK %s, low %lu, mid %lu, high %lu permille; %lu switches\r\n",
+                         APP_LOG_STR(clock_level[clock_env.level].name),
+                         permille[CLOCK_LEVEL_LOW], permille[CLOCK_LEVEL_MID],
+                         permille[CLOCK_LEVEL_HIGH], stats->switches);
+            APP_LOG_DEBUG("__CLOCK held by i2c %lu, servo %lu, lsad %lu, trace %lu\r\n",
+                          stats->deferred[CLOCK_HOLD_I2C], stats->deferred[CLOCK_HOLD_SERVO],
+                          stats->deferred[CLOCK_HOLD_LSAD], stats->deferred[CLOCK_HOLD_TRACE]);
+        }
+        break;
+    }
+}
@@ -0,0 +1,286 @@
+/******************************************************************************
+ * File Name        : app_conn_policy.c
+ * Description      : This module implements the connection parameter policy
+ *                    engine.
+ *
+ *                    Each connection is kept in one of two states:
+ *                      - IDLE   : long interval and high slave latency, the
+ *                                 radio only wakes for supervision traffic.
+ *                      - ACTIVE : short interval with no latency, used while
+ *                                 commands or bulk transfers are in progress.
+ *                    Activity moves a link to ACTIVE and (re)starts a timer
+ *                    which drops the link back to IDLE when it expires.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <ble_abstraction.h>
+#include <swmTrace_api.h>
+#include <app.h>
+#include <app_conn_policy.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+struct conn_policy_env_tag
+{
+    uint8_t state;          // requested policy state
+    uint16_t interval;      // current connection interval (1.25 ms units)
+    uint16_t latency;       // current slave latency
+    uint16_t timeout;       // current supervision timeout (10 ms units)
+};
+
+static struct conn_policy_env_tag conn_policy_env[APP_MAX_NB_CON];
+
+static const struct gapc_conn_param conn_policy_idle_params =
+{
+    .intv_min = CONN_POLICY_IDLE_INTV_MIN,
+    .intv_max = CONN_POLICY_IDLE_INTV_MAX,
+    .latency  = CONN_POLICY_IDLE_LATENCY,
+    .time_out = CONN_POLICY_IDLE_TIMEOUT
+};
+
+static const struct gapc_conn_param conn_policy_active_params =
+{
+    .intv_min = CONN_POLICY_ACTIVE_INTV_MIN,
+    .intv_max = CONN_POLICY_ACTIVE_INTV_MAX,
+    .latency  = CONN_POLICY_ACTIVE_LATENCY,
+    .time_out = CONN_POLICY_ACTIVE_TIMEOUT
+};
+
+static const char *const conn_policy_state_name[] =
+{
+    [CONN_POLICY_STATE_DISCONNECTED] = "DISCONNECTED",
+    [CONN_POLICY_STATE_IDLE]         = "IDLE",
+    [CONN_POLICY_STATE_ACTIVE]       = "ACTIVE",
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : ConnPolicy_UpdateEnergy
+ *
+ * Description   : Set the radio current of the open connections, at their
+ *                 current parameters, on the CONN energy account.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void ConnPolicy_UpdateEnergy(void)
+{
+    uint32_t current_ua = 0;
+
+    for (uint8_t conidx = 0; conidx < APP_MAX_NB_CON; conidx++)
+    {
+        if (conn_policy_env[conidx].state != CONN_POLICY_STATE_DISCONNECTED)
+        {
+            current_ua += ConnPolicy_EstimateCurrent(conn_policy_env[conidx].interval,
+                                                     conn_policy_env[conidx].latency) -
+                          CONN_POLICY_SLEEP_CURRENT_UA;
+        }
+    }
+
+    Energy_SetCurrent(ENERGY_CONN, current_ua);
+}
+
+/* Function      : ConnPolicy_Transition
+ *
+ * Description   : Move a connection to a new policy state and request the
+ *                 matching connection parameters from the central.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *                 uint8_t state  : new policy state
+ *
+ * Returns       : None
+ */
+static void ConnPolicy_Transition(uint8_t conidx, uint8_t state)
+{
+    const struct gapc_conn_param *params;
+
+    if (state == CONN_POLICY_STATE_ACTIVE)
+    {
+        params = &conn_policy_active_params;
+    }
+    else
+    {
+        params = &conn_policy_idle_params;
+    }
+
+    APP_LOG_INFO("__CONN_POLICY conidx=%d: %s -> %s (intv %d-%d, lat %d, est. %lu uA)\r\n",
+                 conidx, APP_LOG_STR(conn_policy_state_name[conn_policy_env[conidx].state]),
+                 APP_LOG_STR(conn_policy_state_name[state]),
+                 params->intv_min, params->intv_max, params->latency,
+                 (unsigned long)ConnPolicy_EstimateCurrent(params->intv_max,
+                                                           params->latency));
+
+    conn_policy_env[conidx].state = state;
+    GAPC_ParamUpdateCmd(conidx, params);
+}
+
+void ConnPolicy_Initialize(void)
+{
+    memset(conn_policy_env, 0, sizeof(conn_policy_env));
+}
+
+void ConnPolicy_RequestActive(uint8_t conidx)
+{
+    if ((conidx >= APP_MAX_NB_CON) ||
+        (conn_policy_env[conidx].state == CONN_POLICY_STATE_DISCONNECTED))
+    {
+        return;
+    }
+
+    if (conn_policy_env[conidx].state != CONN_POLICY_STATE_ACTIVE)
+    {
+        ConnPolicy_Transition(conidx, CONN_POLICY_STATE_ACTIVE);
+    }
+
+    /* Setting the timer again replaces the pending one, so the link only
+     * falls back once activity has stopped for the whole hold time */
+    ke_timer_set(CONN_POLICY_TIMEOUT, KE_BUILD_ID(TASK_APP, conidx),
+                 TIMER_SETTING_MS(CONN_POLICY_ACTIVE_HOLD_MS));
+}
+
+uint8_t ConnPolicy_GetState(uint8_t conidx)
+{
+    if (conidx >= APP_MAX_NB_CON)
+    {
+        return CONN_POLICY_STATE_DISCONNECTED;
+    }
+
+    return conn_policy_env[conidx].state;
+}
+
+uint32_t ConnPolicy_EstimateCurrent(uint16_t interval, uint16_t latency)
+{
+    /* The slave only attends one event out of (latency + 1) */
+    uint32_t period_us = CONN_INTV_TO_US(interval) * ((uint32_t)latency + 1);
+
+    if (period_us == 0)
+    {
+        return 0;
+    }
+
+    /* nC / us = mA, scale by 1000 for uA */
+    return CONN_POLICY_SLEEP_CURRENT_UA +
+           ((uint32_t)CONN_POLICY_EVENT_CHARGE_NC * 1000) / period_us;
+}
+
+void ConnPolicy_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                           ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    uint8_t conidx = KE_IDX_GET(src_id);
+
+    switch (msg_id)
+    {
+        case GAPC_CONNECTION_REQ_IND:
+        {
+            const struct gapc_connection_req_ind *p = param;
+
+            if (conidx >= APP_MAX_NB_CON)
+            {
+                break;
+            }
+
+            conn_policy_env[conidx].interval = p->con_interval;
+            conn_policy_env[conidx].latency = p->con_latency;
+            conn_policy_env[conidx].timeout = p->sup_to;
+
+            /* Leave the central's parameters in place while it discovers
+             * the services, the hold timer moves the link to idle after */
+            conn_policy_env[conidx].state = CONN_POLICY_STATE_ACTIVE;
+            ke_timer_set(CONN_POLICY_TIMEOUT, KE_BUILD_ID(TASK_APP, conidx),
+                         TIMER_SETTING_MS(CONN_POLICY_CONNECT_HOLD_MS));
+            ConnPolicy_UpdateEnergy();
+
+            APP_LOG_INFO("__CONN_POLICY conidx=%d: connected (intv %d, lat %d, est. %lu uA)\r\n",
+                         conidx, p->con_interval, p->con_latency,
+                         (unsigned long)ConnPolicy_EstimateCurrent(p->con_interval,
+                                                                   p->con_latency));
+        }
+        break;
+
+        case GAPC_DISCONNECT_IND:
+        {
+            if (conidx >= APP_MAX_NB_CON)
+            {
+                break;
+            }
+
+            ke_timer_clear(CONN_POLICY_TIMEOUT, KE_BUILD_ID(TASK_APP, conidx));
+            conn_policy_env[conidx].state = CONN_POLICY_STATE_DISCONNECTED;
+            ConnPolicy_UpdateEnergy();
+        }
+        break;
+
+        case GAPC_PARAM_UPDATE_REQ_IND:
+        {
+            /* Peer device requested an update in connection params. Accept
+             * it, a short interval request means the peer is busy with
+             * the link so treat it as activity. */
+            const struct gapc_param_update_req_ind *p = param;
+
+            GAPC_ParamUpdateCfm(conidx, true, 0xFFFF, 0xFFFF);
+            APP_LOG_INFO("GAPC_PARAM_UPDATE_REQ_IND: intv %d-%d, lat %d\r\n",
+                         p->intv_min, p->intv_max, p->latency);
+
+            if ((conidx < APP_MAX_NB_CON) &&
+                (p->intv_max <= CONN_POLICY_ACTIVE_INTV_LIMIT))
+            {
+                conn_policy_env[conidx].state = CONN_POLICY_STATE_ACTIVE;
+                ke_timer_set(CONN_POLICY_TIMEOUT, KE_BUILD_ID(TASK_APP, conidx),
+                             TIMER_SETTING_MS(CONN_POLICY_ACTIVE_HOLD_MS));
+            }
+        }
+        break;
+
+        case GAPC_PARAM_UPDATED_IND:
+        {
+            const struct gapc_param_updated_ind *p = param;
+
+            if (conidx >= APP_MAX_NB_CON)
+            {
+                break;
+            }
+
+            conn_policy_env[conidx].interval = p->con_interval;
+            conn_policy_env[conidx].latency = p->con_latency;
+            conn_policy_env[conidx].timeout = p->sup_to;
+            ConnPolicy_UpdateEnergy();
+
+            APP_LOG_INFO("__CONN_POLICY conidx=%d: %s params applied (intv %lu us, lat %d, "
+                         "timeout %lu ms, est. %lu uA)\r\n",
+                         conidx, APP_LOG_STR(conn_policy_state_name[conn_policy_env[conidx].state]),
+                         (unsigned long)CONN_INTV_TO_US(p->con_interval), p->con_latency,
+                         (unsigned long)CONN_TIMEOUT_TO_MS(p->sup_to),
+                         (unsigned long)ConnPolicy_EstimateCurrent(p->con_interval,
+                                                                   p->con_latency));
+        }
+        break;
+
+        case CONN_POLICY_TIMEOUT:
+        {
+            /* Timers are addressed to the connection's application task */
+            conidx = KE_IDX_GET(dest_id);
+
+            if ((conidx < APP_MAX_NB_CON) &&
+                (conn_policy_env[conidx].state == CONN_POLICY_STATE_ACTIVE) &&
+                GAPC_IsConnectionActive(conidx))
+            {
+                ConnPolicy_Transition(conidx, CONN_POLICY_STATE_IDLE);
+            }
+        }
+        break;
+    }
+}
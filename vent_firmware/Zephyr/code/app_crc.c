@@ -0,0 +1,46 @@
+/******************************************************************************
+ * File Name        : app_crc.c
+ * Description      : This module implements the CRC-32 used to check bulk
+ *                    transfers. A 16 entry (nibble) table keeps the flash
+ *                    cost at 64 bytes while running ~4x faster than the
+ *                    bitwise loop.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <app_crc.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+static const uint32_t crc32_nibble_table[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+uint32_t CRC32_Update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+    }
+
+    return crc;
+}
@@ -42,79 +42,47 @@
  * --------------------------------------------------------------------------*/
 static struct app_env_tag_cs app_env_cs;
 
+// Attribute database entries of one characteristic, see CS_ENUM_ENTRY for
+// the matching indexes
+#define CS_ATT_CCC_NONE(svc, name)
+#define CS_ATT_CCC_CCC(svc, name) \
+    CS_CHAR_CCC(CS_##name##_VALUE_CCC##svc, app_env_cs.ccc.name##_cccd, NULL),
+#define CS_ATT_CCC_CCC_ON(svc, name)    CS_ATT_CCC_CCC(svc, name)
+#ifdef CS_USER_DESCRIPTIONS
+#define CS_ATT_DESC(svc, name) \
+    CS_CHAR_USER_DESC(CS_##name##_VALUE_USR_DSCP##svc, sizeof(#name) - 1, #name, NULL),
+#else  /* ifdef CS_USER_DESCRIPTIONS */
+#define CS_ATT_DESC(svc, name)
+#endif /* ifdef CS_USER_DESCRIPTIONS */
+
+// Snapshot values have no buffer, CUSTOMSS_MsgHandler serves every read
+#define CS_ATT_DATA_ENV(name)           app_env_cs.value.name##_buffer
+#define CS_ATT_DATA_SNAPSHOT(name)      NULL
+
+#define CS_ATT_ENTRY(svc, name, uuid4, uuid5, perm, length, store, ccc, callback, hub_key) \
+    CS_CHAR_UUID_128(CS_##name##_VALUE_CHAR##svc,                                   \
+                     CS_##name##_VALUE_VAL##svc,                                    \
+                     CS_UUID(uuid4, uuid5),                                         \
+                     perm,                                                          \
+                     length,                                                        \
+                     CS_ATT_DATA_##store(name),                                     \
+                     callback),                                                     \
+    CS_ATT_CCC_##ccc(svc, name)                                                     \
+    CS_ATT_DESC(svc, name)
+
+// CCC values written when the environment is reset
+#define CS_CCC_INIT_NONE(name)
+#define CS_CCC_INIT_CCC(name)
+#define CS_CCC_INIT_CCC_ON(name)        app_env_cs.ccc.name##_cccd[0] = ATT_CCC_START_NTF;
+#define CS_CCC_INIT(svc, name, uuid4, uuid5, perm, length, store, ccc, callback, hub_key) \
+    CS_CCC_INIT_##ccc(name)
+
 static const struct att_db_desc att_db_cs_svc0[] =
 {
     //**** Service 0 ****
     CS_SERVICE_UUID_128(CS_SERVICE0, CS_SVC_UUID),
 
-    // To the BLE transfer
-    CS_CHAR_UUID_128(CS_TX_VALUE_CHAR0,
-                     CS_TX_VALUE_VAL0,
-                     CS_CHAR_TX_UUID,
-                     PERM(RD, ENABLE) | PERM(WRITE_REQ, ENABLE) | PERM(WRITE_COMMAND, ENABLE) | PERM(RP, SEC_CON),
-                     sizeof(app_env_cs.to_air_buffer),
-                     app_env_cs.to_air_buffer, NULL),
-    CS_CHAR_CCC(CS_TX_VALUE_CCC0,
-                app_env_cs.to_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_TX_VALUE_USR_DSCP0,
-                      sizeof(CS_TX_CHAR_NAME) - 1,
-                      CS_TX_CHAR_NAME,
-                      NULL),
-
-    // From the BLE transfer
-    CS_CHAR_UUID_128(CS_RX_VALUE_CHAR0,
-                     CS_RX_VALUE_VAL0,
-                     CS_CHAR_RX_UUID,
-                     PERM(RD, ENABLE) | PERM(NTF, ENABLE),
-                     sizeof(app_env_cs.from_air_buffer),
-                     app_env_cs.from_air_buffer,
-                     CUSTOMSS_RXCharCallback),
-    CS_CHAR_CCC(CS_RX_VALUE_CCC0,
-                app_env_cs.from_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_RX_VALUE_USR_DSCP0,
-                      sizeof(CS_RX_CHAR_NAME) - 1,
-                      CS_RX_CHAR_NAME,
-                      NULL),
-
-    // To the BLE long transfer
-    CS_CHAR_UUID_128(CS_TX_LONG_VALUE_CHAR0,
-                     CS_TX_LONG_VALUE_VAL0,
-                     CS_CHAR_LONG_TX_UUID,
-                     PERM(RD, ENABLE) | PERM(WRITE_REQ, ENABLE) | PERM(WRITE_COMMAND, ENABLE),
-                     sizeof(app_env_cs.to_air_buffer_long),
-                     app_env_cs.to_air_buffer_long,
-                     NULL),
-    CS_CHAR_CCC(CS_TX_LONG_VALUE_CCC0,
-                app_env_cs.to_air_cccd_value_long,
-                NULL),
-    CS_CHAR_USER_DESC(CS_TX_LONG_VALUE_USR_DSCP0,
-                      sizeof(CS_TX_CHAR_LONG_NAME) - 1,
-                      CS_TX_CHAR_LONG_NAME,
-                      NULL),
-
-    // From the BLE long transfer
-    CS_CHAR_UUID_128(CS_RX_LONG_VALUE_CHAR0,                     /* attidx_char */
-                     CS_RX_LONG_VALUE_VAL0,                      /* attidx_val */
-                     CS_CHAR_LONG_RX_UUID,                       /* uuid */
-#ifdef RX_VALUE_LONG_INDICATION
-                     PERM(RD, ENABLE) | PERM(IND, ENABLE),       /* perm, use indication */
-#else  /* ifdef RX_VALUE_LONG_INDICATION */
-                     PERM(RD, ENABLE) | PERM(NTF, ENABLE),       /* perm, use notification */
-#endif /* ifdef RX_VALUE_LONG_INDICATION */
-                     sizeof(app_env_cs.from_air_buffer_long),    /* length */
-                     app_env_cs.from_air_buffer_long,            /* data */
-                     CUSTOMSS_RXLongCharCallback),               /* callback */
-    // Client Characteristic Configuration descriptor
-    CS_CHAR_CCC(CS_RX_LONG_VALUE_CCC0,                           /* attidx */
-                app_env_cs.from_air_cccd_value_long,             /* data */
-                NULL),                                           /* callback */
-    // Characteristic User Description descriptor
-    CS_CHAR_USER_DESC(CS_RX_LONG_VALUE_USR_DSCP0,                /* attidx */
-                      sizeof(CS_RX_CHAR_LONG_NAME) - 1,          /* length */
-                      CS_RX_CHAR_LONG_NAME,                      /* data */
-                      NULL),                                     /* callback */
+    CS_SVC0_MANIFEST(CS_ATT_ENTRY)
 };
 
 static const struct att_db_desc att_db_cs_svc1[] =
@@ -122,140 +90,97 @@ static const struct att_db_desc att_db_cs_svc1[] =
     //**** Service 1 ****
     CS_SERVICE_UUID_128(CS_SERVICE1, CS_BLT_SVC_UUID),
 
-    // To the BLE Battery transfer
-    CS_CHAR_UUID_128(CS_BATTERY_VALUE_CHAR1,
-                     CS_BATTERY_VALUE_VAL1,
-                     CS_CHAR_BATTERY_UUID,
-                     PERM(RD, ENABLE) | PERM(NTF, ENABLE),
-                     sizeof(app_env_cs.battery_to_air_buffer),
-                     app_env_cs.battery_to_air_buffer, NULL),
-    CS_CHAR_CCC(CS_BATTERY_VALUE_CCC1,
-                app_env_cs.battery_to_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_BATTERY_VALUE_USR_DSCP1,
-                      sizeof(CS_BATTERY_CHAR_NAME) - 1,
-                      CS_BATTERY_CHAR_NAME,
-                      NULL),
-
-    // From the BLE LED Transfer
-    CS_CHAR_UUID_128(CS_LED_VALUE_CHAR1,
-                     CS_LED_VALUE_VAL1,
-                     CS_CHAR_LED_UUID,
-                     PERM(RD, ENABLE) | PERM(WRITE_REQ, ENABLE) | PERM(WRITE_COMMAND, ENABLE),
-                     sizeof(app_env_cs.led_from_air_buffer),
-                     app_env_cs.led_from_air_buffer,
-                     CUSTOMSS_LEDCharCallback),
-    CS_CHAR_CCC(CS_LED_VALUE_CCC1,
-                app_env_cs.led_from_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_LED_VALUE_USR_DSCP1,
-                      sizeof(CS_LED_CHAR_NAME) - 1,
-                      CS_LED_CHAR_NAME,
-                      NULL),
-
-    // To the BLE Button transfer
-    CS_CHAR_UUID_128(CS_BUTTON_VALUE_CHAR1,
-                     CS_BUTTON_VALUE_VAL1,
-                     CS_CHAR_BUTTON_UUID,
-                     PERM(RD, ENABLE) | PERM(NTF, ENABLE),
-                     sizeof(app_env_cs.button_to_air_buffer),
-                     app_env_cs.button_to_air_buffer, NULL),
-    CS_CHAR_CCC(CS_BUTTON_VALUE_CCC1,
-                app_env_cs.button_to_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_BUTTON_VALUE_USR_DSCP1,
-                      sizeof(CS_BUTTON_CHAR_NAME) - 1,
-                      CS_BUTTON_CHAR_NAME,
-                      NULL),
-
-    // From the BLE Vent Transfer
-    CS_CHAR_UUID_128(CS_VENT_VALUE_CHAR1,
-                     CS_VENT_VALUE_VAL1,
-                     CS_CHAR_VENT_UUID,
-                     PERM(RD, ENABLE) | PERM(WRITE_REQ, ENABLE) | PERM(WRITE_COMMAND, ENABLE),
-                     sizeof(app_env_cs.vent_from_air_buffer),
-                     app_env_cs.vent_from_air_buffer,
-                     CUSTOMSS_VentCharCallback),
-    CS_CHAR_CCC(CS_VENT_VALUE_CCC1,
-                app_env_cs.vent_from_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_VENT_VALUE_USR_DSCP1,
-                      sizeof(CS_VENT_CHAR_NAME) - 1,
-                      CS_VENT_CHAR_NAME,
-                      NULL),
-
-    // To the BLE Humidity transfer
-    CS_CHAR_UUID_128(CS_HUM_VALUE_CHAR1,
-                     CS_HUM_VALUE_VAL1,
-                     CS_CHAR_HUM_UUID,
-                     PERM(RD, ENABLE) | PERM(NTF, ENABLE),
-                     sizeof(app_env_cs.hum_to_air_buffer),
-                     app_env_cs.hum_to_air_buffer, NULL),
-    CS_CHAR_CCC(CS_HUM_VALUE_CCC1,
-                app_env_cs.hum_to_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_HUM_VALUE_USR_DSCP1,
-                      sizeof(CS_HUM_CHAR_NAME) - 1,
-                      CS_HUM_CHAR_NAME,
-                      NULL),
-
-    // To the BLE Temperature transfer
-    CS_CHAR_UUID_128(CS_TEMP_VALUE_CHAR1,
-                     CS_TEMP_VALUE_VAL1,
-                     CS_CHAR_TEMP_UUID,
-                     PERM(RD, ENABLE) | PERM(NTF, ENABLE),
-                     sizeof(app_env_cs.temp_to_air_buffer),
-                     app_env_cs.temp_to_air_buffer, NULL),
-    CS_CHAR_CCC(CS_TEMP_VALUE_CCC1,
-                app_env_cs.temp_to_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_TEMP_VALUE_USR_DSCP1,
-                      sizeof(CS_TEMP_CHAR_NAME) - 1,
-                      CS_TEMP_CHAR_NAME,
-                      NULL),
-
-    // From the BLE Temperature Upper Threshold transfer
-    CS_CHAR_UUID_128(CS_TEMP_UTHR_VALUE_CHAR1,
-                     CS_TEMP_UTHR_VALUE_VAL1,
-                     CS_CHAR_TEMP_UTHR_UUID,
-                     PERM(RD, ENABLE) | PERM(WRITE_REQ, ENABLE) | PERM(WRITE_COMMAND, ENABLE),
-                     sizeof(app_env_cs.temp_uthr_from_air_buffer),
-                     app_env_cs.temp_uthr_from_air_buffer,
-                     CUSTOMSS_TempUTHRCharCallback),
-    CS_CHAR_CCC(CS_TEMP_UTHR_VALUE_CCC1,
-                app_env_cs.temp_uthr_from_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_TEMP_UTHR_VALUE_USR_DSCP1,
-                      sizeof(CS_TEMP_UTHR_CHAR_NAME) - 1,
-                      CS_TEMP_UTHR_CHAR_NAME,
-                      NULL),
-
-    // From the BLE Temperature Lower Threshold transfer
-    CS_CHAR_UUID_128(CS_TEMP_LTHR_VALUE_CHAR1,
-                     CS_TEMP_LTHR_VALUE_VAL1,
-                     CS_CHAR_TEMP_LTHR_UUID,
-                     PERM(RD, ENABLE) | PERM(WRITE_REQ, ENABLE) | PERM(WRITE_COMMAND, ENABLE),
-                     sizeof(app_env_cs.temp_lthr_from_air_buffer),
-                     app_env_cs.temp_lthr_from_air_buffer,
-                     CUSTOMSS_TempLTHRCharCallback),
-    CS_CHAR_CCC(CS_TEMP_LTHR_VALUE_CCC1,
-                app_env_cs.temp_lthr_from_air_cccd_value,
-                NULL),
-    CS_CHAR_USER_DESC(CS_TEMP_LTHR_VALUE_USR_DSCP1,
-                      sizeof(CS_TEMP_LTHR_CHAR_NAME) - 1,
-                      CS_TEMP_LTHR_CHAR_NAME,
-                      NULL),
+    CS_SVC1_MANIFEST(CS_ATT_ENTRY)
 };
 
 static uint32_t notifyOnTimeout;
 static uint8_t val_notif = 0;
 static uint8_t button_value = 0;
-static uint8_t gpio0_pressed = 0;
+
+// Snapshot read waiting for a new sample, by link (ATT allows one request
+// at a time per connection), 0 if none
+static uint16_t pending_read_handle[BLE_CONNECTION_MAX];
 
 /* ----------------------------------------------------------------------------
  * Function definitions
  * --------------------------------------------------------------------------*/
 
+/* Function      : CUSTOMSS_SensorNotifyEnabled
+ *
+ * Description   : Check whether any of the sensor characteristics has
+ *                 notifications enabled.
+ *
+ * Parameters    : None
+ *
+ * Returns       : bool : true if a sample would be sent to someone
+ */
+static bool CUSTOMSS_SensorNotifyEnabled(void)
+{
+    return (app_env_cs.ccc.BATTERY_cccd[0] == ATT_CCC_START_NTF) ||
+           (app_env_cs.ccc.HUM_cccd[0] == ATT_CCC_START_NTF) ||
+           (app_env_cs.ccc.TEMP_cccd[0] == ATT_CCC_START_NTF);
+}
+
+/* Function      : CUSTOMSS_SnapshotField
+ *
+ * Description   : Find the snapshot value served for an attribute handle.
+ *
+ * Parameters    : uint16_t handle  : attribute handle
+ *                 uint16_t *offset : snapshot byte offset, set if found
+ *                 uint16_t *length : value length, set if found
+ *
+ * Returns       : bool : true if the handle is a snapshot characteristic
+ *                        value
+ */
+static bool CUSTOMSS_SnapshotField(uint16_t handle, uint16_t *offset, uint16_t *length)
+{
+    if (handle == GATTM_GetHandle(CUST_SVC1, CS_BATTERY_VALUE_VAL1)) {
+        *offset = SNAPSHOT_BATTERY;
+        *length = CS_BATTERY_MAX_LENGTH;
+    } else if (handle == GATTM_GetHandle(CUST_SVC1, CS_HUM_VALUE_VAL1)) {
+        *offset = SNAPSHOT_HUMIDITY;
+        *length = CS_HUMIDITY_MAX_LENGTH;
+    } else if (handle == GATTM_GetHandle(CUST_SVC1, CS_TEMP_VALUE_VAL1)) {
+        *offset = SNAPSHOT_TEMPERATURE;
+        *length = CS_TEMPERATURE_MAX_LENGTH;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/* Function      : CUSTOMSS_SnapshotReadCfm
+ *
+ * Description   : Confirm a read of a snapshot characteristic with the
+ *                 value in the active snapshot.
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t handle : attribute handle read
+ *
+ * Returns       : None
+ */
+static void CUSTOMSS_SnapshotReadCfm(uint8_t conidx, uint16_t handle)
+{
+    struct gattc_read_cfm *cfm;
+    uint16_t offset;
+    uint16_t length;
+
+    PROFILE_SCOPE(CUSTOMSS_SNAPSHOT);
+
+    if (!CUSTOMSS_SnapshotField(handle, &offset, &length)) {
+        return;
+    }
+
+    cfm = KE_MSG_ALLOC_DYN(GATTC_READ_CFM, KE_BUILD_ID(TASK_GATTC, conidx),
+                           KE_BUILD_ID(TASK_APP, conidx), gattc_read_cfm, length);
+    cfm->handle = handle;
+    cfm->length = length;
+    cfm->status = ATT_ERR_NO_ERROR;
+    Snapshot_Read(offset, cfm->value, length);
+    ke_msg_send(cfm);
+}
+
 const struct att_db_desc * CUSTOMSS_GetDatabaseDescription(uint8_t att_db_cs_svc_id)
 {
     switch (att_db_cs_svc_id) {
@@ -274,29 +199,25 @@ void CUSTOMSS_Initialize(void)
 {
     memset(&app_env_cs, '\0', sizeof(struct app_env_tag_cs));
 
-    app_env_cs.battery_to_air_cccd_value[0] = ATT_CCC_START_NTF;
-    app_env_cs.battery_to_air_cccd_value[1] = 0x00;
-
-    app_env_cs.button_to_air_cccd_value[0] = ATT_CCC_START_NTF;
-    app_env_cs.button_to_air_cccd_value[1] = 0x00;
+    // Server-initiated notifications are on from the start for the sensor
+    // characteristics (see the ccc column of the manifest)
+    CS_SVC0_MANIFEST(CS_CCC_INIT)
+    CS_SVC1_MANIFEST(CS_CCC_INIT)
 
-    app_env_cs.hum_to_air_cccd_value[0] = ATT_CCC_START_NTF;
-    app_env_cs.hum_to_air_cccd_value[1] = 0x00;
-
-    app_env_cs.temp_to_air_cccd_value[0] = ATT_CCC_START_NTF;
-    app_env_cs.temp_to_air_cccd_value[1] = 0x00;
+    // Little endian, the sampler starts with the same default
+    app_env_cs.value.MAX_AGE_buffer[0] = (uint8_t)(SENSOR_MAX_AGE_DEFAULT_S & 0xFF);
+    app_env_cs.value.MAX_AGE_buffer[1] = (uint8_t)(SENSOR_MAX_AGE_DEFAULT_S >> 8);
 
     notifyOnTimeout = 0;
-
-    MsgHandler_Add(GATTM_ADD_SVC_RSP, CUSTOMSS_MsgHandler);
-    MsgHandler_Add(CUSTOMSS_NTF_TIMEOUT, CUSTOMSS_MsgHandler);
-    MsgHandler_Add(CUSTOM_BUTTON_NTF, CUSTOMSS_MsgHandler);
-    MsgHandler_Add(GATTC_CMP_EVT, CUSTOMSS_MsgHandler);
+    memset(pending_read_handle, 0, sizeof(pending_read_handle));
 }
 
-void CUSTOMSS_NotifyOnTimeout(uint32_t timeout)
+void CUSTOMSS_NotifyOnTimeout(uint32_t timeout, bool save)
 {
     notifyOnTimeout = timeout;
+    if (save) {
+        KV_Set(KV_NTF_INTERVAL, &timeout);
+    }
 
     for (uint8_t i = 0; i < BLE_CONNECTION_MAX; i++) {
         if (GATT_GetEnv()->cust_svc_db[0].cust_svc_start_hdl && timeout) {
@@ -324,321 +245,639 @@ void CUSTOMSS_MsgHandler(ke_msg_id_t const msg_id, void const *param,
         break;
         case CUSTOMSS_NTF_TIMEOUT: {
             uint8_t conidx = KE_IDX_GET(dest_id);
-            memset(&app_env_cs.from_air_buffer[0], val_notif, CS_VALUE_MAX_LENGTH);
-
-            // Update the sensor variables
-            sensor_measurement();
+            memset(&app_env_cs.value.RX_buffer[0], val_notif, CS_VALUE_MAX_LENGTH);
 
-            // Update the buffers
-            memset(&app_env_cs.battery_to_air_buffer[0], battery_level, CS_BATTERY_MAX_LENGTH);
-            memcpy(app_env_cs.temp_to_air_buffer, temperature_reading.bytes, CS_TEMPERATURE_MAX_LENGTH);
-            memcpy(app_env_cs.hum_to_air_buffer, humidity_reading.bytes, CS_HUMIDITY_MAX_LENGTH);
+            // Sample only while someone consumes the readings, they are
+            // notified from SENSOR_SAMPLE_IND once the conversion is done
+            if (CUSTOMSS_SensorNotifyEnabled() && GAPC_IsConnectionActive(conidx)) {
+                Sensor_Request();
+            }
 
-            if ((app_env_cs.from_air_cccd_value[0] == ATT_CCC_START_NTF &&
-                 app_env_cs.from_air_cccd_value[1] == 0x00)
+            if ((app_env_cs.ccc.RX_cccd[0] == ATT_CCC_START_NTF &&
+                 app_env_cs.ccc.RX_cccd[1] == 0x00)
                 && GAPC_IsConnectionActive(conidx))
             {
                 // Send notification to peer device
-                GATTC_SendEvtCmd(conidx, GATTC_NOTIFY, 0, GATTM_GetHandle(CUST_SVC0, CS_RX_VALUE_VAL0),
-                                 CS_VALUE_MAX_LENGTH, app_env_cs.from_air_buffer);
+                NtfQueue_Push(conidx, GATTC_NOTIFY, GATTM_GetHandle(CUST_SVC0, CS_RX_VALUE_VAL0),
+                              CS_VALUE_MAX_LENGTH, app_env_cs.value.RX_buffer);
                 val_notif++;
-                swmLogInfo("\n__CUSTOMSS notifying peer device %d\r\n", conidx);
+                APP_LOG_DEBUG("__CUSTOMSS notifying peer device %d\r\n", conidx);
             }
 
-            if (app_env_cs.from_air_cccd_value_long[1] == 0x00 && GAPC_IsConnectionActive(conidx)) {
-                // Update RX long characteristic with the inverted version of
-                // TX long characteristic
-                for (uint8_t i = 0; i < CS_LONG_VALUE_MAX_LENGTH; i++) {
-                    app_env_cs.from_air_buffer_long[i] = 0xFF ^ app_env_cs.to_air_buffer_long[i];
-                }
+            if (notifyOnTimeout) {   // Restart timer
+                ke_timer_set(CUSTOMSS_NTF_TIMEOUT, KE_BUILD_ID(TASK_APP, conidx),
+                             notifyOnTimeout);
+            }
+        }
+        break;
+        case GATTC_READ_REQ_IND: {
+            const struct gattc_read_req_ind *p = param;
+            uint8_t conidx = KE_IDX_GET(src_id);
+            uint16_t offset;
+            uint16_t length;
+
+            // Other attributes are served through their callback
+            if (!CUSTOMSS_SnapshotField(p->handle, &offset, &length)) {
+                break;
+            }
 
-                if (app_env_cs.from_air_cccd_value_long[0] == ATT_CCC_START_IND) {
-                    // Send indication to peer device
-                    GATTC_SendEvtCmd(conidx, GATTC_INDICATE, 0, GATTM_GetHandle(CUST_SVC0, CS_RX_LONG_VALUE_VAL0),
-                                     CS_LONG_VALUE_MAX_LENGTH, app_env_cs.from_air_buffer_long);
+            // A sample older than the max age is never served, the read is
+            // confirmed from SENSOR_SAMPLE_IND once a new one is published
+            if (Sensor_IsFresh()) {
+                CUSTOMSS_SnapshotReadCfm(conidx, p->handle);
+            } else {
+                pending_read_handle[conidx] = p->handle;
+                Sensor_Request();
+            }
+        }
+        break;
+        case GAPC_DISCONNECT_IND: {
+            pending_read_handle[KE_IDX_GET(src_id)] = 0;
+        }
+        break;
+        case SENSOR_SAMPLE_IND: {
+            // The snapshot stays valid until the next sample on this task,
+            // the notifications point straight into it
+            const struct sensor_snapshot_t *snap = Snapshot_Get();
+
+            // Auto open/close the vent if the thresholds are active, through
+            // vent_update like a client or group command
+            vent_threshold_check();
+
+            for (uint8_t conidx = 0; conidx < BLE_CONNECTION_MAX; conidx++) {
+                // Answer a read waiting for this sample
+                if (pending_read_handle[conidx] != 0) {
+                    CUSTOMSS_SnapshotReadCfm(conidx, pending_read_handle[conidx]);
+                    pending_read_handle[conidx] = 0;
                 }
 
-                if (app_env_cs.from_air_cccd_value_long[0] == ATT_CCC_START_NTF) {
+                // Transmit the Battery Level data
+                if ((app_env_cs.ccc.BATTERY_cccd[0] == ATT_CCC_START_NTF &&
+                     app_env_cs.ccc.BATTERY_cccd[1] == 0x00)
+                    && GAPC_IsConnectionActive(conidx))
+                {
                     // Send notification to peer device
-                    GATTC_SendEvtCmd(conidx, GATTC_NOTIFY, 0, GATTM_GetHandle(CUST_SVC0, CS_RX_LONG_VALUE_VAL0),
-                                     CS_LONG_VALUE_MAX_LENGTH, app_env_cs.from_air_buffer_long);
+                    NtfQueue_Push(conidx, GATTC_NOTIFY, GATTM_GetHandle(CUST_SVC1, CS_BATTERY_VALUE_VAL1),
+                                  CS_BATTERY_MAX_LENGTH, &snap->battery);
                 }
-            }
-
-            // Transmit the Battery Level data
-            if ((app_env_cs.battery_to_air_cccd_value[0] == ATT_CCC_START_NTF &&
-                 app_env_cs.battery_to_air_cccd_value[1] == 0x00)
-                && GAPC_IsConnectionActive(conidx))
-            {
-                // Send notification to peer device
-                GATTC_SendEvtCmd(conidx, GATTC_NOTIFY, 0, GATTM_GetHandle(CUST_SVC1, CS_BATTERY_VALUE_VAL1),
-                                 CS_BATTERY_MAX_LENGTH, app_env_cs.battery_to_air_buffer);
-            }
-
-            // Transmit the Humidity data
-            if ((app_env_cs.hum_to_air_cccd_value[0] == ATT_CCC_START_NTF &&
-                 app_env_cs.hum_to_air_cccd_value[1] == 0x00)
-                && GAPC_IsConnectionActive(conidx))
-            {
-                // Send notification to peer device
-                GATTC_SendEvtCmd(conidx, GATTC_NOTIFY, 0, GATTM_GetHandle(CUST_SVC1, CS_HUM_VALUE_VAL1),
-                                 CS_HUMIDITY_MAX_LENGTH, app_env_cs.hum_to_air_buffer);
-            }
 
-            // Transmit the Temperature data
-            if ((app_env_cs.temp_to_air_cccd_value[0] == ATT_CCC_START_NTF &&
-                 app_env_cs.temp_to_air_cccd_value[1] == 0x00)
-                && GAPC_IsConnectionActive(conidx))
-            {
-                // Send notification to peer device
-                GATTC_SendEvtCmd(conidx, GATTC_NOTIFY, 0, GATTM_GetHandle(CUST_SVC1, CS_TEMP_VALUE_VAL1),
-                                 CS_TEMPERATURE_MAX_LENGTH, app_env_cs.temp_to_air_buffer);
-            }
+                // Transmit the Humidity data
+                if ((app_env_cs.ccc.HUM_cccd[0] == ATT_CCC_START_NTF &&
+                     app_env_cs.ccc.HUM_cccd[1] == 0x00)
+                    && GAPC_IsConnectionActive(conidx))
+                {
+                    // Send notification to peer device
+                    NtfQueue_Push(conidx, GATTC_NOTIFY, GATTM_GetHandle(CUST_SVC1, CS_HUM_VALUE_VAL1),
+                                  CS_HUMIDITY_MAX_LENGTH, (const uint8_t *)&snap->humidity);
+                }
 
-            if (notifyOnTimeout) {   // Restart timer
-                ke_timer_set(CUSTOMSS_NTF_TIMEOUT, KE_BUILD_ID(TASK_APP, conidx),
-                             notifyOnTimeout);
+                // Transmit the Temperature data
+                if ((app_env_cs.ccc.TEMP_cccd[0] == ATT_CCC_START_NTF &&
+                     app_env_cs.ccc.TEMP_cccd[1] == 0x00)
+                    && GAPC_IsConnectionActive(conidx))
+                {
+                    // Send notification to peer device
+                    NtfQueue_Push(conidx, GATTC_NOTIFY, GATTM_GetHandle(CUST_SVC1, CS_TEMP_VALUE_VAL1),
+                                  CS_TEMPERATURE_MAX_LENGTH, (const uint8_t *)&snap->temperature);
+                }
             }
         }
         break;
         case CUSTOM_BUTTON_NTF: {
             uint8_t conidx = KE_IDX_GET(dest_id);
-            memset(&app_env_cs.button_to_air_buffer[0], button_value,
+            memset(&app_env_cs.value.BUTTON_buffer[0], button_value,
                    CS_LED_BUTTON_MAX_LENGTH);
-            if ((app_env_cs.button_to_air_cccd_value[0] == ATT_CCC_START_NTF
-                 && app_env_cs.button_to_air_cccd_value[1] == 0x00)
+            if ((app_env_cs.ccc.BUTTON_cccd[0] == ATT_CCC_START_NTF
+                 && app_env_cs.ccc.BUTTON_cccd[1] == 0x00)
                 && GAPC_IsConnectionActive(conidx))
             {
                 // Send notification to peer device
-                GATTC_SendEvtCmd(conidx, GATTC_NOTIFY, 0,
-                                 GATTM_GetHandle(CUST_SVC1, CS_BUTTON_VALUE_VAL1),
-                                 CS_LED_BUTTON_MAX_LENGTH,
-                                 app_env_cs.button_to_air_buffer);
+                NtfQueue_Push(conidx, GATTC_NOTIFY,
+                              GATTM_GetHandle(CUST_SVC1, CS_BUTTON_VALUE_VAL1),
+                              CS_LED_BUTTON_MAX_LENGTH,
+                              app_env_cs.value.BUTTON_buffer);
             }
         }
         break;
-    }
-}
+        case CUSTOMSS_VENT_CMD: {
+            const struct customss_write_cmd *p = param;
 
-void GPIO0_Pressed_Flag_Clear(void)
-{
-	gpio0_pressed = 0;
-}
+            // Store the new state to the global variable and move the vent
+            *vent_state = p->value[0];
+            APP_LOG_INFO("__CUSTOMSS vent state (%d)\r\n", *vent_state);
+            vent_update();
+        }
+        break;
+        case CUSTOMSS_LED_CMD: {
+            const struct customss_write_cmd *p = param;
+
+            if (p->value[0] == 0) {
+                set_vent_state(VENT_OPEN_STATE);
+                Sys_GPIO_Set_High(LED_STATE_GPIO);    // Turn LED off
+            } else {
+                set_vent_state(VENT_CLOSED_STATE);
+                Sys_GPIO_Set_Low(LED_STATE_GPIO);    // Turn LED on
+            }
+        }
+        break;
+        case CUSTOMSS_TEMP_UTHR_CMD: {
+            const struct customss_write_cmd *p = param;
+
+            // Thresholds are only changed from the app task, where
+            // vent_threshold_check runs on every sample (SENSOR_SAMPLE_IND)
+            memcpy(temperature_upper_threshold.bytes, p->value, CS_TEMPERATURE_MAX_LENGTH);
+            KV_Set(KV_UPPER_THRESHOLD, &temperature_upper_threshold.value);
+            Adv_Kick();
+        }
+        break;
+        case CUSTOMSS_TEMP_LTHR_CMD: {
+            const struct customss_write_cmd *p = param;
 
-uint8_t GPIO0_Pressed(void)
-{
-	return gpio0_pressed;
+            memcpy(temperature_lower_threshold.bytes, p->value, CS_TEMPERATURE_MAX_LENGTH);
+            KV_Set(KV_LOWER_THRESHOLD, &temperature_lower_threshold.value);
+            Adv_Kick();
+        }
+        break;
+        case CUSTOMSS_ZONE_CMD: {
+            const struct customss_write_cmd *p = param;
+
+            Group_SetZone(p->value[0]);
+        }
+        break;
+    }
 }
 
-void GPIO0_IRQHandler(void)
+void CUSTOMSS_ButtonTask(uint32_t pressed)
 {
-    static uint8_t button_pressed = 0;
-    static uint8_t LED_state = 0;
-
-    if (button_pressed == 1) {
-        // If GPIO0 has just been disconnected from the ground
-        // (SW1 pushbutton on the evaluation board has just been released)
+    if (pressed == 0) {
+        // SW1 pushbutton has just been released
 
-        button_pressed = 0;
         button_value = 0;
 
         // Clear timers and restore LED state when button is released
         ke_timer_clear(APP_SW1_TIMEOUT, TASK_APP);
         ke_timer_clear(APP_SW1LED_TIMEOUT, TASK_APP);
 
-        LED_state = app_env_cs.led_from_air_buffer[0];
-
-        if (LED_state == 0) {
+        if (app_env_cs.value.LED_buffer[0] == 0) {
             // Turn off LED
             Sys_GPIO_Set_High(LED_STATE_GPIO);
         } else {
             // Turn on LED
             Sys_GPIO_Set_Low(LED_STATE_GPIO);
         }
-    } else if (Sys_GPIO_Read(BUTTON_GPIO) == 0) {
-        // If GPIO0 has just been connected to the ground
-        // (SW1 pushbutton on the evaluation board has just been pressed)
+    } else {
+        // SW1 pushbutton has just been pressed
 
-        button_pressed = 1;
         button_value = 1;
 
         // Clear bond list after CLR_BDLST_HOLD_DURATION_S seconds
         ke_timer_set(APP_SW1_TIMEOUT, TASK_APP, TIMER_SETTING_S(CLR_BONDLIST_HOLD_DURATION_S));
     }
-    gpio0_pressed = 1;
+
+    // Notify the new button state on every link, let a disconnected hub
+    // find the vent quickly
+    for (unsigned int i = 0; i < BLE_CONNECTION_MAX; i++) {
+        if (GAPC_IsConnectionActive(i)) {
+            ke_msg_send_basic(CUSTOM_BUTTON_NTF, KE_BUILD_ID(TASK_APP, i), KE_BUILD_ID(TASK_APP, i));
+        }
+    }
+    Adv_Kick();
+}
+
+void GPIO0_IRQHandler(void)
+{
+    static uint8_t button_pressed = 0;
+
+    if (button_pressed == 1) {
+        // If GPIO0 has just been disconnected from the ground
+        // (SW1 pushbutton on the evaluation board has just been released)
+        button_pressed = 0;
+    } else if (Sys_GPIO_Read(BUTTON_GPIO) == 0) {
+        // If GPIO0 has just been connected to the ground
+        // (SW1 pushbutton on the evaluation board has just been pressed)
+        button_pressed = 1;
+    }
+
+    // The kernel is not interrupt safe, the main loop does the rest
+    AppSched_Post(APP_SCHED_BUTTON, button_pressed);
 }
 
-/* Function      : print_large_buffer
+/* Function      : CUSTOMSS_ValidateState
  *
- * Description   : Use swmLogInfo for 10 Bytes of data at time.
- *                 remaining byte/s will be printed in string format to avoid
- *                 use of swmLogInfo for individual byte
- *                 This will result in reduce overhead for UART
+ * Description   : Check a value written to a one byte open/closed (or
+ *                 off/on) characteristic.
  *
- * Parameters    : const uint8_t *buffer : data buffer
- *                 uint16_t length       : length of data
+ * Parameters    : const uint8_t *value : value written
+ *                 uint16_t length      : length written
  *
- * Returns       : None
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if valid, an ATT error otherwise
  */
-static void print_large_buffer(const uint8_t *buffer, uint16_t length)
+static uint8_t CUSTOMSS_ValidateState(const uint8_t *value, uint16_t length)
 {
-    unsigned int num_of_blocks = (length / 10);
-    unsigned int rem_bytes = ((num_of_blocks) ? (length % 10) : length);
-
-    for (int i = 0; i < num_of_blocks; i++) {
-        int j = (i * 10);
-        swmLogInfo("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x ", buffer[j],
-                   buffer[j + 1], buffer[j + 2], buffer[j + 3],
-                   buffer[j + 4], buffer[j + 5], buffer[j + 6],
-                   buffer[j + 7], buffer[j + 8], buffer[j + 9]);
+    if (length != CS_LED_BUTTON_MAX_LENGTH) {
+        return ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN;
     }
 
-    if (rem_bytes) {
-        int j = (num_of_blocks * 10);
-        char temp_string[28] = { 0 };
-        uint8_t index = 0;
+    if (value[0] > 1) {
+        return ATT_ERR_APP_ERROR;
+    }
 
-        for (int i = j; i < length; i++) {
-            sprintf(&temp_string[index], "%02x", buffer[i]);
-            index += 2;
+    return ATT_ERR_NO_ERROR;
+}
 
-            // put space before next data
-            temp_string[index] = 0x20;
-            index += 1;
-        }
+/* Function      : CUSTOMSS_ValidateThreshold
+ *
+ * Description   : Check a value written to a temperature threshold
+ *                 characteristic (32-bit float). Anything from
+ *                 CS_TEMP_THRESHOLD_MIN up is accepted, values at or above
+ *                 THRESHOLD_OFF_LIMIT turn the threshold off.
+ *
+ * Parameters    : const uint8_t *value : value written
+ *                 uint16_t length      : length written
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if valid, an ATT error otherwise
+ */
+static uint8_t CUSTOMSS_ValidateThreshold(const uint8_t *value, uint16_t length)
+{
+    EncodedFloat threshold;
+
+    if (length != CS_TEMPERATURE_MAX_LENGTH) {
+        return ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN;
+    }
 
-        swmLogInfo("%s ", temp_string);
+    memcpy(threshold.bytes, value, CS_TEMPERATURE_MAX_LENGTH);
+
+    // NaN fails both comparisons
+    if (!(threshold.value >= CS_TEMP_THRESHOLD_MIN)) {
+        return ATT_ERR_APP_ERROR;
     }
 
-    swmLogInfo("\r\n");
+    return ATT_ERR_NO_ERROR;
 }
 
+/* Function      : CUSTOMSS_PostWrite
+ *
+ * Description   : Post a validated write to the application task so its
+ *                 side effect runs after the write response is sent.
+ *
+ * Parameters    : uint8_t conidx       : connection index
+ *                 ke_msg_id_t msg_id   : deferred write message
+ *                 const uint8_t *value : value written
+ *                 uint16_t length      : length written
+ *
+ * Returns       : None
+ */
+static void CUSTOMSS_PostWrite(uint8_t conidx, ke_msg_id_t msg_id,
+                               const uint8_t *value, uint16_t length)
+{
+    struct customss_write_cmd *cmd = KE_MSG_ALLOC(msg_id, KE_BUILD_ID(TASK_APP, conidx),
+                                                  KE_BUILD_ID(TASK_APP, conidx),
+                                                  customss_write_cmd);
+
+    memset(cmd->value, 0, sizeof(cmd->value));
+    memcpy(cmd->value, value, (length < sizeof(cmd->value)) ? length : sizeof(cmd->value));
+    ke_msg_send(cmd);
+}
 
 uint8_t CUSTOMSS_RXCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
                                 uint8_t *to, const uint8_t *from,
                                 uint16_t length, uint16_t operation, uint8_t hl_status)
 {
+    PROFILE_SCOPE(CUSTOMSS_RX);
+
     if (hl_status == GAP_ERR_NO_ERROR) {
         memcpy(to, from, length);
-        swmLogInfo("\nRXCharCallback (%d):(%d) ", conidx, length);
-        print_large_buffer(app_env_cs.from_air_buffer, length);
+        APP_LOG_INFO("RXCharCallback (%d):(%d)\r\n", conidx, length);
+        APP_LOG_INFO_BUFFER("RX data (%d):", app_env_cs.value.RX_buffer, length);
         return ATT_ERR_NO_ERROR;
     } else {
-        swmLogInfo("\nRXCharCallback (%d): operation (%d): error(%d) \r\n", conidx, operation, hl_status);
+        APP_LOG_WARN("RXCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
         return hl_status;
     }
 }
 
 
-uint8_t CUSTOMSS_RXLongCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
-                                    uint8_t *to, const uint8_t *from,
-                                    uint16_t length, uint16_t operation, uint8_t hl_status)
+uint8_t CUSTOMSS_LEDCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                 uint8_t *to, const uint8_t *from,
+                                 uint16_t length, uint16_t operation, uint8_t hl_status)
 {
+    PROFILE_SCOPE(CUSTOMSS_LED);
+
     if (hl_status == GAP_ERR_NO_ERROR) {
-        memcpy(to, from, length);
-        swmLogInfo("\nRXLongCharCallback (%d):(%d) ", conidx, length);
+        if (operation == GATTC_WRITE_REQ_IND) {
+            uint8_t status = CUSTOMSS_ValidateState(from, length);
 
-        // Update RX long characteristic with the inverted version of
-        // TX long characteristic just received
-        if (operation == GATTC_READ_REQ_IND) {
-            for (uint8_t i = 0; i < CS_LONG_VALUE_MAX_LENGTH; i++) {
-                app_env_cs.from_air_buffer_long[i] = 0xFF ^ app_env_cs.to_air_buffer_long[i];
+            if (status != ATT_ERR_NO_ERROR) {
+                return status;
             }
         }
 
-        print_large_buffer(app_env_cs.from_air_buffer_long, length);
+        memcpy(to, from, length);
+
+        if (operation == GATTC_WRITE_REQ_IND) {
+            // Commands arrive in bursts, keep the link on short intervals
+            ConnPolicy_RequestActive(conidx);
+            CUSTOMSS_PostWrite(conidx, CUSTOMSS_LED_CMD, from, length);
+        }
+
         return ATT_ERR_NO_ERROR;
     } else {
-        swmLogInfo("\nRXLongCharCallback (%d): operation (%d): error(%d) \r\n", conidx, operation, hl_status);
+        APP_LOG_WARN("LEDCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
         return hl_status;
     }
 }
 
 
-uint8_t CUSTOMSS_LEDCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
-                                 uint8_t *to, const uint8_t *from,
-                                 uint16_t length, uint16_t operation, uint8_t hl_status)
+
+uint8_t CUSTOMSS_TempUTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                      uint8_t *to, const uint8_t *from,
+                                      uint16_t length, uint16_t operation, uint8_t hl_status)
 {
+    PROFILE_SCOPE(CUSTOMSS_TEMP_UTHR);
+
     if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_WRITE_REQ_IND) {
+            uint8_t status = CUSTOMSS_ValidateThreshold(from, length);
+
+            if (status != ATT_ERR_NO_ERROR) {
+                return status;
+            }
+        }
+
         memcpy(to, from, length);
-        // TODO: remove this from the function after testing is complete
-        // Store buffer to global variable
-        //*vent_state = app_env_cs.vent_from_air_buffer[0];
 
-        // Update the vent with the new state
-        //vent_update();
+        if (operation == GATTC_WRITE_REQ_IND) {
+            // Commands arrive in bursts, keep the link on short intervals
+            ConnPolicy_RequestActive(conidx);
+            CUSTOMSS_PostWrite(conidx, CUSTOMSS_TEMP_UTHR_CMD, from, length);
+        }
+
+        return ATT_ERR_NO_ERROR;
+    } else {
+        APP_LOG_WARN("LEDCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
+        return hl_status;
+    }
+}
+
+uint8_t CUSTOMSS_TempLTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                      uint8_t *to, const uint8_t *from,
+                                      uint16_t length, uint16_t operation, uint8_t hl_status)
+{
+    PROFILE_SCOPE(CUSTOMSS_TEMP_LTHR);
+
+    if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_WRITE_REQ_IND) {
+            uint8_t status = CUSTOMSS_ValidateThreshold(from, length);
 
-        if (app_env_cs.led_from_air_buffer[0] == 0) {
-            set_vent_state(VENT_OPEN_STATE);
-            Sys_GPIO_Set_High(LED_STATE_GPIO);    // Turn LED off
-        } else if (app_env_cs.led_from_air_buffer[0] == 1) {
-            set_vent_state(VENT_CLOSED_STATE);
-            Sys_GPIO_Set_Low(LED_STATE_GPIO);    // Turn LED on
+            if (status != ATT_ERR_NO_ERROR) {
+                return status;
+            }
+        }
+
+        memcpy(to, from, length);
+
+        if (operation == GATTC_WRITE_REQ_IND) {
+            // Commands arrive in bursts, keep the link on short intervals
+            ConnPolicy_RequestActive(conidx);
+            CUSTOMSS_PostWrite(conidx, CUSTOMSS_TEMP_LTHR_CMD, from, length);
         }
+
         return ATT_ERR_NO_ERROR;
     } else {
-        swmLogInfo("\nLEDCharCallback (%d): operation (%d): error(%d) \r\n", conidx, operation, hl_status);
+        APP_LOG_WARN("LEDCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
         return hl_status;
     }
 }
 
+uint8_t CUSTOMSS_VentCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                  uint8_t *to, const uint8_t *from,
+                                  uint16_t length, uint16_t operation, uint8_t hl_status)
+{
+    PROFILE_SCOPE(CUSTOMSS_VENT);
+
+    if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_WRITE_REQ_IND) {
+            uint8_t status = CUSTOMSS_ValidateState(from, length);
+
+            if (status != ATT_ERR_NO_ERROR) {
+                return status;
+            }
+        }
+
+        memcpy(to, from, length);
 
+        if (operation == GATTC_WRITE_REQ_IND) {
+            // Commands arrive in bursts, keep the link on short intervals
+            ConnPolicy_RequestActive(conidx);
+            CUSTOMSS_PostWrite(conidx, CUSTOMSS_VENT_CMD, from, length);
+        }
 
-uint8_t CUSTOMSS_TempUTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+        return ATT_ERR_NO_ERROR;
+    } else {
+        APP_LOG_WARN("LEDCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
+        return hl_status;
+    }
+}
+
+uint8_t CUSTOMSS_LinkInfoCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
                                       uint8_t *to, const uint8_t *from,
                                       uint16_t length, uint16_t operation, uint8_t hl_status)
 {
+    PROFILE_SCOPE(CUSTOMSS_LINK_INFO);
+
     if (hl_status == GAP_ERR_NO_ERROR) {
+        // Serve the values negotiated on the connection that is reading
+        if (operation == GATTC_READ_REQ_IND) {
+            Link_PackInfo(conidx, app_env_cs.value.LINK_INFO_buffer);
+        }
+
         memcpy(to, from, length);
-        // Store buffer to global variable
-        memcpy(temperature_upper_threshold.bytes, app_env_cs.temp_uthr_from_air_buffer, CS_TEMPERATURE_MAX_LENGTH);
+        return ATT_ERR_NO_ERROR;
+    } else {
+        APP_LOG_WARN("LinkInfoCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
+        return hl_status;
+    }
+}
+
+uint8_t CUSTOMSS_BattHealthCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                        uint8_t *to, const uint8_t *from,
+                                        uint16_t length, uint16_t operation, uint8_t hl_status)
+{
+    PROFILE_SCOPE(CUSTOMSS_BATT_HEALTH);
 
+    if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_READ_REQ_IND) {
+            Battery_PackHealth(app_env_cs.value.BATT_HEALTH_buffer);
+        }
+
+        memcpy(to, from, length);
         return ATT_ERR_NO_ERROR;
     } else {
-        swmLogInfo("\nLEDCharCallback (%d): operation (%d): error(%d) \r\n", conidx, operation, hl_status);
+        APP_LOG_WARN("BattHealthCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
         return hl_status;
     }
 }
 
-uint8_t CUSTOMSS_TempLTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+uint8_t CUSTOMSS_EnergyCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                    uint8_t *to, const uint8_t *from,
+                                    uint16_t length, uint16_t operation, uint8_t hl_status)
+{
+    PROFILE_SCOPE(CUSTOMSS_ENERGY);
+
+    if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_READ_REQ_IND) {
+            Energy_PackInfo(app_env_cs.value.ENERGY_buffer);
+        }
+
+        memcpy(to, from, length);
+        return ATT_ERR_NO_ERROR;
+    } else {
+        APP_LOG_WARN("EnergyCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
+        return hl_status;
+    }
+}
+
+uint8_t CUSTOMSS_ZoneIdCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                    uint8_t *to, const uint8_t *from,
+                                    uint16_t length, uint16_t operation, uint8_t hl_status)
+{
+    PROFILE_SCOPE(CUSTOMSS_ZONE_ID);
+
+    if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_WRITE_REQ_IND) {
+            if (length != CS_ZONE_ID_MAX_LENGTH) {
+                return ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN;
+            }
+
+            // GROUP_ZONE_ALL addresses every zone, no vent can be in it
+            if (from[0] == GROUP_ZONE_ALL) {
+                return ATT_ERR_APP_ERROR;
+            }
+        }
+
+        memcpy(to, from, length);
+
+        if (operation == GATTC_WRITE_REQ_IND) {
+            CUSTOMSS_PostWrite(conidx, CUSTOMSS_ZONE_CMD, from, length);
+        }
+
+        return ATT_ERR_NO_ERROR;
+    } else {
+        APP_LOG_WARN("ZoneIdCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
+        return hl_status;
+    }
+}
+
+uint8_t CUSTOMSS_GroupKeyCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
                                       uint8_t *to, const uint8_t *from,
                                       uint16_t length, uint16_t operation, uint8_t hl_status)
 {
+    uint32_t seq_floor;
+
+    PROFILE_SCOPE(CUSTOMSS_GROUP_KEY);
+
+    if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation != GATTC_WRITE_REQ_IND) {
+            return ATT_ERR_READ_NOT_PERMITTED;
+        }
+
+        if (length != CS_GROUP_KEY_MAX_LENGTH) {
+            return ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN;
+        }
+
+        // Plain state and a deferred flash write, safe from the callback
+        memcpy(&seq_floor, &from[GROUP_KEY_LENGTH], sizeof(seq_floor));
+        Group_SetKey(from, seq_floor);
+        return ATT_ERR_NO_ERROR;
+    } else {
+        APP_LOG_WARN("GroupKeyCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
+        return hl_status;
+    }
+}
+
+uint8_t CUSTOMSS_BenchCtrlCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                       uint8_t *to, const uint8_t *from,
+                                       uint16_t length, uint16_t operation, uint8_t hl_status)
+{
+    PROFILE_SCOPE(CUSTOMSS_BENCH_CTRL);
+
     if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_WRITE_REQ_IND) {
+            if (length != CS_BENCH_CTRL_MAX_LENGTH) {
+                return ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN;
+            }
+
+            if (!Bench_ValidateCommand(from, length)) {
+                return ATT_ERR_APP_ERROR;
+            }
+
+            // Tests that answer on BENCH_DATA need its notifications on
+            if ((from[0] == BENCH_OP_THROUGHPUT || from[0] == BENCH_OP_PING) &&
+                app_env_cs.ccc.BENCH_DATA_cccd[0] != ATT_CCC_START_NTF) {
+                return ATT_ERR_APP_ERROR;
+            }
+        }
+
         memcpy(to, from, length);
-        // Store buffer to global variable
-        memcpy(temperature_lower_threshold.bytes, app_env_cs.temp_lthr_from_air_buffer, CS_TEMPERATURE_MAX_LENGTH);
+
+        if (operation == GATTC_WRITE_REQ_IND) {
+            // Measure on short intervals, not on the idle ones
+            ConnPolicy_RequestActive(conidx);
+            Bench_Post(conidx, from);
+        }
 
         return ATT_ERR_NO_ERROR;
     } else {
-        swmLogInfo("\nLEDCharCallback (%d): operation (%d): error(%d) \r\n", conidx, operation, hl_status);
+        APP_LOG_WARN("BenchCtrlCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
         return hl_status;
     }
 }
 
-uint8_t CUSTOMSS_VentCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
-                                  uint8_t *to, const uint8_t *from,
-                                  uint16_t length, uint16_t operation, uint8_t hl_status)
+uint8_t CUSTOMSS_BenchResultCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                         uint8_t *to, const uint8_t *from,
+                                         uint16_t length, uint16_t operation, uint8_t hl_status)
 {
+    PROFILE_SCOPE(CUSTOMSS_BENCH_RESULT);
+
     if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_READ_REQ_IND) {
+            Bench_PackResult(app_env_cs.value.BENCH_RESULT_buffer);
+        }
+
         memcpy(to, from, length);
-        // Store buffer to global variable
-        *vent_state = app_env_cs.vent_from_air_buffer[0];
-        swmLogInfo("\nVentCharCallback (%d) \t operation (%d)\r\n", *vent_state, app_env_cs.vent_from_air_buffer[0]);
+        return ATT_ERR_NO_ERROR;
+    } else {
+        APP_LOG_WARN("BenchResultCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
+        return hl_status;
+    }
+}
 
-        // Update the vent with the new state
-        //vent_update();
-        //set_vent_state(*vent_state);
+uint8_t CUSTOMSS_MaxAgeCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                    uint8_t *to, const uint8_t *from,
+                                    uint16_t length, uint16_t operation, uint8_t hl_status)
+{
+    PROFILE_SCOPE(CUSTOMSS_MAX_AGE);
 
-        if (app_env_cs.vent_from_air_buffer[0] == 0) {
-            set_vent_state(VENT_OPEN_STATE);
-        } else if (app_env_cs.vent_from_air_buffer[0] == 1) {
-            set_vent_state(VENT_CLOSED_STATE);
+    if (hl_status == GAP_ERR_NO_ERROR) {
+        if (operation == GATTC_WRITE_REQ_IND) {
+            uint16_t max_age;
+
+            if (length != CS_MAX_AGE_MAX_LENGTH) {
+                return ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN;
+            }
+
+            max_age = (uint16_t)(from[0] | (from[1] << 8));
+            if (max_age > SENSOR_MAX_AGE_LIMIT_S) {
+                return ATT_ERR_APP_ERROR;
+            }
+
+            Sensor_SetMaxAge(max_age);
         }
 
+        memcpy(to, from, length);
         return ATT_ERR_NO_ERROR;
     } else {
-        swmLogInfo("\nLEDCharCallback (%d): operation (%d): error(%d) \r\n", conidx, operation, hl_status);
+        APP_LOG_WARN("MaxAgeCharCallback (%d): operation (%d): error(%d)\r\n", conidx, operation, hl_status);
         return hl_status;
     }
 }
@@ -0,0 +1,196 @@
+/******************************************************************************
+ * File Name        : app_dispatch.c
+ * Description      : This module implements the application message
+ *                    dispatcher (see app_dispatch.h).
+ *
+ *                    The table is constant; at initialization the rows of
+ *                    each message ID are linked in table order and the first
+ *                    row of each ID is placed in an open-addressed hash, so a
+ *                    dispatch costs one hash probe plus one call per handler
+ *                    of the message.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <ble_abstraction.h>
+#include <app.h>
+#include <app_dispatch.h>
+#include <app_cycles.h>
+#include <app_profile.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+typedef void (*app_dispatch_handler_t)(ke_msg_id_t const msg_id, void const *param,
+                                       ke_task_id_t const dest_id,
+                                       ke_task_id_t const src_id);
+
+struct app_dispatch_entry_t
+{
+    ke_msg_id_t msg_id;
+    app_dispatch_handler_t handler;
+    const char *name;
+};
+
+#define APP_DISPATCH_ENTRY(msg_id, handler)     { (msg_id), handler, #handler },
+
+static const struct app_dispatch_entry_t app_dispatch_table[] =
+{
+    APP_DISPATCH_TABLE(APP_DISPATCH_ENTRY)
+};
+
+#define APP_DISPATCH_ROWS               (sizeof(app_dispatch_table) / sizeof(app_dispatch_table[0]))
+#define APP_DISPATCH_NONE               (0xFF)
+
+_Static_assert(APP_DISPATCH_ROWS < APP_DISPATCH_NONE, "dispatch table too large");
+_Static_assert((APP_DISPATCH_BUCKETS & (APP_DISPATCH_BUCKETS - 1)) == 0,
+               "APP_DISPATCH_BUCKETS must be a power of two");
+_Static_assert(APP_DISPATCH_BUCKETS >= (2 * APP_DISPATCH_ROWS),
+               "APP_DISPATCH_BUCKETS too small for the dispatch table");
+
+// First row of each message ID, by hash of the ID
+static uint8_t dispatch_bucket[APP_DISPATCH_BUCKETS];
+
+// Next row with the same message ID
+static uint8_t dispatch_next[APP_DISPATCH_ROWS];
+
+static struct profile_stats_t dispatch_stats[APP_DISPATCH_ROWS];
+
+// Call count of each row at the last report
+static uint32_t dispatch_reported[APP_DISPATCH_ROWS];
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : AppDispatch_Hash
+ *
+ * Description   : Returns the home bucket of a message ID.
+ *
+ * Parameters    : ke_msg_id_t msg_id : Kernel message ID number
+ *
+ * Returns       : uint32_t : bucket index
+ */
+static inline uint32_t AppDispatch_Hash(ke_msg_id_t msg_id)
+{
+    return (((uint32_t)msg_id * 2654435761U) >> 16) & (APP_DISPATCH_BUCKETS - 1);
+}
+
+/* Function      : AppDispatch_Find
+ *
+ * Description   : Returns the bucket holding a message ID, or the empty
+ *                 bucket where it would be inserted.
+ *
+ * Parameters    : ke_msg_id_t msg_id : Kernel message ID number
+ *
+ * Returns       : uint32_t : bucket index
+ */
+static uint32_t AppDispatch_Find(ke_msg_id_t msg_id)
+{
+    uint32_t bucket = AppDispatch_Hash(msg_id);
+
+    while ((dispatch_bucket[bucket] != APP_DISPATCH_NONE) &&
+           (app_dispatch_table[dispatch_bucket[bucket]].msg_id != msg_id))
+    {
+        bucket = (bucket + 1) & (APP_DISPATCH_BUCKETS - 1);
+    }
+
+    return bucket;
+}
+
+void AppDispatch_Initialize(void)
+{
+    memset(dispatch_bucket, APP_DISPATCH_NONE, sizeof(dispatch_bucket));
+    memset(dispatch_next, APP_DISPATCH_NONE, sizeof(dispatch_next));
+    memset(dispatch_stats, 0, sizeof(dispatch_stats));
+    memset(dispatch_reported, 0, sizeof(dispatch_reported));
+
+    for (uint8_t row = 0; row < APP_DISPATCH_ROWS; row++)
+    {
+        uint32_t bucket = AppDispatch_Find(app_dispatch_table[row].msg_id);
+        uint8_t last = dispatch_bucket[bucket];
+
+        if (last == APP_DISPATCH_NONE)
+        {
+            // First handler of this ID, subscribe the dispatcher once
+            dispatch_bucket[bucket] = row;
+            MsgHandler_Add(app_dispatch_table[row].msg_id, AppDispatch_Handler);
+            continue;
+        }
+
+        while (dispatch_next[last] != APP_DISPATCH_NONE)
+        {
+            last = dispatch_next[last];
+        }
+        dispatch_next[last] = row;
+    }
+}
+
+void AppDispatch_Handler(ke_msg_id_t const msg_id, void const *param,
+                         ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    uint8_t row = dispatch_bucket[AppDispatch_Find(msg_id)];
+
+    for (; row != APP_DISPATCH_NONE; row = dispatch_next[row])
+    {
+        uint32_t start = Cycles_Now();
+
+        app_dispatch_table[row].handler(msg_id, param, dest_id, src_id);
+
+        Profile_Update(&dispatch_stats[row], Cycles_Since(start));
+    }
+}
+
+uint8_t AppDispatch_FanOut(ke_msg_id_t msg_id)
+{
+    uint8_t row = dispatch_bucket[AppDispatch_Find(msg_id)];
+    uint8_t count = 0;
+
+    for (; row != APP_DISPATCH_NONE; row = dispatch_next[row])
+    {
+        count++;
+    }
+
+    return count;
+}
+
+const struct profile_stats_t * AppDispatch_GetStats(uint8_t row)
+{
+    return (row < APP_DISPATCH_ROWS) ? &dispatch_stats[row] : NULL;
+}
+
+uint8_t AppDispatch_Rows(void)
+{
+    return (uint8_t)APP_DISPATCH_ROWS;
+}
+
+void AppDispatch_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                            ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    for (uint8_t row = 0; row < APP_DISPATCH_ROWS; row++)
+    {
+        const struct profile_stats_t *stats = &dispatch_stats[row];
+
+        if (stats->count == dispatch_reported[row])
+        {
+            continue;
+        }
+
+        APP_LOG_INFO("__DISPATCH 0x%04x %s: %lu calls, min %lu max %lu avg %lu cycles\r\n",
+                     app_dispatch_table[row].msg_id,
+                     APP_LOG_STR(app_dispatch_table[row].name),
+                     stats->count, stats->min_cycles, stats->max_cycles,
+                     (uint32_t)(stats->total_cycles / stats->count));
+        dispatch_reported[row] = stats->count;
+    }
+}
@@ -0,0 +1,214 @@
+/******************************************************************************
+ * File Name        : app_energy.c
+ * Description      : This module implements the energy accounting (see
+ *                    app_energy.h).
+ *
+ *                    An active account is settled (its time since the last
+ *                    settle charged at its present current) whenever its
+ *                    current changes and whenever its totals are read, so
+ *                    a window of any length costs two clock reads. The
+ *                    core cycles are converted to nanoseconds as they are
+ *                    added, at the clock level they ran at.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_energy.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define ENERGY_ACCOUNT_CURRENT(name, current_uA)    (current_uA),
+#define ENERGY_ACCOUNT_NAME(name, current_uA)       #name,
+
+static const uint32_t energy_table_uA[ENERGY_ACCOUNT_COUNT] =
+{
+    ENERGY_ACCOUNT_TABLE(ENERGY_ACCOUNT_CURRENT)
+};
+
+static const char *const energy_name[ENERGY_ACCOUNT_COUNT] =
+{
+    ENERGY_ACCOUNT_TABLE(ENERGY_ACCOUNT_NAME)
+};
+
+struct energy_account_env_t
+{
+    uint32_t current_uA;        // present draw, 0 when inactive
+    uint64_t since;             // AppTimer_Now at the last settle
+    uint8_t depth;              // Energy_Begin windows open
+};
+
+struct energy_env_tag
+{
+    struct energy_account_env_t account[ENERGY_ACCOUNT_COUNT];
+    struct energy_stats_t stats[ENERGY_ACCOUNT_COUNT];
+    uint64_t run_ns;            // see Energy_AddCycles
+    uint64_t run_cycles;
+    uint64_t start;             // AppTimer_Now at the reset
+};
+
+static struct energy_env_tag energy_env;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Energy_Settle
+ *
+ * Description   : Charge the time an account was active since its last
+ *                 settle at its present current.
+ *
+ * Parameters    : uint8_t account : enum energy_account
+ *
+ * Returns       : None
+ */
+static void Energy_Settle(uint8_t account)
+{
+    struct energy_account_env_t *env = &energy_env.account[account];
+    uint64_t now = AppTimer_Now();
+
+    if (env->current_uA != 0)
+    {
+        uint64_t us = now - env->since;
+
+        energy_env.stats[account].charge_pC += us * env->current_uA;
+        energy_env.stats[account].active_us += us;
+    }
+
+    env->since = now;
+}
+
+void Energy_Initialize(void)
+{
+    memset(&energy_env, 0, sizeof(energy_env));
+    energy_env.start = AppTimer_Now();
+}
+
+void Energy_Begin(uint8_t account)
+{
+    struct energy_account_env_t *env = &energy_env.account[account];
+
+    if (env->depth++ == 0)
+    {
+        Energy_SetCurrent(account, energy_table_uA[account]);
+    }
+}
+
+void Energy_End(uint8_t account)
+{
+    struct energy_account_env_t *env = &energy_env.account[account];
+
+    if ((env->depth > 0) && (--env->depth == 0))
+    {
+        Energy_SetCurrent(account, 0);
+    }
+}
+
+void Energy_SetCurrent(uint8_t account, uint32_t current_uA)
+{
+    struct energy_account_env_t *env = &energy_env.account[account];
+
+    Energy_Settle(account);
+
+    if ((env->current_uA == 0) && (current_uA != 0))
+    {
+        energy_env.stats[account].windows++;
+    }
+
+    env->current_uA = current_uA;
+}
+
+void Energy_AddTime(uint8_t account, uint64_t us)
+{
+    energy_env.stats[account].charge_pC += us * energy_table_uA[account];
+    energy_env.stats[account].active_us += us;
+    energy_env.stats[account].windows++;
+}
+
+void Energy_AddCycles(uint32_t cycles)
+{
+    energy_env.run_ns += ((uint64_t)cycles * 1000) / (SystemCoreClock / 1000000);
+    energy_env.run_cycles += cycles;
+}
+
+const struct energy_stats_t *Energy_GetStats(uint8_t account)
+{
+    if (account >= ENERGY_ACCOUNT_COUNT)
+    {
+        return NULL;
+    }
+
+    if (account == ENERGY_RUN)
+    {
+        struct energy_stats_t *stats = &energy_env.stats[ENERGY_RUN];
+
+        // A cycle lasts 1 / ENERGY_RUN_MHZ us at the table current
+        stats->active_us = energy_env.run_ns / 1000;
+        stats->charge_pC = (energy_env.run_cycles * energy_table_uA[ENERGY_RUN]) / ENERGY_RUN_MHZ;
+    }
+    else
+    {
+        Energy_Settle(account);
+    }
+
+    return &energy_env.stats[account];
+}
+
+void Energy_PackInfo(uint8_t *buf)
+{
+    uint32_t uptime_s = (uint32_t)((AppTimer_Now() - energy_env.start) / 1000000);
+
+    buf[0] = ENERGY_ACCOUNT_COUNT;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        buf[1 + i] = (uint8_t)(uptime_s >> (8 * i));
+    }
+
+    for (uint8_t account = 0; account < ENERGY_ACCOUNT_COUNT; account++)
+    {
+        const struct energy_stats_t *stats = Energy_GetStats(account);
+        uint32_t charge_mC = (uint32_t)(stats->charge_pC / 1000000000);
+        uint32_t active_s = (uint32_t)(stats->active_us / 1000000);
+        uint8_t *entry = &buf[5 + (account * ENERGY_ACCOUNT_LENGTH)];
+
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            entry[i] = (uint8_t)(charge_mC >> (8 * i));
+            entry[4 + i] = (uint8_t)(active_s >> (8 * i));
+        }
+    }
+}
+
+void Energy_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                       ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    uint64_t total_pC = 0;
+    uint64_t uptime_us = AppTimer_Now() - energy_env.start;
+
+    for (uint8_t account = 0; account < ENERGY_ACCOUNT_COUNT; account++)
+    {
+        const struct energy_stats_t *stats = Energy_GetStats(account);
+
+        total_pC += stats->charge_pC;
+        APP_LOG_DEBUG("__ENERGY %s: %lu mC, %lu s active, %lu windows\r\n",
+                      APP_LOG_STR(energy_name[account]),
+                      (uint32_t)(stats->charge_pC / 1000000000),
+                      (uint32_t)(stats->active_us / 1000000), stats->windows);
+    }
+
+    // Charge over time: pC / us = uA
+    APP_LOG_INFO("__ENERGY %lu mC in %lu s, average %lu uA\r\n",
+                 (uint32_t)(total_pC / 1000000000), (uint32_t)(uptime_us / 1000000),
+                 (uptime_us == 0) ? 0 : (uint32_t)(total_pC / uptime_us));
+}
@@ -0,0 +1,513 @@
+/******************************************************************************
+ * File Name        : app_group.c
+ * Description      : This module implements the connectionless group
+ *                    commands (see app_group.h).
+ *
+ *                    The scan activity is created and started with raw GAPM
+ *                    commands from GROUP_TASK and then runs without an end.
+ *                    Advertising reports are filtered on the company ID and
+ *                    the frame length before the MAC is computed, so the
+ *                    reports of other devices cost a few compares each.
+ *                    Every group frame heard is also offered to the relay
+ *                    (app_relay.h), which drops it unless the relay role is
+ *                    built in.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_group.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+// Scan activity states
+enum group_scan_state
+{
+    GROUP_SCAN_NONE,            // not created
+    GROUP_SCAN_CREATING,
+    GROUP_SCAN_STARTING,
+    GROUP_SCAN_STARTED,
+};
+
+struct group_env_tag
+{
+    uint8_t scan;               // enum group_scan_state
+    uint8_t actv_idx;
+    uint8_t zone;
+    bool key_valid;
+    uint8_t key[GROUP_KEY_LENGTH];
+    uint32_t last_seq;          // last command applied
+    uint32_t rejected;          // authentic-looking frames that failed the MAC
+};
+
+static struct group_env_tag group_env;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Group_Load32
+ *
+ * Description   : Read a little endian 32-bit value.
+ *
+ * Parameters    : const uint8_t *p : first byte
+ *
+ * Returns       : uint32_t : value
+ */
+static uint32_t Group_Load32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Function      : Group_CreateScan
+ *
+ * Description   : Request the scan activity. The stack sends back a
+ *                 GAPM_ACTIVITY_CREATED_IND and a GAPM_CMP_EVT /
+ *                 GAPM_CREATE_SCAN_ACTIVITY to GROUP_TASK.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Group_CreateScan(void)
+{
+    struct gapm_activity_create_cmd *cmd = KE_MSG_ALLOC(GAPM_ACTIVITY_CREATE_CMD,
+                                                        TASK_GAPM, GROUP_TASK,
+                                                        gapm_activity_create_cmd);
+
+    cmd->operation = GAPM_CREATE_SCAN_ACTIVITY;
+    cmd->own_addr_type = GAPM_OWN_ADDR_TYPE;
+    ke_msg_send(cmd);
+
+    group_env.scan = GROUP_SCAN_CREATING;
+}
+
+/* Function      : Group_StartScan
+ *
+ * Description   : Start the created scan activity without an end.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Group_StartScan(void)
+{
+    struct gapm_activity_start_cmd *cmd = KE_MSG_ALLOC(GAPM_START_ACTIVITY_CMD,
+                                                       TASK_GAPM, GROUP_TASK,
+                                                       gapm_activity_start_cmd);
+    struct gapm_scan_param *scan = &cmd->u_param.scan_param;
+
+    cmd->operation = GAPM_START_ACTIVITY;
+    cmd->actv_idx = group_env.actv_idx;
+    scan->type = GAPM_SCAN_TYPE_OBSERVER;
+    scan->prop = GAPM_SCAN_PROP_PHY_1M_BIT;
+    // Repeats of a frame are dropped by sequence number; the controller
+    // filter would also drop new frames from the same hub address
+    scan->dup_filt_pol = GAPM_DUP_FILT_DIS;
+    scan->scan_param_1m.scan_intv = GROUP_SCAN_INTV;
+    scan->scan_param_1m.scan_wd = GROUP_SCAN_WINDOW;
+    scan->duration = 0;
+    scan->period = 0;
+    ke_msg_send(cmd);
+
+    group_env.scan = GROUP_SCAN_STARTING;
+}
+
+/* Function      : Group_ScanFailed
+ *
+ * Description   : Drop the scan activity and try again later.
+ *
+ * Parameters    : uint8_t status : GAP error code
+ *
+ * Returns       : None
+ */
+static void Group_ScanFailed(uint8_t status)
+{
+    APP_LOG_WARN("__GROUP scan failed: %d\r\n", status);
+
+    if (group_env.scan != GROUP_SCAN_CREATING)
+    {
+        struct gapm_activity_delete_cmd *cmd = KE_MSG_ALLOC(GAPM_DELETE_ACTIVITY_CMD,
+                                                            TASK_GAPM, GROUP_TASK,
+                                                            gapm_activity_delete_cmd);
+
+        cmd->operation = GAPM_DELETE_ACTIVITY;
+        cmd->actv_idx = group_env.actv_idx;
+        ke_msg_send(cmd);
+    }
+
+    group_env.scan = GROUP_SCAN_NONE;
+    ke_timer_set(GROUP_SCAN_RETRY_TIMEOUT, TASK_APP, TIMER_SETTING_S(GROUP_SCAN_RETRY_S));
+}
+
+/* Function      : Group_Apply
+ *
+ * Description   : Carry out an authenticated command.
+ *
+ * Parameters    : uint8_t command  : enum group_cmd
+ *                 uint8_t argument : command argument
+ *
+ * Returns       : bool : true if the command is known and its argument valid
+ */
+static bool Group_Apply(uint8_t command, uint8_t argument)
+{
+    switch (command)
+    {
+        case GROUP_CMD_VENT:
+        {
+            if (argument > VENT_CLOSED_STATE)
+            {
+                return false;
+            }
+
+            *vent_state = argument;
+            vent_update();
+        }
+        break;
+
+        default:
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Function      : Group_HandleCommand
+ *
+ * Description   : Apply a command frame addressed to this vent, once.
+ *
+ * Parameters    : const uint8_t *frame : command frame from its type byte
+ *
+ * Returns       : None
+ */
+static void Group_HandleCommand(const uint8_t *frame)
+{
+    uint8_t zone = frame[1];
+    uint32_t seq = Group_Load32(&frame[4]);
+
+    // Cheap checks first: repeats of the last frame arrive many times
+    if (!group_env.key_valid || (seq <= group_env.last_seq) ||
+        ((zone != GROUP_ZONE_ALL) && (zone != group_env.zone)))
+    {
+        return;
+    }
+
+    if (!Group_CheckMac(frame))
+    {
+        group_env.rejected++;
+        APP_LOG_WARN("__GROUP bad MAC, seq %lu (%lu rejected)\r\n",
+                     seq, group_env.rejected);
+        return;
+    }
+
+    // Authentic: never accept this sequence number again, even if the
+    // command itself is not understood, nor after a reset
+    group_env.last_seq = seq;
+    KV_Set(KV_GROUP_SEQ, &group_env.last_seq);
+
+    if (!Group_Apply(frame[2], frame[3]))
+    {
+        APP_LOG_WARN("__GROUP command 0x%02x (%d) not applied\r\n", frame[2], frame[3]);
+    }
+    else
+    {
+        APP_LOG_INFO("__GROUP zone %d command 0x%02x (%d), seq %lu\r\n",
+                     zone, frame[2], frame[3], seq);
+    }
+
+    Group_RefreshTelemetry();
+}
+
+/* Function      : Group_ParseFrame
+ *
+ * Description   : Check a manufacturer specific data field for one of the
+ *                 group frames, apply the commands addressed to this vent
+ *                 and hand every frame to the relay.
+ *
+ * Parameters    : const uint8_t *addr : address of the transmitter
+ *                 const uint8_t *data : field data, after the AD type
+ *                 uint8_t length      : field data length
+ *
+ * Returns       : None
+ */
+static void Group_ParseFrame(const uint8_t *addr, const uint8_t *data, uint8_t length)
+{
+    static const uint8_t company_id[] = APP_COMPANY_ID;
+    const uint8_t *frame = &data[GROUP_FRAME_OFFSET];
+    uint8_t frame_len = length - GROUP_FRAME_OFFSET;
+
+    if ((length <= GROUP_FRAME_OFFSET) || memcmp(data, company_id, APP_COMPANY_ID_LEN))
+    {
+        return;
+    }
+
+    switch (frame[0])
+    {
+        case GROUP_FRAME_COMMAND:
+        {
+            if (length == GROUP_COMMAND_LENGTH)
+            {
+                Group_HandleCommand(frame);
+                Relay_Forward(addr, frame, frame_len, 0, RELAY_TTL);
+            }
+        }
+        break;
+
+        case GROUP_FRAME_TELEMETRY:
+        {
+            if (length == GROUP_TELEMETRY_LENGTH)
+            {
+                Relay_Forward(addr, frame, frame_len, 0, RELAY_TTL);
+            }
+        }
+        break;
+
+        case GROUP_FRAME_RELAY:
+        {
+            const uint8_t *inner = &frame[RELAY_HEADER_LENGTH];
+            uint8_t inner_len = frame_len - RELAY_HEADER_LENGTH;
+
+            if (frame_len <= RELAY_HEADER_LENGTH)
+            {
+                break;
+            }
+
+            if ((inner[0] == GROUP_FRAME_COMMAND) &&
+                (inner_len == (GROUP_COMMAND_LENGTH - GROUP_FRAME_OFFSET)))
+            {
+                Group_HandleCommand(inner);
+            }
+
+            Relay_Forward(&frame[RELAY_ORIGIN_OFFSET], inner, inner_len,
+                          frame[RELAY_HOP_OFFSET], frame[RELAY_TTL_OFFSET]);
+        }
+        break;
+    }
+}
+
+/* Function      : Group_ParseReport
+ *
+ * Description   : Walk the AD structures of an advertising report.
+ *
+ * Parameters    : const uint8_t *addr : address of the transmitter
+ *                 const uint8_t *data : advertising data
+ *                 uint16_t length     : advertising data length
+ *
+ * Returns       : None
+ */
+static void Group_ParseReport(const uint8_t *addr, const uint8_t *data, uint16_t length)
+{
+    uint16_t i = 0;
+
+    while ((i + 1) < length)
+    {
+        uint8_t field_len = data[i];
+
+        if ((field_len == 0) || ((i + 1 + field_len) > length))
+        {
+            break;
+        }
+
+        if (data[i + 1] == GAP_AD_TYPE_MANU_SPECIFIC_DATA)
+        {
+            Group_ParseFrame(addr, &data[i + 2], field_len - 1);
+        }
+
+        i += 1 + field_len;
+    }
+}
+
+void Group_Initialize(void)
+{
+    memset(&group_env, 0, sizeof(group_env));
+    group_env.scan = GROUP_SCAN_NONE;
+    group_env.zone = GROUP_ZONE_NONE;
+
+    // Defaults for what the hub never set
+    KV_Get(KV_GROUP_ZONE, &group_env.zone);
+    group_env.key_valid = KV_Get(KV_GROUP_KEY, group_env.key);
+    KV_Get(KV_GROUP_SEQ, &group_env.last_seq);
+
+    APP_LOG_INFO("__GROUP zone %d, key %s, last seq %lu\r\n", group_env.zone,
+                 APP_LOG_STR(group_env.key_valid ? "set" : "not set"), group_env.last_seq);
+}
+
+void Group_Start(void)
+{
+    if (group_env.scan == GROUP_SCAN_NONE)
+    {
+        Group_CreateScan();
+    }
+}
+
+bool Group_CheckMac(const uint8_t *frame)
+{
+    uint64_t mac;
+
+    if (!group_env.key_valid)
+    {
+        return false;
+    }
+
+    mac = SipHash24(group_env.key, frame, GROUP_MAC_OFFSET);
+    for (uint8_t i = 0; i < SIPHASH_MAC_LENGTH; i++)
+    {
+        if (frame[GROUP_MAC_OFFSET + i] != (uint8_t)(mac >> (8 * i)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Group_SetZone(uint8_t zone)
+{
+    if (zone == group_env.zone)
+    {
+        return;
+    }
+
+    group_env.zone = zone;
+    KV_Set(KV_GROUP_ZONE, &group_env.zone);
+    APP_LOG_INFO("__GROUP zone %d\r\n", zone);
+    Group_RefreshTelemetry();
+}
+
+uint8_t Group_GetZone(void)
+{
+    return group_env.zone;
+}
+
+void Group_SetKey(const uint8_t *key, uint32_t seq_floor)
+{
+    // Frames of another key fail the MAC, its sequence numbers do not count
+    if (!group_env.key_valid || memcmp(group_env.key, key, GROUP_KEY_LENGTH) ||
+        (seq_floor > group_env.last_seq))
+    {
+        group_env.last_seq = seq_floor;
+    }
+
+    memcpy(group_env.key, key, GROUP_KEY_LENGTH);
+    group_env.key_valid = true;
+
+    KV_Set(KV_GROUP_KEY, group_env.key);
+    KV_Set(KV_GROUP_SEQ, &group_env.last_seq);
+    APP_LOG_INFO("__GROUP key set, commands above seq %lu\r\n", group_env.last_seq);
+}
+
+void Group_PackTelemetry(uint8_t *data)
+{
+    static const uint8_t company_id[] = APP_COMPANY_ID;
+
+    memcpy(data, company_id, APP_COMPANY_ID_LEN);
+    data[2] = GROUP_FRAME_TELEMETRY;
+    data[3] = group_env.zone;
+    data[4] = *vent_state;
+    data[5] = (uint8_t)group_env.last_seq;
+    data[6] = (uint8_t)(group_env.last_seq >> 8);
+    data[7] = (uint8_t)(group_env.last_seq >> 16);
+    data[8] = (uint8_t)(group_env.last_seq >> 24);
+}
+
+void Group_RefreshTelemetry(void)
+{
+    PrepareAdvScanData();
+    Adv_RefreshData();
+}
+
+void Group_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    if ((msg_id != GROUP_SCAN_RETRY_TIMEOUT) && (dest_id != GROUP_TASK))
+    {
+        // Answers to the advertising and relay activities
+        return;
+    }
+
+    switch (msg_id)
+    {
+        case GAPM_ACTIVITY_CREATED_IND:
+        {
+            const struct gapm_activity_created_ind *p = param;
+
+            group_env.actv_idx = p->actv_idx;
+        }
+        break;
+
+        case GAPM_CMP_EVT:
+        {
+            const struct gapm_cmp_evt *p = param;
+
+            if ((p->operation == GAPM_CREATE_SCAN_ACTIVITY) &&
+                (group_env.scan == GROUP_SCAN_CREATING))
+            {
+                if (p->status == GAP_ERR_NO_ERROR)
+                {
+                    Group_StartScan();
+                }
+                else
+                {
+                    Group_ScanFailed(p->status);
+                }
+            }
+            else if ((p->operation == GAPM_START_ACTIVITY) &&
+                     (group_env.scan == GROUP_SCAN_STARTING))
+            {
+                if (p->status == GAP_ERR_NO_ERROR)
+                {
+                    group_env.scan = GROUP_SCAN_STARTED;
+                    APP_LOG_INFO("__GROUP scanning\r\n");
+                }
+                else
+                {
+                    Group_ScanFailed(p->status);
+                }
+            }
+        }
+        break;
+
+        case GAPM_ACTIVITY_STOPPED_IND:
+        {
+            const struct gapm_activity_stopped_ind *p = param;
+
+            // The scan has no duration, it only stops on an error
+            if (p->actv_idx == group_env.actv_idx)
+            {
+                Group_ScanFailed(p->reason);
+            }
+        }
+        break;
+
+        case GAPM_EXT_ADV_REPORT_IND:
+        {
+            const struct gapm_ext_adv_report_ind *p = param;
+
+            if ((p->info & GAPM_REPORT_INFO_REPORT_TYPE_MASK) == GAPM_REPORT_TYPE_ADV_LEG)
+            {
+                Group_ParseReport(p->trans_addr.addr.addr, p->data, p->length);
+            }
+        }
+        break;
+
+        case GROUP_SCAN_RETRY_TIMEOUT:
+        {
+            Group_Start();
+        }
+        break;
+    }
+}
@@ -0,0 +1,193 @@
+/******************************************************************************
+ * File Name        : app_history.c
+ * Description      : This module keeps the on-device sample log: a RAM ring
+ *                    of the last HISTORY_DEPTH readings, exposed to the
+ *                    stream endpoint as the STREAM_SRC_HISTORY source.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <ble_abstraction.h>
+#include <app.h>
+#include <app_history.h>
+#include <app_stream.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+static struct history_sample_t history_log[HISTORY_DEPTH];
+
+// Absolute number of samples recorded since boot
+static uint32_t history_count;
+
+// A sample was requested for the log and is not published yet
+static bool history_pending;
+
+static uint32_t History_StreamBegin(void);
+static uint32_t History_StreamEnd(void);
+static uint16_t History_StreamRead(uint32_t offset, uint8_t *buf, uint16_t length);
+
+static const struct stream_source_t history_source =
+{
+    .begin = History_StreamBegin,
+    .end   = History_StreamEnd,
+    .read  = History_StreamRead,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : History_StreamBegin
+ *
+ * Description   : Offset of the oldest byte still in the log.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : stream offset
+ */
+static uint32_t History_StreamBegin(void)
+{
+    uint32_t first = (history_count > HISTORY_DEPTH) ? (history_count - HISTORY_DEPTH) : 0;
+
+    return first * HISTORY_SAMPLE_SIZE;
+}
+
+/* Function      : History_StreamEnd
+ *
+ * Description   : Offset just past the newest sample.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : stream offset
+ */
+static uint32_t History_StreamEnd(void)
+{
+    return history_count * HISTORY_SAMPLE_SIZE;
+}
+
+/* Function      : History_StreamRead
+ *
+ * Description   : Copy log bytes starting at a stream offset, unwrapping
+ *                 the ring.
+ *
+ * Parameters    : uint32_t offset  : stream offset
+ *                 uint8_t *buf     : destination
+ *                 uint16_t length  : bytes wanted
+ *
+ * Returns       : uint16_t : bytes copied, 0 if offset is no longer in the log
+ */
+static uint16_t History_StreamRead(uint32_t offset, uint8_t *buf, uint16_t length)
+{
+    const uint8_t *log = (const uint8_t *)history_log;
+    uint32_t ring_size = HISTORY_DEPTH * HISTORY_SAMPLE_SIZE;
+    uint32_t end = History_StreamEnd();
+    uint16_t copied = 0;
+
+    if ((offset < History_StreamBegin()) || (offset >= end))
+    {
+        return 0;
+    }
+
+    if ((end - offset) < length)
+    {
+        length = (uint16_t)(end - offset);
+    }
+
+    while (copied < length)
+    {
+        uint32_t pos = (offset + copied) % ring_size;
+        uint32_t chunk = ring_size - pos;
+
+        if (chunk > (uint32_t)(length - copied))
+        {
+            chunk = length - copied;
+        }
+
+        memcpy(&buf[copied], &log[pos], chunk);
+        copied += (uint16_t)chunk;
+    }
+
+    return copied;
+}
+
+/* Function      : History_Record
+ *
+ * Description   : Append the readings of the active sensor snapshot.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void History_Record(void)
+{
+    const struct sensor_snapshot_t *snap = Snapshot_Get();
+    struct history_sample_t sample;
+
+    sample.temperature = (int16_t)(snap->temperature * 100.0f);
+    sample.humidity = (uint16_t)(snap->humidity * 100.0f);
+    sample.battery = snap->battery;
+    sample.vent_state = *vent_state;
+    History_Append(&sample);
+}
+
+void History_Initialize(void)
+{
+    memset(history_log, 0, sizeof(history_log));
+    history_count = 0;
+    history_pending = false;
+
+    Stream_RegisterSource(STREAM_SRC_HISTORY, &history_source);
+
+    ke_timer_set(HISTORY_SAMPLE_TIMEOUT, TASK_APP, TIMER_SETTING_S(HISTORY_INTERVAL_S));
+}
+
+void History_Append(const struct history_sample_t *sample)
+{
+    history_log[history_count % HISTORY_DEPTH] = *sample;
+    history_count++;
+}
+
+void History_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                        ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    switch (msg_id)
+    {
+        case HISTORY_SAMPLE_TIMEOUT:
+        {
+            /* Reuse the last reading if it is still fresh, otherwise ask for
+             * one and record it when it is published */
+            if (Sensor_IsFresh())
+            {
+                History_Record();
+            }
+            else
+            {
+                history_pending = true;
+                Sensor_Request();
+            }
+
+            ke_timer_set(HISTORY_SAMPLE_TIMEOUT, TASK_APP, TIMER_SETTING_S(HISTORY_INTERVAL_S));
+        }
+        break;
+
+        case SENSOR_SAMPLE_IND:
+        {
+            if (history_pending)
+            {
+                history_pending = false;
+                History_Record();
+            }
+        }
+        break;
+    }
+}
@@ -62,6 +62,22 @@ void DeviceInit(void)
         SYS_WATCHDOG_REFRESH();
     }
 
+    DeviceGPIOInit();
+
+    /* Turn LED_STATE_GPIO off */
+    Sys_GPIO_Set_High(LED_STATE_GPIO);
+
+    uint32_t trim_error = DeviceClockInit();
+
+    /* Configuring temperature sensor */
+    Temperature_Sensor_Init(trim_error);
+
+    /* Configuring LSAD input channels */
+    LSAD_ChannelInit(trim_error);
+}
+
+void DeviceGPIOInit(void)
+{
     /* Disable JTAG TDI, TDO, and TRST connections to GPIO 2, 3, and 4 */
     GPIO->JTAG_SW_PAD_CFG &= ~(CM33_JTAG_DATA_ENABLED | CM33_JTAG_TRST_ENABLED);
 
@@ -69,10 +85,10 @@ void DeviceInit(void)
     SYS_GPIO_CONFIG(CONNECTION_STATE_GPIO, GPIO_MODE_GPIO_OUT);
     Sys_GPIO_IntConfig(0, GPIO_EVENT_TRANSITION | GPIO_SRC(BUTTON_GPIO) |
     GPIO_DEBOUNCE_ENABLE, GPIO_DEBOUNCE_SLOWCLK_DIV1024, 49);
+}
 
-    /* Turn LED_STATE_GPIO off */
-    Sys_GPIO_Set_High(LED_STATE_GPIO);
-
+uint32_t DeviceClockInit(void)
+{
     /* Load default trim values */
     uint32_t trim_error = SYS_TRIM_LOAD_DEFAULT();
 
@@ -95,11 +111,7 @@ void DeviceInit(void)
     /* Initialize clock and access to flash */
     Flash_Initialize(0, (FlashClockFrequency_t)(SystemCoreClock));
 
-    /* Configuring temperature sensor */
-    Temperature_Sensor_Init(trim_error);
-
-    /* Configuring LSAD input channels */
-    LSAD_ChannelInit(trim_error);
+    return trim_error;
 }
 
 void SWMTraceInit(void)
@@ -110,6 +122,14 @@ void SWMTraceInit(void)
 }
 
 void BLESystemInit(void)
+{
+    BLERadioInit();
+
+    /* Initialize BLE stack */
+    BLEStackInit();
+}
+
+void BLERadioInit(void)
 {
     /* Set ICH_TRIM for optimum RF performance */
 	Sys_ACS_WriteRegister(&ACS->VCC_CTRL, (((ACS->VCC_CTRL) & (~(ACS_VCC_CTRL_ICH_TRIM_Mask))) |
@@ -120,9 +140,6 @@ void BLESystemInit(void)
 
     /* Configure Baseband Controller Interface */
     BBIF->CTRL = (BB_CLK_ENABLE | BBCLK_DIVIDER_8);
-
-    /* Initialize BLE stack */
-    BLEStackInit();
 }
 
 void EnableBLEInterrupts(void)
@@ -189,43 +206,56 @@ void BLEStackInit(void)
 
 void AppMsgHandlersInit(void)
 {
-    /* BLE database setup handler */
-    MsgHandler_Add(GAPM_CMP_EVT, BLE_ConfigHandler);
-    MsgHandler_Add(GAPM_PROFILE_ADDED_IND, BLE_ConfigHandler);
-    MsgHandler_Add(GATTM_ADD_SVC_RSP, BLE_ConfigHandler);
-
-    /* BLE activity handler (responsible for air operations) */
-    MsgHandler_Add(GAPM_CMP_EVT, BLE_ActivityHandler);
-    MsgHandler_Add(GAPM_ACTIVITY_CREATED_IND, BLE_ActivityHandler);
-    MsgHandler_Add(GAPM_ACTIVITY_STOPPED_IND, BLE_ActivityHandler);
-
-    /* BLE connection handler */
-    MsgHandler_Add(GAPM_CMP_EVT, BLE_ConnectionHandler);
-    MsgHandler_Add(GAPC_CONNECTION_REQ_IND, BLE_ConnectionHandler);
-    MsgHandler_Add(GAPC_DISCONNECT_IND, BLE_ConnectionHandler);
-    MsgHandler_Add(GAPM_ADDR_SOLVED_IND, BLE_ConnectionHandler);
-    MsgHandler_Add(GAPC_GET_DEV_INFO_REQ_IND, BLE_ConnectionHandler);
-    MsgHandler_Add(GAPC_PARAM_UPDATE_REQ_IND, BLE_ConnectionHandler);
-
-    /* BLE pairing / bonding  handler */
-    MsgHandler_Add(GAPC_BOND_REQ_IND, BLE_PairingHandler);
-    MsgHandler_Add(GAPC_BOND_IND, BLE_PairingHandler);
-    MsgHandler_Add(GAPC_ENCRYPT_REQ_IND, BLE_PairingHandler);
-    MsgHandler_Add(GAPC_ENCRYPT_IND, BLE_PairingHandler);
-
-    /* LED Blink handler (control the LED blinking frequency
-     * according to number of connected peer devices) */
-    MsgHandler_Add(APP_LED_TIMEOUT, LEDHandler);
-
-    /* Battery level read handler */
-    MsgHandler_Add(APP_BATT_LEVEL_READ_TIMEOUT, BattLevelReadHandler);
-
-    /* SW1 handler (to time the 5 seconds holding SW1) */
-    MsgHandler_Add(APP_SW1_TIMEOUT, SW1Handler);
-
-    /* SW1 LED handler (to control the timing of LED
-     * blinking when bond list clear is successful) */
-    MsgHandler_Add(APP_SW1LED_TIMEOUT, SW1LEDHandler);
+    /* Energy accounts, charged from the power manager and the drivers */
+    Energy_Initialize();
+
+    /* Power manager (sleep with retention, residency report) */
+    Power_Initialize();
+
+    /* System clock policy (performance level requests) */
+    Clock_Initialize();
+
+    /* Application timers (servo travel, I2C error signal), started earlier
+     * during the peripheral setup run from here on */
+    AppTimer_Initialize();
+
+    /* Application scheduler (button and other interrupt driven events) */
+    AppSched_Initialize();
+
+    /* Battery state estimator, fed by the LSAD bursts and the servo moves */
+    Battery_Initialize();
+
+    /* Advertising and reconnect policy (directed / fast / medium / slow) */
+    Adv_Initialize();
+
+    /* Connectionless group commands (scan, zone, key) and relay */
+    Group_Initialize();
+    Relay_Initialize();
+
+    /* Connection parameter policy (idle / active intervals) */
+    ConnPolicy_Initialize();
+
+    /* Link optimization (MTU, data length, PHY) */
+    Link_Initialize();
+
+    /* Notification queue (flow control on GATTC_CMP_EVT) */
+    NtfQueue_Initialize();
+
+    /* Sensor sampler (on-demand measurements) */
+    Sensor_Initialize();
+
+    /* Bulk stream endpoint (L2CAP channel) and its sources */
+    Stream_Initialize();
+    History_Initialize();
+    Profile_Initialize();
+
+    /* BLE throughput / latency benchmark (custom service 0) */
+    Bench_Initialize();
+
+    /* Subscribe all application handlers (BLE database setup, advertising,
+     * connection, pairing / bonding, LED, battery, SW1 and the modules
+     * above) through the dispatch table, see APP_DISPATCH_TABLE */
+    AppDispatch_Initialize();
 }
 
 void BatteryServiceServerInit(void)
@@ -253,6 +283,11 @@ void DeviceInformationServiceServerInit(void)
 
 void CustomServiceServerInit(void)
 {
+    uint32_t interval = TIMER_SETTING_S(10);
+
+    /* Interval saved by an earlier CUSTOMSS_NotifyOnTimeout, if any */
+    KV_Get(KV_NTF_INTERVAL, &interval);
+
     CUSTOMSS_Initialize();
-    CUSTOMSS_NotifyOnTimeout(TIMER_SETTING_S(10));
+    CUSTOMSS_NotifyOnTimeout(interval, false);
 }
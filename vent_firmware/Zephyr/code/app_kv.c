@@ -0,0 +1,455 @@
+/******************************************************************************
+ * File Name        : app_kv.c
+ * Description      : This module implements the flash key-value store (see
+ *                    app_kv.h).
+ *
+ *                    Flash is read through its memory map and written with
+ *                    the ROM flash library, at the timing Flash_Initialize
+ *                    set for the current clock level; the core stalls for
+ *                    the few word pairs of a flush and for the sector
+ *                    erase of a compaction (about once per hundred
+ *                    changes). A record or header whose write fails is
+ *                    treated as damage: the sector is compacted on the
+ *                    next flush and the failed write is never read back.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_kv.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define KV_SECTOR_ADDR(sector)          (KV_FLASH_BASE + ((sector) * KV_SECTOR_SIZE))
+
+// Endurance mode of the ROM flash library, for frequently rewritten data
+#define KV_FLASH_ENDURANCE              (true)
+
+struct kv_key_t
+{
+    uint8_t id;                 // stored in flash
+    uint8_t length;             // value bytes
+};
+
+#define KV_KEY_ENTRY(name, id, length)  { (id), (length) },
+
+static const struct kv_key_t kv_key[KV_KEY_COUNT] =
+{
+    KV_KEY_TABLE(KV_KEY_ENTRY)
+};
+
+struct kv_entry_t
+{
+    uint16_t offset;                    // latest record in the active sector, 0 if none
+    bool dirty;                         // pending holds a change to write
+    uint8_t pending[KV_VALUE_MAX];
+};
+
+struct kv_env_tag
+{
+    uint8_t sector;                     // active sector
+    uint32_t seq;                       // its sequence, 0 before the first write
+    uint16_t head;                      // first free byte of the active sector
+    bool damaged;                       // no more appends, compact first
+    bool flush_armed;                   // KV_FLUSH_TIMEOUT running
+    uint32_t retry_ms;                  // next retry delay, 0 after a clean flush
+    uint32_t errors;                    // failed flash operations
+    struct kv_entry_t entry[KV_KEY_COUNT];
+};
+
+static struct kv_env_tag kv_env;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : KV_Crc
+ *
+ * Description   : Returns the CRC-32 of a record.
+ *
+ * Parameters    : uint8_t id            : key id
+ *                 uint8_t length        : value bytes
+ *                 const uint8_t *value  : value
+ *
+ * Returns       : uint32_t : CRC-32
+ */
+static uint32_t KV_Crc(uint8_t id, uint8_t length, const uint8_t *value)
+{
+    uint8_t header[2] = { id, length };
+    uint32_t crc = CRC32_Update(CRC32_INIT, header, sizeof(header));
+
+    return CRC32_FINAL(CRC32_Update(crc, value, length));
+}
+
+/* Function      : KV_Stored
+ *
+ * Description   : Returns the value of the latest record of a key.
+ *
+ * Parameters    : uint8_t key : enum kv_key
+ *
+ * Returns       : const uint8_t * : value in flash, NULL if none
+ */
+static const uint8_t *KV_Stored(uint8_t key)
+{
+    uint16_t offset = kv_env.entry[key].offset;
+
+    if (offset == 0)
+    {
+        return NULL;
+    }
+
+    return (const uint8_t *)(KV_SECTOR_ADDR(kv_env.sector) + offset + 8);
+}
+
+/* Function      : KV_Value
+ *
+ * Description   : Returns the current value of a key, a pending change or
+ *                 the latest record.
+ *
+ * Parameters    : uint8_t key : enum kv_key
+ *
+ * Returns       : const uint8_t * : value, NULL if the key has none
+ */
+static const uint8_t *KV_Value(uint8_t key)
+{
+    return kv_env.entry[key].dirty ? kv_env.entry[key].pending : KV_Stored(key);
+}
+
+/* Function      : KV_Scan
+ *
+ * Description   : Index the latest valid record of each key in the active
+ *                 sector and find its first free byte. Stops at a record
+ *                 header that fails its check, the rest of the sector is
+ *                 not trusted.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void KV_Scan(void)
+{
+    uint32_t base = KV_SECTOR_ADDR(kv_env.sector);
+    uint16_t offset = KV_HEADER_LENGTH;
+
+    while ((offset + 8) <= KV_SECTOR_SIZE)
+    {
+        const uint32_t *word = (const uint32_t *)(base + offset);
+        uint16_t header = (uint16_t)(word[0] & 0xFFFF);
+        uint8_t id = (uint8_t)(header & 0xFF);
+        uint8_t length = (uint8_t)(header >> 8);
+
+        if (word[0] == 0xFFFFFFFF)
+        {
+            break;
+        }
+
+        if (((word[0] >> 16) != (header ^ 0xFFFFU)) || (length > KV_VALUE_MAX) ||
+            ((offset + KV_RECORD_LENGTH(length)) > KV_SECTOR_SIZE))
+        {
+            kv_env.damaged = true;
+            break;
+        }
+
+        // Unknown ids (keys removed from the table) are dropped by the
+        // next compaction
+        for (uint8_t key = 0; key < KV_KEY_COUNT; key++)
+        {
+            if ((kv_key[key].id == id) && (kv_key[key].length == length) &&
+                (word[1] == KV_Crc(id, length, (const uint8_t *)&word[2])))
+            {
+                kv_env.entry[key].offset = offset;
+            }
+        }
+
+        offset += KV_RECORD_LENGTH(length);
+    }
+
+    kv_env.head = offset;
+}
+
+/* Function      : KV_WriteRecord
+ *
+ * Description   : Program one record.
+ *
+ * Parameters    : uint32_t addr         : record address, word pair aligned
+ *                 uint8_t key           : enum kv_key
+ *                 const uint8_t *value  : value
+ *
+ * Returns       : bool : false if the flash library failed
+ */
+static bool KV_WriteRecord(uint32_t addr, uint8_t key, const uint8_t *value)
+{
+    uint32_t record[KV_RECORD_LENGTH(KV_VALUE_MAX) / 4];
+    uint8_t length = kv_key[key].length;
+    uint16_t header = (uint16_t)(kv_key[key].id | (length << 8));
+
+    memset(record, 0xFF, sizeof(record));
+    record[0] = header | ((uint32_t)(header ^ 0xFFFFU) << 16);
+    record[1] = KV_Crc(kv_key[key].id, length, value);
+    memcpy(&record[2], value, length);
+
+    if (Flash_WriteBuffer(addr, KV_RECORD_LENGTH(length) / 4, record,
+                          KV_FLASH_ENDURANCE) != FLASH_ERR_NONE)
+    {
+        kv_env.errors++;
+        return false;
+    }
+
+    return true;
+}
+
+/* Function      : KV_Compact
+ *
+ * Description   : Copy the current value of each key into the next sector of
+ *                 the ring and make it the active one. On a failure the
+ *                 active sector is kept.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void KV_Compact(void)
+{
+    uint8_t sector = (kv_env.sector + 1) % KV_SECTORS;
+    uint32_t base = KV_SECTOR_ADDR(sector);
+    uint32_t header[2] = { KV_MAGIC, kv_env.seq + 1 };
+    uint16_t offset[KV_KEY_COUNT];
+    uint16_t head = KV_HEADER_LENGTH;
+
+    if (Flash_EraseSector(base, KV_FLASH_ENDURANCE) != FLASH_ERR_NONE)
+    {
+        kv_env.errors++;
+        return;
+    }
+
+    for (uint8_t key = 0; key < KV_KEY_COUNT; key++)
+    {
+        const uint8_t *value = KV_Value(key);
+
+        offset[key] = 0;
+        if (value == NULL)
+        {
+            continue;
+        }
+
+        if (!KV_WriteRecord(base + head, key, value))
+        {
+            return;
+        }
+
+        offset[key] = head;
+        head += KV_RECORD_LENGTH(kv_key[key].length);
+    }
+
+    // The header commits the copy
+    if (Flash_WriteBuffer(base, 2, header, KV_FLASH_ENDURANCE) != FLASH_ERR_NONE)
+    {
+        kv_env.errors++;
+        return;
+    }
+
+    kv_env.sector = sector;
+    kv_env.seq++;
+    kv_env.head = head;
+    kv_env.damaged = false;
+
+    for (uint8_t key = 0; key < KV_KEY_COUNT; key++)
+    {
+        kv_env.entry[key].offset = offset[key];
+        kv_env.entry[key].dirty = false;
+    }
+
+    APP_LOG_INFO("__KV compacted into sector %u, seq %lu, %u bytes\r\n",
+                 sector, kv_env.seq, head);
+}
+
+/* Function      : KV_Flush
+ *
+ * Description   : Append the pending changes to the active sector, compact
+ *                 it if they do not fit.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void KV_Flush(void)
+{
+    for (uint8_t key = 0; key < KV_KEY_COUNT; key++)
+    {
+        struct kv_entry_t *entry = &kv_env.entry[key];
+        uint16_t length = KV_RECORD_LENGTH(kv_key[key].length);
+
+        if (!entry->dirty)
+        {
+            continue;
+        }
+
+        if (kv_env.damaged || ((kv_env.head + length) > KV_SECTOR_SIZE))
+        {
+            // Writes every current value, the pending ones included
+            KV_Compact();
+            return;
+        }
+
+        if (!KV_WriteRecord(KV_SECTOR_ADDR(kv_env.sector) + kv_env.head, key, entry->pending))
+        {
+            // The head is not moved past a failed write, it is never read
+            kv_env.damaged = true;
+            KV_Compact();
+            return;
+        }
+
+        entry->offset = kv_env.head;
+        entry->dirty = false;
+        kv_env.head += length;
+    }
+}
+
+/* Function      : KV_IsDirty
+ *
+ * Description   : Returns true while a change is still to be written.
+ *
+ * Parameters    : None
+ *
+ * Returns       : bool : true if any key is dirty
+ */
+static bool KV_IsDirty(void)
+{
+    for (uint8_t key = 0; key < KV_KEY_COUNT; key++)
+    {
+        if (kv_env.entry[key].dirty)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void KV_Initialize(void)
+{
+    bool found = false;
+
+    memset(&kv_env, 0, sizeof(kv_env));
+
+    for (uint8_t sector = 0; sector < KV_SECTORS; sector++)
+    {
+        const uint32_t *header = (const uint32_t *)KV_SECTOR_ADDR(sector);
+
+        if ((header[0] == KV_MAGIC) && (header[1] != 0xFFFFFFFF) &&
+            (!found || (header[1] > kv_env.seq)))
+        {
+            found = true;
+            kv_env.sector = sector;
+            kv_env.seq = header[1];
+        }
+    }
+
+    if (found)
+    {
+        KV_Scan();
+    }
+    else
+    {
+        // Blank store, the first flush writes sector 0
+        kv_env.sector = KV_SECTORS - 1;
+        kv_env.damaged = true;
+    }
+
+    APP_LOG_INFO("__KV sector %u, seq %lu, %u of %u bytes used\r\n",
+                 kv_env.sector, kv_env.seq, kv_env.head, KV_SECTOR_SIZE);
+}
+
+bool KV_Get(uint8_t key, void *value)
+{
+    const uint8_t *current;
+
+    if (key >= KV_KEY_COUNT)
+    {
+        return false;
+    }
+
+    current = KV_Value(key);
+    if (current == NULL)
+    {
+        return false;
+    }
+
+    memcpy(value, current, kv_key[key].length);
+
+    return true;
+}
+
+void KV_Set(uint8_t key, const void *value)
+{
+    struct kv_entry_t *entry;
+    const uint8_t *stored;
+
+    if (key >= KV_KEY_COUNT)
+    {
+        return;
+    }
+
+    entry = &kv_env.entry[key];
+    stored = KV_Stored(key);
+    memcpy(entry->pending, value, kv_key[key].length);
+
+    // Nothing to write for the value in flash, even if changed back to it
+    // before the flush
+    entry->dirty = (stored == NULL) || (memcmp(stored, value, kv_key[key].length) != 0);
+
+    if (entry->dirty && !kv_env.flush_armed)
+    {
+        kv_env.flush_armed = true;
+        ke_timer_set(KV_FLUSH_TIMEOUT, TASK_APP, TIMER_SETTING_MS(KV_FLUSH_DELAY_MS));
+    }
+}
+
+void KV_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                   ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    switch (msg_id)
+    {
+        case KV_FLUSH_TIMEOUT:
+        {
+            kv_env.flush_armed = false;
+            KV_Flush();
+
+            if (kv_env.errors != 0)
+            {
+                APP_LOG_WARN("__KV %lu flash operations failed\r\n", kv_env.errors);
+            }
+
+            // A failed erase or write leaves changes dirty: try again,
+            // backing off so a failing flash is not hammered
+            if (!KV_IsDirty())
+            {
+                kv_env.retry_ms = 0;
+                break;
+            }
+
+            kv_env.retry_ms = (kv_env.retry_ms == 0) ? KV_FLUSH_DELAY_MS :
+                              (2 * kv_env.retry_ms);
+            if (kv_env.retry_ms > KV_FLUSH_RETRY_MAX_MS)
+            {
+                kv_env.retry_ms = KV_FLUSH_RETRY_MAX_MS;
+            }
+
+            kv_env.flush_armed = true;
+            ke_timer_set(KV_FLUSH_TIMEOUT, TASK_APP, TIMER_SETTING_MS(kv_env.retry_ms));
+            APP_LOG_WARN("__KV flush failed, retry in %lu ms\r\n", kv_env.retry_ms);
+        }
+        break;
+    }
+}
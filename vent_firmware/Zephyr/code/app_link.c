@@ -0,0 +1,206 @@
+/******************************************************************************
+ * File Name        : app_link.c
+ * Description      : This module optimizes every new connection for bulk
+ *                    transfers. It negotiates the largest ATT MTU and LL
+ *                    data length, then selects the PHY from the connection
+ *                    RSSI: 2M on strong links, coded only on weak links and
+ *                    1M in between. The negotiated values are tracked per
+ *                    connection and exposed through the custom service.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <ble_abstraction.h>
+#include <swmTrace_api.h>
+#include <app.h>
+#include <app_link.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+static struct link_info_t link_info[APP_MAX_NB_CON];
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Link_Reset
+ *
+ * Description   : Set the link information of a connection to the values
+ *                 every link starts with (23 byte MTU, 27 byte PDUs, 1M).
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : None
+ */
+static void Link_Reset(uint8_t conidx)
+{
+    link_info[conidx].mtu = LINK_DEFAULT_MTU;
+    link_info[conidx].tx_octets = LINK_DEFAULT_OCTETS;
+    link_info[conidx].rx_octets = LINK_DEFAULT_OCTETS;
+    link_info[conidx].tx_phy = GAP_PHY_LE_1MBPS;
+    link_info[conidx].rx_phy = GAP_PHY_LE_1MBPS;
+    link_info[conidx].rssi = 0;
+}
+
+/* Function      : Link_SelectPhy
+ *
+ * Description   : Request the PHY matching the measured RSSI. An RSSI the
+ *                 controller could not measure leaves the link on 1M.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *                 int8_t rssi    : connection RSSI (dBm)
+ *
+ * Returns       : None
+ */
+static void Link_SelectPhy(uint8_t conidx, int8_t rssi)
+{
+    if (rssi == LINK_RSSI_UNKNOWN)
+    {
+        /* Not a strong link, keep the 1M PHY the connection started on */
+        APP_LOG_INFO("__LINK conidx=%d: RSSI not available, staying on 1M PHY\r\n", conidx);
+    }
+    else if (rssi >= LINK_RSSI_2M_MIN)
+    {
+        APP_LOG_INFO("__LINK conidx=%d: RSSI %d dBm, requesting 2M PHY\r\n", conidx, rssi);
+        GAPC_SetPhyCmd(conidx, GAP_PHY_LE_2MBPS, GAP_PHY_LE_2MBPS, 0);
+    }
+    else if (rssi <= LINK_RSSI_CODED_MAX)
+    {
+        APP_LOG_INFO("__LINK conidx=%d: RSSI %d dBm, requesting coded PHY\r\n", conidx, rssi);
+        GAPC_SetPhyCmd(conidx, GAP_PHY_LE_CODED, GAP_PHY_LE_CODED,
+                       LINK_CODED_PHY_RATE);
+    }
+    else
+    {
+        /* Connections start on 1M, nothing to request */
+        APP_LOG_INFO("__LINK conidx=%d: RSSI %d dBm, staying on 1M PHY\r\n", conidx, rssi);
+    }
+}
+
+void Link_Initialize(void)
+{
+    for (uint8_t i = 0; i < APP_MAX_NB_CON; i++)
+    {
+        Link_Reset(i);
+    }
+}
+
+void Link_Optimize(uint8_t conidx)
+{
+    if (conidx >= APP_MAX_NB_CON)
+    {
+        return;
+    }
+
+    Link_Reset(conidx);
+
+    /* The central answers with its own MTU, the stack keeps the minimum */
+    GATTC_MtuExchange(conidx);
+
+    /* Ask the controller for full size LL packets */
+    GAPC_SetLeDataLengthCmd(conidx, LINK_MAX_TX_OCTETS, LINK_MAX_TX_TIME);
+
+    /* PHY is selected once the RSSI is known (GAPC_CON_RSSI_IND) */
+    GAPC_GetInfoCmd(conidx, GAPC_GET_CON_RSSI);
+}
+
+const struct link_info_t * Link_GetInfo(uint8_t conidx)
+{
+    if (conidx >= APP_MAX_NB_CON)
+    {
+        return NULL;
+    }
+
+    return &link_info[conidx];
+}
+
+void Link_PackInfo(uint8_t conidx, uint8_t *buf)
+{
+    const struct link_info_t *info = Link_GetInfo(conidx);
+
+    if (info == NULL)
+    {
+        memset(buf, 0, LINK_INFO_LENGTH);
+        return;
+    }
+
+    buf[0] = (uint8_t)(info->mtu & 0xFF);
+    buf[1] = (uint8_t)(info->mtu >> 8);
+    buf[2] = (uint8_t)(info->tx_octets & 0xFF);
+    buf[3] = (uint8_t)(info->tx_octets >> 8);
+    buf[4] = (uint8_t)(info->rx_octets & 0xFF);
+    buf[5] = (uint8_t)(info->rx_octets >> 8);
+    buf[6] = info->tx_phy;
+    buf[7] = info->rx_phy;
+    buf[8] = (uint8_t)info->rssi;
+}
+
+void Link_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                     ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    uint8_t conidx = KE_IDX_GET(src_id);
+
+    if (conidx >= APP_MAX_NB_CON)
+    {
+        return;
+    }
+
+    switch (msg_id)
+    {
+        case GATTC_MTU_CHANGED_IND:
+        {
+            const struct gattc_mtu_changed_ind *p = param;
+
+            link_info[conidx].mtu = p->mtu;
+            APP_LOG_INFO("__LINK conidx=%d: MTU %d\r\n", conidx, p->mtu);
+        }
+        break;
+
+        case GAPC_LE_PKT_SIZE_IND:
+        {
+            const struct gapc_le_pkt_size_ind *p = param;
+
+            link_info[conidx].tx_octets = p->max_tx_octets;
+            link_info[conidx].rx_octets = p->max_rx_octets;
+            APP_LOG_INFO("__LINK conidx=%d: data length tx %d rx %d\r\n",
+                         conidx, p->max_tx_octets, p->max_rx_octets);
+        }
+        break;
+
+        case GAPC_LE_PHY_IND:
+        {
+            const struct gapc_le_phy_ind *p = param;
+
+            link_info[conidx].tx_phy = p->tx_phy;
+            link_info[conidx].rx_phy = p->rx_phy;
+            APP_LOG_INFO("__LINK conidx=%d: PHY tx %d rx %d\r\n",
+                         conidx, p->tx_phy, p->rx_phy);
+        }
+        break;
+
+        case GAPC_CON_RSSI_IND:
+        {
+            const struct gapc_con_rssi_ind *p = param;
+
+            link_info[conidx].rssi = p->rssi;
+            Link_SelectPhy(conidx, p->rssi);
+        }
+        break;
+
+        case GAPC_DISCONNECT_IND:
+        {
+            Link_Reset(conidx);
+        }
+        break;
+    }
+}
@@ -0,0 +1,387 @@
+/******************************************************************************
+ * File Name        : app_log.c
+ * Description      : This module implements the tokenized binary log (see
+ *                    app_log.h).
+ *
+ *                    Producers reserve space by advancing the ring head with
+ *                    an exclusive load/store, write the arguments and then
+ *                    the header, which commits the record. The drain only
+ *                    consumes up to the first record whose header is still
+ *                    zero, clears what it consumed and then advances the
+ *                    tail, so a producer never reuses words before they are
+ *                    cleared.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_log.h>
+#include <app_stream.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define APP_LOG_RING_MASK               (APP_LOG_RING_WORDS - 1)
+#define APP_LOG_STORE_WORDS             (APP_LOG_STORE_SIZE / 4)
+
+static volatile uint32_t log_ring[APP_LOG_RING_WORDS];
+
+// Free-running word indexes, head is advanced by producers, tail by the drain
+static volatile uint32_t log_head;
+static volatile uint32_t log_tail;
+
+static volatile uint32_t log_dropped;
+static uint32_t log_dropped_reported;
+
+// Drained records, byte offsets since boot of the first and next record
+static uint32_t log_store[APP_LOG_STORE_WORDS];
+static uint32_t log_store_begin;
+static uint32_t log_store_end;
+
+static uint32_t AppLog_StreamBegin(void);
+static uint32_t AppLog_StreamEnd(void);
+static uint16_t AppLog_StreamRead(uint32_t offset, uint8_t *buf, uint16_t length);
+
+static const struct stream_source_t log_source =
+{
+    .begin = AppLog_StreamBegin,
+    .end   = AppLog_StreamEnd,
+    .read  = AppLog_StreamRead,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : AppLog_Reserve
+ *
+ * Description   : Claim consecutive ring words for one record.
+ *
+ * Parameters    : uint32_t words   : record length in words
+ *                 uint32_t *index : first word of the reservation
+ *
+ * Returns       : bool : true if reserved, false if the ring is full
+ */
+static bool AppLog_Reserve(uint32_t words, uint32_t *index)
+{
+    uint32_t head;
+
+    do
+    {
+        head = __LDREXW((volatile uint32_t *)&log_head);
+        if ((head - log_tail + words) > APP_LOG_RING_WORDS)
+        {
+            __CLREX();
+            log_dropped++;
+            return false;
+        }
+    } while (__STREXW(head + words, (volatile uint32_t *)&log_head) != 0);
+
+    *index = head;
+    return true;
+}
+
+/* Function      : AppLog_Header
+ *
+ * Description   : Build a record header.
+ *
+ * Parameters    : uint8_t level   : log level
+ *                 const char *fmt : format string in .applog_fmt
+ *                 uint32_t flags  : APP_LOG_HDR_BUFFER or 0
+ *                 uint32_t nargs  : argument words
+ *
+ * Returns       : uint32_t : header word
+ */
+static inline uint32_t AppLog_Header(uint8_t level, const char *fmt,
+                                     uint32_t flags, uint32_t nargs)
+{
+    return ((uint32_t)(uintptr_t)fmt << APP_LOG_HDR_TOKEN_SHIFT) |
+           ((uint32_t)(level & APP_LOG_HDR_LEVEL_MASK) << APP_LOG_HDR_LEVEL_SHIFT) |
+           flags | nargs;
+}
+
+void AppLog_Write(uint8_t level, const char *fmt, const uint32_t *args, uint8_t nargs)
+{
+    uint32_t index;
+
+    if (nargs > APP_LOG_ARGS_MAX)
+    {
+        nargs = APP_LOG_ARGS_MAX;
+    }
+
+    if (!AppLog_Reserve(1 + nargs, &index))
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < nargs; i++)
+    {
+        log_ring[(index + 1 + i) & APP_LOG_RING_MASK] = args[i];
+    }
+
+    // Arguments before the header, the header commits the record
+    __DMB();
+    log_ring[index & APP_LOG_RING_MASK] = AppLog_Header(level, fmt, 0, nargs);
+}
+
+void AppLog_WriteBuffer(uint8_t level, const char *fmt, const uint8_t *data, uint16_t length)
+{
+    uint32_t index;
+    uint32_t nargs;
+
+    if (length > APP_LOG_BUFFER_MAX)
+    {
+        length = APP_LOG_BUFFER_MAX;
+    }
+
+    nargs = 1 + ((length + 3) / 4);
+    if (!AppLog_Reserve(1 + nargs, &index))
+    {
+        return;
+    }
+
+    log_ring[(index + 1) & APP_LOG_RING_MASK] = length;
+    for (uint32_t i = 1; i < nargs; i++)
+    {
+        uint32_t word = 0;
+
+        for (uint32_t b = 0; b < 4; b++)
+        {
+            uint32_t pos = ((i - 1) * 4) + b;
+
+            if (pos < length)
+            {
+                word |= (uint32_t)data[pos] << (8 * b);
+            }
+        }
+
+        log_ring[(index + 1 + i) & APP_LOG_RING_MASK] = word;
+    }
+
+    __DMB();
+    log_ring[index & APP_LOG_RING_MASK] = AppLog_Header(level, fmt, APP_LOG_HDR_BUFFER, nargs);
+}
+
+#ifdef APP_LOG_UART
+/* Function      : AppLog_Print
+ *
+ * Description   : Print a record as one line of hex words ("#L w0 w1 ...")
+ *                 for log_decoder.py, without going through printf.
+ *
+ * Parameters    : const uint32_t *record : record words
+ *                 uint32_t words         : record length in words
+ *
+ * Returns       : None
+ */
+static void AppLog_Print(const uint32_t *record, uint32_t words)
+{
+    static const char hex[] = "0123456789abcdef";
+    char line[3 + ((1 + APP_LOG_ARGS_MAX) * 9) + 3];
+    uint32_t n = 0;
+
+    line[n++] = '#';
+    line[n++] = 'L';
+    for (uint32_t i = 0; i < words; i++)
+    {
+        line[n++] = ' ';
+        for (int32_t shift = 28; shift >= 0; shift -= 4)
+        {
+            line[n++] = hex[(record[i] >> shift) & 0xF];
+        }
+    }
+    line[n++] = '\r';
+    line[n++] = '\n';
+    line[n] = '\0';
+
+    swmLogInfo("%s", line);
+}
+#endif    /* APP_LOG_UART */
+
+/* Function      : AppLog_Store
+ *
+ * Description   : Append a record to the store, dropping whole records from
+ *                 the front when it is full so a stream always starts on a
+ *                 record boundary.
+ *
+ * Parameters    : const uint32_t *record : record words
+ *                 uint32_t words         : record length in words
+ *
+ * Returns       : None
+ */
+static void AppLog_Store(const uint32_t *record, uint32_t words)
+{
+    uint32_t bytes = words * 4;
+
+    while ((log_store_end + bytes - log_store_begin) > APP_LOG_STORE_SIZE)
+    {
+        uint32_t header = log_store[(log_store_begin / 4) % APP_LOG_STORE_WORDS];
+
+        log_store_begin += (1 + (header & APP_LOG_HDR_NARGS_MASK)) * 4;
+    }
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        log_store[((log_store_end / 4) + i) % APP_LOG_STORE_WORDS] = record[i];
+    }
+
+    log_store_end += bytes;
+}
+
+bool AppLog_Drain(void)
+{
+    uint32_t record[1 + APP_LOG_ARGS_MAX];
+    uint32_t dropped;
+
+#ifdef APP_LOG_UART
+    // Formatting the records is the cost of the drain
+    Clock_Request(CLOCK_LOG, (log_tail != log_head) ? CLOCK_LEVEL_MID : CLOCK_LEVEL_LOW);
+#endif    /* APP_LOG_UART */
+
+    for (uint8_t count = 0; count < APP_LOG_DRAIN_MAX; count++)
+    {
+        uint32_t tail = log_tail;
+        uint32_t words;
+
+        if (tail == log_head)
+        {
+            break;
+        }
+
+        // Reserved but not committed yet
+        record[0] = log_ring[tail & APP_LOG_RING_MASK];
+        if (record[0] == 0)
+        {
+            break;
+        }
+
+        __DMB();
+        words = 1 + (record[0] & APP_LOG_HDR_NARGS_MASK);
+        for (uint32_t i = 0; i < words; i++)
+        {
+            record[i] = log_ring[(tail + i) & APP_LOG_RING_MASK];
+            log_ring[(tail + i) & APP_LOG_RING_MASK] = 0;
+        }
+
+        // Words cleared before they are handed back to the producers
+        __DMB();
+        log_tail = tail + words;
+
+        AppLog_Store(record, words);
+#ifdef APP_LOG_UART
+        Energy_Begin(ENERGY_UART);
+        AppLog_Print(record, words);
+        Energy_End(ENERGY_UART);
+#endif    /* APP_LOG_UART */
+    }
+
+    dropped = log_dropped;
+    if (dropped != log_dropped_reported)
+    {
+        APP_LOG_WARN("__LOG %lu records dropped\r\n", dropped - log_dropped_reported);
+        log_dropped_reported = dropped;
+    }
+
+    return (log_tail != log_head);
+}
+
+bool AppLog_IsBusy(void)
+{
+    return (log_tail != log_head);
+}
+
+uint32_t AppLog_GetDropped(void)
+{
+    return log_dropped;
+}
+
+/* Function      : AppLog_StreamBegin
+ *
+ * Description   : Offset of the oldest record still in the store.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : stream offset
+ */
+static uint32_t AppLog_StreamBegin(void)
+{
+    return log_store_begin;
+}
+
+/* Function      : AppLog_StreamEnd
+ *
+ * Description   : Offset just past the newest record.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : stream offset
+ */
+static uint32_t AppLog_StreamEnd(void)
+{
+    return log_store_end;
+}
+
+/* Function      : AppLog_StreamRead
+ *
+ * Description   : Copy store bytes starting at a stream offset, unwrapping
+ *                 the ring.
+ *
+ * Parameters    : uint32_t offset  : stream offset
+ *                 uint8_t *buf     : destination
+ *                 uint16_t length  : bytes wanted
+ *
+ * Returns       : uint16_t : bytes copied, 0 if offset is no longer stored
+ */
+static uint16_t AppLog_StreamRead(uint32_t offset, uint8_t *buf, uint16_t length)
+{
+    const uint8_t *store = (const uint8_t *)log_store;
+    uint16_t copied = 0;
+
+    if ((offset < log_store_begin) || (offset >= log_store_end))
+    {
+        return 0;
+    }
+
+    if ((log_store_end - offset) < length)
+    {
+        length = (uint16_t)(log_store_end - offset);
+    }
+
+    while (copied < length)
+    {
+        uint32_t pos = (offset + copied) % APP_LOG_STORE_SIZE;
+        uint32_t chunk = APP_LOG_STORE_SIZE - pos;
+
+        if (chunk > (uint32_t)(length - copied))
+        {
+            chunk = length - copied;
+        }
+
+        memcpy(&buf[copied], &store[pos], chunk);
+        copied += (uint16_t)chunk;
+    }
+
+    return copied;
+}
+
+void AppLog_Initialize(void)
+{
+    memset((void *)log_ring, 0, sizeof(log_ring));
+    log_head = 0;
+    log_tail = 0;
+    log_dropped = 0;
+    log_dropped_reported = 0;
+    log_store_begin = 0;
+    log_store_end = 0;
+
+    Stream_RegisterSource(STREAM_SRC_LOG, &log_source);
+}
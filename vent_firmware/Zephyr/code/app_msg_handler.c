@@ -32,8 +32,6 @@ uint8_t app_scan_rsp_data_len;
 /* Application custom service database */
 cust_svc_desc app_cust_svc_db[APP_NUM_CUST_SVC];
 
-GAPM_ActivityStatus_t advActivityStatus;
-
 struct gapm_set_dev_config_cmd devConfigCmd =
 {
     .operation = GAPM_SET_DEV_CONFIG,
@@ -50,54 +48,16 @@ struct gapm_set_dev_config_cmd devConfigCmd =
     .gap_start_hdl = GAPM_DEFAULT_GAP_START_HDL,
     .gatt_start_hdl = GAPM_DEFAULT_GATT_START_HDL,
     .att_cfg = GAPM_DEFAULT_ATT_CFG,
-    .sugg_max_tx_octets = GAPM_DEFAULT_TX_OCT_MAX,
-    .sugg_max_tx_time = GAPM_DEFAULT_TX_TIME_MAX,
-    .max_mtu = GAPM_DEFAULT_MTU_MAX,
-    .max_mps = GAPM_DEFAULT_MPS_MAX,
-    .max_nb_lecb = GAPM_DEFAULT_MAX_NB_LECB,
+    .sugg_max_tx_octets = LINK_MAX_TX_OCTETS,
+    .sugg_max_tx_time = LINK_MAX_TX_TIME,
+    .max_mtu = LINK_MAX_MTU,
+    .max_mps = LINK_MAX_MPS,
+    .max_nb_lecb = STREAM_MAX_CHANNELS,
     .audio_cfg = GAPM_DEFAULT_AUDIO_CFG,
     .tx_pref_phy = GAP_PHY_ANY,
     .rx_pref_phy = GAP_PHY_ANY,
 };
 
-struct gapm_adv_create_param advParam =
-{
-#if ADV_EXTENSION == 1
-    .type = GAPM_ADV_TYPE_EXTENDED,
-#else  /* if ADV_EXTENSION == 1 */
-    .type = GAPM_ADV_TYPE_LEGACY,
-#endif /* if ADV_EXTENSION == 1 */
-
-    .disc_mode = GAPM_ADV_MODE_GEN_DISC,
-
-#if ADV_EXTENSION == 1
-    .prop = GAPM_EXT_ADV_PROP_UNDIR_CONN_MASK,
-#else  /* if ADV_EXTENSION == 1 */
-    .prop = GAPM_ADV_PROP_UNDIR_CONN_MASK,
-#endif /* if ADV_EXTENSION == 1 */
-
-    .filter_pol = ADV_ALLOW_SCAN_ANY_CON_ANY,
-    .max_tx_pwr = DEF_TX_POWER,
-    .prim_cfg = {
-        .adv_intv_min = APP_ADV_INT_MIN,
-        .adv_intv_max = APP_ADV_INT_MAX,
-        .chnl_map = GAPM_DEFAULT_ADV_CHMAP,
-#if ADV_EXTENSION == 1
-        .phy = GAPM_PHY_TYPE_LE_CODED,
-#else  /* if ADV_EXTENSION == 1 */
-        .phy = GAPM_PHY_TYPE_LE_1M,
-#endif /* if ADV_EXTENSION == 1 */
-    },
-
-#if ADV_EXTENSION == 1
-    .second_cfg = {
-        .phy = GAPM_PHY_TYPE_LE_CODED,
-        .max_skip = 0,
-        .adv_sid = 0,
-    },
-#endif /* if ADV_EXTENSION == 1 */
-};
-
 union gapc_bond_cfm_data pairingRsp =
 {
     .pairing_feat =
@@ -178,12 +138,12 @@ void BLE_ConfigHandler(ke_msg_id_t const msg_id, void const *param,
 
             if (p->operation == GAPM_RESET)    /* Step 2 */
             {
-                swmLogInfo("__GAPM_RESET completed. Setting BLE device configuration...\r\n");
+                APP_LOG_INFO("__GAPM_RESET completed. Setting BLE device configuration...\r\n");
 
                 /* Check privacy_cfg bit 0 to identify address type, public if not set */
                 if (devConfigCmd.privacy_cfg & GAPM_CFG_ADDR_PRIVATE)
                 {
-                    swmLogInfo("	devConfigCmd address to set static private random\r\n");
+                    APP_LOG_INFO("	devConfigCmd address to set static private random\r\n");
                 }
                 else
                 {
@@ -195,14 +155,10 @@ void BLE_ConfigHandler(ke_msg_id_t const msg_id, void const *param,
                      * using Device_BLE_Public_Address_Read() before calling Device_BLE_Param_Get() */
                     Device_BLE_Param_Get(PARAM_ID_BD_ADDRESS, &ble_dev_addr_len, ble_dev_addr_buf);
 
-                    swmLogInfo("	Device BLE public address read: ");
-                    for (int i = 0; i < GAP_BD_ADDR_LEN; i++)
-                    {
-                        swmLogInfo("0x%02x ", ble_dev_addr_buf[i]);
-                    }
-                    swmLogInfo("\r\n");
+                    APP_LOG_INFO_BUFFER("	Device BLE public address read (%d):",
+                                        ble_dev_addr_buf, GAP_BD_ADDR_LEN);
 
-                    swmLogInfo("	devConfigCmd address set to public\r\n");
+                    APP_LOG_INFO("	devConfigCmd address set to public\r\n");
                     memcpy(devConfigCmd.addr.addr, ble_dev_addr_buf, GAP_BD_ADDR_LEN);
                 }
 
@@ -217,17 +173,17 @@ void BLE_ConfigHandler(ke_msg_id_t const msg_id, void const *param,
             else if (p->operation == GAPM_SET_DEV_CONFIG &&
                      p->status == GAP_ERR_NO_ERROR) /* Step 3 - Add BASS profile */
             {
-                swmLogInfo("__GAPM_SET_DEV_CONFIG completed.\r\n");
+                APP_LOG_INFO("__GAPM_SET_DEV_CONFIG completed.\r\n");
 
                 BASS_ProfileTaskAddCmd();
-                swmLogInfo("    Adding BLE BASS profile...\r\n");
+                APP_LOG_INFO("    Adding BLE BASS profile...\r\n");
             }
         }
         break;
 
         case GAPM_PROFILE_ADDED_IND: /* Step 4 */
         {
-            swmLogInfo("__GAPM_PROFILE_ADDED_IND - profile added count=%d\r\n",
+            APP_LOG_INFO("__GAPM_PROFILE_ADDED_IND - profile added count=%d\r\n",
                     GAPM_GetProfileAddedCount());
 
             const struct gapm_profile_added_ind *p = param;
@@ -236,24 +192,24 @@ void BLE_ConfigHandler(ke_msg_id_t const msg_id, void const *param,
             {
                 if(p->prf_task_id == TASK_ID_BASS)	/* Step 4(a) - Add DISS profile */
                 {
-                    swmLogInfo("    BLE profile BASS added successfully...\r\n");
+                    APP_LOG_INFO("    BLE profile BASS added successfully...\r\n");
 
-                    /*Setting kernel timer to call BattLevelReadHandler after
-                     * BEGIN_TIMER_S seconds */
-                    ke_timer_set(APP_BATT_LEVEL_READ_TIMEOUT, TASK_APP, TIMER_SETTING_S(BEGIN_TIMER_S));
+                    /* First battery burst, later ones when a reading is
+                     * older than BATT_MAX_AGE_S */
+                    APP_BASS_RequestBattLevel();
 
                     DISS_ProfileTaskAddCmd();
-                    swmLogInfo("    Adding BLE DISS profile...\r\n");
+                    APP_LOG_INFO("    Adding BLE DISS profile...\r\n");
                 }
 
                 if(p->prf_task_id == TASK_ID_DISS)	/* Step 4(b) - Add customer service 0  */
                 {
-                    swmLogInfo("    BLE profile DISS added successfully...\r\n");
+                    APP_LOG_INFO("    BLE profile DISS added successfully...\r\n");
 
                     /* Request the stack to add our custom service 0 server to the attribute database.
                      * The stack sends back a GATTM_ADD_SVC_RSP event. */
                     GATTM_AddAttributeDatabase(CUSTOMSS_GetDatabaseDescription(CUST_SVC0), CS_NB0);
-                    swmLogInfo("    Adding custom service0...\r\n");
+                    APP_LOG_INFO("    Adding custom service0...\r\n");
                 }
             }
         }
@@ -261,28 +217,30 @@ void BLE_ConfigHandler(ke_msg_id_t const msg_id, void const *param,
 
         case GATTM_ADD_SVC_RSP: /* Step 5 */
         {
-            swmLogInfo("__GATTM_ADD_SVC_RSP - custom service added count=%d\r\n",
+            APP_LOG_INFO("__GATTM_ADD_SVC_RSP - custom service added count=%d\r\n",
                     GATTM_GetServiceAddedCount());
 
             if(GATTM_GetServiceAddedCount() < APP_NUM_CUST_SVC)	/* Step 5(a) - Add custom service 1 */
             {
-                swmLogInfo("    Custom Service 0 added successfully...\r\n");
+                APP_LOG_INFO("    Custom Service 0 added successfully...\r\n");
 
                 /* Request the stack to add our custom service 1 server to the attribute database.
                  * The stack sends back a GATTM_ADD_SVC_RSP event. */
                 GATTM_AddAttributeDatabase(CUSTOMSS_GetDatabaseDescription(CUST_SVC1), CS_NB1);
-                swmLogInfo("    Adding custom service1...\n");
+                APP_LOG_INFO("    Adding custom service1...\n");
             }
             else
             {
-                swmLogInfo("    Custom Service 1 added successfully...\r\n");
+                APP_LOG_INFO("    Custom Service 1 added successfully...\r\n");
 
                 if(GATTM_GetServiceAddedCount() == APP_NUM_CUST_SVC)	/* Step 5(b) - Create Advertising activity */
                 {
                     /* Request the stack to create an advertising activity.
-                     * The stack sends back a GAPM_ACTIVITY_CREATED_IND. See ActivityHandler for next steps. */
-                    swmLogInfo("    Creating Advertising activity...\r\n");
-                    GAPM_ActivityCreateAdvCmd(&advActivityStatus, GAPM_OWN_ADDR_TYPE, &advParam);
+                     * The stack sends back a GAPM_ACTIVITY_CREATED_IND. See Adv_MsgHandler for next steps. */
+                    APP_LOG_INFO("    Creating Advertising activity...\r\n");
+                    Adv_Start();
+                    Group_Start();
+                    Relay_Start();
                 }
 #if BUTTON_SECURE_ATTRIBUTE
 				uint8_t result = attm_att_update_perm(GATTM_GetHandle(CUST_SVC1, CS_BUTTON_VALUE_VAL1), PERM_MASK_NP, PERM_RIGHT_UNAUTH);
@@ -290,11 +248,11 @@ void BLE_ConfigHandler(ke_msg_id_t const msg_id, void const *param,
 				{
 					if (result == ATT_ERR_INVALID_HANDLE)
 					{
-						swmLogInfo("ERROR: Failed to update attribute permissions, handle doesn't exist in database...\r\n");
+						APP_LOG_ERROR("ERROR: Failed to update attribute permissions, handle doesn't exist in database...\r\n");
 					}
 					else if (result == ATT_ERR_REQUEST_NOT_SUPPORTED)
 					{
-						swmLogInfo("ERROR: Failed to update attribute permissions, attribute permission is fixed...\r\n");
+						APP_LOG_ERROR("ERROR: Failed to update attribute permissions, attribute permission is fixed...\r\n");
 					}
 				}
 #endif
@@ -304,64 +262,6 @@ void BLE_ConfigHandler(ke_msg_id_t const msg_id, void const *param,
     }
 }
 
-void BLE_ActivityHandler(ke_msg_id_t const msg_id, void const *param,
-                         ke_task_id_t const dest_id,
-                         ke_task_id_t const src_id)
-{
-    switch (msg_id)
-    {
-        case GAPM_CMP_EVT:
-        {
-            const struct gapm_cmp_evt *p = param;
-
-            if (p->operation == GAPM_SET_ADV_DATA)    /* Step 7 */
-            {
-                swmLogInfo("__GAPM_SET_ADV_DATA status = %d. Start advertising activity...\r\n", p->status);
-                GAPM_AdvActivityStart(advActivityStatus.actv_idx, 0, 0);
-                ke_timer_set(APP_LED_TIMEOUT, TASK_APP, TIMER_SETTING_S(2));    /* Start LED blinking */
-
-                /* From now on, this device is advertising. Any peer device can
-                 * connect, discover services, pair/bond/encrypt, etc.
-                 * When a peer device tries to connect, the stack sends back to the application
-                 * a GAPC_CONNECTION_REQ_IND. See ConnectionHandler for more details. */
-            }
-        }
-        break;
-
-        case GAPM_ACTIVITY_CREATED_IND:    /* Step 6 */
-        {
-            swmLogInfo("__GAPM_ACTIVITY_CREATED_IND actv_idx = %d. Setting adv and scan data...\r\n",
-                       advActivityStatus.actv_idx);
-
-            /* Request the stack to set the advertising and scan response data.
-             * The stack sends back a GAPM_CMP_EVT: operation = GAPM_SET_ADV_DATA. */
-#if ADV_EXTENSION == 0
-            GAPM_SetAdvDataCmd(GAPM_SET_SCAN_RSP_DATA, advActivityStatus.actv_idx,
-                               app_scan_rsp_data_len, app_scan_rsp_data);
-#endif /* if ADV_EXTENSION == 0 */
-            GAPM_SetAdvDataCmd(GAPM_SET_ADV_DATA, advActivityStatus.actv_idx,
-                               app_adv_data_len, app_adv_data);
-        }
-        break;
-
-        case GAPM_ACTIVITY_STOPPED_IND:
-        {
-            /* The advertising activity is stopped upon receiving
-             * connection request. Restart advertising if not connected to
-             * maximum number of peers configured for this application */
-            if ((GAPC_ConnectionCount() < APP_MAX_NB_CON))
-            {
-                swmLogInfo("__GAPM_ACTIVITY_STOPPED_IND. Restarting advertising...\r\n");
-                if (advActivityStatus.state == ACTIVITY_STATE_NOT_STARTED)
-                {
-                    GAPM_AdvActivityStart(advActivityStatus.actv_idx, 0, 0);
-                }
-            }
-        }
-        break;
-    }
-}
-
 void BLE_ConnectionHandler(ke_msg_id_t const msg_id, void const *param,
                            ke_task_id_t const dest_id, ke_task_id_t const src_id)
 {
@@ -372,11 +272,15 @@ void BLE_ConnectionHandler(ke_msg_id_t const msg_id, void const *param,
         case GAPC_CONNECTION_REQ_IND:    /* Step 8 */
         {
             const struct gapc_connection_req_ind *p = param;
-            swmLogInfo("__GAPC_CONNECTION_REQ_IND conidx=%d\r\n", conidx);
+            APP_LOG_INFO("__GAPC_CONNECTION_REQ_IND conidx=%d\r\n", conidx);
+
+            /* A hub reconnecting from the address it was last resolved from
+             * is confirmed with its cached bond (see Adv_MatchHub) */
+            bool cached = Adv_MatchHub(conidx, p->peer_addr.addr, p->peer_addr_type);
 
-            /* If the peer device address is private resolvable and bond list is not empty */
+            /* If the peer device address is private resolvable, not cached and bond list is not empty */
             if (GAP_IsAddrPrivateResolvable(p->peer_addr.addr, p->peer_addr_type) &&
-                BondList_Size() > 0)
+                !cached && BondList_Size() > 0)
             {
                 /* Ask the stack to resolve the address with the IRKs we have in our bond list.
                  * In case of success, the stack returns GAPM_ADDR_SOLVED_IND.
@@ -395,22 +299,16 @@ void BLE_ConnectionHandler(ke_msg_id_t const msg_id, void const *param,
 
         case GAPC_DISCONNECT_IND:
         {
-            swmLogInfo("__GAPC_DISCONNECT_IND: reason = %d\r\n",
+            /* Advertising is restarted by Adv_MsgHandler */
+            APP_LOG_INFO("__GAPC_DISCONNECT_IND: reason = %d\r\n",
                        ((struct gapc_disconnect_ind *)param)->reason);
-            /* If advertising activity is stopped, restart advertising while
-             * not connected to maximum number of peers for this application */
-            if (GAPC_ConnectionCount() == (APP_MAX_NB_CON - 1))
-            {
-                swmLogInfo("    Restarting advertising...\r\n");
-                GAPM_AdvActivityStart(advActivityStatus.actv_idx, 0, 0);
-            }
         }
         break;
 
         case GAPM_ADDR_SOLVED_IND:
         {
             /* Private address resolution was successful */
-            swmLogInfo("__GAPM_ADDR_SOLVED_IND\r\n");
+            APP_LOG_INFO("__GAPM_ADDR_SOLVED_IND\r\n");
             conidx = KE_IDX_GET(dest_id);
 
             /* Send confirmation */
@@ -433,14 +331,6 @@ void BLE_ConnectionHandler(ke_msg_id_t const msg_id, void const *param,
         }
         break;
 
-        case GAPC_PARAM_UPDATE_REQ_IND:
-        {
-            /* Peer device requested update in connection params. Accept it. */
-            GAPC_ParamUpdateCfm(conidx, true, 0xFFFF, 0xFFFF);
-            swmLogInfo("GAPC_PARAM_UPDATE_REQ_IND\r\n");
-        }
-        break;
-
         case GAPC_GET_DEV_INFO_REQ_IND:
         {
             /* Peer device requested information about the device (such as name,
@@ -448,7 +338,7 @@ void BLE_ConnectionHandler(ke_msg_id_t const msg_id, void const *param,
             const struct gapc_get_dev_info_req_ind *p = param;
 
             GAPC_GetDevInfoCfm(conidx, p->req, getDevInfoCfm[p->req]);
-            swmLogInfo("GAPC_GET_DEV_INFO_REQ_IND: req = %d\r\n", p->req);
+            APP_LOG_INFO("GAPC_GET_DEV_INFO_REQ_IND: req = %d\r\n", p->req);
         }
         break;
     }
@@ -483,14 +373,14 @@ void BLE_PairingHandler(ke_msg_id_t const msg_id, void const *param,
                         pairingRsp.pairing_feat.auth = GAP_AUTH_REQ_NO_MITM_BOND;
                         pairingRsp.pairing_feat.sec_req = GAP_NO_SEC;
                     }
-                    swmLogInfo("__GAPC_BOND_REQ_IND / GAPC_PAIRING_REQ: accept = %d conidx=%d\r\n", accept, conidx);
+                    APP_LOG_INFO("__GAPC_BOND_REQ_IND / GAPC_PAIRING_REQ: accept = %d conidx=%d\r\n", accept, conidx);
                     GAPC_BondCfm(conidx, GAPC_PAIRING_RSP, accept, &pairingRsp);
                 }
                 break;
 
                 case GAPC_NC_EXCH:
                 {
-                	swmLogInfo("__GAPC_BOND_REQ_IND / GAPC_NC_EXCH: accept = %d conidx=%d\r\n",true, conidx);
+                	APP_LOG_INFO("__GAPC_BOND_REQ_IND / GAPC_NC_EXCH: accept = %d conidx=%d\r\n",true, conidx);
 
                 	/* Print GAPC_NC_EXCH key */
                 	uint32_t ncExch = p->data.nc_data.value[3] << 24;
@@ -498,7 +388,7 @@ void BLE_PairingHandler(ke_msg_id_t const msg_id, void const *param,
                 	ncExch |= p->data.nc_data.value[1] << 8;
                 	ncExch |= p->data.nc_data.value[0];
 
-                	swmLogInfo("__GAPC_BOND_REQ_IND / GAPC_NC_EXCH: key = %d\r\n", ncExch);
+                	APP_LOG_INFO("__GAPC_BOND_REQ_IND / GAPC_NC_EXCH: key = %d\r\n", ncExch);
 
                 	/* For now we set accept=true for GAPC_NC_EXCH request in order to accept
                 	 * request and complete pairing successfully. */
@@ -510,7 +400,7 @@ void BLE_PairingHandler(ke_msg_id_t const msg_id, void const *param,
                 case GAPC_LTK_EXCH:
                 {
                     /* Prepare and send random LTK (legacy only) */
-                    swmLogInfo("__GAPC_BOND_REQ_IND / GAPC_LTK_EXCH\r\n");
+                    APP_LOG_INFO("__GAPC_BOND_REQ_IND / GAPC_LTK_EXCH\r\n");
                     union gapc_bond_cfm_data ltkExch;
                     ltkExch.ltk.ediv = co_rand_hword();
 
@@ -529,7 +419,7 @@ void BLE_PairingHandler(ke_msg_id_t const msg_id, void const *param,
                 /* Prepare and send TK */
                 case GAPC_TK_EXCH:
                 {
-                    swmLogInfo("__GAPC_BOND_REQ_IND / GAPC_TK_EXCH\r\n");
+                    APP_LOG_INFO("__GAPC_BOND_REQ_IND / GAPC_TK_EXCH\r\n");
                     /* IO Capabilities are set to GAP_IO_CAP_NO_INPUT_NO_OUTPUT in this application.
                      * Therefore TK exchange is NOT performed. It is always set to 0 (Just Works algorithm). */
                 }
@@ -537,7 +427,7 @@ void BLE_PairingHandler(ke_msg_id_t const msg_id, void const *param,
 
                 case GAPC_IRK_EXCH:
                 {
-                    swmLogInfo("__GAPC_BOND_REQ_IND / GAPC_IRK_EXCH\r\n");
+                    APP_LOG_INFO("__GAPC_BOND_REQ_IND / GAPC_IRK_EXCH\r\n");
                     union gapc_bond_cfm_data irkExch;
                     memcpy(irkExch.irk.addr.addr.addr, GAPM_GetDeviceConfig()->addr.addr, GAP_BD_ADDR_LEN);
                     irkExch.irk.addr.addr_type = GAPM_GetDeviceConfig()->privacy_cfg;
@@ -550,7 +440,7 @@ void BLE_PairingHandler(ke_msg_id_t const msg_id, void const *param,
 
                 case GAPC_CSRK_EXCH:
                 {
-                    swmLogInfo("__GAPC_BOND_REQ_IND / GAPC_CSRK_EXCH\r\n");
+                    APP_LOG_INFO("__GAPC_BOND_REQ_IND / GAPC_CSRK_EXCH\r\n");
                     union gapc_bond_cfm_data csrkExch;
 
                     /* Send confirmation */
@@ -567,12 +457,12 @@ void BLE_PairingHandler(ke_msg_id_t const msg_id, void const *param,
 
             if (p->info == GAPC_PAIRING_SUCCEED)
             {
-                swmLogInfo("__GAPC_BOND_IND / GAPC_PAIRING_SUCCEED\r\n");
+                APP_LOG_INFO("__GAPC_BOND_IND / GAPC_PAIRING_SUCCEED\r\n");
                 GAPC_AddDeviceToBondList(conidx);
             }
             else if (p->info == GAPC_PAIRING_FAILED)
             {
-                swmLogError("__GAPC_BOND_IND / GAPC_PAIRING_FAILED reason=%d\r\n", p->data.reason);
+                APP_LOG_ERROR("__GAPC_BOND_IND / GAPC_PAIRING_FAILED reason=%d\r\n", p->data.reason);
             }
         }
         break;
@@ -582,19 +472,20 @@ void BLE_PairingHandler(ke_msg_id_t const msg_id, void const *param,
             /* Peer device was bonded previously and wants to encrypt the link.
              * Accept request if the bond information is valid & EDIV/RAND match */
             const struct gapc_encrypt_req_ind *p = param;
+            const BondInfo_t *bond = Adv_GetBondInfo(conidx);
 
-            bool found = (GAPC_IsBonded(conidx) &&
-                          p->ediv == GAPC_GetBondInfo(conidx)->ediv &&
-                          !memcmp(p->rand_nb.nb, GAPC_GetBondInfo(conidx)->rand, GAP_RAND_NB_LEN));
+            bool found = (bond != NULL &&
+                          p->ediv == bond->ediv &&
+                          !memcmp(p->rand_nb.nb, bond->rand, GAP_RAND_NB_LEN));
 
-            swmLogInfo("__GAPC_ENCRYPT_REQ_IND: bond information %s\r\n", (found ? "FOUND" : "NOT FOUND"));
-            GAPC_EncryptCfm(conidx, found, GAPC_GetBondInfo(conidx)->ltk, GAP_KEY_LEN);
+            APP_LOG_INFO("__GAPC_ENCRYPT_REQ_IND: bond information %s\r\n", APP_LOG_STR(found ? "FOUND" : "NOT FOUND"));
+            GAPC_EncryptCfm(conidx, found, (found ? bond->ltk : GAPC_GetBondInfo(conidx)->ltk), GAP_KEY_LEN);
         }
         break;
 
         case GAPC_ENCRYPT_IND:
         {
-            swmLogInfo("__GAPC_ENCRYPT_IND: Link encryption is ON\r\n");
+            APP_LOG_INFO("__GAPC_ENCRYPT_IND: Link encryption is ON\r\n");
         }
         break;
     }
@@ -612,30 +503,34 @@ static void SetConnectionCfmParams(uint8_t conidx, struct gapc_connection_cfm *c
     cfm->gatt_end_handle = 0;
     cfm->svc_chg_handle = 0;
 
-    if (GAPC_IsBonded(conidx))
+    const BondInfo_t *bond = Adv_GetBondInfo(conidx);
+
+    if (bond != NULL)
     {
         cfm->ltk_present = true;
-        memcpy(cfm->rcsrk.key, GAPC_GetBondInfo(conidx)->csrk, KEY_LEN);
+        memcpy(cfm->rcsrk.key, bond->csrk, KEY_LEN);
         cfm->lsign_counter = 0xFFFFFFFF;
         cfm->rsign_counter = 0;
-        cfm->pairing_lvl = GAPC_GetBondInfo(conidx)->pairing_lvl;
+        cfm->pairing_lvl = bond->pairing_lvl;
     }
-    swmLogInfo("  connectionCfm->ltk_present = %d\r\n", cfm->ltk_present);
-    swmLogInfo("  connectionCfm->pairing_lvl = %d\r\n", cfm->pairing_lvl);
+    APP_LOG_INFO("  connectionCfm->ltk_present = %d\r\n", cfm->ltk_present);
+    APP_LOG_INFO("  connectionCfm->pairing_lvl = %d\r\n", cfm->pairing_lvl);
 }
 
 void PrepareAdvScanData(void)
 {
     uint8_t companyID[] = APP_COMPANY_ID;
     uint8_t devName[]   = APP_DEVICE_NAME;
+    uint8_t telemetry[GROUP_TELEMETRY_LENGTH];
 
-    /* Assemble advertising data as device name + company ID and
-     * copy into app_adv_data */
+    /* Assemble advertising data as device name + company ID with the group
+     * telemetry frame (see app_group.h) and copy into app_adv_data */
+    Group_PackTelemetry(telemetry);
     app_adv_data_len = 0;
     GAP_AddAdvData(APP_DEVICE_NAME_LEN + 1, GAP_AD_TYPE_COMPLETE_NAME,
                    devName, app_adv_data, &app_adv_data_len);
-    GAP_AddAdvData(APP_COMPANY_ID_LEN + 1, GAP_AD_TYPE_MANU_SPECIFIC_DATA,
-                   companyID, app_adv_data, &app_adv_data_len);
+    GAP_AddAdvData(GROUP_TELEMETRY_LENGTH + 1, GAP_AD_TYPE_MANU_SPECIFIC_DATA,
+                   telemetry, app_adv_data, &app_adv_data_len);
 
     /* Set scan response data as company ID */
     app_scan_rsp_data_len = 0;
@@ -651,11 +546,6 @@ void APP_SendConCfm(uint8_t conidx)
     /* Send connection confirmation */
     GAPC_ConnectionCfm(conidx, &cfm);
 
-#ifdef APP_PHY_UPDATE_REQ
-    GAPC_SetPhyCmd(conidx, APP_PREFERRED_PHY_RX, APP_PREFERRED_PHY_TX,
-                   APP_PREFERRED_CODED_PHY_RATE);
-#endif /* ifdef APP_PHY_UPDATE_REQ */
-
     /* Get Task IDs for each added profile/s */
     uint16_t added_profile_task_id[APP_MAX_NB_PROFILES];
     memcpy(added_profile_task_id, GAP_GetProfileAddedTaskId(), APP_MAX_NB_PROFILES);
@@ -667,15 +557,13 @@ void APP_SendConCfm(uint8_t conidx)
     	{
     		/* Enable BASS */
     		BASS_EnableReq(conidx);
-    		swmLogInfo("  Enabling BASS...\n");
+    		APP_LOG_INFO("  Enabling BASS...\n");
     		break;
     	}
     }
 
-#ifdef MTU_EXCHANGE
-    /* Start MTU exchange */
-    GATTC_MtuExchange(conidx);
-#endif /* ifdef MTU_EXCHANGE */
+    /* Negotiate MTU, data length and PHY for bulk transfers */
+    Link_Optimize(conidx);
 }
 
 /* The LED handler keeps running in parallel and blinking the
@@ -689,11 +577,33 @@ void LEDHandler(ke_msg_id_t const msg_id, void const *param,
     /* Blink LED according to the number of connections */
     switch (connectionCount)
     {
-        /* If no connections, toggle CONNECTION_STATE_GPIO every 200ms */
+        /* If no connections, toggle CONNECTION_STATE_GPIO every 200ms while
+         * advertising fast, then flash it once per period as the advertising
+         * interval grows (the LED is on when the GPIO is low) */
         case 0:
         {
-            ke_timer_set(APP_LED_TIMEOUT, TASK_APP, TIMER_SETTING_MS(200));
-            Sys_GPIO_Toggle(CONNECTION_STATE_GPIO);
+            static bool flash_on = false;
+            uint32_t period = Adv_GetLedPeriod();
+
+            if (period == 0)
+            {
+                ke_timer_set(APP_LED_TIMEOUT, TASK_APP, TIMER_SETTING_MS(200));
+                Sys_GPIO_Toggle(CONNECTION_STATE_GPIO);
+                flash_on = false;
+            }
+            else if (!flash_on)
+            {
+                ke_timer_set(APP_LED_TIMEOUT, TASK_APP, TIMER_SETTING_MS(ADV_LED_FLASH_MS));
+                Sys_GPIO_Set_Low(CONNECTION_STATE_GPIO);
+                flash_on = true;
+            }
+            else
+            {
+                ke_timer_set(APP_LED_TIMEOUT, TASK_APP,
+                             TIMER_SETTING_MS(period - ADV_LED_FLASH_MS));
+                Sys_GPIO_Set_High(CONNECTION_STATE_GPIO);
+                flash_on = false;
+            }
             toggle_cnt = 0;
         }
         break;
@@ -738,6 +648,9 @@ void SW1Handler(ke_msg_id_t const msg_id, void const *param,
     /* Clear bond list */
     if (BondList_RemoveAll())
     {
+        /* The cached hub bond is gone with it */
+        Adv_ForgetHub();
+
         /* Success, blink LED repeatedly */
         ke_timer_set(APP_SW1LED_TIMEOUT, TASK_APP, TIMER_SETTING_MS(0));
     }
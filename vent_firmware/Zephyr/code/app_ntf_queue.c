@@ -0,0 +1,267 @@
+/******************************************************************************
+ * File Name        : app_ntf_queue.c
+ * Description      : This module implements the per-connection notification
+ *                    queue (see app_ntf_queue.h).
+ *
+ *                    Pending values sit in a fixed array kept in FIFO order
+ *                    by an enqueue counter. Values handed to the stack move
+ *                    to the in-flight table until GATTC_CMP_EVT returns
+ *                    their sequence number.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <ble_abstraction.h>
+#include <swmTrace_api.h>
+#include <app.h>
+#include <app_ntf_queue.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+struct ntf_entry_t
+{
+    bool used;
+    uint8_t operation;
+    uint16_t handle;
+    uint16_t length;
+    uint16_t seq_num;           // in-flight entries only
+    uint32_t order;             // pending entries only, FIFO position
+    uint32_t queued_time;       // ke_time() when first queued
+    uint8_t value[NTF_QUEUE_VALUE_MAX];
+};
+
+struct ntf_queue_t
+{
+    struct ntf_entry_t pending[NTF_QUEUE_SLOTS];
+    struct ntf_entry_t in_flight[NTF_QUEUE_MAX_IN_FLIGHT];
+    uint32_t next_order;
+    uint16_t next_seq;
+    struct ntf_queue_stats_t stats;
+};
+
+static struct ntf_queue_t ntf_queue[APP_MAX_NB_CON];
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : NtfQueue_Oldest
+ *
+ * Description   : Find the oldest pending entry of a queue.
+ *
+ * Parameters    : struct ntf_queue_t *q : queue
+ *
+ * Returns       : struct ntf_entry_t * : oldest entry, NULL if none pending
+ */
+static struct ntf_entry_t * NtfQueue_Oldest(struct ntf_queue_t *q)
+{
+    struct ntf_entry_t *oldest = NULL;
+
+    for (uint8_t i = 0; i < NTF_QUEUE_SLOTS; i++)
+    {
+        if (q->pending[i].used &&
+            ((oldest == NULL) || ((int32_t)(q->pending[i].order - oldest->order) < 0)))
+        {
+            oldest = &q->pending[i];
+        }
+    }
+
+    return oldest;
+}
+
+/* Function      : NtfQueue_Pump
+ *
+ * Description   : Hand pending values to the stack, oldest first, while
+ *                 in-flight slots are free.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : None
+ */
+static void NtfQueue_Pump(uint8_t conidx)
+{
+    struct ntf_queue_t *q = &ntf_queue[conidx];
+
+    for (uint8_t i = 0; i < NTF_QUEUE_MAX_IN_FLIGHT; i++)
+    {
+        struct ntf_entry_t *entry;
+
+        if (q->in_flight[i].used)
+        {
+            continue;
+        }
+
+        entry = NtfQueue_Oldest(q);
+        if (entry == NULL)
+        {
+            return;
+        }
+
+        q->in_flight[i] = *entry;
+        q->in_flight[i].seq_num = NTF_QUEUE_SEQ_FLAG | (q->next_seq++ & ~NTF_QUEUE_SEQ_FLAG);
+        entry->used = false;
+        q->stats.depth--;
+
+        GATTC_SendEvtCmd(conidx, q->in_flight[i].operation, q->in_flight[i].seq_num,
+                         q->in_flight[i].handle, q->in_flight[i].length,
+                         q->in_flight[i].value);
+    }
+}
+
+void NtfQueue_Initialize(void)
+{
+    memset(ntf_queue, 0, sizeof(ntf_queue));
+}
+
+bool NtfQueue_Push(uint8_t conidx, uint8_t operation, uint16_t handle,
+                   uint16_t length, const uint8_t *value)
+{
+    struct ntf_queue_t *q;
+    struct ntf_entry_t *slot = NULL;
+
+    if ((conidx >= APP_MAX_NB_CON) || (length > NTF_QUEUE_VALUE_MAX) ||
+        !GAPC_IsConnectionActive(conidx))
+    {
+        return false;
+    }
+
+    q = &ntf_queue[conidx];
+
+    /* A newer value of the same attribute replaces the stale one and keeps
+     * its place in the queue */
+    for (uint8_t i = 0; i < NTF_QUEUE_SLOTS; i++)
+    {
+        if (q->pending[i].used && (q->pending[i].handle == handle) &&
+            (q->pending[i].operation == operation))
+        {
+            slot = &q->pending[i];
+            q->stats.replaced++;
+            break;
+        }
+    }
+
+    if (slot == NULL)
+    {
+        for (uint8_t i = 0; i < NTF_QUEUE_SLOTS; i++)
+        {
+            if (!q->pending[i].used)
+            {
+                slot = &q->pending[i];
+                break;
+            }
+        }
+
+        if (slot == NULL)
+        {
+            /* Full: memory stays bounded, the oldest value goes */
+            slot = NtfQueue_Oldest(q);
+            q->stats.dropped++;
+            q->stats.depth--;
+        }
+
+        slot->used = true;
+        slot->operation = operation;
+        slot->handle = handle;
+        slot->order = q->next_order++;
+        slot->queued_time = ke_time();
+        q->stats.depth++;
+
+        if (q->stats.depth > q->stats.depth_max)
+        {
+            q->stats.depth_max = q->stats.depth;
+        }
+    }
+
+    slot->length = length;
+    memcpy(slot->value, value, length);
+    q->stats.queued++;
+
+    NtfQueue_Pump(conidx);
+
+    return true;
+}
+
+const struct ntf_queue_stats_t * NtfQueue_GetStats(uint8_t conidx)
+{
+    if (conidx >= APP_MAX_NB_CON)
+    {
+        return NULL;
+    }
+
+    return &ntf_queue[conidx].stats;
+}
+
+void NtfQueue_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                         ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    uint8_t conidx = KE_IDX_GET(src_id);
+    struct ntf_queue_t *q;
+
+    if (conidx >= APP_MAX_NB_CON)
+    {
+        return;
+    }
+
+    q = &ntf_queue[conidx];
+
+    switch (msg_id)
+    {
+        case GATTC_CMP_EVT:
+        {
+            const struct gattc_cmp_evt *p = param;
+
+            if (((p->operation != GATTC_NOTIFY) && (p->operation != GATTC_INDICATE)) ||
+                !(p->seq_num & NTF_QUEUE_SEQ_FLAG))
+            {
+                break;
+            }
+
+            for (uint8_t i = 0; i < NTF_QUEUE_MAX_IN_FLIGHT; i++)
+            {
+                if (q->in_flight[i].used && (q->in_flight[i].seq_num == p->seq_num))
+                {
+                    uint32_t latency = ke_time() - q->in_flight[i].queued_time;
+
+                    q->in_flight[i].used = false;
+                    q->stats.completed++;
+                    q->stats.latency_sum += latency;
+                    if (latency > q->stats.latency_max)
+                    {
+                        q->stats.latency_max = latency;
+                    }
+
+                    if (p->status != GAP_ERR_NO_ERROR)
+                    {
+                        q->stats.failed++;
+                    }
+                    break;
+                }
+            }
+
+            NtfQueue_Pump(conidx);
+        }
+        break;
+
+        case GAPC_DISCONNECT_IND:
+        {
+            APP_LOG_INFO("__NTF_QUEUE conidx=%d: queued %lu, replaced %lu, dropped %lu, "
+                         "completed %lu (failed %lu), max depth %d, max latency %lu\r\n",
+                         conidx, (unsigned long)q->stats.queued,
+                         (unsigned long)q->stats.replaced, (unsigned long)q->stats.dropped,
+                         (unsigned long)q->stats.completed, (unsigned long)q->stats.failed,
+                         q->stats.depth_max, (unsigned long)q->stats.latency_max);
+            memset(q, 0, sizeof(struct ntf_queue_t));
+        }
+        break;
+    }
+}
@@ -0,0 +1,243 @@
+/******************************************************************************
+ * File Name        : app_power.c
+ * Description      : This module implements the power manager (see
+ *                    app_power.h).
+ *
+ *                    The residency is counted at every state change from the
+ *                    baseband clock. The clock is brought up to date by the
+ *                    stack after a sleep, so the sleep is closed on the
+ *                    first idle after the wakeup and includes the restore
+ *                    and the work that woke the chip (well under 1 % of a
+ *                    typical sleep).
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_power.h>
+#include <app_cycles.h>
+#include <rwip.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+// Baseband clock wraps at 2^28 half slots (~23 h)
+#define POWER_CLOCK_MASK                (0x0FFFFFFFU)
+
+// Half slots of 312.5 us to microseconds
+#define POWER_HS_TO_US(hs)              (((uint64_t)(hs) * 625) / 2)
+
+struct power_env_tag
+{
+    uint8_t state;              // enum power_state
+    uint32_t since;             // half slots, start of the current state
+    uint32_t run_start;         // cycle count, start of the run state
+    struct power_stats_t stats;
+};
+
+static struct power_env_tag power_env;
+
+// Sleep mode configuration handed to the stack
+static struct sleep_mode_env_tag power_sleep_env;
+
+#define POWER_BUSY_QUERY(name, query)   query,
+
+static bool (*const power_busy_query[POWER_BUSY_COUNT])(void) =
+{
+    POWER_BUSY_TABLE(POWER_BUSY_QUERY)
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Power_SetState
+ *
+ * Description   : Count the time spent in the current state and switch to
+ *                 a new one. The run time is charged to the energy
+ *                 accounts from the cycle counter, the idle and sleep time
+ *                 from the baseband clock.
+ *
+ * Parameters    : uint8_t state : enum power_state
+ *
+ * Returns       : None
+ */
+static void Power_SetState(uint8_t state)
+{
+    uint32_t now = rwip_time_get().hs;
+    uint32_t elapsed = (now - power_env.since) & POWER_CLOCK_MASK;
+
+    power_env.stats.residency[power_env.state] += elapsed;
+
+    switch (power_env.state)
+    {
+        case POWER_STATE_RUN:
+        {
+            Energy_AddCycles(Cycles_Since(power_env.run_start));
+        }
+        break;
+
+        case POWER_STATE_IDLE:
+        {
+            Energy_AddTime(ENERGY_IDLE, POWER_HS_TO_US(elapsed));
+        }
+        break;
+
+        default:
+        {
+            Energy_AddTime(ENERGY_SLEEP, POWER_HS_TO_US(elapsed));
+        }
+        break;
+    }
+
+    power_env.state = state;
+    power_env.since = now;
+    power_env.run_start = Cycles_Now();
+}
+
+void Power_Initialize(void)
+{
+    memset(&power_env, 0, sizeof(power_env));
+    power_env.state = POWER_STATE_RUN;
+    power_env.since = rwip_time_get().hs;
+    power_env.run_start = Cycles_Now();
+
+    // Wake on the baseband timer (programmed by the stack for the next radio
+    // event or kernel timer) and on a button press
+    power_sleep_env.wakeup_cfg = (WAKEUP_DELAY_32 | WAKEUP_DCDC_OVERLOAD_DISABLE |
+                                  WAKEUP_GPIO0_ENABLE | WAKEUP_GPIO0_FALLING);
+    power_sleep_env.wakeup_ctrl = (PADS_RETENTION_EN_BYTE | WAKEUP_BB_TIMER_CLEAR |
+                                   WAKEUP_GPIO0_EVENT_CLEAR | WAKEUP_PAD_EVENT_CLEAR |
+                                   WAKEUP_DCDC_OVERLOAD_CLEAR);
+    power_sleep_env.mem_power_cfg = POWER_SLEEP_MEM_RETENTION;
+    power_sleep_env.mem_power_cfg_wakeup = POWER_SLEEP_MEM_RETENTION;
+    power_sleep_env.wakeup_addr = (uint32_t)Power_WakeupFromSleep;
+
+    ke_timer_set(POWER_REPORT_TIMEOUT, TASK_APP, TIMER_SETTING_S(POWER_REPORT_S));
+}
+
+void Power_Idle(void)
+{
+    bool busy = !POWER_SLEEP_ENABLE;
+
+    GLOBAL_INT_DISABLE();
+
+    // An event posted by an interrupt since the scheduler ran is handled
+    // first, the core would otherwise wait for the next interrupt
+    if (!AppSched_IsPending())
+    {
+        for (uint8_t i = 0; !busy && (i < POWER_BUSY_COUNT); i++)
+        {
+            if (power_busy_query[i]())
+            {
+                power_env.stats.vetoes[i]++;
+                busy = true;
+            }
+        }
+
+        if (!busy)
+        {
+            // Does not return if the stack puts the chip to sleep, which it
+            // refuses when the next event is closer than the wakeup time
+            Power_SetState(POWER_STATE_SLEEP);
+            BLE_Power_Mode_Enter(&power_sleep_env, POWER_MODE_SLEEP);
+            power_env.stats.refused++;
+        }
+
+        Power_SetState(POWER_STATE_IDLE);
+        __WFI();
+        Power_SetState(POWER_STATE_RUN);
+    }
+
+    GLOBAL_INT_RESTORE();
+}
+
+void Power_WakeupFromSleep(void)
+{
+    uint32_t trim_error;
+
+    // Clocks and flash first, the peripherals run from them
+    trim_error = DeviceClockInit();
+    DeviceGPIOInit();
+    BLERadioInit();
+
+    Temperature_Sensor_Init(trim_error);
+    LSAD_ChannelConfig();
+    restore_i2c_connection();
+    restore_servo();
+    SWMTraceInit();
+    Cycles_Resume();
+    Clock_Restore();
+
+    IRQPriorityInit();
+    EnableBLEInterrupts();
+    EnableAppInterrupts();
+
+    // A press that woke the chip is handled as if the interrupt had run
+    if (ACS->WAKEUP_CTRL & WAKEUP_GPIO0_EVENT_SET)
+    {
+        NVIC_SetPendingIRQ(GPIO0_IRQn);
+    }
+
+    power_env.stats.sleeps++;
+
+    PRIMASK_FAULTMASK_ENABLE_INTERRUPTS();
+    main_loop();
+}
+
+bool Power_TraceBusy(void)
+{
+#if SWMTRACE_ENABLE
+    return ((UART->STATUS & UART_TX_BUSY) != 0);
+#else  /* if SWMTRACE_ENABLE */
+    return false;
+#endif /* if SWMTRACE_ENABLE */
+}
+
+const struct power_stats_t *Power_GetStats(void)
+{
+    Power_SetState(power_env.state);
+
+    return &power_env.stats;
+}
+
+void Power_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    if (msg_id == POWER_REPORT_TIMEOUT)
+    {
+        const struct power_stats_t *stats = Power_GetStats();
+        uint64_t total = 0;
+        uint32_t permille[POWER_STATE_COUNT];
+
+        for (uint8_t i = 0; i < POWER_STATE_COUNT; i++)
+        {
+            total += stats->residency[i];
+        }
+
+        for (uint8_t i = 0; i < POWER_STATE_COUNT; i++)
+        {
+            permille[i] = (total == 0) ? 0 : (uint32_t)((stats->residency[i] * 1000) / total);
+        }
+
+        APP_LOG_INFO("__POWER run %lu, idle %lu, sleep %lu permille; %lu sleeps, %lu refused\r\n",
+                     permille[POWER_STATE_RUN], permille[POWER_STATE_IDLE],
+                     permille[POWER_STATE_SLEEP], stats->sleeps, stats->refused);
+        APP_LOG_DEBUG("__POWER vetoes i2c %lu, servo %lu, log %lu, lsad %lu, trace %lu\r\n",
+                      stats->vetoes[POWER_BUSY_I2C], stats->vetoes[POWER_BUSY_SERVO],
+                      stats->vetoes[POWER_BUSY_LOG], stats->vetoes[POWER_BUSY_LSAD],
+                      stats->vetoes[POWER_BUSY_TRACE]);
+
+        ke_timer_set(POWER_REPORT_TIMEOUT, TASK_APP, TIMER_SETTING_S(POWER_REPORT_S));
+    }
+}
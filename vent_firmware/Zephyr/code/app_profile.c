@@ -0,0 +1,262 @@
+/******************************************************************************
+ * File Name        : app_profile.c
+ * Description      : This module implements the cycle profiler (see
+ *                    app_profile.h).
+ *
+ *                    A call costs two counter reads and one statistics
+ *                    update; the histogram bucket is found from the leading
+ *                    zeros of the cycle count. The stream source packs the
+ *                    records it is asked for from the live statistics, no
+ *                    copy of the table is kept.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_profile.h>
+#include <app_stream.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define APP_PROFILE_PROBE_NAME(name)    #name,
+
+static const char *const profile_name[PROFILE_PROBE_COUNT] =
+{
+    APP_PROFILE_PROBE_TABLE(APP_PROFILE_PROBE_NAME)
+};
+
+static struct profile_stats_t profile_stats[PROFILE_PROBE_COUNT];
+
+// Call count of each probe at the last report
+static uint32_t profile_reported[PROFILE_PROBE_COUNT];
+
+static uint32_t Profile_StreamBegin(void);
+static uint32_t Profile_StreamEnd(void);
+static uint16_t Profile_StreamRead(uint32_t offset, uint8_t *buf, uint16_t length);
+
+static const struct stream_source_t profile_source =
+{
+    .begin = Profile_StreamBegin,
+    .end   = Profile_StreamEnd,
+    .read  = Profile_StreamRead,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Profile_Bucket
+ *
+ * Description   : Returns the histogram bucket of a call duration.
+ *
+ * Parameters    : uint32_t cycles : duration of the call
+ *
+ * Returns       : uint8_t : bucket, 0 to PROFILE_BUCKETS - 1
+ */
+static uint8_t Profile_Bucket(uint32_t cycles)
+{
+    uint32_t bits = 32 - (uint32_t)__CLZ(cycles);
+
+    if (bits <= PROFILE_BUCKET_SHIFT(0))
+    {
+        return 0;
+    }
+
+    bits = (bits - PROFILE_BUCKET_SHIFT(0) + 1) / 2;
+
+    return (bits < PROFILE_BUCKETS) ? (uint8_t)bits : (PROFILE_BUCKETS - 1);
+}
+
+/* Function      : Profile_PackRecord
+ *
+ * Description   : Serialize the statistics of one probe or dispatch row in
+ *                 the stream layout.
+ *
+ * Parameters    : const struct profile_stats_t *stats : statistics
+ *                 uint8_t *buf                        : destination,
+ *                                                       PROFILE_RECORD_LENGTH
+ *                                                       bytes
+ *
+ * Returns       : None
+ */
+static void Profile_PackRecord(const struct profile_stats_t *stats, uint8_t *buf)
+{
+    uint32_t mean = (stats->count == 0) ? 0 : (uint32_t)(stats->total_cycles / stats->count);
+    uint32_t fields[4] = { stats->count, stats->min_cycles, stats->max_cycles, mean };
+
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        buf[i] = (uint8_t)(fields[i / 4] >> (8 * (i % 4)));
+    }
+
+    for (uint8_t i = 0; i < PROFILE_BUCKETS; i++)
+    {
+        buf[16 + (2 * i)] = (uint8_t)(stats->histogram[i] & 0xFF);
+        buf[17 + (2 * i)] = (uint8_t)(stats->histogram[i] >> 8);
+    }
+}
+
+/* Function      : Profile_StreamBegin
+ *
+ * Description   : First offset of the STREAM_SRC_DIAG source.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : stream offset
+ */
+static uint32_t Profile_StreamBegin(void)
+{
+    return 0;
+}
+
+/* Function      : Profile_StreamEnd
+ *
+ * Description   : Offset after the last record of the STREAM_SRC_DIAG
+ *                 source.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : stream offset
+ */
+static uint32_t Profile_StreamEnd(void)
+{
+    return PROFILE_HEADER_LENGTH +
+           ((PROFILE_PROBE_COUNT + AppDispatch_Rows()) * PROFILE_RECORD_LENGTH);
+}
+
+/* Function      : Profile_StreamRead
+ *
+ * Description   : Copy the bytes of the STREAM_SRC_DIAG source starting at
+ *                 a stream offset, packing each record as it is reached.
+ *
+ * Parameters    : uint32_t offset  : stream offset
+ *                 uint8_t *buf     : destination
+ *                 uint16_t length  : bytes requested
+ *
+ * Returns       : uint16_t : bytes copied
+ */
+static uint16_t Profile_StreamRead(uint32_t offset, uint8_t *buf, uint16_t length)
+{
+    uint32_t end = Profile_StreamEnd();
+    uint16_t copied = 0;
+
+    while ((copied < length) && (offset < end))
+    {
+        uint8_t record[PROFILE_RECORD_LENGTH];
+        uint32_t start;
+        uint32_t size;
+        uint32_t chunk;
+
+        if (offset < PROFILE_HEADER_LENGTH)
+        {
+            uint16_t mhz = (uint16_t)(SystemCoreClock / 1000000);
+
+            record[0] = PROFILE_PROBE_COUNT;
+            record[1] = AppDispatch_Rows();
+            record[2] = (uint8_t)(mhz & 0xFF);
+            record[3] = (uint8_t)(mhz >> 8);
+            start = 0;
+            size = PROFILE_HEADER_LENGTH;
+        }
+        else
+        {
+            uint32_t index = (offset - PROFILE_HEADER_LENGTH) / PROFILE_RECORD_LENGTH;
+
+            Profile_PackRecord((index < PROFILE_PROBE_COUNT) ?
+                               &profile_stats[index] :
+                               AppDispatch_GetStats((uint8_t)(index - PROFILE_PROBE_COUNT)),
+                               record);
+            start = PROFILE_HEADER_LENGTH + (index * PROFILE_RECORD_LENGTH);
+            size = PROFILE_RECORD_LENGTH;
+        }
+
+        chunk = size - (offset - start);
+        if (chunk > (uint32_t)(length - copied))
+        {
+            chunk = length - copied;
+        }
+
+        memcpy(&buf[copied], &record[offset - start], chunk);
+        copied += (uint16_t)chunk;
+        offset += chunk;
+    }
+
+    return copied;
+}
+
+void Profile_Initialize(void)
+{
+    memset(profile_stats, 0, sizeof(profile_stats));
+    memset(profile_reported, 0, sizeof(profile_reported));
+
+    Stream_RegisterSource(STREAM_SRC_DIAG, &profile_source);
+}
+
+void Profile_Update(struct profile_stats_t *stats, uint32_t cycles)
+{
+    uint8_t bucket = Profile_Bucket(cycles);
+
+    if ((stats->count == 0) || (cycles < stats->min_cycles))
+    {
+        stats->min_cycles = cycles;
+    }
+    if (cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+
+    stats->count++;
+    stats->total_cycles += cycles;
+    if (stats->histogram[bucket] != UINT16_MAX)
+    {
+        stats->histogram[bucket]++;
+    }
+}
+
+void Profile_Record(uint8_t probe, uint32_t cycles)
+{
+    if (probe < PROFILE_PROBE_COUNT)
+    {
+        Profile_Update(&profile_stats[probe], cycles);
+    }
+}
+
+const struct profile_stats_t *Profile_GetStats(uint8_t probe)
+{
+    return (probe < PROFILE_PROBE_COUNT) ? &profile_stats[probe] : NULL;
+}
+
+void Profile_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                        ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    for (uint8_t probe = 0; probe < PROFILE_PROBE_COUNT; probe++)
+    {
+        const struct profile_stats_t *stats = &profile_stats[probe];
+
+        if (stats->count == profile_reported[probe])
+        {
+            continue;
+        }
+
+        APP_LOG_INFO("__PROFILE %s: %lu calls, min %lu max %lu avg %lu cycles, "
+                     "hist %u %u %u %u %u %u %u %u\r\n",
+                     APP_LOG_STR(profile_name[probe]), stats->count,
+                     stats->min_cycles, stats->max_cycles,
+                     (uint32_t)(stats->total_cycles / stats->count),
+                     stats->histogram[0], stats->histogram[1], stats->histogram[2],
+                     stats->histogram[3], stats->histogram[4], stats->histogram[5],
+                     stats->histogram[6], stats->histogram[7]);
+        profile_reported[probe] = stats->count;
+    }
+}
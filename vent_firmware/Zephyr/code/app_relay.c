@@ -0,0 +1,385 @@
+/******************************************************************************
+ * File Name        : app_relay.c
+ * Description      : This module implements the vent-to-vent relay (see
+ *                    app_relay.h).
+ *
+ *                    Frames to forward wait in a small ring; when it is full
+ *                    the oldest frame is dropped, newer telemetry being worth
+ *                    more to the hub. A non-connectable advertising activity
+ *                    is created once and started for RELAY_BURST_EVENTS
+ *                    events per frame, when the token bucket allows it.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_relay.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+// Relay advertising activity states
+enum relay_activity_state
+{
+    RELAY_ACTIVITY_NONE,        // not created
+    RELAY_ACTIVITY_CREATING,
+    RELAY_ACTIVITY_IDLE,        // created, not advertising
+    RELAY_ACTIVITY_BUSY,        // data, start or burst in progress
+};
+
+struct relay_frame_t
+{
+    uint8_t origin[GAP_BD_ADDR_LEN];
+    uint8_t hops;
+    uint8_t ttl;
+    uint8_t length;
+    uint8_t frame[RELAY_INNER_MAX];
+};
+
+struct relay_seen_t
+{
+    uint8_t origin[GAP_BD_ADDR_LEN];
+    uint8_t age;                // ticks, RELAY_DEDUPE_TICKS when free
+    uint32_t crc;               // CRC-32 of the frame
+};
+
+struct relay_env_tag
+{
+    uint8_t activity;           // enum relay_activity_state
+    uint8_t actv_idx;
+    uint8_t tokens;
+
+    // Ring of frames to forward
+    struct relay_frame_t queue[RELAY_QUEUE_LENGTH];
+    uint8_t head;
+    uint8_t count;
+
+    struct relay_seen_t seen[RELAY_CACHE_LENGTH];
+
+    // Statistics
+    uint32_t forwarded;
+    uint32_t duplicates;
+    uint32_t dropped;           // pushed out of a full queue
+};
+
+static struct relay_env_tag relay_env;
+
+static const struct gapm_adv_create_param relay_adv_params =
+{
+    .type = GAPM_ADV_TYPE_LEGACY,
+    .prop = GAPM_ADV_PROP_NON_CONN_NON_SCAN_MASK,
+    .disc_mode = GAPM_ADV_MODE_NON_DISC,
+    .filter_pol = ADV_ALLOW_SCAN_ANY_CON_ANY,
+    .max_tx_pwr = DEF_TX_POWER,
+    .prim_cfg = {
+        .adv_intv_min = RELAY_ADV_INTV,
+        .adv_intv_max = RELAY_ADV_INTV,
+        .chnl_map = APP_ADV_CHMAP,
+        .phy = GAPM_PHY_TYPE_LE_1M,
+    },
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Relay_CreateActivity
+ *
+ * Description   : Request the relay advertising activity. The stack sends
+ *                 back a GAPM_ACTIVITY_CREATED_IND and a GAPM_CMP_EVT /
+ *                 GAPM_CREATE_ADV_ACTIVITY to RELAY_TASK.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Relay_CreateActivity(void)
+{
+    struct gapm_activity_create_adv_cmd *cmd = KE_MSG_ALLOC(GAPM_ACTIVITY_CREATE_CMD,
+                                                            TASK_GAPM, RELAY_TASK,
+                                                            gapm_activity_create_adv_cmd);
+
+    cmd->operation = GAPM_CREATE_ADV_ACTIVITY;
+    cmd->own_addr_type = GAPM_OWN_ADDR_TYPE;
+    cmd->adv_param = relay_adv_params;
+    ke_msg_send(cmd);
+
+    relay_env.activity = RELAY_ACTIVITY_CREATING;
+}
+
+/* Function      : Relay_Send
+ *
+ * Description   : Hand the oldest queued frame to the activity if it is idle
+ *                 and the budget allows a burst. The burst starts once the
+ *                 stack has taken the data.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Relay_Send(void)
+{
+    static const uint8_t company_id[] = APP_COMPANY_ID;
+    const struct relay_frame_t *f = &relay_env.queue[relay_env.head];
+    struct gapm_set_adv_data_cmd *cmd;
+    uint8_t *data;
+    uint8_t field_len;
+
+    if ((relay_env.activity != RELAY_ACTIVITY_IDLE) || (relay_env.count == 0) ||
+        (relay_env.tokens == 0))
+    {
+        return;
+    }
+
+    // One manufacturer specific data field holds the whole relay frame
+    field_len = 1 + GROUP_FRAME_OFFSET + RELAY_HEADER_LENGTH + f->length;
+    cmd = KE_MSG_ALLOC_DYN(GAPM_SET_ADV_DATA_CMD, TASK_GAPM, RELAY_TASK,
+                           gapm_set_adv_data_cmd, field_len + 1);
+    cmd->operation = GAPM_SET_ADV_DATA;
+    cmd->actv_idx = relay_env.actv_idx;
+    cmd->length = field_len + 1;
+
+    data = cmd->data;
+    *data++ = field_len;
+    *data++ = GAP_AD_TYPE_MANU_SPECIFIC_DATA;
+    memcpy(data, company_id, APP_COMPANY_ID_LEN);
+    data += APP_COMPANY_ID_LEN;
+    *data++ = GROUP_FRAME_RELAY;
+    *data++ = f->hops;
+    *data++ = f->ttl;
+    memcpy(data, f->origin, GAP_BD_ADDR_LEN);
+    data += GAP_BD_ADDR_LEN;
+    memcpy(data, f->frame, f->length);
+    ke_msg_send(cmd);
+
+    relay_env.head = (relay_env.head + 1) % RELAY_QUEUE_LENGTH;
+    relay_env.count--;
+    relay_env.tokens--;
+    relay_env.forwarded++;
+    relay_env.activity = RELAY_ACTIVITY_BUSY;
+}
+
+/* Function      : Relay_Seen
+ *
+ * Description   : Check a frame against the recently forwarded ones and
+ *                 remember it if it is new.
+ *
+ * Parameters    : const uint8_t *origin : originator address
+ *                 uint32_t crc          : CRC-32 of the frame
+ *
+ * Returns       : bool : true if the frame was forwarded recently
+ */
+static bool Relay_Seen(const uint8_t *origin, uint32_t crc)
+{
+    struct relay_seen_t *oldest = &relay_env.seen[0];
+
+    for (uint8_t i = 0; i < RELAY_CACHE_LENGTH; i++)
+    {
+        struct relay_seen_t *e = &relay_env.seen[i];
+
+        if ((e->age < RELAY_DEDUPE_TICKS) && (e->crc == crc) &&
+            !memcmp(e->origin, origin, GAP_BD_ADDR_LEN))
+        {
+            return true;
+        }
+
+        if (e->age > oldest->age)
+        {
+            oldest = e;
+        }
+    }
+
+    memcpy(oldest->origin, origin, GAP_BD_ADDR_LEN);
+    oldest->crc = crc;
+    oldest->age = 0;
+
+    return false;
+}
+
+void Relay_Initialize(void)
+{
+    memset(&relay_env, 0, sizeof(relay_env));
+    relay_env.activity = RELAY_ACTIVITY_NONE;
+
+    for (uint8_t i = 0; i < RELAY_CACHE_LENGTH; i++)
+    {
+        relay_env.seen[i].age = RELAY_DEDUPE_TICKS;
+    }
+}
+
+void Relay_Start(void)
+{
+    if (!RELAY_ENABLE || (relay_env.activity != RELAY_ACTIVITY_NONE))
+    {
+        return;
+    }
+
+    relay_env.tokens = RELAY_BUCKET_SIZE;
+    Relay_CreateActivity();
+    ke_timer_set(RELAY_TICK_TIMEOUT, TASK_APP, TIMER_SETTING_S(RELAY_TICK_S));
+}
+
+void Relay_Forward(const uint8_t *origin, const uint8_t *frame, uint8_t length,
+                   uint8_t hops, uint8_t ttl)
+{
+    struct relay_frame_t *f;
+
+    if (!RELAY_ENABLE || (hops >= ttl) || (ttl > RELAY_TTL) ||
+        (length > RELAY_INNER_MAX) ||
+        !memcmp(origin, devConfigCmd.addr.addr, GAP_BD_ADDR_LEN))
+    {
+        return;
+    }
+
+    // Dedupe before the MAC: repeats of a frame arrive many times
+    if (Relay_Seen(origin, CRC32_FINAL(CRC32_Update(CRC32_INIT, frame, length))))
+    {
+        relay_env.duplicates++;
+        return;
+    }
+
+    if ((frame[0] == GROUP_FRAME_COMMAND) && !Group_CheckMac(frame))
+    {
+        return;
+    }
+
+    if (relay_env.count == RELAY_QUEUE_LENGTH)
+    {
+        relay_env.head = (relay_env.head + 1) % RELAY_QUEUE_LENGTH;
+        relay_env.count--;
+        relay_env.dropped++;
+    }
+
+    f = &relay_env.queue[(relay_env.head + relay_env.count) % RELAY_QUEUE_LENGTH];
+    memcpy(f->origin, origin, GAP_BD_ADDR_LEN);
+    f->hops = hops + 1;
+    f->ttl = ttl;
+    f->length = length;
+    memcpy(f->frame, frame, length);
+    relay_env.count++;
+
+    Relay_Send();
+}
+
+void Relay_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    if ((msg_id != RELAY_TICK_TIMEOUT) && (dest_id != RELAY_TASK))
+    {
+        // Answers to the advertising and scan activities
+        return;
+    }
+
+    switch (msg_id)
+    {
+        case GAPM_ACTIVITY_CREATED_IND:
+        {
+            const struct gapm_activity_created_ind *p = param;
+
+            relay_env.actv_idx = p->actv_idx;
+        }
+        break;
+
+        case GAPM_CMP_EVT:
+        {
+            const struct gapm_cmp_evt *p = param;
+
+            switch (p->operation)
+            {
+                case GAPM_CREATE_ADV_ACTIVITY:
+                {
+                    if (p->status != GAP_ERR_NO_ERROR)
+                    {
+                        // Created again on the next tick
+                        APP_LOG_WARN("__RELAY create failed: %d\r\n", p->status);
+                        relay_env.activity = RELAY_ACTIVITY_NONE;
+                        break;
+                    }
+
+                    relay_env.activity = RELAY_ACTIVITY_IDLE;
+                    Relay_Send();
+                }
+                break;
+
+                case GAPM_SET_ADV_DATA:
+                {
+                    struct gapm_activity_start_cmd *cmd;
+
+                    if (p->status != GAP_ERR_NO_ERROR)
+                    {
+                        relay_env.activity = RELAY_ACTIVITY_IDLE;
+                        Relay_Send();
+                        break;
+                    }
+
+                    cmd = KE_MSG_ALLOC(GAPM_START_ACTIVITY_CMD, TASK_GAPM, RELAY_TASK,
+                                       gapm_activity_start_cmd);
+                    cmd->operation = GAPM_START_ACTIVITY;
+                    cmd->actv_idx = relay_env.actv_idx;
+                    cmd->u_param.adv_add_param.duration = 0;
+                    cmd->u_param.adv_add_param.max_adv_evt = RELAY_BURST_EVENTS;
+                    ke_msg_send(cmd);
+                }
+                break;
+
+                case GAPM_START_ACTIVITY:
+                {
+                    if (p->status != GAP_ERR_NO_ERROR)
+                    {
+                        relay_env.activity = RELAY_ACTIVITY_IDLE;
+                        Relay_Send();
+                    }
+                }
+                break;
+            }
+        }
+        break;
+
+        case GAPM_ACTIVITY_STOPPED_IND:
+        {
+            // Burst over
+            relay_env.activity = RELAY_ACTIVITY_IDLE;
+            Relay_Send();
+        }
+        break;
+
+        case RELAY_TICK_TIMEOUT:
+        {
+            APP_LOG_DEBUG("__RELAY forwarded %lu, duplicates %lu, dropped %lu\r\n",
+                          relay_env.forwarded, relay_env.duplicates, relay_env.dropped);
+
+            relay_env.tokens = (relay_env.tokens + RELAY_REFILL_TOKENS > RELAY_BUCKET_SIZE) ?
+                               RELAY_BUCKET_SIZE : relay_env.tokens + RELAY_REFILL_TOKENS;
+
+            for (uint8_t i = 0; i < RELAY_CACHE_LENGTH; i++)
+            {
+                if (relay_env.seen[i].age < RELAY_DEDUPE_TICKS)
+                {
+                    relay_env.seen[i].age++;
+                }
+            }
+
+            if (relay_env.activity == RELAY_ACTIVITY_NONE)
+            {
+                Relay_CreateActivity();
+            }
+            else
+            {
+                Relay_Send();
+            }
+
+            ke_timer_set(RELAY_TICK_TIMEOUT, TASK_APP, TIMER_SETTING_S(RELAY_TICK_S));
+        }
+        break;
+    }
+}
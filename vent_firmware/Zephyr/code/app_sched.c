@@ -0,0 +1,236 @@
+/******************************************************************************
+ * File Name        : app_sched.c
+ * Description      : This module implements the application scheduler (see
+ *                    app_sched.h).
+ *
+ *                    Each task ring is indexed by two free running 8-bit
+ *                    counters: head, written only by the producer, and tail,
+ *                    written only by the main loop. The producer writes the
+ *                    event before it moves head and the main loop reads it
+ *                    before it moves tail, with a memory barrier in between,
+ *                    so neither side ever sees a half written event.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_sched.h>
+#include <app_cycles.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+_Static_assert((APP_SCHED_QUEUE_LENGTH & (APP_SCHED_QUEUE_LENGTH - 1)) == 0,
+               "APP_SCHED_QUEUE_LENGTH must be a power of two");
+_Static_assert(APP_SCHED_QUEUE_LENGTH <= 128, "APP_SCHED_QUEUE_LENGTH too large");
+
+#define APP_SCHED_NONE                  (0xFF)
+
+struct app_sched_event_t
+{
+    uint32_t arg;
+    uint32_t posted;            // cycle count at the post
+};
+
+struct app_sched_ring_t
+{
+    struct app_sched_event_t event[APP_SCHED_QUEUE_LENGTH];
+    volatile uint8_t head;      // next event to write (producer)
+    volatile uint8_t tail;      // next event to run (main loop)
+};
+
+#define APP_SCHED_TASK_PRIO(name, priority, deadline_us, handler)       priority,
+#define APP_SCHED_TASK_DEADLINE(name, priority, deadline_us, handler)   deadline_us,
+#define APP_SCHED_TASK_HANDLER(name, priority, deadline_us, handler)    handler,
+#define APP_SCHED_TASK_NAME(name, priority, deadline_us, handler)       #name,
+
+static const uint8_t sched_prio[APP_SCHED_TASK_COUNT] =
+{
+    APP_SCHED_TASK_TABLE(APP_SCHED_TASK_PRIO)
+};
+
+static const uint32_t sched_deadline_us[APP_SCHED_TASK_COUNT] =
+{
+    APP_SCHED_TASK_TABLE(APP_SCHED_TASK_DEADLINE)
+};
+
+static const app_sched_handler_t sched_handler[APP_SCHED_TASK_COUNT] =
+{
+    APP_SCHED_TASK_TABLE(APP_SCHED_TASK_HANDLER)
+};
+
+static const char *const sched_name[APP_SCHED_TASK_COUNT] =
+{
+    APP_SCHED_TASK_TABLE(APP_SCHED_TASK_NAME)
+};
+
+static struct app_sched_ring_t sched_ring[APP_SCHED_TASK_COUNT];
+
+static struct app_sched_stats_t sched_stats[APP_SCHED_TASK_COUNT];
+
+// Events run by each task at the last report
+static uint32_t sched_reported[APP_SCHED_TASK_COUNT];
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : AppSched_Next
+ *
+ * Description   : Returns the highest priority task with a pending event,
+ *                 the first in table order among equals.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint8_t : task, APP_SCHED_NONE if no event is pending
+ */
+static uint8_t AppSched_Next(void)
+{
+    for (uint8_t prio = 0; prio < APP_SCHED_PRIO_COUNT; prio++)
+    {
+        for (uint8_t task = 0; task < APP_SCHED_TASK_COUNT; task++)
+        {
+            if ((sched_prio[task] == prio) && (sched_ring[task].head != sched_ring[task].tail))
+            {
+                return task;
+            }
+        }
+    }
+
+    return APP_SCHED_NONE;
+}
+
+void AppSched_Initialize(void)
+{
+    memset(sched_stats, 0, sizeof(sched_stats));
+    memset(sched_reported, 0, sizeof(sched_reported));
+}
+
+bool AppSched_Post(uint8_t task, uint32_t arg)
+{
+    struct app_sched_ring_t *ring = &sched_ring[task];
+    struct app_sched_stats_t *stats = &sched_stats[task];
+    uint8_t head = ring->head;
+    uint8_t depth = (uint8_t)(head - ring->tail);
+
+    stats->posted++;
+    if (depth >= APP_SCHED_QUEUE_LENGTH)
+    {
+        stats->dropped++;
+        return false;
+    }
+
+    ring->event[head & (APP_SCHED_QUEUE_LENGTH - 1)].arg = arg;
+    ring->event[head & (APP_SCHED_QUEUE_LENGTH - 1)].posted = Cycles_Now();
+
+    // The event is complete before the main loop can see it
+    __DMB();
+    ring->head = head + 1;
+
+    if (depth + 1 > stats->max_depth)
+    {
+        stats->max_depth = depth + 1;
+    }
+
+    return true;
+}
+
+bool AppSched_Run(void)
+{
+    for (uint8_t n = 0; n < APP_SCHED_BATCH; n++)
+    {
+        uint8_t task = AppSched_Next();
+        struct app_sched_ring_t *ring;
+        struct app_sched_stats_t *stats;
+        struct app_sched_event_t event;
+        uint32_t latency;
+        uint32_t start;
+        uint32_t cycles;
+
+        if (task == APP_SCHED_NONE)
+        {
+            return false;
+        }
+
+        ring = &sched_ring[task];
+        stats = &sched_stats[task];
+        event = ring->event[ring->tail & (APP_SCHED_QUEUE_LENGTH - 1)];
+
+        // The event is copied before the producer can reuse its slot
+        __DMB();
+        ring->tail = ring->tail + 1;
+
+        latency = Cycles_Since(event.posted);
+        if (latency > stats->max_latency)
+        {
+            stats->max_latency = latency;
+        }
+        // The clock level may have changed since start up, convert now
+        if (latency > sched_deadline_us[task] * (SystemCoreClock / 1000000))
+        {
+            stats->missed++;
+        }
+
+        start = Cycles_Now();
+        sched_handler[task](event.arg);
+        cycles = Cycles_Since(start);
+
+        stats->run++;
+        stats->total_cycles += cycles;
+        if (cycles > stats->max_cycles)
+        {
+            stats->max_cycles = cycles;
+        }
+    }
+
+    return AppSched_IsPending();
+}
+
+bool AppSched_IsPending(void)
+{
+    for (uint8_t task = 0; task < APP_SCHED_TASK_COUNT; task++)
+    {
+        if (sched_ring[task].head != sched_ring[task].tail)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const struct app_sched_stats_t *AppSched_GetStats(uint8_t task)
+{
+    return (task < APP_SCHED_TASK_COUNT) ? &sched_stats[task] : NULL;
+}
+
+void AppSched_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                         ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    for (uint8_t task = 0; task < APP_SCHED_TASK_COUNT; task++)
+    {
+        const struct app_sched_stats_t *stats = &sched_stats[task];
+
+        if (stats->run == sched_reported[task])
+        {
+            continue;
+        }
+
+        APP_LOG_INFO("__SCHED %s: %lu run, %lu dropped, depth %u, latency max %lu cycles, "
+                     "%lu missed, run max %lu cycles, avg %lu\r\n",
+                     APP_LOG_STR(sched_name[task]), stats->run, stats->dropped,
+                     stats->max_depth, stats->max_latency, stats->missed,
+                     stats->max_cycles, stats->total_cycles / stats->run);
+        sched_reported[task] = stats->run;
+    }
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+ * File Name        : app_sensor.c
+ * Description      : This module implements the sensor sampler (see
+ *                    app_sensor.h). Sample age is tracked with a kernel
+ *                    timer armed for the maximum age at every publish, so no
+ *                    clock has to be read to decide whether a sample is
+ *                    still fresh. The publish time is kept only to re-arm
+ *                    the timer when the maximum age changes.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <ble_abstraction.h>
+#include <app.h>
+#include <app_sensor.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+static uint16_t sensor_max_age_s;
+
+// HDC2080 configured by the boot sequencer, requests are taken
+static bool sensor_ready;
+
+// Conversion started by Sensor_Request and not yet read
+static bool sensor_busy;
+
+// Last sample is older than the maximum age (or there is none)
+static bool sensor_stale;
+
+// A sample was published, at AppTimer_Now sensor_published_us
+static bool sensor_sampled;
+static uint64_t sensor_published_us;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Sensor_Publish
+ *
+ * Description   : Read the converted values and the battery level into a
+ *                 new snapshot, publish it and restart the age timer.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Sensor_Publish(void)
+{
+    struct sensor_snapshot_t *sample = Snapshot_BeginUpdate();
+
+    PROFILE_BEGIN(SENSOR_MEASUREMENT);
+    sample->temperature = get_temperature();
+    sample->humidity = get_humidity();
+    PROFILE_END(SENSOR_MEASUREMENT);
+    sample->battery = APP_BASS_ReadBattLevel(0);
+    Snapshot_Publish();
+
+    sensor_sampled = true;
+    sensor_published_us = AppTimer_Now();
+
+    if (sensor_max_age_s == 0)
+    {
+        sensor_stale = true;
+    }
+    else
+    {
+        sensor_stale = false;
+        ke_timer_set(SENSOR_STALE_TIMEOUT, TASK_APP, TIMER_SETTING_S(sensor_max_age_s));
+    }
+}
+
+void Sensor_Initialize(void)
+{
+    sensor_max_age_s = SENSOR_MAX_AGE_DEFAULT_S;
+    sensor_ready = false;
+    sensor_busy = false;
+    sensor_stale = true;
+    sensor_sampled = false;
+}
+
+void Sensor_Start(void)
+{
+    sensor_ready = true;
+    Sensor_Request();
+}
+
+void Sensor_Request(void)
+{
+    // Before Sensor_Start the first sample is still to come
+    if (sensor_busy || !sensor_ready)
+    {
+        return;
+    }
+
+    sensor_busy = true;
+    trigger_measurement();
+    ke_timer_set(SENSOR_CONVERSION_TIMEOUT, TASK_APP, TIMER_SETTING_MS(SENSOR_CONVERSION_MS));
+}
+
+bool Sensor_IsFresh(void)
+{
+    return !sensor_stale;
+}
+
+void Sensor_SetMaxAge(uint16_t max_age_s)
+{
+    uint64_t age_us;
+    uint64_t max_age_us;
+
+    if (max_age_s > SENSOR_MAX_AGE_LIMIT_S)
+    {
+        max_age_s = SENSOR_MAX_AGE_LIMIT_S;
+    }
+
+    if (max_age_s == sensor_max_age_s)
+    {
+        return;
+    }
+
+    sensor_max_age_s = max_age_s;
+
+    // Judge the last sample against the new age from its publish time
+    ke_timer_clear(SENSOR_STALE_TIMEOUT, TASK_APP);
+
+    age_us = AppTimer_Now() - sensor_published_us;
+    max_age_us = (uint64_t)max_age_s * 1000000U;
+
+    if (!sensor_sampled || (age_us >= max_age_us))
+    {
+        sensor_stale = true;
+    }
+    else
+    {
+        sensor_stale = false;
+        ke_timer_set(SENSOR_STALE_TIMEOUT, TASK_APP,
+                     TIMER_SETTING_MS((uint32_t)((max_age_us - age_us + 999) / 1000)));
+    }
+}
+
+void Sensor_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                       ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    switch (msg_id)
+    {
+        case SENSOR_CONVERSION_TIMEOUT:
+        {
+            if (sensor_busy)
+            {
+                sensor_busy = false;
+                Sensor_Publish();
+                ke_msg_send_basic(SENSOR_SAMPLE_IND, TASK_APP, TASK_APP);
+            }
+        }
+        break;
+
+        case SENSOR_STALE_TIMEOUT:
+        {
+            sensor_stale = true;
+        }
+        break;
+    }
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+ * File Name        : app_siphash.c
+ * Description      : This module implements SipHash-2-4 (Aumasson and
+ *                    Bernstein). Messages are a few bytes long, so the
+ *                    straightforward 64-bit form is used; the Cortex-M33
+ *                    runs one compression round in a few dozen cycles.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <app_siphash.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+#define ROTL64(x, b)                    (((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND(v0, v1, v2, v3)                                   \
+    do                                                             \
+    {                                                              \
+        v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32); \
+        v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2;                   \
+        v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0;                   \
+        v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32); \
+    } while (0)
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : SipHash_Load64
+ *
+ * Description   : Read a little endian 64-bit word.
+ *
+ * Parameters    : const uint8_t *p : first byte
+ *
+ * Returns       : uint64_t : value
+ */
+static uint64_t SipHash_Load64(const uint8_t *p)
+{
+    uint64_t value = 0;
+
+    for (int i = 7; i >= 0; i--)
+    {
+        value = (value << 8) | p[i];
+    }
+
+    return value;
+}
+
+uint64_t SipHash24(const uint8_t *key, const uint8_t *data, uint32_t length)
+{
+    uint64_t k0 = SipHash_Load64(key);
+    uint64_t k1 = SipHash_Load64(key + 8);
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+    uint64_t m;
+    uint32_t left = length & 7;
+    const uint8_t *end = data + (length - left);
+
+    for (; data != end; data += 8)
+    {
+        m = SipHash_Load64(data);
+        v3 ^= m;
+        SIPROUND(v0, v1, v2, v3);
+        SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    // Last block: remaining bytes, length in the top byte
+    m = (uint64_t)length << 56;
+    while (left--)
+    {
+        m |= (uint64_t)data[left] << (8 * left);
+    }
+
+    v3 ^= m;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    v0 ^= m;
+
+    v2 ^= 0xff;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+ * File Name        : app_snapshot.c
+ * Description      : This module implements the double-buffered sensor
+ *                    snapshot (see app_snapshot.h).
+ *
+ *                    The writer clears the sequence number of the back
+ *                    buffer before touching it and sets a new one before the
+ *                    flip. A reader takes the sequence number of the active
+ *                    buffer, copies, and checks that the same buffer still
+ *                    carries it and is still the active one. The first
+ *                    check fails if a writer started on it in the meantime,
+ *                    the second if it was rewritten but not yet published,
+ *                    so a reader never returns a sample ahead of the one
+ *                    published and its reads never go backwards.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <string.h>
+#include <app.h>
+#include <app_snapshot.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+static struct sensor_snapshot_t snapshot[2];
+
+// Index of the active buffer
+static volatile uint8_t snapshot_active;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+void Snapshot_Initialize(void)
+{
+    memset(snapshot, 0, sizeof(snapshot));
+    snapshot[0].seq = 1;
+    snapshot_active = 0;
+}
+
+struct sensor_snapshot_t * Snapshot_BeginUpdate(void)
+{
+    volatile struct sensor_snapshot_t *back = &snapshot[snapshot_active ^ 1];
+
+    back->seq = SNAPSHOT_SEQ_WRITING;
+    __DMB();
+
+    back->temperature = snapshot[snapshot_active].temperature;
+    back->humidity = snapshot[snapshot_active].humidity;
+    back->battery = snapshot[snapshot_active].battery;
+
+    return (struct sensor_snapshot_t *)back;
+}
+
+void Snapshot_Publish(void)
+{
+    uint8_t front = snapshot_active;
+    volatile struct sensor_snapshot_t *back = &snapshot[front ^ 1];
+    uint32_t seq = snapshot[front].seq + 1;
+
+    if (seq == SNAPSHOT_SEQ_WRITING)
+    {
+        seq++;
+    }
+
+    // Data before sequence number, sequence number before the flip
+    __DMB();
+    back->seq = seq;
+    __DMB();
+    snapshot_active = front ^ 1;
+}
+
+const struct sensor_snapshot_t * Snapshot_Get(void)
+{
+    return &snapshot[snapshot_active];
+}
+
+uint32_t Snapshot_Read(uint16_t offset, uint8_t *to, uint16_t length)
+{
+    const volatile uint8_t *from;
+    uint8_t index;
+    uint32_t seq;
+
+    if ((offset + length) > sizeof(struct sensor_snapshot_t))
+    {
+        return SNAPSHOT_SEQ_WRITING;
+    }
+
+    do
+    {
+        index = snapshot_active;
+        seq = ((const volatile struct sensor_snapshot_t *)&snapshot[index])->seq;
+        __DMB();
+
+        from = (const volatile uint8_t *)&snapshot[index] + offset;
+        for (uint16_t i = 0; i < length; i++)
+        {
+            to[i] = from[i];
+        }
+
+        __DMB();
+    } while ((seq == SNAPSHOT_SEQ_WRITING) ||
+             (((const volatile struct sensor_snapshot_t *)&snapshot[index])->seq != seq) ||
+             (snapshot_active != index));
+
+    return seq;
+}
@@ -0,0 +1,519 @@
+/******************************************************************************
+ * File Name        : app_stream.c
+ * Description      : This module implements the bulk stream endpoint on an
+ *                    LE credit based L2CAP channel (see app_stream.h for the
+ *                    frame format).
+ *
+ *                    One SDU is in flight at a time. The next one is built
+ *                    when the stack completes the previous send, and only
+ *                    if the peer granted enough credits for all of its
+ *                    PDUs; otherwise the stream waits for L2CC_LECB_ADD_IND.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <ble_abstraction.h>
+#include <swmTrace_api.h>
+#include <app.h>
+#include <app_crc.h>
+#include <app_stream.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+enum stream_state
+{
+    STREAM_STATE_IDLE,          // no channel
+    STREAM_STATE_CONNECTED,     // channel open, waiting for a request
+    STREAM_STATE_STREAMING,     // sending data frames
+};
+
+struct stream_env_tag
+{
+    uint8_t state;
+    uint8_t conidx;
+    uint16_t local_cid;
+    uint16_t peer_mtu;
+    uint16_t peer_mps;
+    uint16_t peer_credits;
+    bool sdu_in_flight;
+
+    // Current download
+    uint8_t source_id;
+    const struct stream_source_t *source;
+    uint32_t offset;
+    uint32_t end;
+    uint32_t crc;
+    uint32_t sent;
+};
+
+static struct stream_env_tag stream_env;
+static const struct stream_source_t *stream_sources[STREAM_MAX_SOURCES + 1];
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Stream_PutU32
+ *
+ * Description   : Store a 32-bit value little endian.
+ *
+ * Parameters    : uint8_t *buf   : destination
+ *                 uint32_t value : value to store
+ *
+ * Returns       : None
+ */
+static void Stream_PutU32(uint8_t *buf, uint32_t value)
+{
+    buf[0] = (uint8_t)(value);
+    buf[1] = (uint8_t)(value >> 8);
+    buf[2] = (uint8_t)(value >> 16);
+    buf[3] = (uint8_t)(value >> 24);
+}
+
+/* Function      : Stream_GetU32
+ *
+ * Description   : Load a little endian 32-bit value.
+ *
+ * Parameters    : const uint8_t *buf : source
+ *
+ * Returns       : uint32_t : value
+ */
+static uint32_t Stream_GetU32(const uint8_t *buf)
+{
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+           ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+/* Function      : Stream_CreditsFor
+ *
+ * Description   : Number of credits (K-frames) needed to send an SDU. The
+ *                 first K-frame also carries the 2 byte SDU length.
+ *
+ * Parameters    : uint16_t length : SDU length
+ *
+ * Returns       : uint16_t : credits
+ */
+static uint16_t Stream_CreditsFor(uint16_t length)
+{
+    return (uint16_t)((length + 2 + stream_env.peer_mps - 1) / stream_env.peer_mps);
+}
+
+/* Function      : Stream_AllocSdu
+ *
+ * Description   : Allocate an SDU send command on the stream channel if the
+ *                 peer granted enough credits for it.
+ *
+ * Parameters    : uint16_t length : SDU length
+ *
+ * Returns       : struct l2cc_lecb_sdu_send_cmd * : command to fill and pass
+ *                                                   to Stream_SendSdu, NULL
+ *                                                   if out of credits
+ */
+static struct l2cc_lecb_sdu_send_cmd * Stream_AllocSdu(uint16_t length)
+{
+    struct l2cc_lecb_sdu_send_cmd *cmd;
+    uint16_t credits = Stream_CreditsFor(length);
+
+    if (stream_env.sdu_in_flight || (credits > stream_env.peer_credits))
+    {
+        return NULL;
+    }
+
+    cmd = KE_MSG_ALLOC_DYN(L2CC_LECB_SDU_SEND_CMD,
+                           KE_BUILD_ID(TASK_L2CC, stream_env.conidx), TASK_APP,
+                           l2cc_lecb_sdu_send_cmd, length);
+    cmd->operation = L2CC_LECB_SDU_SEND;
+    cmd->sdu.cid = stream_env.local_cid;
+    cmd->sdu.credit = credits;
+    cmd->sdu.length = length;
+
+    return cmd;
+}
+
+/* Function      : Stream_SendSdu
+ *
+ * Description   : Send an SDU allocated with Stream_AllocSdu.
+ *
+ * Parameters    : struct l2cc_lecb_sdu_send_cmd *cmd : filled command
+ *
+ * Returns       : None
+ */
+static void Stream_SendSdu(struct l2cc_lecb_sdu_send_cmd *cmd)
+{
+    stream_env.peer_credits -= cmd->sdu.credit;
+    stream_env.sdu_in_flight = true;
+    ke_msg_send(cmd);
+}
+
+/* Function      : Stream_SendError
+ *
+ * Description   : Answer a request with an error frame. Dropped if the
+ *                 channel is out of credits, the client times out instead.
+ *
+ * Parameters    : uint8_t source_id : requested source
+ *                 uint8_t error     : enum stream_error
+ *
+ * Returns       : None
+ */
+static void Stream_SendError(uint8_t source_id, uint8_t error)
+{
+    struct l2cc_lecb_sdu_send_cmd *cmd = Stream_AllocSdu(STREAM_ERROR_LENGTH);
+
+    APP_LOG_WARN("__STREAM error %d on source %d\r\n", error, source_id);
+
+    if (cmd != NULL)
+    {
+        cmd->sdu.data[0] = STREAM_FRAME_ERROR;
+        cmd->sdu.data[1] = source_id;
+        cmd->sdu.data[2] = error;
+        Stream_SendSdu(cmd);
+    }
+}
+
+/* Function      : Stream_Pump
+ *
+ * Description   : Send the next data frame of the current download, or the
+ *                 end frame once the snapshot end is reached.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Stream_Pump(void)
+{
+    struct l2cc_lecb_sdu_send_cmd *cmd;
+    uint16_t sdu_max;
+    uint16_t length;
+
+    if ((stream_env.state != STREAM_STATE_STREAMING) || stream_env.sdu_in_flight)
+    {
+        return;
+    }
+
+    if (stream_env.offset >= stream_env.end)
+    {
+        cmd = Stream_AllocSdu(STREAM_END_LENGTH);
+        if (cmd == NULL)
+        {
+            return;
+        }
+
+        cmd->sdu.data[0] = STREAM_FRAME_END;
+        Stream_PutU32(&cmd->sdu.data[1], stream_env.end);
+        Stream_PutU32(&cmd->sdu.data[5], CRC32_FINAL(stream_env.crc));
+        Stream_SendSdu(cmd);
+
+        APP_LOG_INFO("__STREAM source %d done, %lu bytes\r\n", stream_env.source_id,
+                     (unsigned long)stream_env.sent);
+        stream_env.state = STREAM_STATE_CONNECTED;
+        Clock_Request(CLOCK_STREAM, CLOCK_LEVEL_LOW);
+        return;
+    }
+
+    sdu_max = (stream_env.peer_mtu < STREAM_SDU_MAX) ? stream_env.peer_mtu : STREAM_SDU_MAX;
+    length = sdu_max - STREAM_DATA_HEADER_LENGTH;
+    if ((stream_env.end - stream_env.offset) < length)
+    {
+        length = (uint16_t)(stream_env.end - stream_env.offset);
+    }
+
+    cmd = Stream_AllocSdu(STREAM_DATA_HEADER_LENGTH + length);
+    if (cmd == NULL)
+    {
+        /* Resumed by L2CC_LECB_ADD_IND or L2CC_CMP_EVT */
+        return;
+    }
+
+    /* The source may return less than asked if the oldest bytes were
+     * overwritten meanwhile, the frame offset lets the client notice */
+    length = stream_env.source->read(stream_env.offset,
+                                     &cmd->sdu.data[STREAM_DATA_HEADER_LENGTH],
+                                     length);
+    cmd->sdu.data[0] = STREAM_FRAME_DATA;
+    Stream_PutU32(&cmd->sdu.data[1], stream_env.offset);
+    cmd->sdu.length = STREAM_DATA_HEADER_LENGTH + length;
+
+    /* Reserve only the K-frames of what was read, the peer returns the
+     * credits of the frames it receives */
+    cmd->sdu.credit = Stream_CreditsFor(cmd->sdu.length);
+
+    stream_env.crc = CRC32_Update(stream_env.crc,
+                                  &cmd->sdu.data[STREAM_DATA_HEADER_LENGTH],
+                                  length);
+    stream_env.offset += length;
+    stream_env.sent += length;
+
+    if (length == 0)
+    {
+        /* Nothing readable left in the snapshot, finish with what was sent */
+        stream_env.end = stream_env.offset;
+    }
+
+    Stream_SendSdu(cmd);
+
+    /* Keep the link on short intervals for the whole download */
+    ConnPolicy_RequestActive(stream_env.conidx);
+}
+
+/* Function      : Stream_HandleRequest
+ *
+ * Description   : Start (or restart) a download from a request frame.
+ *
+ * Parameters    : const uint8_t *data : frame
+ *                 uint16_t length     : frame length
+ *
+ * Returns       : None
+ */
+static void Stream_HandleRequest(const uint8_t *data, uint16_t length)
+{
+    uint8_t source_id;
+    uint32_t offset;
+    uint32_t begin;
+
+    if ((length < STREAM_REQUEST_LENGTH) || (data[0] != STREAM_FRAME_REQUEST))
+    {
+        Stream_SendError(0, STREAM_ERR_BAD_REQUEST);
+        return;
+    }
+
+    source_id = data[1];
+    offset = Stream_GetU32(&data[2]);
+
+    if ((source_id == 0) || (source_id > STREAM_MAX_SOURCES) ||
+        (stream_sources[source_id] == NULL))
+    {
+        Stream_SendError(source_id, STREAM_ERR_UNKNOWN_SOURCE);
+        return;
+    }
+
+    stream_env.source_id = source_id;
+    stream_env.source = stream_sources[source_id];
+    stream_env.end = stream_env.source->end();
+    begin = stream_env.source->begin();
+
+    if (offset > stream_env.end)
+    {
+        stream_env.state = STREAM_STATE_CONNECTED;
+        Clock_Request(CLOCK_STREAM, CLOCK_LEVEL_LOW);
+        Stream_SendError(source_id, STREAM_ERR_BAD_OFFSET);
+        return;
+    }
+
+    /* Data older than begin() is gone, continue with the oldest available */
+    stream_env.offset = (offset < begin) ? begin : offset;
+    stream_env.crc = CRC32_INIT;
+    stream_env.sent = 0;
+    stream_env.state = STREAM_STATE_STREAMING;
+
+    /* Reading the source and the CRC run for every frame */
+    Clock_Request(CLOCK_STREAM, CLOCK_LEVEL_MID);
+
+    APP_LOG_INFO("__STREAM source %d from %lu to %lu\r\n", source_id,
+                 (unsigned long)stream_env.offset, (unsigned long)stream_env.end);
+
+    Stream_Pump();
+}
+
+/* Function      : Stream_ReturnCredits
+ *
+ * Description   : Give back the credits used by a received SDU.
+ *
+ * Parameters    : uint16_t credits : number of credits
+ *
+ * Returns       : None
+ */
+static void Stream_ReturnCredits(uint16_t credits)
+{
+    struct l2cc_lecb_add_cmd *cmd;
+
+    if (credits == 0)
+    {
+        return;
+    }
+
+    cmd = KE_MSG_ALLOC(L2CC_LECB_ADD_CMD, KE_BUILD_ID(TASK_L2CC, stream_env.conidx),
+                       TASK_APP, l2cc_lecb_add_cmd);
+    cmd->operation = L2CC_LECB_CREDIT_ADD;
+    cmd->local_cid = stream_env.local_cid;
+    cmd->credit = credits;
+    ke_msg_send(cmd);
+}
+
+/* Function      : Stream_RegisterPsm
+ *
+ * Description   : Register the stream LE PSM with the host so that the
+ *                 channel requests are routed to the application task.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Stream_RegisterPsm(void)
+{
+    struct gapm_lepsm_register_cmd *cmd;
+
+    cmd = KE_MSG_ALLOC(GAPM_LEPSM_REGISTER_CMD, TASK_GAPM, TASK_APP,
+                       gapm_lepsm_register_cmd);
+    cmd->operation = GAPM_LEPSM_REG;
+    cmd->le_psm = STREAM_LE_PSM;
+    cmd->app_task = TASK_APP;
+
+    /* Same level as the open characteristics of the vent service */
+    cmd->sec_lvl = 0;
+    ke_msg_send(cmd);
+}
+
+void Stream_Initialize(void)
+{
+    memset(&stream_env, 0, sizeof(stream_env));
+}
+
+bool Stream_RegisterSource(uint8_t id, const struct stream_source_t *source)
+{
+    if ((id == 0) || (id > STREAM_MAX_SOURCES) || (source == NULL))
+    {
+        return false;
+    }
+
+    stream_sources[id] = source;
+    return true;
+}
+
+void Stream_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                       ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    uint8_t conidx = KE_IDX_GET(src_id);
+
+    switch (msg_id)
+    {
+        case GAPM_CMP_EVT:
+        {
+            const struct gapm_cmp_evt *p = param;
+
+            if ((p->operation == GAPM_SET_DEV_CONFIG) &&
+                (p->status == GAP_ERR_NO_ERROR))
+            {
+                Stream_RegisterPsm();
+            }
+            else if (p->operation == GAPM_LEPSM_REG)
+            {
+                APP_LOG_INFO("__STREAM LE PSM 0x%x registered, status %d\r\n",
+                             STREAM_LE_PSM, p->status);
+            }
+        }
+        break;
+
+        case L2CC_LECB_CONNECT_REQ_IND:
+        {
+            const struct l2cc_lecb_connect_req_ind *p = param;
+            struct l2cc_lecb_connect_cfm *cfm;
+
+            cfm = KE_MSG_ALLOC(L2CC_LECB_CONNECT_CFM, KE_BUILD_ID(TASK_L2CC, conidx),
+                               TASK_APP, l2cc_lecb_connect_cfm);
+            cfm->peer_cid = p->peer_cid;
+            cfm->accept = (stream_env.state == STREAM_STATE_IDLE) &&
+                          (p->le_psm == STREAM_LE_PSM);
+            cfm->local_cid = 0;    // allocated by the host
+            cfm->local_credit = STREAM_LOCAL_CREDITS;
+            cfm->local_mtu = STREAM_LOCAL_MTU;
+            cfm->local_mps = STREAM_LOCAL_MPS;
+            ke_msg_send(cfm);
+
+            APP_LOG_INFO("__STREAM conidx=%d: channel request mtu %d mps %d, %s\r\n",
+                         conidx, p->peer_mtu, p->peer_mps,
+                         APP_LOG_STR(cfm->accept ? "accepted" : "rejected"));
+        }
+        break;
+
+        case L2CC_LECB_CONNECT_IND:
+        {
+            const struct l2cc_lecb_connect_ind *p = param;
+
+            if (p->status != GAP_ERR_NO_ERROR)
+            {
+                break;
+            }
+
+            stream_env.state = STREAM_STATE_CONNECTED;
+            stream_env.conidx = conidx;
+            stream_env.local_cid = p->local_cid;
+            stream_env.peer_mtu = p->peer_mtu;
+            stream_env.peer_mps = p->peer_mps;
+            stream_env.peer_credits = p->peer_credit;
+            stream_env.sdu_in_flight = false;
+
+            APP_LOG_INFO("__STREAM conidx=%d: channel open, peer mtu %d mps %d credits %d\r\n",
+                         conidx, p->peer_mtu, p->peer_mps, p->peer_credit);
+        }
+        break;
+
+        case L2CC_LECB_ADD_IND:
+        {
+            const struct l2cc_lecb_add_ind *p = param;
+
+            if ((stream_env.state != STREAM_STATE_IDLE) &&
+                (p->local_cid == stream_env.local_cid))
+            {
+                stream_env.peer_credits += p->peer_added_credit;
+                Stream_Pump();
+            }
+        }
+        break;
+
+        case L2CC_LECB_SDU_RECV_IND:
+        {
+            const struct l2cc_lecb_sdu_recv_ind *p = param;
+
+            if ((stream_env.state == STREAM_STATE_IDLE) ||
+                (p->sdu.cid != stream_env.local_cid))
+            {
+                break;
+            }
+
+            Stream_ReturnCredits(p->sdu.credit);
+
+            if (p->status == GAP_ERR_NO_ERROR)
+            {
+                Stream_HandleRequest(p->sdu.data, p->sdu.length);
+            }
+        }
+        break;
+
+        case L2CC_CMP_EVT:
+        {
+            const struct l2cc_cmp_evt *p = param;
+
+            if ((p->operation == L2CC_LECB_SDU_SEND) &&
+                (p->cid == stream_env.local_cid))
+            {
+                stream_env.sdu_in_flight = false;
+                Stream_Pump();
+            }
+        }
+        break;
+
+        case L2CC_LECB_DISCONNECT_IND:
+        case GAPC_DISCONNECT_IND:
+        {
+            if ((stream_env.state != STREAM_STATE_IDLE) &&
+                (conidx == stream_env.conidx))
+            {
+                APP_LOG_INFO("__STREAM conidx=%d: channel closed at offset %lu\r\n",
+                             conidx, (unsigned long)stream_env.offset);
+                memset(&stream_env, 0, sizeof(stream_env));
+                Clock_Request(CLOCK_STREAM, CLOCK_LEVEL_LOW);
+            }
+        }
+        break;
+    }
+}
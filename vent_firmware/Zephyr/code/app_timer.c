@@ -0,0 +1,351 @@
+/******************************************************************************
+ * File Name        : app_timer.c
+ * Description      : This module implements the application timer service
+ *                    (see app_timer.h).
+ *
+ *                    The running timers form a binary min-heap on their
+ *                    deadline, each timer keeping its heap index so it is
+ *                    cancelled in O(log n) without a search. The kernel
+ *                    timer is armed when a timer becomes the earliest one;
+ *                    a cancelled earliest timer leaves it armed, the expiry
+ *                    then finds nothing due and arms the next deadline.
+ *
+ *                    The baseband clock counts 312.5 us half slots and
+ *                    wraps after ~23 h; it is extended to 64 bits on every
+ *                    read, and the kernel timer stays armed (at most
+ *                    APP_TIMER_ARM_MAX_MS) even with no timer running so no
+ *                    wrap is missed.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stddef.h>
+#ifdef APP_TIMER_HOST
+#include <app_timer.h>
+#else  /* ifdef APP_TIMER_HOST */
+#include <app.h>
+#include <app_timer.h>
+#include <rwip.h>
+#endif /* ifdef APP_TIMER_HOST */
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+// Baseband clock wraps at 2^28 half slots
+#define APP_TIMER_CLOCK_MASK            (0x0FFFFFFFU)
+
+struct app_timer_env_tag
+{
+    struct app_timer_t *heap[APP_TIMER_MAX];
+    uint8_t count;
+    bool ready;                 // kernel up, see AppTimer_Initialize
+
+#ifdef APP_TIMER_HOST
+    uint64_t clock;             // virtual clock (us)
+#else  /* ifdef APP_TIMER_HOST */
+    uint32_t last_hs;           // last baseband clock read
+    uint64_t epoch_hs;          // half slots since start up
+#endif /* ifdef APP_TIMER_HOST */
+};
+
+static struct app_timer_env_tag app_timer_env;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : AppTimer_Place
+ *
+ * Description   : Store a timer at a heap index and record the index.
+ *
+ * Parameters    : struct app_timer_t *timer : timer
+ *                 uint8_t i                 : heap index
+ *
+ * Returns       : None
+ */
+static void AppTimer_Place(struct app_timer_t *timer, uint8_t i)
+{
+    app_timer_env.heap[i] = timer;
+    timer->slot = i + 1;
+}
+
+/* Function      : AppTimer_SiftUp
+ *
+ * Description   : Move a timer toward the root while it is due earlier
+ *                 than its parent.
+ *
+ * Parameters    : uint8_t i : heap index
+ *
+ * Returns       : None
+ */
+static void AppTimer_SiftUp(uint8_t i)
+{
+    struct app_timer_t *timer = app_timer_env.heap[i];
+
+    while (i > 0)
+    {
+        uint8_t parent = (i - 1) / 2;
+
+        if (app_timer_env.heap[parent]->deadline <= timer->deadline)
+        {
+            break;
+        }
+
+        AppTimer_Place(app_timer_env.heap[parent], i);
+        i = parent;
+    }
+
+    AppTimer_Place(timer, i);
+}
+
+/* Function      : AppTimer_SiftDown
+ *
+ * Description   : Move a timer toward the leaves while a child is due
+ *                 earlier.
+ *
+ * Parameters    : uint8_t i : heap index
+ *
+ * Returns       : None
+ */
+static void AppTimer_SiftDown(uint8_t i)
+{
+    struct app_timer_t *timer = app_timer_env.heap[i];
+
+    for (;;)
+    {
+        uint8_t child = 2 * i + 1;
+
+        if (child >= app_timer_env.count)
+        {
+            break;
+        }
+
+        if ((child + 1 < app_timer_env.count) &&
+            (app_timer_env.heap[child + 1]->deadline < app_timer_env.heap[child]->deadline))
+        {
+            child++;
+        }
+
+        if (timer->deadline <= app_timer_env.heap[child]->deadline)
+        {
+            break;
+        }
+
+        AppTimer_Place(app_timer_env.heap[child], i);
+        i = child;
+    }
+
+    AppTimer_Place(timer, i);
+}
+
+/* Function      : AppTimer_Remove
+ *
+ * Description   : Take a running timer out of the heap.
+ *
+ * Parameters    : struct app_timer_t *timer : running timer
+ *
+ * Returns       : None
+ */
+static void AppTimer_Remove(struct app_timer_t *timer)
+{
+    uint8_t i = timer->slot - 1;
+    struct app_timer_t *last = app_timer_env.heap[--app_timer_env.count];
+
+    timer->slot = 0;
+
+    if (last != timer)
+    {
+        // The last timer fills the hole and moves whichever way it must
+        AppTimer_Place(last, i);
+        AppTimer_SiftUp(i);
+        AppTimer_SiftDown(last->slot - 1);
+    }
+}
+
+/* Function      : AppTimer_Insert
+ *
+ * Description   : Add a timer with its deadline set to the heap.
+ *
+ * Parameters    : struct app_timer_t *timer : stopped timer
+ *
+ * Returns       : None
+ */
+static void AppTimer_Insert(struct app_timer_t *timer)
+{
+    AppTimer_Place(timer, app_timer_env.count++);
+    AppTimer_SiftUp(app_timer_env.count - 1);
+}
+
+/* Function      : AppTimer_Arm
+ *
+ * Description   : Arm the kernel timer for the earliest deadline, in whole
+ *                 milliseconds rounded up.
+ *
+ * Parameters    : uint64_t now : current time (us)
+ *
+ * Returns       : None
+ */
+static void AppTimer_Arm(uint64_t now)
+{
+#ifndef APP_TIMER_HOST
+    uint64_t delay_ms = APP_TIMER_ARM_MAX_MS;
+
+    if (!app_timer_env.ready)
+    {
+        return;
+    }
+
+    if (app_timer_env.count > 0)
+    {
+        uint64_t deadline = app_timer_env.heap[0]->deadline;
+
+        delay_ms = (deadline > now) ? ((deadline - now + 999) / 1000) : 1;
+        if (delay_ms > APP_TIMER_ARM_MAX_MS)
+        {
+            delay_ms = APP_TIMER_ARM_MAX_MS;
+        }
+    }
+
+    ke_timer_set(APP_TIMER_EXPIRY_TIMEOUT, TASK_APP, TIMER_SETTING_MS((uint32_t)delay_ms));
+#else  /* ifndef APP_TIMER_HOST */
+    // The virtual clock runs the expiries itself, see AppTimer_HostAdvance
+    (void)now;
+#endif /* ifndef APP_TIMER_HOST */
+}
+
+/* Function      : AppTimer_Expire
+ *
+ * Description   : Run the callbacks of every timer due at a given time,
+ *                 earliest first. Periodic timers are put back before
+ *                 their callback runs, so the callback may cancel them.
+ *
+ * Parameters    : uint64_t now : current time (us)
+ *
+ * Returns       : None
+ */
+static void AppTimer_Expire(uint64_t now)
+{
+    while ((app_timer_env.count > 0) && (app_timer_env.heap[0]->deadline <= now))
+    {
+        struct app_timer_t *timer = app_timer_env.heap[0];
+
+        AppTimer_Remove(timer);
+
+        if (timer->period != 0)
+        {
+            timer->deadline += timer->period;
+
+            // Late by more than a period: skip the missed expiries
+            if (timer->deadline <= now)
+            {
+                timer->deadline = now + timer->period;
+            }
+
+            AppTimer_Insert(timer);
+        }
+
+        timer->callback(timer->context);
+    }
+}
+
+void AppTimer_Initialize(void)
+{
+    app_timer_env.ready = true;
+    AppTimer_Arm(AppTimer_Now());
+}
+
+bool AppTimer_Start(struct app_timer_t *timer, uint32_t delay, uint32_t period,
+                    app_timer_cb_t callback, void *context)
+{
+    uint64_t now = AppTimer_Now();
+
+    if (timer->slot != 0)
+    {
+        AppTimer_Remove(timer);
+    }
+    else if (app_timer_env.count == APP_TIMER_MAX)
+    {
+        return false;
+    }
+
+    timer->callback = callback;
+    timer->context = context;
+    timer->deadline = now + delay;
+    timer->period = period;
+    AppTimer_Insert(timer);
+
+    if (timer->slot == 1)
+    {
+        AppTimer_Arm(now);
+    }
+
+    return true;
+}
+
+void AppTimer_Cancel(struct app_timer_t *timer)
+{
+    if (timer->slot != 0)
+    {
+        AppTimer_Remove(timer);
+    }
+}
+
+bool AppTimer_IsRunning(const struct app_timer_t *timer)
+{
+    return (timer->slot != 0);
+}
+
+#ifdef APP_TIMER_HOST
+uint64_t AppTimer_Now(void)
+{
+    return app_timer_env.clock;
+}
+
+void AppTimer_HostAdvance(uint64_t us)
+{
+    uint64_t target = app_timer_env.clock + us;
+
+    // Stop at each deadline so callbacks see the time they were due at
+    while ((app_timer_env.count > 0) && (app_timer_env.heap[0]->deadline <= target))
+    {
+        if (app_timer_env.heap[0]->deadline > app_timer_env.clock)
+        {
+            app_timer_env.clock = app_timer_env.heap[0]->deadline;
+        }
+
+        AppTimer_Expire(app_timer_env.clock);
+    }
+
+    app_timer_env.clock = target;
+}
+#else  /* ifdef APP_TIMER_HOST */
+uint64_t AppTimer_Now(void)
+{
+    rwip_time_t time = rwip_time_get();
+
+    app_timer_env.epoch_hs += (time.hs - app_timer_env.last_hs) & APP_TIMER_CLOCK_MASK;
+    app_timer_env.last_hs = time.hs;
+
+    // Half slots of 312.5 us plus the half microseconds into the slot
+    return ((app_timer_env.epoch_hs * 625) + time.hus) / 2;
+}
+
+void AppTimer_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                         ke_task_id_t const dest_id, ke_task_id_t const src_id)
+{
+    if (msg_id == APP_TIMER_EXPIRY_TIMEOUT)
+    {
+        AppTimer_Expire(AppTimer_Now());
+        AppTimer_Arm(AppTimer_Now());
+    }
+}
+#endif /* ifdef APP_TIMER_HOST */
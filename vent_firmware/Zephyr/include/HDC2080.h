@@ -33,9 +33,18 @@
  * --------------------------------------------------------------------------*/
 // General
 #define BITS_PER_BYTE			(8)
-#ifndef MICRO_DELAY											// microseconds delay function
- #define MICRO_DELAY(x)			Sys_Delay(((x * SystemCoreClock) / 1000000))
-#endif
+
+// Longest single transfer (two bytes at 100 kHz take ~300 us); a transfer
+// still running after it is aborted
+#define I2C_TRANSFER_TIMEOUT_US	(2000)
+
+// Bus speed settings tried, with an abort in between, before giving up
+// until the end of the next transfer
+#define I2C_SPEED_TRIES			(4)
+
+// Bus error signal: GPIO toggles and toggle period
+#define I2C_ERROR_TOGGLES		(10)
+#define I2C_ERROR_TOGGLE_MS		(50)
 
 // I2C configuration
 #define RSL15_SLAVE_ADDRESS		(5)
@@ -273,6 +282,17 @@ float get_temperature(void);
  */
 uint16_t get_raw_temperature(void);
 
+/* Function      : SysTick_Handler
+ *
+ * Description   : SysTick interrupt, ends the WFI of a blocking transfer
+ * 				   at its deadline (SysTick only runs during one).
+ *
+ * Parameters    : None
+ *
+ * Returns		 : None
+ */
+void SysTick_Handler(void);
+
 /* Function      : i2c_callback
  *
  * Description   : A callback registered to the I2C->Initialize function.
@@ -299,9 +319,40 @@ void i2c_callback(uint32_t event);
  */
 void initialize_hdc2080(void);
 
+/* Function      : configure_hdc2080_step
+ *
+ * Description   : Starts one register write of the configuration done by
+ * 				   initialize_hdc2080 and returns at once, so the boot can
+ * 				   run other work during the transfer. done is called from
+ * 				   the I2C interrupt when the transfer ends (or fails);
+ * 				   complete_hdc2080_step must then be called before the
+ * 				   next transfer.
+ *
+ * Parameters    : uint8_t step           : The configuration write, from 0.
+ *                 void (*done)(void)     : Transfer end callback.
+ *
+ * Returns		 : bool : false if step is past the last write (nothing
+ * 						  started)
+ */
+bool configure_hdc2080_step(uint8_t step, void (*done)(void));
+
+/* Function      : complete_hdc2080_step
+ *
+ * Description   : Clears the peripheral after a configure_hdc2080_step
+ * 				   write, aborting it if it did not end in time, and
+ * 				   signals a bus error.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : None
+ */
+void complete_hdc2080_step(void);
+
 /* Function      : initialize_i2c_connection
  *
- * Description   : Configures the I2C connection to the HDC2080 module.
+ * Description   : Configures the I2C connection to the HDC2080 module. A
+ * 				   bus speed the driver refuses is logged, signalled as a
+ * 				   bus error and retried after the next transfer.
  *
  * Parameters    : None
  *
@@ -309,6 +360,40 @@ void initialize_hdc2080(void);
  */
 void initialize_i2c_connection(void);
 
+/* Function      : restore_i2c_connection
+ *
+ * Description   : Configures the I2C connection again on wakeup from sleep.
+ * 				   The driver is powered down first, its state is retained
+ * 				   but the peripheral registers are not.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : None
+ */
+void restore_i2c_connection(void);
+
+/* Function      : i2c_is_busy
+ *
+ * Description   : Returns true while an I2C transfer is in progress.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : bool : true if the I2C driver is busy
+ */
+bool i2c_is_busy(void);
+
+/* Function      : i2c_clock_changed
+ *
+ * Description   : Derives the bus speed prescaler again after a system
+ * 				   clock change, so the bus stays at I2C_SPEED; a failure
+ * 				   is handled as by initialize_i2c_connection.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : None
+ */
+void i2c_clock_changed(void);
+
 /* Function      : read_from_register
  *
  * Description   : Sends a command to the HDC2080 to trigger a measurement
@@ -36,19 +36,11 @@
  *     Continuous range			= 1
  */
 #define CONTINUOUS_SERVO		(0)
-#ifndef MICRO_DELAY											// microseconds delay function
- #define MICRO_DELAY(x)			Sys_Delay(((x * SystemCoreClock) / 1000000))
-#endif
-#ifndef MILLI_DELAY											// milliseconds delay function
- #define MILLI_DELAY(x)			Sys_Delay(((x * SystemCoreClock) / 1000))
-#endif
-#ifndef SECOND_DELAY										// seconds delay function
- #define SECOND_DELAY(x)		Sys_Delay((x * SystemCoreClock))
-#endif
-
-// Clock configuration
+
+// Clock configuration (SLOWCLK = SERVO_SYSCLK_HZ / SERVO_CLK_PRESCALER)
 #define SERVO_CLK_SELECT		(1)
 #define SERVO_CLK_PRESCALER		(50)
+#define SERVO_SYSCLK_HZ			(8000000)					// CLOCK_LEVEL_LOW
 
 // PWM configuration
 #define SERVO_PWM_CHANNEL		(0)
@@ -58,6 +50,7 @@
 #define US_PER_ROTATION			(564000)					// microseconds (empirically obtained)
 #define US_PER_DEGREE			(US_PER_ROTATION / 360)
 #define DEG_ROTATION_DELAY(x)	(int)(x * US_PER_ROTATION / 360)
+#define SERVO_TRAVEL_MS			(500)						// fixed range servo, full travel
 
 // Vent state configuration
 #define VENT_OPEN_DEG			(180)						// degrees
@@ -126,13 +119,58 @@ uint8_t get_vent_state(void);
 
 /* Function      : init_servo
  *
- * Description   : Set the PWM channels to a known state.
+ * Description   : Set the vent state variables to the state the vent was
+ * 				   left in, without moving it: the position of a continuous
+ * 				   servo is counted from there. The PWM channel is
+ * 				   configured by the first set_position, so the boot does
+ * 				   not wait for it.
+ *
+ * Parameters    : uint8_t state : restored vent state, VENT_OPEN_STATE if
+ * 								   not VENT_CLOSED_STATE
+ *
+ * Returns		 : None
+ */
+void initialize_servo(uint8_t state);
+
+
+/* Function      : restore_servo
+ *
+ * Description   : Configures the PWM channel of the servo (clock, offset and
+ * 				   period) without changing the vent state. Used on wakeup
+ * 				   from sleep, the PWM registers are not retained; does
+ * 				   nothing before the first move configured it.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : None
+ */
+void restore_servo(void);
+
+
+/* Function      : servo_is_busy
+ *
+ * Description   : Returns true while the PWM drives the servo to a position.
+ *
+ * Parameters    : None
+ *
+ * Returns		 : bool : true if the servo is moving
+ */
+bool servo_is_busy(void);
+
+
+/* Function      : servo_clock_changed
+ *
+ * Description   : Configures the PWM clock again after a system clock
+ * 				   change and starts a move that waited for the lowest
+ * 				   clock level. The PWM runs from SLOWCLK, whose
+ * 				   prescaler the clock dividers setup overwrites; the
+ * 				   SERVO_PWM_PERIOD is only derivable at SERVO_SYSCLK_HZ.
  *
  * Parameters    : None
  *
  * Returns		 : None
  */
-void initialize_servo(void);
+void servo_clock_changed(void);
 
 
 /* Function      : set_position
@@ -140,6 +178,8 @@ void initialize_servo(void);
  * Description   : Sets the position of the servo to the specified degree
  * 				   between 0 and 180. In the case of a continuous servo, the
  * 				   position is approximated based on rotation speed.
+ * 				   Returns at once, the PWM is stopped by a timer after the
+ * 				   travel; an angle set while moving is applied after it.
  *
  * Parameters    : uint8_t angle : The angle that the servo should move to (0-180).
  *
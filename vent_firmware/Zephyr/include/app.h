@@ -54,8 +54,32 @@ extern "C"
 #include <app_msg_handler.h>
 #include <app_customss.h>
 #include <app_bass.h>
+#include <app_battery.h>
+#include <app_energy.h>
 #include <app_diss.h>
 #include <app_temperature_sensor.h>
+#include <app_conn_policy.h>
+#include <app_link.h>
+#include <app_crc.h>
+#include <app_stream.h>
+#include <app_history.h>
+#include <app_ntf_queue.h>
+#include <app_snapshot.h>
+#include <app_sensor.h>
+#include <app_log.h>
+#include <app_dispatch.h>
+#include <app_bench.h>
+#include <app_adv.h>
+#include <app_siphash.h>
+#include <app_relay.h>
+#include <app_group.h>
+#include <app_power.h>
+#include <app_clock.h>
+#include <app_timer.h>
+#include <app_sched.h>
+#include <app_profile.h>
+#include <app_boot.h>
+#include <app_kv.h>
 #include "RTE_Device.h"
 
 #include "i2c_driver.h"
@@ -108,11 +132,8 @@ enum appm_msg
 // Advertising channel map - 37, 38, 39
 #define APP_ADV_CHMAP                   GAPM_DEFAULT_ADV_CHMAP
 
-// Advertising minimum interval - 40ms (64 * 0.625ms)
-#define APP_ADV_INT_MIN                 GAPM_DEFAULT_ADV_INTV_MIN
-
-// Advertising maximum interval - 40ms (64*0.625ms)
-#define APP_ADV_INT_MAX                 GAPM_DEFAULT_ADV_INTV_MAX
+// Advertising intervals and phases are set by the advertising policy
+// (app_adv.h)
 
 // Location of BLE public address
 //	- BLE public address location in MNVR is used as a default value;
@@ -149,8 +170,9 @@ enum appm_msg
 #define CONNECTION_STATE_GPIO           BLUE_LED
 
 // Advertising data is composed by device name and company identification (ID)
-//  Notes: In order to have both device name and company ID included in
-//         the advertising, the length of APP_DEVICE_NAME should not exceed 22 bytes.
+// followed by the group telemetry frame (app_group.h)
+//  Notes: In order to have both device name and telemetry included in
+//         the advertising, the length of APP_DEVICE_NAME should not exceed 15 bytes.
 #define APP_DEVICE_NAME                 "zephyr_ble_vent"
 #define APP_DEVICE_NAME_LEN             (sizeof(APP_DEVICE_NAME) - 1)
 
@@ -159,10 +181,12 @@ enum appm_msg
 #define APP_COMPANY_ID_LEN              (2)
 
 #define APP_DEVICE_APPEARANCE           (0)
-#define APP_PREF_SLV_MIN_CON_INTERVAL   (8)
-#define APP_PREF_SLV_MAX_CON_INTERVAL   (10)
-#define APP_PREF_SLV_LATENCY            (0)
-#define APP_PREF_SLV_SUP_TIMEOUT        (200)
+
+// Preferred parameters advertised to the central are the idle ones
+#define APP_PREF_SLV_MIN_CON_INTERVAL   (CONN_POLICY_IDLE_INTV_MIN)
+#define APP_PREF_SLV_MAX_CON_INTERVAL   (CONN_POLICY_IDLE_INTV_MAX)
+#define APP_PREF_SLV_LATENCY            (CONN_POLICY_IDLE_LATENCY)
+#define APP_PREF_SLV_SUP_TIMEOUT        (CONN_POLICY_IDLE_TIMEOUT)
 
 // Application-provided IRK
 #define APP_IRK                         { 0x01, 0x23, 0x45, 0x68, 0x78, 0x9a, \
@@ -174,14 +198,6 @@ enum appm_msg
                                           0xbc, 0xde, 0x01, 0x23, 0x45, 0x68, \
                                           0x78, 0x9a, 0xbc, 0xde }
 
-
-// Based on enum gap_phy
-#define APP_PREFERRED_PHY_RX            GAP_PHY_LE_CODED
-#define APP_PREFERRED_PHY_TX            GAP_PHY_LE_CODED
-
-// Based on enum gapc_phy_option
-#define APP_PREFERRED_CODED_PHY_RATE    GAPC_PHY_OPT_LE_CODED_125K_RATE
-
 #define SECURE_CONNECTION               (1)    // set 0 for LEGACY_CONNECTION or 1 for SECURE_CONNECTION.
 
 //**** Application common interface defines  ****
@@ -261,15 +277,11 @@ extern DRIVER_PWM_t *pwm;
 extern DRIVER_GPIO_t Driver_GPIO;
 extern DRIVER_GPIO_t *gpio;
 
-// Sensor value storage
-extern EncodedFloat temperature_reading;
-extern EncodedFloat humidity_reading;
+// Threshold storage, the sensor readings are in the snapshot (app_snapshot.h)
 extern EncodedFloat temperature_upper_threshold;
 extern EncodedFloat temperature_lower_threshold;
 // Motor value storage
 extern uint8_t *vent_state;
-// Battery level value storage
-extern uint8_t battery_level;
 
 
 /* ----------------------------------------------------------------------------
@@ -344,7 +356,9 @@ void main_loop(void);
 
 /* Function      : vent_initialization
  *
- * Description   :
+ * Description   : Set the vent state variables from the restored
+ *                 *vent_state, the servo PWM is configured by the first
+ *                 move.
  *
  * Parameters    : None
  *
@@ -362,9 +376,12 @@ void vent_initialization(void);
  */
 void vent_update(void);
 
-/* Function      : vent_update
+/* Function      : vent_threshold_check
  *
- * Description   :
+ * Description   : Close the vent at or above the upper temperature
+ *                 threshold and open it at or below the lower one, each
+ *                 only if active. Run on every published sample
+ *                 (SENSOR_SAMPLE_IND).
  *
  * Parameters    : None
  *
@@ -374,7 +391,8 @@ void vent_threshold_check(void);
 
 /* Function      : sensor_initialization
  *
- * Description   :
+ * Description   : Initialize the I2C connection to the HDC2080, its
+ *                 registers are written by the boot sequencer (Boot_Start).
  *
  * Parameters    : None
  *
@@ -382,16 +400,6 @@ void vent_threshold_check(void);
  */
 void sensor_initialization(void);
 
-/* Function      : sensor_measurement
- *
- * Description   :
- *
- * Parameters    : None
- *
- * Returns		 : None
- */
-void sensor_measurement(void);
-
 
 #ifdef __cplusplus
 }
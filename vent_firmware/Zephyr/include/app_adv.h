@@ -0,0 +1,207 @@
+/******************************************************************************
+ * File Name        : app_adv.h
+ * Description      : This header module contains the constants and function
+ *                    prototypes of the advertising and reconnect policy.
+ *
+ *                    When the hub drops, the vent advertises in phases:
+ *                      DIRECTED : high duty cycle directed advertising to the
+ *                                 address the hub last connected from
+ *                      FAST     : undirected advertising on a short interval
+ *                      MEDIUM   : undirected advertising on a longer interval
+ *                      SLOW     : undirected advertising on a long interval,
+ *                                 kept until a central connects
+ *                    Each phase ends with the duration given to the stack.
+ *                    While the hub is away, a button press or a vent or
+ *                    threshold change returns to FAST (Adv_Kick) and the
+ *                    connection LED flashes less often as the interval
+ *                    grows. The hub address is cached with its bond, so a
+ *                    hub reconnecting from the same resolvable private
+ *                    address is confirmed without another address
+ *                    resolution.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_ADV_H
+#define APP_ADV_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+#include <ble_abstraction.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Advertising intervals (0.625 ms units)
+#define ADV_FAST_INTV                   (48)    // 30 ms
+#define ADV_MEDIUM_INTV                 (668)   // 417.5 ms
+#define ADV_SLOW_INTV                   (1636)  // 1022.5 ms
+
+// Phase durations (10 ms units, at most 65535), 0 runs until a connection.
+// The controller ends high duty cycle directed advertising after 1.28 s.
+#define ADV_DIRECTED_DURATION           (128)
+#define ADV_FAST_DURATION               (3000)  // 30 s
+#define ADV_MEDIUM_DURATION             (30000) // 5 min
+#define ADV_SLOW_DURATION               (0)
+
+// Connection LED while nobody is connected: FAST and DIRECTED toggle it
+// every 200 ms, MEDIUM and SLOW flash it briefly once per period (ms)
+#define ADV_LED_FLASH_MS                (20)
+#define ADV_MEDIUM_LED_PERIOD_MS        (2000)
+#define ADV_SLOW_LED_PERIOD_MS          (10000)
+
+// Current draw model used for the logged estimate of each phase: one
+// legacy advertising event (3 channels, scan request window) costs about
+// ADV_EVENT_CHARGE_NC; high duty cycle directed advertising keeps the
+// radio close to always on. LED current is not included.
+#define ADV_SLEEP_CURRENT_UA            (2)
+#define ADV_EVENT_CHARGE_NC             (15000)
+#define ADV_DIRECTED_CURRENT_UA         (4000)
+
+// Average current of undirected advertising at an interval (0.625 ms units)
+#define ADV_CURRENT_UA(intv)            (ADV_SLEEP_CURRENT_UA + \
+                                         ((uint32_t)ADV_EVENT_CHARGE_NC * 8 / ((uint32_t)(intv) * 5)))
+
+// Advertising phases
+enum adv_phase
+{
+    ADV_PHASE_DIRECTED,
+    ADV_PHASE_FAST,
+    ADV_PHASE_MEDIUM,
+    ADV_PHASE_SLOW,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Adv_Initialize
+ *
+ * Description   : Reset the advertising state and forget the hub. The
+ *                 handler is subscribed through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Adv_Initialize(void);
+
+/* Function      : Adv_Start
+ *
+ * Description   : Create the advertising activity and start the fast phase,
+ *                 called once the attribute database is complete.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Adv_Start(void);
+
+/* Function      : Adv_Kick
+ *
+ * Description   : Return to fast advertising after a local event the hub
+ *                 should learn about soon (button, vent or threshold
+ *                 change). Does nothing while the hub is connected or the
+ *                 directed and fast phases are running.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Adv_Kick(void);
+
+/* Function      : Adv_RefreshData
+ *
+ * Description   : Hand the current advertising data (app_adv_data) to the
+ *                 undirected activity, called after the data changed.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Adv_RefreshData(void);
+
+/* Function      : Adv_GetLedPeriod
+ *
+ * Description   : Returns the connection LED flash period of the current
+ *                 advertising phase.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : period in ms, 0 to toggle every 200 ms
+ */
+uint32_t Adv_GetLedPeriod(void);
+
+/* Function      : Adv_MatchHub
+ *
+ * Description   : Record the address of a connecting peer and check it
+ *                 against the cached hub address.
+ *
+ * Parameters    : uint8_t conidx        : connection index
+ *                 const uint8_t *addr   : peer address (GAP_BD_ADDR_LEN bytes)
+ *                 uint8_t addr_type     : peer address type
+ *
+ * Returns       : bool : true if the peer is the bonded hub reconnecting from
+ *                        the address it was last resolved from
+ */
+bool Adv_MatchHub(uint8_t conidx, const uint8_t *addr, uint8_t addr_type);
+
+/* Function      : Adv_GetBondInfo
+ *
+ * Description   : Returns the bond of a connection, either the one found by
+ *                 the stack or the cached hub bond when Adv_MatchHub skipped
+ *                 the address resolution.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : const BondInfo_t * : bond information, NULL if not bonded
+ */
+const BondInfo_t * Adv_GetBondInfo(uint8_t conidx);
+
+/* Function      : Adv_ForgetHub
+ *
+ * Description   : Drop the cached hub, called when the bond list is cleared.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Adv_ForgetHub(void);
+
+/* Function      : Adv_MsgHandler
+ *
+ * Description   : Drive the advertising activity through the phases, cache
+ *                 the hub once its link is bonded and start the reconnect
+ *                 sequence when it disconnects.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Adv_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                    ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_ADV_H */
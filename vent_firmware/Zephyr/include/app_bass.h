@@ -28,6 +28,7 @@ extern "C"
 #endif    /* ifdef __cplusplus */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <ke_msg.h>
 
 /* ----------------------------------------------------------------------------
@@ -46,11 +47,6 @@ extern "C"
 /* LSAD, VBAT and BATMON alarm configuration */
 #define BATMON_ALARM_COUNT_CFG           1U
 
-/* Maximum and minimum voltage values used as a reference in order to calculate
- * battery level percent */
-#define MAX_VOLTAGE_MV                   3000
-#define MIN_VOLTAGE_MV                   1800
-
 /* VBAT LSAD Channel */
 #define LSAD_VBAT_CHANNEL                3
 
@@ -65,17 +61,19 @@ extern "C"
 
 #define LSAD_VOLTAGE_RANGE_MV            2000
 
+/* Readings averaged by a battery burst */
 #define LSAD_READS_NUM                   16
 
 /* Sample rate is SLOWCLK/1280 (97.65625 Hz per channel), where SLOWCLK = 1MHz
  * so the value must be above 81.92 milliseconds in order to allow enough time
- * for all 8 channels to be sampled */
-#define LSAD_READ_INTERVAL_MS            100
+ * for all 8 channels to be sampled. A burst takes
+ * LSAD_READS_NUM * LSAD_READ_INTERVAL_MS (~1.3 s) */
+#define LSAD_READ_INTERVAL_MS            82
 
-#define LSAD_CHANNEL_NUM                 8
+/* Age of the battery level after which a read starts a new burst */
+#define BATT_MAX_AGE_S                   3600
 
-/* Interval for timer that calls BattLevelReadHandler the first time */
-#define BEGIN_TIMER_S     1
+#define LSAD_CHANNEL_NUM                 8
 
 /* Time interval to check for battery level changes and notify if necessary.
  * BASS_NotifyOnBattLevelChange uses this value to set a kernel timer for
@@ -98,6 +96,16 @@ void APP_BASS_SetBatMonAlarm(uint32_t supplyThresholdCfg);
 
 uint8_t APP_BASS_ReadBattLevel(uint8_t bas_nb);
 
+void APP_BASS_RequestBattLevel(void);
+
+void APP_BASS_LsadStart(void);
+
+void APP_BASS_LsadStop(void);
+
+uint32_t APP_BASS_SampleBattVoltage(void);
+
+uint32_t APP_BASS_GetBattVoltage(uint64_t *read_time);
+
 void BattLevelReadHandler(ke_msg_id_t const msg_id,
                           void const *param,
                           ke_task_id_t const dest_id,
@@ -110,8 +118,12 @@ void APP_BASS_BattLevelLow_Handler(ke_msg_id_t const msg_id,
 
 void APP_BASS_ReadBattLevelInit(uint32_t trim_error);
 
+bool APP_BASS_IsReading(void);
+
 void LSAD_ChannelInit(uint32_t trim_error);
 
+void LSAD_ChannelConfig(void);
+
 extern void LSAD_BATMON_IRQHandler(void);
 
 /* ----------------------------------------------------------------------------
@@ -120,9 +132,14 @@ extern void LSAD_BATMON_IRQHandler(void);
 
 struct app_batt_read_t
 {
-    uint32_t lsad_sum_mV;
-    uint8_t prev_batt_lvl_percent;
+    uint32_t lsad_sum_code;         /* VBAT channel codes of the burst */
+    uint32_t batt_lvl_mV;           /* last burst average */
+    uint64_t read_time;             /* AppTimer_Now at the end of the last burst */
     uint8_t read_cnt;
+    uint8_t activity;               /* busiest enum battery_activity of the burst */
+    uint8_t lsad_users;             /* APP_BASS_LsadStart calls not yet stopped */
+    bool busy;                      /* burst running */
+    bool valid;                     /* a burst has completed */
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,204 @@
+/******************************************************************************
+ * File Name        : app_battery.h
+ * Description      : This header module contains the constants, discharge
+ *                    curves and function prototypes of the battery state
+ *                    estimator.
+ *
+ *                    Every LSAD burst (app_bass.c) comes tagged with the
+ *                    busiest activity seen while it ran: idle, radio
+ *                    (a connection open) or servo (readings during a move
+ *                    are left out of the average, and the burst is not
+ *                    used). The estimator keeps a filtered rest voltage,
+ *                    weighting idle bursts most and correcting radio ones
+ *                    for the expected sag, and maps it to a percentage
+ *                    with the discharge curve of the battery chemistry.
+ *                    The percentage only goes down, unless it jumps up by
+ *                    BATT_REPLACED_PERCENT (new batteries).
+ *
+ *                    During each servo move the VBAT channel is sampled and
+ *                    the lowest voltage kept; the drop from the rest voltage
+ *                    grows with the internal resistance as the battery
+ *                    ages. The moves remaining are the charge left above
+ *                    the point where the rest voltage minus that drop
+ *                    falls under BATT_MOVE_CUTOFF_MV, divided by the charge
+ *                    of one move (standby drain not counted).
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_BATTERY_H
+#define APP_BATTERY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Battery chemistries (two cells in series)
+#define BATT_CHEM_ALKALINE_2S           (0)
+#define BATT_CHEM_LITHIUM_2S            (1)     // Li-FeS2 AA
+#define BATT_CHEM_NIMH_2S               (2)
+
+#ifndef BATT_CHEMISTRY
+#define BATT_CHEMISTRY                  BATT_CHEM_ALKALINE_2S
+#endif /* ifndef BATT_CHEMISTRY */
+
+/* Discharge curves: rest voltage (mV) to charge left (%), by decreasing
+ * voltage, at the few mA the vent draws; linear in between */
+#if (BATT_CHEMISTRY == BATT_CHEM_ALKALINE_2S)
+#define BATT_CAPACITY_MAH               (2400)
+#define BATT_CURVE                      { { 3150, 100 }, { 2900, 90 }, { 2700, 75 }, \
+                                          { 2550, 60 }, { 2450, 45 }, { 2350, 30 }, \
+                                          { 2250, 18 }, { 2150, 10 }, { 2000, 4 },  \
+                                          { 1800, 0 } }
+#elif (BATT_CHEMISTRY == BATT_CHEM_LITHIUM_2S)
+#define BATT_CAPACITY_MAH               (3000)
+#define BATT_CURVE                      { { 3500, 100 }, { 3300, 95 }, { 3200, 85 }, \
+                                          { 3100, 60 }, { 3000, 35 }, { 2900, 15 }, \
+                                          { 2800, 7 }, { 2600, 2 }, { 1800, 0 } }
+#elif (BATT_CHEMISTRY == BATT_CHEM_NIMH_2S)
+#define BATT_CAPACITY_MAH               (2000)
+#define BATT_CURVE                      { { 2800, 100 }, { 2700, 95 }, { 2600, 80 }, \
+                                          { 2500, 55 }, { 2450, 35 }, { 2400, 20 }, \
+                                          { 2300, 10 }, { 2200, 5 }, { 2000, 0 } }
+#else
+#error "Unknown BATT_CHEMISTRY"
+#endif
+
+// Servo current while moving (mA) and lowest loaded voltage the servo and
+// the chip ride through (mV)
+#define BATT_SERVO_CURRENT_MA           (250)
+#define BATT_MOVE_CUTOFF_MV             (2000)
+
+// Drop assumed before the first move is captured (mV)
+#define BATT_SAG_DEFAULT_MV             (200)
+
+// Mean drop of a reading taken with a connection open (mV)
+#define BATT_RADIO_SAG_MV               (15)
+
+// Rise of the curve percentage taken as a battery change
+#define BATT_REPLACED_PERCENT           (20)
+
+// Activity while a burst or reading is taken, by increasing load
+enum battery_activity
+{
+    BATTERY_ACTIVITY_IDLE,
+    BATTERY_ACTIVITY_RADIO,
+    BATTERY_ACTIVITY_SERVO,
+};
+
+struct battery_state_t
+{
+    uint16_t rest_mV;           // filtered rest voltage, 0 before the first burst
+    uint16_t sag_mV;            // filtered drop during the servo moves
+    uint16_t move_min_mV;       // lowest voltage of the last move, 0 if none
+    uint8_t percent;            // charge left (%)
+    uint8_t activity;           // enum battery_activity of the last burst
+    uint32_t moves;             // servo moves since start up or battery change
+    uint32_t moves_left;        // estimated servo moves remaining
+};
+
+// Battery health characteristic: rest_mV, sag_mV, move_min_mV (uint16 LE),
+// percent, activity, moves, moves_left (uint32 LE)
+#define BATT_HEALTH_LENGTH              (16)
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Battery_Initialize
+ *
+ * Description   : Reset the estimator, the first burst sets the state.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Battery_Initialize(void);
+
+/* Function      : Battery_Activity
+ *
+ * Description   : Returns the current activity: servo moving, a connection
+ *                 open, or idle.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint8_t : enum battery_activity
+ */
+uint8_t Battery_Activity(void);
+
+/* Function      : Battery_Update
+ *
+ * Description   : Feed the average voltage of a burst to the estimator;
+ *                 a burst tagged servo is logged and dropped.
+ *
+ * Parameters    : uint32_t mV      : average battery voltage
+ *                 uint8_t activity : busiest enum battery_activity seen
+ *
+ * Returns       : None
+ */
+void Battery_Update(uint32_t mV, uint8_t activity);
+
+/* Function      : Battery_MoveStarted
+ *
+ * Description   : Start sampling the battery for the lowest voltage of a
+ *                 servo move. Called by the servo driver.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Battery_MoveStarted(void);
+
+/* Function      : Battery_MoveEnded
+ *
+ * Description   : Stop sampling and update the drop with the lowest voltage
+ *                 of the move. Called by the servo driver.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Battery_MoveEnded(void);
+
+/* Function      : Battery_GetState
+ *
+ * Description   : Returns the estimated battery state.
+ *
+ * Parameters    : None
+ *
+ * Returns       : const struct battery_state_t * : state
+ */
+const struct battery_state_t *Battery_GetState(void);
+
+/* Function      : Battery_PackHealth
+ *
+ * Description   : Serialize the battery state in the characteristic layout.
+ *
+ * Parameters    : uint8_t *buf : destination, BATT_HEALTH_LENGTH bytes
+ *
+ * Returns       : None
+ */
+void Battery_PackHealth(uint8_t *buf);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_BATTERY_H */
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * File Name        : app_bench.h
+ * Description      : This header module contains the commands, the result
+ *                    layout and the function prototypes of the BLE benchmark
+ *                    served by custom service 0.
+ *
+ *                    A client writes a 4-byte command to BENCH_CTRL:
+ *                      THROUGHPUT [1] duration (s), [2] payload (bytes,
+ *                                 0 = ATT MTU - 3): notify BENCH_DATA as
+ *                                 fast as the stack accepts for the
+ *                                 duration, each payload starts with a
+ *                                 32-bit sequence number
+ *                      PING       [1..2] sequence number: the command is
+ *                                 notified back on BENCH_DATA, the client
+ *                                 times write to notification
+ *                      STOP       end a throughput test early
+ *                      RESET      clear the counters
+ *                    The counters are read from BENCH_RESULT.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_BENCH_H
+#define APP_BENCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Command opcodes (byte 0 of a BENCH_CTRL write)
+#define BENCH_OP_STOP                   (0x00)
+#define BENCH_OP_THROUGHPUT             (0x01)
+#define BENCH_OP_PING                   (0x02)
+#define BENCH_OP_RESET                  (0x03)
+
+#define BENCH_CTRL_LENGTH               (4)
+
+// Largest notification payload (ATT MTU - 3 at the largest MTU)
+#define BENCH_PAYLOAD_MAX               (LINK_MAX_MTU - 3)
+
+// Smallest payload, holds the sequence number
+#define BENCH_PAYLOAD_MIN               (4)
+
+#define BENCH_DURATION_MAX_S            (60)
+
+// Notifications handed to the stack and not yet completed
+#define BENCH_MAX_IN_FLIGHT             (6)
+
+// Sequence numbers used by the benchmark, kept apart from the notification
+// queue (NTF_QUEUE_SEQ_FLAG)
+#define BENCH_SEQ_FLAG                  (0x4000)
+#define BENCH_SEQ_MASK                  (0xC000)
+
+// Benchmark state (result byte 0)
+enum bench_state
+{
+    BENCH_STATE_IDLE,
+    BENCH_STATE_THROUGHPUT,     // sending
+    BENCH_STATE_DRAINING,       // duration over, waiting for completions
+};
+
+// Result characteristic layout (little endian)
+//   [0] state, [1] conidx, [2..3] payload bytes, [4..5] ATT MTU,
+//   [6..9] notifications completed, [10..13] payload bytes completed,
+//   [14..17] test duration (ms, first send to last completion),
+//   [18..21] completions with an error, [22..25] pings answered,
+//   [26..29] worst ping turnaround in the device (us)
+#define BENCH_RESULT_LENGTH             (30)
+
+// Benchmark messages
+enum bench_msg_id
+{
+    // Command written to BENCH_CTRL (struct bench_cmd_t)
+    BENCH_CMD = TASK_FIRST_MSG(TASK_ID_APP) + 100,
+
+    // Throughput test duration elapsed
+    BENCH_TIMEOUT,
+};
+
+struct bench_cmd_t
+{
+    uint8_t value[BENCH_CTRL_LENGTH];
+    uint64_t rx_us;             // AppTimer_Now() when the write arrived
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Bench_Initialize
+ *
+ * Description   : Reset the benchmark state and counters.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Bench_Initialize(void);
+
+/* Function      : Bench_ValidateCommand
+ *
+ * Description   : Check a BENCH_CTRL write before it is accepted.
+ *
+ * Parameters    : const uint8_t *value : written value
+ *                 uint16_t length      : written length
+ *
+ * Returns       : bool : true if the command is well formed
+ */
+bool Bench_ValidateCommand(const uint8_t *value, uint16_t length);
+
+/* Function      : Bench_Post
+ *
+ * Description   : Time-stamp a BENCH_CTRL write and post it to the
+ *                 application task as BENCH_CMD.
+ *
+ * Parameters    : uint8_t conidx       : connection index
+ *                 const uint8_t *value : validated command
+ *
+ * Returns       : None
+ */
+void Bench_Post(uint8_t conidx, const uint8_t *value);
+
+/* Function      : Bench_PackResult
+ *
+ * Description   : Write the result characteristic value.
+ *
+ * Parameters    : uint8_t *buf : destination, BENCH_RESULT_LENGTH bytes
+ *
+ * Returns       : None
+ */
+void Bench_PackResult(uint8_t *buf);
+
+/* Function      : Bench_MsgHandler
+ *
+ * Description   : Run the commands, keep the throughput test fed on
+ *                 GATTC_CMP_EVT and stop it on timeout or disconnection.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Bench_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_BENCH_H */
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * File Name        : app_boot.h
+ * Description      : This header module contains the phase table and
+ *                    function prototypes of the boot sequencer.
+ *
+ *                    main() starts the BLE stack reset first; its reset,
+ *                    device configuration and database setup run as kernel
+ *                    messages. The HDC2080 registers are written in the
+ *                    meantime, one non-blocking I2C transfer at a time,
+ *                    each started by the scheduler task of the previous
+ *                    one's end, and the first conversion follows the last
+ *                    write. The servo PWM is configured by the first move
+ *                    (Servo.c), not at boot.
+ *
+ *                    The time of each phase of BOOT_PHASE_TABLE is
+ *                    recorded once, in microseconds from the end of
+ *                    DeviceInit: on the cycle counter until the stack
+ *                    reset is sent, on the baseband clock (AppTimer_Now)
+ *                    from there, which keeps counting across sleep. The
+ *                    phases are logged once advertising has started and
+ *                    the first sample is published.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_BOOT_H
+#define APP_BOOT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+/* Boot phases, in their usual order:
+ *   X(name)
+ *   name : BOOT_PHASE_<name> index, passed to Boot_Mark
+ */
+#define BOOT_PHASE_TABLE(X)                                                    \
+    X(CLOCKS)                   /* DeviceInit done, time origin */             \
+    X(LOG)                      /* trace UART and log buffer up */             \
+    X(BLE_RESET)                /* stack initialized, GAPM_RESET sent */       \
+    X(STACK_RESET)              /* GAPM_RESET complete */                      \
+    X(DEV_CONFIG)               /* GAPM_SET_DEV_CONFIG complete */             \
+    X(SERVICES)                 /* last custom service added */                \
+    X(ADV)                      /* first advertising started */                \
+    X(SENSOR_CONFIG)            /* HDC2080 registers written */                \
+    X(FIRST_SAMPLE)             /* first snapshot published */                 \
+    X(SERVO)                    /* PWM configured by the first move */
+
+#define BOOT_PHASE_ENUM(name)           BOOT_PHASE_##name,
+
+enum boot_phase
+{
+    BOOT_PHASE_TABLE(BOOT_PHASE_ENUM)
+    BOOT_PHASE_COUNT
+};
+
+// Time of a phase not reached yet
+#define BOOT_PHASE_NONE                 (UINT32_MAX)
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Boot_Initialize
+ *
+ * Description   : Start the cycle counter and the boot clock. Called from
+ *                 main() right after DeviceInit, the time origin.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Boot_Initialize(void);
+
+/* Function      : Boot_Mark
+ *
+ * Description   : Record the time of a phase, the first time it is reached.
+ *                 BOOT_PHASE_BLE_RESET moves the boot clock to the baseband
+ *                 clock. Application task only.
+ *
+ * Parameters    : uint8_t phase : enum boot_phase
+ *
+ * Returns       : None
+ */
+void Boot_Mark(uint8_t phase);
+
+/* Function      : Boot_Start
+ *
+ * Description   : Start writing the HDC2080 configuration in the
+ *                 background. Called once the BLE stack reset is sent; the
+ *                 sampler is started after the last write.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Boot_Start(void);
+
+/* Function      : Boot_SensorTask
+ *
+ * Description   : Scheduler task posted by the I2C interrupt at the end of a
+ *                 configuration write: clear the peripheral and start the
+ *                 next write.
+ *
+ * Parameters    : uint32_t arg : configuration write that ended
+ *
+ * Returns       : None
+ */
+void Boot_SensorTask(uint32_t arg);
+
+/* Function      : Boot_GetPhase
+ *
+ * Description   : Returns the time of a phase.
+ *
+ * Parameters    : uint8_t phase : enum boot_phase
+ *
+ * Returns       : uint32_t : microseconds from the end of DeviceInit,
+ *                            BOOT_PHASE_NONE if not reached
+ */
+uint32_t Boot_GetPhase(uint8_t phase);
+
+/* Function      : Boot_MsgHandler
+ *
+ * Description   : Record the phases of the BLE stack reset and database
+ *                 setup, and of the first sample.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Boot_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                     ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_BOOT_H */
@@ -0,0 +1,233 @@
+/******************************************************************************
+ * File Name        : app_clock.h
+ * Description      : This header module contains the level tables and
+ *                    function prototypes of the system clock policy.
+ *
+ *                    The core runs at the lowest level of
+ *                    CLOCK_LEVEL_TABLE, the lowest clock the BLE stack is
+ *                    run at, unless a client of CLOCK_CLIENT_TABLE
+ *                    requests a higher level for bursty work (pairing
+ *                    crypto, log formatting, stream packing). The level
+ *                    applied is the highest request, capped by the lowest
+ *                    limit: the servo PWM period can only be derived from
+ *                    SLOWCLK at the lowest level, so a move holds it there.
+ *
+ *                    A level change reprograms the RF clock prescaler, the
+ *                    baseband clock divider (kept at 1 MHz), the flash
+ *                    timing and the UART, sensor and user clock dividers
+ *                    (kept at UART_CLK, SENSOR_CLK and USER_CLK), then
+ *                    calls the drivers of CLOCK_NOTIFY_TABLE to re-derive
+ *                    their own dividers (I2C_SPEED, SERVO_PWM_PERIOD). It
+ *                    is deferred while a subsystem of CLOCK_HOLD_TABLE is
+ *                    running from the clocks and retried from the main
+ *                    loop.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_CLOCK_H
+#define APP_CLOCK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+/* Levels, lowest first:
+ *   X(name, prescale, hz, bbclk_divider)
+ *   name          : CLOCK_LEVEL_<name> index, passed to the requests
+ *   prescale      : RF clock (48 MHz XTAL) prescaler, SYSCLK source
+ *   hz            : resulting SYSCLK
+ *   bbclk_divider : SYSCLK to 1 MHz baseband clock
+ */
+#define CLOCK_LEVEL_TABLE(X)                                                   \
+    X(LOW,  CK_DIV_1_6_PRESCALE_6_BYTE, 8000000,  BBCLK_DIVIDER_8)             \
+    X(MID,  CK_DIV_1_6_PRESCALE_3_BYTE, 16000000, BBCLK_DIVIDER_16)            \
+    X(HIGH, CK_DIV_1_6_PRESCALE_2_BYTE, 24000000, BBCLK_DIVIDER_24)
+
+#define CLOCK_LEVEL_ENUM(name, prescale, hz, bbclk_divider)    CLOCK_LEVEL_##name,
+
+enum clock_level
+{
+    CLOCK_LEVEL_TABLE(CLOCK_LEVEL_ENUM)
+    CLOCK_LEVEL_COUNT
+};
+
+/* Clients, each holds one request and one limit:
+ *   X(name)
+ *   name : CLOCK_<name> index, passed to the requests
+ */
+#define CLOCK_CLIENT_TABLE(X)                                                  \
+    X(PAIRING)                  /* security manager, bond request to bond */   \
+    X(LOG)                      /* log records left to format */               \
+    X(STREAM)                   /* stream download, read and CRC */            \
+    X(SERVO)                    /* PWM pulse train, limit */
+
+#define CLOCK_CLIENT_ENUM(name)         CLOCK_##name,
+
+enum clock_client
+{
+    CLOCK_CLIENT_TABLE(CLOCK_CLIENT_ENUM)
+    CLOCK_CLIENT_COUNT
+};
+
+/* Subsystems that defer a level change while running, in order:
+ *   X(name, query)
+ *   name  : CLOCK_HOLD_<name> index, used in the deferral counters
+ *   query : bool (*)(void), true while the subsystem runs from the clocks
+ */
+#define CLOCK_HOLD_TABLE(X)                                                    \
+    X(I2C,      i2c_is_busy)            /* HDC2080 transfer */                 \
+    X(SERVO,    servo_is_busy)          /* PWM pulse train */                  \
+    X(LSAD,     APP_BASS_IsReading)     /* battery measurement burst */        \
+    X(TRACE,    Power_TraceBusy)        /* swmTrace UART transmit */
+
+#define CLOCK_HOLD_ENUM(name, query)    CLOCK_HOLD_##name,
+
+enum clock_hold
+{
+    CLOCK_HOLD_TABLE(CLOCK_HOLD_ENUM)
+    CLOCK_HOLD_COUNT
+};
+
+/* Drivers told after a level change, in order:
+ *   X(name, notify)
+ *   notify : void (*)(void), re-derives the driver clocks from
+ *            SystemCoreClock
+ */
+#define CLOCK_NOTIFY_TABLE(X)                                                  \
+    X(I2C,      i2c_clock_changed)      /* bus speed prescaler */              \
+    X(SERVO,    servo_clock_changed)    /* PWM SLOWCLK prescaler, period */
+
+struct clock_stats_t
+{
+    uint64_t residency_us[CLOCK_LEVEL_COUNT];   // time at each level
+    uint32_t switches;                          // level changes applied
+    uint32_t deferred[CLOCK_HOLD_COUNT];        // updates held per subsystem
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Clock_Initialize
+ *
+ * Description   : Clear the requests and limits and reset the statistics.
+ *                 The clock is at the lowest level (DeviceClockInit). The
+ *                 handler is subscribed through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Clock_Initialize(void);
+
+/* Function      : Clock_Request
+ *
+ * Description   : Set the lowest level a client needs, CLOCK_LEVEL_LOW once
+ *                 its work is done. The level changes at once unless a
+ *                 subsystem holds the clocks. Application task only.
+ *
+ * Parameters    : uint8_t client : enum clock_client
+ *                 uint8_t level  : enum clock_level
+ *
+ * Returns       : None
+ */
+void Clock_Request(uint8_t client, uint8_t level);
+
+/* Function      : Clock_Limit
+ *
+ * Description   : Set the highest level a client allows,
+ *                 CLOCK_LEVEL_COUNT - 1 to remove the limit. Application
+ *                 task only.
+ *
+ * Parameters    : uint8_t client : enum clock_client
+ *                 uint8_t level  : enum clock_level
+ *
+ * Returns       : None
+ */
+void Clock_Limit(uint8_t client, uint8_t level);
+
+/* Function      : Clock_Update
+ *
+ * Description   : Apply the level of the current requests and limits if no
+ *                 subsystem holds the clocks. Called from the main loop
+ *                 for the changes deferred by Clock_Request and
+ *                 Clock_Limit.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Clock_Update(void);
+
+/* Function      : Clock_Restore
+ *
+ * Description   : Restore the requested level after a sleep, the wakeup
+ *                 restarts the clocks at the lowest level.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Clock_Restore(void);
+
+/* Function      : Clock_GetLevel
+ *
+ * Description   : Returns the level the core runs at.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint8_t : enum clock_level
+ */
+uint8_t Clock_GetLevel(void);
+
+/* Function      : Clock_GetStats
+ *
+ * Description   : Returns the level residency and the switch counters, the
+ *                 current level counted up to now.
+ *
+ * Parameters    : None
+ *
+ * Returns       : const struct clock_stats_t * : statistics
+ */
+const struct clock_stats_t *Clock_GetStats(void);
+
+/* Function      : Clock_MsgHandler
+ *
+ * Description   : Request the highest level from a pairing request to the
+ *                 end of the pairing or of the link, and log the level
+ *                 residency with the power report.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Clock_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_CLOCK_H */
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * File Name        : app_conn_policy.h
+ * Description      : This header module contains the constants and function
+ *                    prototypes for the connection parameter policy engine.
+ *
+ *                    The policy keeps each link on long intervals with high
+ *                    slave latency while idle, switches to short intervals
+ *                    while a bulk transfer or command burst is in progress
+ *                    and falls back to the idle parameters after a timeout.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_CONN_POLICY_H
+#define APP_CONN_POLICY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Idle parameters: 400-500 ms interval (1.25 ms units), 4 skipped events,
+// 6 s supervision timeout (10 ms units). The radio wakes every ~2 s.
+#define CONN_POLICY_IDLE_INTV_MIN           (320)
+#define CONN_POLICY_IDLE_INTV_MAX           (400)
+#define CONN_POLICY_IDLE_LATENCY            (4)
+#define CONN_POLICY_IDLE_TIMEOUT            (600)
+
+// Active parameters: 7.5-15 ms interval, no latency, 2 s supervision timeout
+#define CONN_POLICY_ACTIVE_INTV_MIN         (6)
+#define CONN_POLICY_ACTIVE_INTV_MAX         (12)
+#define CONN_POLICY_ACTIVE_LATENCY          (0)
+#define CONN_POLICY_ACTIVE_TIMEOUT          (200)
+
+// Peer requests at or below this interval are treated as activity
+#define CONN_POLICY_ACTIVE_INTV_LIMIT       (CONN_POLICY_ACTIVE_INTV_MAX * 2)
+
+// Time spent in the active state after the last activity (ms)
+#define CONN_POLICY_ACTIVE_HOLD_MS          (5000)
+
+// Time spent in the active state after connection (service discovery, ms)
+#define CONN_POLICY_CONNECT_HOLD_MS         (10000)
+
+// Current draw model used for the logged estimate
+#define CONN_POLICY_SLEEP_CURRENT_UA        (2)     // sleep floor between events
+#define CONN_POLICY_EVENT_CHARGE_NC         (5000)  // charge per connection event
+
+// Connection interval / supervision timeout unit conversions
+#define CONN_INTV_TO_US(x)                  ((uint32_t)(x) * 1250)
+#define CONN_TIMEOUT_TO_MS(x)               ((uint32_t)(x) * 10)
+
+// Connection policy states
+enum conn_policy_state
+{
+    CONN_POLICY_STATE_DISCONNECTED,
+    CONN_POLICY_STATE_IDLE,
+    CONN_POLICY_STATE_ACTIVE,
+};
+
+// Connection policy messages
+enum conn_policy_msg_id
+{
+    CONN_POLICY_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 70,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : ConnPolicy_Initialize
+ *
+ * Description   : Reset the per-connection policy state. The handler is
+ *                 subscribed through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void ConnPolicy_Initialize(void);
+
+/* Function      : ConnPolicy_RequestActive
+ *
+ * Description   : Signal activity on a connection (command burst, bulk
+ *                 transfer). Requests the short interval parameters if the
+ *                 link is idle and restarts the fall back timer.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : None
+ */
+void ConnPolicy_RequestActive(uint8_t conidx);
+
+/* Function      : ConnPolicy_GetState
+ *
+ * Description   : Returns the policy state of a connection.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : uint8_t : one of enum conn_policy_state
+ */
+uint8_t ConnPolicy_GetState(uint8_t conidx);
+
+/* Function      : ConnPolicy_EstimateCurrent
+ *
+ * Description   : Estimates the average current drawn by a connection with
+ *                 the given parameters, from the sleep floor and the charge
+ *                 spent on each connection event the slave attends.
+ *
+ * Parameters    : uint16_t interval : connection interval (1.25 ms units)
+ *                 uint16_t latency  : slave latency (events)
+ *
+ * Returns       : uint32_t : estimated average current (uA)
+ */
+uint32_t ConnPolicy_EstimateCurrent(uint16_t interval, uint16_t latency);
+
+/* Function      : ConnPolicy_MsgHandler
+ *
+ * Description   : Handle the connection events and timers of the policy.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void ConnPolicy_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                           ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_CONN_POLICY_H */
@@ -0,0 +1,58 @@
+/******************************************************************************
+ * File Name        : app_crc.h
+ * Description      : This header module contains the function prototypes for
+ *                    the CRC-32 (IEEE 802.3, reflected 0xEDB88320) used to
+ *                    check bulk transfers.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_CRC_H
+#define APP_CRC_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Start value of a CRC computation, pass the result through CRC32_FINAL
+#define CRC32_INIT                      (0xFFFFFFFFUL)
+#define CRC32_FINAL(crc)                ((crc) ^ 0xFFFFFFFFUL)
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : CRC32_Update
+ *
+ * Description   : Accumulate a block of data into a running CRC-32. The
+ *                 result matches zlib.crc32() once CRC32_FINAL is applied.
+ *
+ * Parameters    : uint32_t crc         : running CRC (CRC32_INIT to start)
+ *                 const uint8_t *data  : data to accumulate
+ *                 uint32_t length      : number of bytes
+ *
+ * Returns       : uint32_t : updated running CRC
+ */
+uint32_t CRC32_Update(uint32_t crc, const uint8_t *data, uint32_t length);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_CRC_H */
@@ -43,90 +43,136 @@ extern "C"
 /* ----------------------------------------------------------------------------
  * Include files
  * --------------------------------------------------------------------------*/
+#include <stddef.h>
 #include <gattc_task.h>
+#include <app_link.h>
+#include <app_battery.h>
+#include <app_energy.h>
+#include <app_bench.h>
+#include <app_group.h>
 
 
 /* ----------------------------------------------------------------------------
  * Defines
  * --------------------------------------------------------------------------*/
-// Custom service UUIDs and characteristics
-
-// Custom service UUIDs
-#define CS_SVC_UUID                     { 0x24, 0xdc, 0x0e, 0x6e, 0x01, 0x40, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-#define CS_CHAR_TX_UUID                 { 0x24, 0xdc, 0x0e, 0x6e, 0x02, 0x40, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-#define CS_CHAR_RX_UUID                 { 0x24, 0xdc, 0x0e, 0x6e, 0x03, 0x40, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-#define CS_CHAR_LONG_TX_UUID            { 0x24, 0xdc, 0x0e, 0x6e, 0x04, 0x40, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-#define CS_CHAR_LONG_RX_UUID            { 0x24, 0xdc, 0x0e, 0x6e, 0x05, 0x40, \
+// Custom service UUIDs, 128-bit little endian. Services and characteristics
+// only differ in bytes 4 and 5.
+#define CS_UUID(B4, B5)                 { 0x24, 0xdc, 0x0e, 0x6e, (B4), (B5), \
                                           0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
                                           0xb5, 0xf3, 0x93, 0xe0 }
 
-#define CS_BLT_SVC_UUID                 { 0x24, 0xdc, 0x0e, 0x6e, 0x01, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-// Battery level
-#define CS_CHAR_BATTERY_UUID            { 0x24, 0xdc, 0x0e, 0x6e, 0x02, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-// RSL on-board LED state
-#define CS_CHAR_LED_UUID                { 0x24, 0xdc, 0x0e, 0x6e, 0x03, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-// RSL on-board button state
-#define CS_CHAR_BUTTON_UUID             { 0x24, 0xdc, 0x0e, 0x6e, 0x04, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-// Vent (motor) state
-#define CS_CHAR_VENT_UUID               { 0x24, 0xdc, 0x0e, 0x6e, 0x05, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-// Sensor humidity reading
-#define CS_CHAR_HUM_UUID                { 0x24, 0xdc, 0x0e, 0x6e, 0x06, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-// Sensor temperature reading
-#define CS_CHAR_TEMP_UUID               { 0x24, 0xdc, 0x0e, 0x6e, 0x07, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-// Vent upper temperature threshold for auto-close
-#define CS_CHAR_TEMP_UTHR_UUID          { 0x24, 0xdc, 0x0e, 0x6e, 0x08, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
-// Vent lower temperature threshold for auto-open
-#define CS_CHAR_TEMP_LTHR_UUID          { 0x24, 0xdc, 0x0e, 0x6e, 0x09, 0x50, \
-                                          0xca, 0x9e, 0xe5, 0xa9, 0xa3, 0x00, \
-                                          0xb5, 0xf3, 0x93, 0xe0 }
+#define CS_SVC_UUID                     CS_UUID(0x01, 0x40)
+#define CS_BLT_SVC_UUID                 CS_UUID(0x01, 0x50)
 
 #define CS_VALUE_MAX_LENGTH          20
-#define CS_LONG_VALUE_MAX_LENGTH     40
 #define CS_BATTERY_MAX_LENGTH        1
 #define CS_LED_BUTTON_MAX_LENGTH     1
 #define CS_VENT_STATE_MAX_LENGTH     1
 #define CS_TEMPERATURE_MAX_LENGTH    4
 #define CS_HUMIDITY_MAX_LENGTH       (CS_TEMPERATURE_MAX_LENGTH)
-
-#define CS_TX_CHAR_NAME            "TX_VALUE"
-#define CS_RX_CHAR_NAME            "RX_VALUE"
-#define CS_TX_CHAR_LONG_NAME       "TX_VALUE_LONG"
-#define CS_RX_CHAR_LONG_NAME       "RX_VALUE_LONG"
-#define CS_BATTERY_CHAR_NAME       "BATTERY_LEVEL"
-#define CS_LED_CHAR_NAME           "LED_STATE"
-#define CS_BUTTON_CHAR_NAME        "BUTTON_STATE"
-#define CS_VENT_CHAR_NAME          "VENT_STATE"
-#define CS_HUM_CHAR_NAME           "HUMIDITY_VALUE"
-#define CS_TEMP_CHAR_NAME          "TEMPERATURE_VALUE"
-#define CS_TEMP_UTHR_CHAR_NAME     "TEMP_UPPER_THRESHOLD_VALUE"
-#define CS_TEMP_LTHR_CHAR_NAME     "TEMP_LOWER_THRESHOLD_VALUE"
-
-// Uncomment to use indications in the RX_VALUE_LONG characteristic
-// #define RX_VALUE_LONG_INDICATION
+#define CS_LINK_INFO_MAX_LENGTH      (LINK_INFO_LENGTH)
+#define CS_MAX_AGE_MAX_LENGTH        2
+#define CS_ZONE_ID_MAX_LENGTH        (GROUP_ZONE_LENGTH)
+#define CS_GROUP_KEY_MAX_LENGTH      (GROUP_KEY_WRITE_LENGTH)
+#define CS_BATT_HEALTH_MAX_LENGTH    (BATT_HEALTH_LENGTH)
+#define CS_ENERGY_MAX_LENGTH         (ENERGY_INFO_LENGTH)
+#define CS_BENCH_CTRL_MAX_LENGTH     (BENCH_CTRL_LENGTH)
+#define CS_BENCH_DATA_MAX_LENGTH     (BENCH_PAYLOAD_MAX)
+#define CS_BENCH_RESULT_MAX_LENGTH   (BENCH_RESULT_LENGTH)
+
+// Lowest temperature threshold accepted (HDC2080 range), values at or above
+// THRESHOLD_OFF_LIMIT disable the threshold
+#define CS_TEMP_THRESHOLD_MIN        (-40.0f)
+
+// Uncomment to add a Characteristic User Description descriptor (the
+// manifest name) to every characteristic, useful with generic BLE explorers
+// #define CS_USER_DESCRIPTIONS
+
+// Characteristic permissions used by the manifest
+#define CS_PERM_READ                 (PERM(RD, ENABLE))
+#define CS_PERM_NOTIFY               (PERM(RD, ENABLE) | PERM(NTF, ENABLE))
+#define CS_PERM_WRITE                (PERM(RD, ENABLE) | PERM(WRITE_REQ, ENABLE) | \
+                                      PERM(WRITE_COMMAND, ENABLE))
+#define CS_PERM_WRITE_SECURE         (CS_PERM_WRITE | PERM(RP, SEC_CON))
+#define CS_PERM_WRITE_ENC            (CS_PERM_WRITE | PERM(WP, UNAUTH))
+#define CS_PERM_WRITE_ONLY_ENC       (PERM(WRITE_REQ, ENABLE) | PERM(WP, UNAUTH))
+
+/* Characteristic manifest
+ *
+ * Every characteristic of the custom services is declared once here. The
+ * attribute indexes, the value buffers, the CCC descriptors, the attribute
+ * databases (app_customss.c) and the hub UUID list (hub_software/src/
+ * gen_ble_config.py) are all generated from these lists.
+ *
+ *   X(svc, name, uuid4, uuid5, perm, length, store, ccc, callback, hub_key)
+ *
+ *   svc      : service index (CUST_SVC0/CUST_SVC1), must match the list
+ *   name     : characteristic name, gives CS_<name>_VALUE_VAL<svc> etc.
+ *   uuid4/5  : bytes 4 and 5 of the characteristic UUID (see CS_UUID)
+ *   perm     : attribute permissions
+ *   length   : value length in bytes
+ *   store    : ENV      - value kept in app_env_cs (<name>_buffer)
+ *              SNAPSHOT - value served from the sensor snapshot, no
+ *                         buffer (see app_snapshot.h); reads are answered
+ *                         by CUSTOMSS_MsgHandler, so no callback
+ *   ccc      : NONE   - no CCC descriptor (read/write only)
+ *              CCC    - CCC descriptor, notifications off until enabled
+ *              CCC_ON - CCC descriptor, notifications on from connection
+ *   callback : attribute access callback, NULL if none
+ *   hub_key  : key of the UUID in the hub ble_config.json, "" if unused
+ */
+#define CS_SVC0_MANIFEST(X) \
+    X(0, TX,        0x02, 0x40, CS_PERM_WRITE_SECURE, CS_VALUE_MAX_LENGTH,       ENV,      NONE,   NULL,                          "") \
+    X(0, RX,        0x03, 0x40, CS_PERM_NOTIFY,       CS_VALUE_MAX_LENGTH,       ENV,      CCC,    CUSTOMSS_RXCharCallback,       "") \
+    X(0, BENCH_CTRL, 0x06, 0x40, CS_PERM_WRITE,       CS_BENCH_CTRL_MAX_LENGTH,  ENV,      NONE,   CUSTOMSS_BenchCtrlCharCallback, "UUID_BENCH_CTRL") \
+    X(0, BENCH_DATA, 0x07, 0x40, CS_PERM_NOTIFY,      CS_BENCH_DATA_MAX_LENGTH,  ENV,      CCC,    NULL,                          "UUID_BENCH_DATA") \
+    X(0, BENCH_RESULT, 0x08, 0x40, CS_PERM_READ,      CS_BENCH_RESULT_MAX_LENGTH, ENV,     NONE,   CUSTOMSS_BenchResultCharCallback, "UUID_BENCH_RESULT")
+
+#define CS_SVC1_MANIFEST(X) \
+    X(1, BATTERY,   0x02, 0x50, CS_PERM_NOTIFY,       CS_BATTERY_MAX_LENGTH,     SNAPSHOT, CCC_ON, NULL,                          "UUID_BATTERY") \
+    X(1, LED,       0x03, 0x50, CS_PERM_WRITE,        CS_LED_BUTTON_MAX_LENGTH,  ENV,      NONE,   CUSTOMSS_LEDCharCallback,      "UUID_LED_STATE") \
+    X(1, BUTTON,    0x04, 0x50, CS_PERM_NOTIFY,       CS_LED_BUTTON_MAX_LENGTH,  ENV,      CCC_ON, NULL,                          "UUID_BUTTON_STATE") \
+    X(1, VENT,      0x05, 0x50, CS_PERM_WRITE,        CS_VENT_STATE_MAX_LENGTH,  ENV,      NONE,   CUSTOMSS_VentCharCallback,     "UUID_VENT_STATE") \
+    X(1, HUM,       0x06, 0x50, CS_PERM_NOTIFY,       CS_HUMIDITY_MAX_LENGTH,    SNAPSHOT, CCC_ON, NULL,                          "UUID_HUMIDITY") \
+    X(1, TEMP,      0x07, 0x50, CS_PERM_NOTIFY,       CS_TEMPERATURE_MAX_LENGTH, SNAPSHOT, CCC_ON, NULL,                          "UUID_TEMPERATURE") \
+    X(1, TEMP_UTHR, 0x08, 0x50, CS_PERM_WRITE,        CS_TEMPERATURE_MAX_LENGTH, ENV,      NONE,   CUSTOMSS_TempUTHRCharCallback, "UUID_TEMP_UPPER_THRESHOLD") \
+    X(1, TEMP_LTHR, 0x09, 0x50, CS_PERM_WRITE,        CS_TEMPERATURE_MAX_LENGTH, ENV,      NONE,   CUSTOMSS_TempLTHRCharCallback, "UUID_TEMP_LOWER_THRESHOLD") \
+    X(1, LINK_INFO, 0x0a, 0x50, CS_PERM_READ,         CS_LINK_INFO_MAX_LENGTH,   ENV,      NONE,   CUSTOMSS_LinkInfoCharCallback, "UUID_LINK_INFO") \
+    X(1, MAX_AGE,   0x0b, 0x50, CS_PERM_WRITE,        CS_MAX_AGE_MAX_LENGTH,     ENV,      NONE,   CUSTOMSS_MaxAgeCharCallback,   "UUID_SAMPLE_MAX_AGE") \
+    X(1, ZONE_ID,   0x0c, 0x50, CS_PERM_WRITE_ENC,    CS_ZONE_ID_MAX_LENGTH,     ENV,      NONE,   CUSTOMSS_ZoneIdCharCallback,   "UUID_ZONE_ID") \
+    X(1, GROUP_KEY, 0x0d, 0x50, CS_PERM_WRITE_ONLY_ENC, CS_GROUP_KEY_MAX_LENGTH, ENV,      NONE,   CUSTOMSS_GroupKeyCharCallback, "UUID_GROUP_KEY") \
+    X(1, BATT_HEALTH, 0x0e, 0x50, CS_PERM_READ,       CS_BATT_HEALTH_MAX_LENGTH, ENV,      NONE,   CUSTOMSS_BattHealthCharCallback, "UUID_BATT_HEALTH") \
+    X(1, ENERGY,    0x0f, 0x50, CS_PERM_READ,         CS_ENERGY_MAX_LENGTH,      ENV,      NONE,   CUSTOMSS_EnergyCharCallback,   "UUID_ENERGY")
+
+// Attribute indexes of one characteristic: declaration, value, then the
+// descriptors it has
+#define CS_ENUM_CCC_NONE(svc, name)
+#define CS_ENUM_CCC_CCC(svc, name)      CS_##name##_VALUE_CCC##svc,
+#define CS_ENUM_CCC_CCC_ON(svc, name)   CS_##name##_VALUE_CCC##svc,
+#ifdef CS_USER_DESCRIPTIONS
+#define CS_ENUM_DESC(svc, name)         CS_##name##_VALUE_USR_DSCP##svc,
+#else  /* ifdef CS_USER_DESCRIPTIONS */
+#define CS_ENUM_DESC(svc, name)
+#endif /* ifdef CS_USER_DESCRIPTIONS */
+
+#define CS_ENUM_ENTRY(svc, name, uuid4, uuid5, perm, length, store, ccc, callback, hub_key) \
+    CS_##name##_VALUE_CHAR##svc, \
+    CS_##name##_VALUE_VAL##svc, \
+    CS_ENUM_CCC_##ccc(svc, name) \
+    CS_ENUM_DESC(svc, name)
+
+// Value buffer and CCC fields of one characteristic (<name>_buffer and
+// <name>_cccd), the name is always pasted so it is never macro expanded
+#define CS_VALUE_FIELD_ENV(name, length)        uint8_t name##_buffer[length];
+#define CS_VALUE_FIELD_SNAPSHOT(name, length)
+#define CS_VALUE_FIELD(svc, name, uuid4, uuid5, perm, length, store, ccc, callback, hub_key) \
+    CS_VALUE_FIELD_##store(name, length)
+
+#define CS_CCC_FIELD_NONE(name)
+#define CS_CCC_FIELD_CCC(name)          uint8_t name##_cccd[2];
+#define CS_CCC_FIELD_CCC_ON(name)       uint8_t name##_cccd[2];
+#define CS_CCC_FIELD(svc, name, uuid4, uuid5, perm, length, store, ccc, callback, hub_key) \
+    CS_CCC_FIELD_##ccc(name)
 
 // Custom service ID
 // Used in calculating attribute number for given custom service
@@ -141,29 +187,7 @@ enum CS0_att
     // Service 0
     CS_SERVICE0,
 
-    // TX Characteristic in Service 0
-    CS_TX_VALUE_CHAR0,
-    CS_TX_VALUE_VAL0,
-    CS_TX_VALUE_CCC0,
-    CS_TX_VALUE_USR_DSCP0,
-
-    // RX Characteristic in Service 0
-    CS_RX_VALUE_CHAR0,
-    CS_RX_VALUE_VAL0,
-    CS_RX_VALUE_CCC0,
-    CS_RX_VALUE_USR_DSCP0,
-
-    // TX Long Characteristic in Service 0
-    CS_TX_LONG_VALUE_CHAR0,
-    CS_TX_LONG_VALUE_VAL0,
-    CS_TX_LONG_VALUE_CCC0,
-    CS_TX_LONG_VALUE_USR_DSCP0,
-
-    // RX Long Characteristic in Service 0
-    CS_RX_LONG_VALUE_CHAR0,
-    CS_RX_LONG_VALUE_VAL0,
-    CS_RX_LONG_VALUE_CCC0,
-    CS_RX_LONG_VALUE_USR_DSCP0,
+    CS_SVC0_MANIFEST(CS_ENUM_ENTRY)
 
     // Max number of services and characteristics
     CS_NB0,
@@ -174,113 +198,52 @@ enum CS1_att
     // Service 1
     CS_SERVICE1,
 
-    // Battery Characteristic in Service 1
-    CS_BATTERY_VALUE_CHAR1,
-    CS_BATTERY_VALUE_VAL1,
-    CS_BATTERY_VALUE_CCC1,
-    CS_BATTERY_VALUE_USR_DSCP1,
-
-    // LED Characteristic in Service 1
-    CS_LED_VALUE_CHAR1,
-    CS_LED_VALUE_VAL1,
-    CS_LED_VALUE_CCC1,
-    CS_LED_VALUE_USR_DSCP1,
-
-    // Button Characteristic in Service 1
-    CS_BUTTON_VALUE_CHAR1,
-    CS_BUTTON_VALUE_VAL1,
-    CS_BUTTON_VALUE_CCC1,
-    CS_BUTTON_VALUE_USR_DSCP1,
-
-    // Vent Characteristic in Service 1
-    CS_VENT_VALUE_CHAR1,
-    CS_VENT_VALUE_VAL1,
-    CS_VENT_VALUE_CCC1,
-    CS_VENT_VALUE_USR_DSCP1,
-
-    // Humidity Characteristic in Service 1
-    CS_HUM_VALUE_CHAR1,
-    CS_HUM_VALUE_VAL1,
-    CS_HUM_VALUE_CCC1,
-    CS_HUM_VALUE_USR_DSCP1,
-
-    // Temperature Characteristic in Service 1
-    CS_TEMP_VALUE_CHAR1,
-    CS_TEMP_VALUE_VAL1,
-    CS_TEMP_VALUE_CCC1,
-    CS_TEMP_VALUE_USR_DSCP1,
-
-    // Temperature Upper Threshold Characteristic in Service 1
-    CS_TEMP_UTHR_VALUE_CHAR1,
-    CS_TEMP_UTHR_VALUE_VAL1,
-    CS_TEMP_UTHR_VALUE_CCC1,
-    CS_TEMP_UTHR_VALUE_USR_DSCP1,
-
-    // Temperature Lower Threshold Characteristic in Service 1
-    CS_TEMP_LTHR_VALUE_CHAR1,
-    CS_TEMP_LTHR_VALUE_VAL1,
-    CS_TEMP_LTHR_VALUE_CCC1,
-    CS_TEMP_LTHR_VALUE_USR_DSCP1,
+    CS_SVC1_MANIFEST(CS_ENUM_ENTRY)
 
     // Max number of services and characteristics
     CS_NB1,
 };
 
-struct app_env_tag_cs
+// Characteristic values, byte arrays only so the layout is packed and
+// CS_VALUE_OFFSET gives the offset of a value in the block
+struct cs_values_tag
 {
-    // To BLE transfer buffer
-    uint8_t to_air_buffer[CS_VALUE_MAX_LENGTH];
-    uint8_t to_air_cccd_value[2];
-
-    // From BLE transfer buffer
-    uint8_t from_air_buffer[CS_VALUE_MAX_LENGTH];
-    uint8_t from_air_cccd_value[2];
-
-    // To BLE long transfer buffer
-    uint8_t to_air_buffer_long[CS_LONG_VALUE_MAX_LENGTH];
-    uint8_t to_air_cccd_value_long[2];
-
-    // From BLE long transfer buffer
-    uint8_t from_air_buffer_long[CS_LONG_VALUE_MAX_LENGTH];
-    uint8_t from_air_cccd_value_long[2];
-
-    // To BLE Battery transfer buffer
-    uint8_t battery_to_air_buffer[CS_BATTERY_MAX_LENGTH];
-    uint8_t battery_to_air_cccd_value[2];
-
-    // From BLE LED transfer buffer
-    uint8_t led_from_air_buffer[CS_LED_BUTTON_MAX_LENGTH];
-    uint8_t led_from_air_cccd_value[2];
-
-    // To BLE Button transfer buffer
-    uint8_t button_to_air_buffer[CS_LED_BUTTON_MAX_LENGTH];
-    uint8_t button_to_air_cccd_value[2];
-
-    // From BLE Vent transfer buffer
-    uint8_t vent_from_air_buffer[CS_LED_BUTTON_MAX_LENGTH];
-    uint8_t vent_from_air_cccd_value[2];
-
-    // To BLE Humidity transfer buffer
-    uint8_t hum_to_air_buffer[CS_HUMIDITY_MAX_LENGTH];
-    uint8_t hum_to_air_cccd_value[2];
+    CS_SVC0_MANIFEST(CS_VALUE_FIELD)
+    CS_SVC1_MANIFEST(CS_VALUE_FIELD)
+};
 
-    // To BLE Temperature transfer buffer
-    uint8_t temp_to_air_buffer[CS_TEMPERATURE_MAX_LENGTH];
-    uint8_t temp_to_air_cccd_value[2];
+#define CS_VALUE_OFFSET(name)           (offsetof(struct cs_values_tag, name##_buffer))
 
-    // From BLE Temperature Upper Threshold transfer buffer
-    uint8_t temp_uthr_from_air_buffer[CS_TEMPERATURE_MAX_LENGTH];
-    uint8_t temp_uthr_from_air_cccd_value[2];
+// Client Characteristic Configuration values, notifying characteristics only
+struct cs_ccc_tag
+{
+    CS_SVC0_MANIFEST(CS_CCC_FIELD)
+    CS_SVC1_MANIFEST(CS_CCC_FIELD)
+};
 
-    // From BLE Temperature Lower Threshold transfer buffer
-    uint8_t temp_lthr_from_air_buffer[CS_TEMPERATURE_MAX_LENGTH];
-    uint8_t temp_lthr_from_air_cccd_value[2];
+struct app_env_tag_cs
+{
+    struct cs_values_tag value;
+    struct cs_ccc_tag ccc;
 };
 
 enum custom_app_msg_id
 {
     CUSTOMSS_NTF_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 60,
-    CUSTOM_BUTTON_NTF
+    CUSTOM_BUTTON_NTF,
+
+    // Deferred write side effects, posted by the attribute callbacks
+    CUSTOMSS_VENT_CMD,
+    CUSTOMSS_LED_CMD,
+    CUSTOMSS_TEMP_UTHR_CMD,
+    CUSTOMSS_TEMP_LTHR_CMD,
+    CUSTOMSS_ZONE_CMD,
+};
+
+// Parameter of the deferred write messages: the validated value written
+struct customss_write_cmd
+{
+    uint8_t value[CS_TEMPERATURE_MAX_LENGTH];
 };
 
 
@@ -316,17 +279,24 @@ void CUSTOMSS_Initialize(void);
 /* Function      : CUSTOMSS_NotifyOnTimeout
  *
  * Description   : Configure custom service to send periodic notifications.
+ *                 A client change is saved in the key-value store; the
+ *                 boot only applies the saved interval.
  *
  * Parameters    : uint32_t timeout : in units of 10ms. If set to 0, periodic
  *                                    notifications are disabled.
+ *                 bool save        : true to save the interval (KV_Set)
  *
  * Returns       : None
  */
-void CUSTOMSS_NotifyOnTimeout(uint32_t timeout);
+void CUSTOMSS_NotifyOnTimeout(uint32_t timeout, bool save);
 
 /* Function      : void CUSTOMSS_MsgHandler
  *
- * Description   : Handle all events related to the custom service
+ * Description   : Handle all events related to the custom service. Reads
+ *                 of the snapshot characteristics (GATTC_READ_REQ_IND) are
+ *                 confirmed at once if the sample is within the maximum
+ *                 age, otherwise a sample is requested and the read is
+ *                 confirmed from SENSOR_SAMPLE_IND.
  *
  * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
  *                 void const *param          : Message parameter
@@ -339,29 +309,22 @@ void CUSTOMSS_MsgHandler(ke_msg_id_t const msg_id, void const *param,
                          ke_task_id_t const dest_id, ke_task_id_t const src_id);
 
 
-/* Function      : GPIO0_Pressed
- *
- * Description   :
- *
- * Parameters    : None
- *
- * Returns       : None
- */
-uint8_t GPIO0_Pressed(void);
-
-/* Function      : GPIO0_Pressed_Flag_Clear
+/* Function      : CUSTOMSS_ButtonTask
  *
- * Description   :
+ * Description   : Scheduler task of the SW1 pushbutton: start or clear the
+ *                 bond list timers, restore the LED on release, notify the
+ *                 button state on every link and kick the advertising.
  *
- * Parameters    : None
+ * Parameters    : uint32_t pressed : 1 on press, 0 on release
  *
  * Returns       : None
  */
-void GPIO0_Pressed_Flag_Clear(void);
+void CUSTOMSS_ButtonTask(uint32_t pressed);
 
 /* Function      : GPIO0_IRQHandler
  *
- * Description   :
+ * Description   : Track the SW1 pushbutton edges and post them to the
+ *                 button task (APP_SCHED_BUTTON).
  *
  * Parameters    : None
  *
@@ -397,37 +360,6 @@ uint8_t CUSTOMSS_RXCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle
                                 uint8_t *to, const uint8_t *from,
                                 uint16_t length, uint16_t operation, uint8_t hl_status);
 
-/* Function      : CUSTOMSS_RXLongCharCallback
- *
- * Description   : User callback data access function for the RX Long
- *                 characteristic. This function is called by the BLE
- *                 abstraction whenever a ReadReqInd or WriteReqInd occurs in
- *                 the specified attribute. The callback is linked to the
- *                 attribute in the database construction. See att_db.
- *                 When a read occurs in the RX long characteristic, this function
- *                 updates the RX Long characteristic value with the complement of
- *                 TX long value.
- *
- * Parameters    : uint8_t conidx  : connection index
- *                 uint16_t attidx : attribute index in the user defined database
- *                 uint16_t handle : attribute handle allocated in the BLE stack
- *                 uint8_t *to     : pointer to destination buffer
- *                 uint8_t *from   : pointer to source buffer
- *                                   "to" and "from" may be a pointer to the
- *                                   'att_db' characteristic buffer or the BLE
- *                                   stack buffer, depending if the "operation" is
- *                                   a write or a read.
- *                 uint16_t length : length of data to be copied
- *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
- *                 uint8_t hl_status  : HL error code
- *
- * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
- *                           hl_status otherwise
- */
-uint8_t CUSTOMSS_RXLongCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
-                                    uint8_t *to, const uint8_t *from,
-                                    uint16_t length, uint16_t operation, uint8_t hl_status);
-
 /* Function      : CUSTOMSS_LEDCharCallback
  *
  * Description   : User callback data access function for the LED
@@ -435,6 +367,8 @@ uint8_t CUSTOMSS_RXLongCharCallback(uint8_t conidx, uint16_t attidx, uint16_t ha
  *                 abstraction whenever a ReadReqInd or WriteReqInd occurs in
  *                 the specified attribute. The callback is linked to the
  *                 attribute in the database construction (see att_db).
+ *                 Writes other than 0x00/0x01 are rejected, the vent move
+ *                 and LED update run later from CUSTOMSS_LED_CMD.
  *
  * Parameters    : uint8_t conidx  : connection index
  *                 uint16_t attidx : attribute index in the user defined database
@@ -449,8 +383,8 @@ uint8_t CUSTOMSS_RXLongCharCallback(uint8_t conidx, uint16_t attidx, uint16_t ha
  *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
  *                 uint8_t hl_status  : HL error code
  *
- * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
- *                           hl_status otherwise
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR
+ *                           and the value is valid, an ATT error otherwise
  */
 uint8_t CUSTOMSS_LEDCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
                                  uint8_t *to, const uint8_t *from,
@@ -463,6 +397,8 @@ uint8_t CUSTOMSS_LEDCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handl
  *                 abstraction whenever a ReadReqInd or WriteReqInd occurs in
  *                 the specified attribute. The callback is linked to the
  *                 attribute in the database construction (see att_db).
+ *                 Writes that are not a valid temperature are rejected,
+ *                 the threshold is updated later from CUSTOMSS_TEMP_UTHR_CMD.
  *
  * Parameters    : uint8_t conidx  : connection index
  *                 uint16_t attidx : attribute index in the user defined database
@@ -473,8 +409,8 @@ uint8_t CUSTOMSS_LEDCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handl
  *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
  *                 uint8_t hl_status  : HL error code
  *
- * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
- *                           hl_status otherwise
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR
+ *                           and the value is valid, an ATT error otherwise
  */
 uint8_t CUSTOMSS_TempUTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
                                  uint8_t *to, const uint8_t *from,
@@ -487,6 +423,8 @@ uint8_t CUSTOMSS_TempUTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t
  *                 abstraction whenever a ReadReqInd or WriteReqInd occurs in
  *                 the specified attribute. The callback is linked to the
  *                 attribute in the database construction (see att_db).
+ *                 Writes that are not a valid temperature are rejected,
+ *                 the threshold is updated later from CUSTOMSS_TEMP_LTHR_CMD.
  *
  * Parameters    : uint8_t conidx  : connection index
  *                 uint16_t attidx : attribute index in the user defined database
@@ -497,8 +435,8 @@ uint8_t CUSTOMSS_TempUTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t
  *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
  *                 uint8_t hl_status  : HL error code
  *
- * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
- *                           hl_status otherwise
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR
+ *                           and the value is valid, an ATT error otherwise
  */
 uint8_t CUSTOMSS_TempLTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
                                  uint8_t *to, const uint8_t *from,
@@ -511,6 +449,8 @@ uint8_t CUSTOMSS_TempLTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t
  *                 abstraction whenever a ReadReqInd or WriteReqInd occurs in
  *                 the specified attribute. The callback is linked to the
  *                 attribute in the database construction (see att_db).
+ *                 Writes other than 0x00/0x01 are rejected, the vent move
+ *                 runs later from CUSTOMSS_VENT_CMD.
  *
  * Parameters    : uint8_t conidx  : connection index
  *                 uint16_t attidx : attribute index in the user defined database
@@ -521,13 +461,199 @@ uint8_t CUSTOMSS_TempLTHRCharCallback(uint8_t conidx, uint16_t attidx, uint16_t
  *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
  *                 uint8_t hl_status  : HL error code
  *
- * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
- *                           hl_status otherwise
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR
+ *                           and the value is valid, an ATT error otherwise
  */
 uint8_t CUSTOMSS_VentCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
                                  uint8_t *to, const uint8_t *from,
                                  uint16_t length, uint16_t operation, uint8_t hl_status);
 
+/* Function      : CUSTOMSS_LinkInfoCharCallback
+ *
+ * Description   : User callback data access function for the Link Info
+ *                 characteristic. On a read the characteristic value is
+ *                 refreshed with the values negotiated on the requesting
+ *                 connection (see Link_PackInfo) before it is returned.
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t attidx : attribute index in the user defined database
+ *                 uint16_t handle : attribute handle allocated in the BLE stack
+ *                 uint8_t *to     : pointer to destination buffer
+ *                 uint8_t *from   : pointer to source buffer
+ *                 uint16_t length : length of data to be copied
+ *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
+ *                 uint8_t hl_status  : HL error code
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
+ *                           hl_status otherwise
+ */
+uint8_t CUSTOMSS_LinkInfoCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                      uint8_t *to, const uint8_t *from,
+                                      uint16_t length, uint16_t operation, uint8_t hl_status);
+
+/* Function      : CUSTOMSS_BattHealthCharCallback
+ *
+ * Description   : User callback data access function for the Battery Health
+ *                 characteristic. On a read the characteristic value is
+ *                 refreshed with the estimated battery state (see
+ *                 Battery_PackHealth) before it is returned.
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t attidx : attribute index in the user defined database
+ *                 uint16_t handle : attribute handle allocated in the BLE stack
+ *                 uint8_t *to     : pointer to destination buffer
+ *                 uint8_t *from   : pointer to source buffer
+ *                 uint16_t length : length of data to be copied
+ *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
+ *                 uint8_t hl_status  : HL error code
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
+ *                           hl_status otherwise
+ */
+uint8_t CUSTOMSS_BattHealthCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                        uint8_t *to, const uint8_t *from,
+                                        uint16_t length, uint16_t operation, uint8_t hl_status);
+
+/* Function      : CUSTOMSS_EnergyCharCallback
+ *
+ * Description   : User callback data access function for the Energy
+ *                 diagnostics characteristic. On a read the characteristic
+ *                 value is refreshed with the charge and active time of
+ *                 each energy account (see Energy_PackInfo) before it is
+ *                 returned.
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t attidx : attribute index in the user defined database
+ *                 uint16_t handle : attribute handle allocated in the BLE stack
+ *                 uint8_t *to     : pointer to destination buffer
+ *                 uint8_t *from   : pointer to source buffer
+ *                 uint16_t length : length of data to be copied
+ *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
+ *                 uint8_t hl_status  : HL error code
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
+ *                           hl_status otherwise
+ */
+uint8_t CUSTOMSS_EnergyCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                    uint8_t *to, const uint8_t *from,
+                                    uint16_t length, uint16_t operation, uint8_t hl_status);
+
+/* Function      : CUSTOMSS_MaxAgeCharCallback
+ *
+ * Description   : User callback data access function for the Sample Max Age
+ *                 characteristic (uint16, seconds, little endian). A write
+ *                 sets how old a sample may be before a read of a sensor
+ *                 characteristic takes a new one (see Sensor_SetMaxAge).
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t attidx : attribute index in the user defined database
+ *                 uint16_t handle : attribute handle allocated in the BLE stack
+ *                 uint8_t *to     : pointer to destination buffer
+ *                 uint8_t *from   : pointer to source buffer
+ *                 uint16_t length : length of data to be copied
+ *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
+ *                 uint8_t hl_status  : HL error code
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR
+ *                           and the value is valid, an ATT error otherwise
+ */
+uint8_t CUSTOMSS_MaxAgeCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                    uint8_t *to, const uint8_t *from,
+                                    uint16_t length, uint16_t operation, uint8_t hl_status);
+
+/* Function      : CUSTOMSS_ZoneIdCharCallback
+ *
+ * Description   : User callback data access function for the Zone ID
+ *                 characteristic (uint8, encrypted link to write). The zone
+ *                 and the telemetry advertisement are updated later from
+ *                 CUSTOMSS_ZONE_CMD (see app_group.h).
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t attidx : attribute index in the user defined database
+ *                 uint16_t handle : attribute handle allocated in the BLE stack
+ *                 uint8_t *to     : pointer to destination buffer
+ *                 uint8_t *from   : pointer to source buffer
+ *                 uint16_t length : length of data to be copied
+ *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
+ *                 uint8_t hl_status  : HL error code
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR
+ *                           and the value is valid, an ATT error otherwise
+ */
+uint8_t CUSTOMSS_ZoneIdCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                    uint8_t *to, const uint8_t *from,
+                                    uint16_t length, uint16_t operation, uint8_t hl_status);
+
+/* Function      : CUSTOMSS_GroupKeyCharCallback
+ *
+ * Description   : User callback data access function for the Group Key
+ *                 characteristic (write only, encrypted link): the 16-byte
+ *                 key and the 4-byte sequence floor (app_group.h). The key
+ *                 authenticates the hub command advertisements; both are
+ *                 handed to Group_SetKey and not kept in the value buffer.
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t attidx : attribute index in the user defined database
+ *                 uint16_t handle : attribute handle allocated in the BLE stack
+ *                 uint8_t *to     : pointer to destination buffer
+ *                 uint8_t *from   : pointer to source buffer
+ *                 uint16_t length : length of data to be copied
+ *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
+ *                 uint8_t hl_status  : HL error code
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR
+ *                           and the value is valid, an ATT error otherwise
+ */
+uint8_t CUSTOMSS_GroupKeyCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                      uint8_t *to, const uint8_t *from,
+                                      uint16_t length, uint16_t operation, uint8_t hl_status);
+
+/* Function      : CUSTOMSS_BenchCtrlCharCallback
+ *
+ * Description   : User callback data access function for the Benchmark
+ *                 Control characteristic. Malformed commands are rejected, a
+ *                 command that notifies BENCH_DATA is rejected unless its
+ *                 notifications are enabled; accepted commands run later
+ *                 from BENCH_CMD (see app_bench.h).
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t attidx : attribute index in the user defined database
+ *                 uint16_t handle : attribute handle allocated in the BLE stack
+ *                 uint8_t *to     : pointer to destination buffer
+ *                 uint8_t *from   : pointer to source buffer
+ *                 uint16_t length : length of data to be copied
+ *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
+ *                 uint8_t hl_status  : HL error code
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR
+ *                           and the command is valid, an ATT error otherwise
+ */
+uint8_t CUSTOMSS_BenchCtrlCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                       uint8_t *to, const uint8_t *from,
+                                       uint16_t length, uint16_t operation, uint8_t hl_status);
+
+/* Function      : CUSTOMSS_BenchResultCharCallback
+ *
+ * Description   : User callback data access function for the Benchmark
+ *                 Result characteristic, packs the current counters on read
+ *                 (see BENCH_RESULT_LENGTH for the layout).
+ *
+ * Parameters    : uint8_t conidx  : connection index
+ *                 uint16_t attidx : attribute index in the user defined database
+ *                 uint16_t handle : attribute handle allocated in the BLE stack
+ *                 uint8_t *to     : pointer to destination buffer
+ *                 uint8_t *from   : pointer to source buffer
+ *                 uint16_t length : length of data to be copied
+ *                 uint16_t operation : GATTC_ReadReqInd or GATTC_WriteReqInd
+ *                 uint8_t hl_status  : HL error code
+ *
+ * Returns       : uint8_t : ATT_ERR_NO_ERROR if hl_status is equal to GAP_ERR_NO_ERROR,
+ *                           hl_status otherwise
+ */
+uint8_t CUSTOMSS_BenchResultCharCallback(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                         uint8_t *to, const uint8_t *from,
+                                         uint16_t length, uint16_t operation, uint8_t hl_status);
+
 /* ----------------------------------------------------------------------------
  * Close the 'extern "C"' block
  * ------------------------------------------------------------------------- */
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * File Name        : app_cycles.h
+ * Description      : This header module contains the inline accessors of the
+ *                    Cortex-M33 DWT cycle counter used to time application
+ *                    code. Intervals are valid up to 2^32 cycles (~179 s at
+ *                    24 MHz), differences are taken modulo 2^32.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_CYCLES_H
+#define APP_CYCLES_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <hw.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Cycles_Initialize
+ *
+ * Description   : Enable the trace block and start the cycle counter from
+ *                 zero, at boot.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static inline void Cycles_Initialize(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* Function      : Cycles_Resume
+ *
+ * Description   : Enable the trace block and the cycle counter again after
+ *                 sleep, without clearing the count. The counter does not
+ *                 run while asleep: time across a sleep is measured with
+ *                 AppTimer_Now.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static inline void Cycles_Resume(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* Function      : Cycles_Now
+ *
+ * Description   : Returns the current cycle count.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : cycle count
+ */
+static inline uint32_t Cycles_Now(void)
+{
+    return DWT->CYCCNT;
+}
+
+/* Function      : Cycles_Since
+ *
+ * Description   : Returns the cycles elapsed since a Cycles_Now value.
+ *
+ * Parameters    : uint32_t start : earlier Cycles_Now value
+ *
+ * Returns       : uint32_t : elapsed cycles
+ */
+static inline uint32_t Cycles_Since(uint32_t start)
+{
+    return DWT->CYCCNT - start;
+}
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_CYCLES_H */
@@ -0,0 +1,240 @@
+/******************************************************************************
+ * File Name        : app_dispatch.h
+ * Description      : This header module contains the message dispatch table
+ *                    of the application task and the function prototypes of
+ *                    the dispatcher.
+ *
+ *                    Every application handler is listed once per message ID
+ *                    in APP_DISPATCH_TABLE. The dispatcher subscribes itself
+ *                    with MsgHandler_Add once per ID and calls the handlers
+ *                    of that ID in table order, timing each call with the
+ *                    cycle counter into the profiler statistics
+ *                    (app_profile.h). Handlers registered by the service
+ *                    libraries (BASS, DISS) are not affected.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_DISPATCH_H
+#define APP_DISPATCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+#include <app_profile.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Application handlers, X(msg_id, handler). Handlers of the same ID run in
+// the order listed; the order matches the former registration order.
+#define APP_DISPATCH_TABLE(X)                                                  \
+    /* Custom service */                                                       \
+    X(GATTM_ADD_SVC_RSP,            CUSTOMSS_MsgHandler)                       \
+    X(CUSTOMSS_NTF_TIMEOUT,         CUSTOMSS_MsgHandler)                       \
+    X(CUSTOM_BUTTON_NTF,            CUSTOMSS_MsgHandler)                       \
+    X(SENSOR_SAMPLE_IND,            CUSTOMSS_MsgHandler)                       \
+    X(GATTC_READ_REQ_IND,           CUSTOMSS_MsgHandler)                       \
+    X(GAPC_DISCONNECT_IND,          CUSTOMSS_MsgHandler)                       \
+    X(CUSTOMSS_VENT_CMD,            CUSTOMSS_MsgHandler)                       \
+    X(CUSTOMSS_LED_CMD,             CUSTOMSS_MsgHandler)                       \
+    X(CUSTOMSS_TEMP_UTHR_CMD,       CUSTOMSS_MsgHandler)                       \
+    X(CUSTOMSS_TEMP_LTHR_CMD,       CUSTOMSS_MsgHandler)                       \
+    X(CUSTOMSS_ZONE_CMD,            CUSTOMSS_MsgHandler)                       \
+    /* BLE database setup */                                                   \
+    X(GAPM_CMP_EVT,                 BLE_ConfigHandler)                         \
+    X(GAPM_PROFILE_ADDED_IND,       BLE_ConfigHandler)                         \
+    X(GATTM_ADD_SVC_RSP,            BLE_ConfigHandler)                         \
+    /* Advertising activity (air operations) */                                \
+    X(GAPM_CMP_EVT,                 Adv_MsgHandler)                            \
+    X(GAPM_ACTIVITY_CREATED_IND,    Adv_MsgHandler)                            \
+    X(GAPM_ACTIVITY_STOPPED_IND,    Adv_MsgHandler)                            \
+    /* Group command scan (answers addressed to GROUP_TASK) */                 \
+    X(GAPM_CMP_EVT,                 Group_MsgHandler)                          \
+    X(GAPM_ACTIVITY_CREATED_IND,    Group_MsgHandler)                          \
+    X(GAPM_ACTIVITY_STOPPED_IND,    Group_MsgHandler)                          \
+    X(GAPM_EXT_ADV_REPORT_IND,      Group_MsgHandler)                          \
+    X(GROUP_SCAN_RETRY_TIMEOUT,     Group_MsgHandler)                          \
+    /* Relay advertising (answers addressed to RELAY_TASK) */                  \
+    X(GAPM_CMP_EVT,                 Relay_MsgHandler)                          \
+    X(GAPM_ACTIVITY_CREATED_IND,    Relay_MsgHandler)                          \
+    X(GAPM_ACTIVITY_STOPPED_IND,    Relay_MsgHandler)                          \
+    X(RELAY_TICK_TIMEOUT,           Relay_MsgHandler)                          \
+    /* BLE connection */                                                       \
+    X(GAPM_CMP_EVT,                 BLE_ConnectionHandler)                     \
+    X(GAPC_CONNECTION_REQ_IND,      BLE_ConnectionHandler)                     \
+    X(GAPC_DISCONNECT_IND,          BLE_ConnectionHandler)                     \
+    X(GAPM_ADDR_SOLVED_IND,         BLE_ConnectionHandler)                     \
+    X(GAPC_GET_DEV_INFO_REQ_IND,    BLE_ConnectionHandler)                     \
+    /* Connection parameter policy */                                          \
+    X(GAPC_CONNECTION_REQ_IND,      ConnPolicy_MsgHandler)                     \
+    X(GAPC_DISCONNECT_IND,          ConnPolicy_MsgHandler)                     \
+    X(GAPC_PARAM_UPDATE_REQ_IND,    ConnPolicy_MsgHandler)                     \
+    X(GAPC_PARAM_UPDATED_IND,       ConnPolicy_MsgHandler)                     \
+    X(CONN_POLICY_TIMEOUT,          ConnPolicy_MsgHandler)                     \
+    /* Link optimization */                                                    \
+    X(GATTC_MTU_CHANGED_IND,        Link_MsgHandler)                           \
+    X(GAPC_LE_PKT_SIZE_IND,         Link_MsgHandler)                           \
+    X(GAPC_LE_PHY_IND,              Link_MsgHandler)                           \
+    X(GAPC_CON_RSSI_IND,            Link_MsgHandler)                           \
+    X(GAPC_DISCONNECT_IND,          Link_MsgHandler)                           \
+    /* Notification queue */                                                   \
+    X(GATTC_CMP_EVT,                NtfQueue_MsgHandler)                       \
+    X(GAPC_DISCONNECT_IND,          NtfQueue_MsgHandler)                       \
+    /* Benchmark (sends outside the notification queue) */                     \
+    X(BENCH_CMD,                    Bench_MsgHandler)                          \
+    X(BENCH_TIMEOUT,                Bench_MsgHandler)                          \
+    X(GATTC_CMP_EVT,                Bench_MsgHandler)                          \
+    X(GAPC_DISCONNECT_IND,          Bench_MsgHandler)                          \
+    /* Sensor sampler */                                                       \
+    X(SENSOR_CONVERSION_TIMEOUT,    Sensor_MsgHandler)                         \
+    X(SENSOR_STALE_TIMEOUT,         Sensor_MsgHandler)                         \
+    /* Bulk stream endpoint and sample log */                                  \
+    X(GAPM_CMP_EVT,                 Stream_MsgHandler)                         \
+    X(L2CC_LECB_CONNECT_REQ_IND,    Stream_MsgHandler)                         \
+    X(L2CC_LECB_CONNECT_IND,        Stream_MsgHandler)                         \
+    X(L2CC_LECB_ADD_IND,            Stream_MsgHandler)                         \
+    X(L2CC_LECB_SDU_RECV_IND,       Stream_MsgHandler)                         \
+    X(L2CC_LECB_DISCONNECT_IND,     Stream_MsgHandler)                         \
+    X(L2CC_CMP_EVT,                 Stream_MsgHandler)                         \
+    X(GAPC_DISCONNECT_IND,          Stream_MsgHandler)                         \
+    X(HISTORY_SAMPLE_TIMEOUT,       History_MsgHandler)                        \
+    X(SENSOR_SAMPLE_IND,            History_MsgHandler)                        \
+    /* BLE pairing / bonding */                                                \
+    X(GAPC_BOND_REQ_IND,            BLE_PairingHandler)                        \
+    X(GAPC_BOND_IND,                BLE_PairingHandler)                        \
+    X(GAPC_ENCRYPT_REQ_IND,         BLE_PairingHandler)                        \
+    X(GAPC_ENCRYPT_IND,             BLE_PairingHandler)                        \
+    /* Clock policy: pairing crypto at the high level */                       \
+    X(GAPC_BOND_REQ_IND,            Clock_MsgHandler)                          \
+    X(GAPC_BOND_IND,                Clock_MsgHandler)                          \
+    X(GAPC_DISCONNECT_IND,          Clock_MsgHandler)                          \
+    /* Advertising policy: hub cache (after bonding) and reconnect */          \
+    X(GAPC_BOND_IND,                Adv_MsgHandler)                            \
+    X(GAPC_ENCRYPT_IND,             Adv_MsgHandler)                            \
+    X(GAPC_DISCONNECT_IND,          Adv_MsgHandler)                            \
+    /* LED blink, battery level read and SW1 timers */                         \
+    X(APP_LED_TIMEOUT,              LEDHandler)                                \
+    X(APP_BATT_LEVEL_READ_TIMEOUT,  BattLevelReadHandler)                      \
+    X(APP_SW1_TIMEOUT,              SW1Handler)                                \
+    X(APP_SW1LED_TIMEOUT,           SW1LEDHandler)                             \
+    /* Power manager residency report, energy and clock levels with it */      \
+    X(POWER_REPORT_TIMEOUT,         Power_MsgHandler)                          \
+    X(POWER_REPORT_TIMEOUT,         Energy_MsgHandler)                         \
+    X(POWER_REPORT_TIMEOUT,         Clock_MsgHandler)                          \
+    /* Application timer service, earliest deadline */                         \
+    X(APP_TIMER_EXPIRY_TIMEOUT,     AppTimer_MsgHandler)                       \
+    /* Scheduler statistics, reported when a connection ends */                \
+    X(GAPC_DISCONNECT_IND,          AppSched_MsgHandler)                       \
+    /* Boot phase times, stack reset to first sample */                        \
+    X(GAPM_CMP_EVT,                 Boot_MsgHandler)                           \
+    X(GATTM_ADD_SVC_RSP,            Boot_MsgHandler)                           \
+    X(SENSOR_SAMPLE_IND,            Boot_MsgHandler)                           \
+    /* Configuration store, pending changes written to flash */                \
+    X(KV_FLUSH_TIMEOUT,             KV_MsgHandler)                             \
+    /* Profiler and dispatch statistics, reported when a connection ends */    \
+    X(GAPC_DISCONNECT_IND,          Profile_MsgHandler)                        \
+    X(GAPC_DISCONNECT_IND,          AppDispatch_MsgHandler)
+
+// Hash buckets for the message ID lookup (power of two, at least twice the
+// number of distinct IDs in the table)
+#define APP_DISPATCH_BUCKETS            (256)
+
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : AppDispatch_Initialize
+ *
+ * Description   : Index the dispatch table and subscribe the dispatcher once
+ *                 to every message ID in the table. The cycle counter runs
+ *                 from Boot_Initialize.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void AppDispatch_Initialize(void);
+
+/* Function      : AppDispatch_Handler
+ *
+ * Description   : Call the handlers of a message in table order and update
+ *                 their statistics.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void AppDispatch_Handler(ke_msg_id_t const msg_id, void const *param,
+                         ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+/* Function      : AppDispatch_FanOut
+ *
+ * Description   : Returns the number of handlers of a message ID.
+ *
+ * Parameters    : ke_msg_id_t msg_id : Kernel message ID number
+ *
+ * Returns       : uint8_t : handler count, 0 if the ID is not in the table
+ */
+uint8_t AppDispatch_FanOut(ke_msg_id_t msg_id);
+
+/* Function      : AppDispatch_GetStats
+ *
+ * Description   : Returns the statistics of a table row.
+ *
+ * Parameters    : uint8_t row : table row, 0 to AppDispatch_Rows() - 1
+ *
+ * Returns       : const struct profile_stats_t * : statistics, NULL if row
+ *                                                  is out of range
+ */
+const struct profile_stats_t * AppDispatch_GetStats(uint8_t row);
+
+/* Function      : AppDispatch_Rows
+ *
+ * Description   : Returns the number of rows of the dispatch table.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint8_t : row count
+ */
+uint8_t AppDispatch_Rows(void);
+
+/* Function      : AppDispatch_MsgHandler
+ *
+ * Description   : Log the statistics of every row called since the last
+ *                 report when a connection ends.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void AppDispatch_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                            ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_DISPATCH_H */
@@ -0,0 +1,206 @@
+/******************************************************************************
+ * File Name        : app_energy.h
+ * Description      : This header module contains the account table, types
+ *                    and function prototypes of the energy accounting.
+ *
+ *                    Each account of ENERGY_ACCOUNT_TABLE charges the time a
+ *                    subsystem is active at its current draw:
+ *                      - the core running, from the cycle counter (DWT)
+ *                        between the idle calls of the power manager;
+ *                      - the core waiting in run mode and the sleep, from
+ *                        the baseband clock residency of the power manager;
+ *                      - the peripherals, between the Energy_Begin and
+ *                        Energy_End hooks of their drivers (servo travel,
+ *                        I2C transfer, LSAD running, log UART output);
+ *                      - the radio, at the average current the advertising
+ *                        phase and the connection policy estimate for their
+ *                        intervals (Energy_SetCurrent).
+ *                    The currents are estimates on top of the sleep floor;
+ *                    adjust the table for a measured board. The charge and
+ *                    the active time of each account are logged with the
+ *                    power report and served on the Energy characteristic
+ *                    (decoded by hub_software/src/energy_decoder.py).
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_ENERGY_H
+#define APP_ENERGY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+/* Accounts, in characteristic order:
+ *   X(name, current_uA)
+ *   name       : ENERGY_<name> index, passed to the hooks
+ *   current_uA : draw while active, 0 if set by Energy_SetCurrent
+ */
+#define ENERGY_ACCOUNT_TABLE(X)                                                \
+    X(RUN,      1350)       /* core running, ENERGY_RUN_MHZ from flash */      \
+    X(IDLE,     900)        /* core halted (WFI), clocks on */                 \
+    X(SLEEP,    2)          /* sleep with retention */                         \
+    X(ADV,      0)          /* advertising, per phase */                       \
+    X(CONN,     0)          /* connections, per interval and latency */        \
+    X(SERVO,    BATT_SERVO_CURRENT_MA * 1000)  /* servo travel */              \
+    X(I2C,      300)        /* HDC2080 transfer, pull-ups */                   \
+    X(LSAD,     15)         /* LSAD converting */                              \
+    X(UART,     400)        /* log output on the trace UART */
+
+// Clock of the RUN current; the core draws in proportion to its clock
+// (CLOCK_LEVEL_TABLE, 8 to 24 MHz), so a cycle costs the same charge at any
+// level and RUN is charged per cycle
+#define ENERGY_RUN_MHZ                  (24)
+
+#define ENERGY_ACCOUNT_ENUM(name, current_uA)   ENERGY_##name,
+
+enum energy_account
+{
+    ENERGY_ACCOUNT_TABLE(ENERGY_ACCOUNT_ENUM)
+    ENERGY_ACCOUNT_COUNT
+};
+
+// Energy characteristic layout (little endian)
+//   [0] ENERGY_ACCOUNT_COUNT, [1..4] uptime (s), then for each account in
+//   table order: charge (mC, uint32), active time (s, uint32)
+#define ENERGY_ACCOUNT_LENGTH           (8)
+#define ENERGY_INFO_LENGTH              (5 + (ENERGY_ACCOUNT_COUNT * ENERGY_ACCOUNT_LENGTH))
+
+struct energy_stats_t
+{
+    uint64_t charge_pC;         // uA x us
+    uint64_t active_us;
+    uint32_t windows;           // active windows opened
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Energy_Initialize
+ *
+ * Description   : Reset the accounts. The report is logged on the power
+ *                 report timer through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Energy_Initialize(void);
+
+/* Function      : Energy_Begin
+ *
+ * Description   : Open an active window of an account at its table current.
+ *                 Windows nest, the account stays active until the last
+ *                 one ends. Application task only.
+ *
+ * Parameters    : uint8_t account : enum energy_account
+ *
+ * Returns       : None
+ */
+void Energy_Begin(uint8_t account);
+
+/* Function      : Energy_End
+ *
+ * Description   : Close an active window opened by Energy_Begin.
+ *
+ * Parameters    : uint8_t account : enum energy_account
+ *
+ * Returns       : None
+ */
+void Energy_End(uint8_t account);
+
+/* Function      : Energy_SetCurrent
+ *
+ * Description   : Set the present draw of an account, 0 when inactive.
+ *                 Application task only.
+ *
+ * Parameters    : uint8_t account     : enum energy_account
+ *                 uint32_t current_uA : average current
+ *
+ * Returns       : None
+ */
+void Energy_SetCurrent(uint8_t account, uint32_t current_uA);
+
+/* Function      : Energy_AddTime
+ *
+ * Description   : Charge a measured active time at the table current.
+ *
+ * Parameters    : uint8_t account : enum energy_account
+ *                 uint64_t us     : active time
+ *
+ * Returns       : None
+ */
+void Energy_AddTime(uint8_t account, uint64_t us);
+
+/* Function      : Energy_AddCycles
+ *
+ * Description   : Charge core cycles to the RUN account. The active time
+ *                 is converted at the current system clock, the charge
+ *                 does not depend on it (see ENERGY_RUN_MHZ).
+ *
+ * Parameters    : uint32_t cycles : cycles run
+ *
+ * Returns       : None
+ */
+void Energy_AddCycles(uint32_t cycles);
+
+/* Function      : Energy_GetStats
+ *
+ * Description   : Returns the totals of an account, the open window
+ *                 counted up to now.
+ *
+ * Parameters    : uint8_t account : enum energy_account
+ *
+ * Returns       : const struct energy_stats_t * : totals, NULL if account
+ *                                                 is out of range
+ */
+const struct energy_stats_t *Energy_GetStats(uint8_t account);
+
+/* Function      : Energy_PackInfo
+ *
+ * Description   : Serialize the totals in the characteristic layout.
+ *
+ * Parameters    : uint8_t *buf : destination, ENERGY_INFO_LENGTH bytes
+ *
+ * Returns       : None
+ */
+void Energy_PackInfo(uint8_t *buf);
+
+/* Function      : Energy_MsgHandler
+ *
+ * Description   : Log the charge of each account with the power report.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Energy_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                       ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_ENERGY_H */
@@ -0,0 +1,241 @@
+/******************************************************************************
+ * File Name        : app_group.h
+ * Description      : This header module contains the constants and function
+ *                    prototypes of the connectionless group commands.
+ *
+ *                    The hub moves every vent of a zone at once by
+ *                    broadcasting a command advertisement instead of
+ *                    connecting to each vent. Vents run a low duty cycle
+ *                    observer scan, check the zone, the sequence number and
+ *                    the SipHash-2-4 MAC of each command frame, apply it and
+ *                    confirm it in the telemetry frame of their own
+ *                    advertising data. The zone and the group key are set
+ *                    over GATT by the bonded hub (ZONE_ID and GROUP_KEY).
+ *
+ *                    Command frame (manufacturer specific data, little
+ *                    endian):
+ *                      [0..1]   company ID (APP_COMPANY_ID)
+ *                      [2]      GROUP_FRAME_COMMAND
+ *                      [3]      zone, GROUP_ZONE_ALL for every zone
+ *                      [4]      command (enum group_cmd)
+ *                      [5]      argument
+ *                      [6..9]   sequence number, must increase
+ *                      [10..17] SipHash-2-4 of bytes [2..9]
+ *
+ *                    Telemetry frame (advertising data of the vent):
+ *                      [0..1]   company ID (APP_COMPANY_ID)
+ *                      [2]      GROUP_FRAME_TELEMETRY
+ *                      [3]      zone
+ *                      [4]      vent state
+ *                      [5..8]   sequence number of the last command applied
+ *
+ *                    A vent only listens GROUP_SCAN_WINDOW out of every
+ *                    GROUP_SCAN_INTV, so the hub repeats a frame for longer
+ *                    than a scan interval; repeats are dropped by their
+ *                    sequence number. The zone, the key and the last
+ *                    sequence number are kept in the configuration store
+ *                    (app_kv.h), so after a reset the vent still takes
+ *                    commands and refuses the frames it applied before.
+ *                    Commands relayed by other vents (app_relay.h) are
+ *                    applied the same way.
+ *
+ *                    GROUP_KEY write (little endian):
+ *                      [0..15]  group key
+ *                      [16..19] sequence floor, commands at or below it
+ *                               are refused
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_GROUP_H
+#define APP_GROUP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+#include <app_siphash.h>
+#include <app_relay.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Observer scan (0.625 ms units): 40 ms every 2.56 s, ~1.6 % duty cycle. A
+// relay listens 640 ms every 2.56 s to hear neighbours on their slow
+// advertising interval.
+#define GROUP_SCAN_INTV                 (4096)
+#if RELAY_ENABLE
+#define GROUP_SCAN_WINDOW               (1024)
+#else  /* if RELAY_ENABLE */
+#define GROUP_SCAN_WINDOW               (64)
+#endif /* if RELAY_ENABLE */
+
+// Delay before a failed scan activity is created again (s)
+#define GROUP_SCAN_RETRY_S              (10)
+
+// Application task instance the scan activity is requested from. GAPM
+// answers the requester, which keeps the scan completions apart from the
+// advertising ones (app_adv.c) that use the same operation codes.
+#define GROUP_TASK                      KE_BUILD_ID(TASK_APP, 1)
+
+// Frame types (byte 2 of the manufacturer data, see app_relay.h for
+// GROUP_FRAME_RELAY)
+#define GROUP_FRAME_COMMAND             (0x47)
+#define GROUP_FRAME_TELEMETRY           (0x54)
+#define GROUP_FRAME_RELAY               (0x52)
+
+// Frames start after the company ID; lengths include it
+#define GROUP_FRAME_OFFSET              (2)
+#define GROUP_COMMAND_LENGTH            (10 + SIPHASH_MAC_LENGTH)
+#define GROUP_TELEMETRY_LENGTH          (9)
+
+// Bytes of a command frame covered by the MAC, from its type byte
+#define GROUP_MAC_OFFSET                (8)
+
+// Zone IDs: GROUP_ZONE_NONE takes GROUP_ZONE_ALL frames only
+#define GROUP_ZONE_NONE                 (0x00)
+#define GROUP_ZONE_ALL                  (0xFF)
+
+#define GROUP_ZONE_LENGTH               (1)
+#define GROUP_KEY_LENGTH                (SIPHASH_KEY_LENGTH)
+#define GROUP_KEY_WRITE_LENGTH          (GROUP_KEY_LENGTH + 4)
+
+// Group commands
+enum group_cmd
+{
+    GROUP_CMD_VENT = 0x01,      // argument: vent state
+};
+
+// Group command messages
+enum group_msg_id
+{
+    // Create the scan activity again after a failure
+    GROUP_SCAN_RETRY_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 110,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Group_Initialize
+ *
+ * Description   : Restore the zone, the key and the last sequence number
+ *                 from the configuration store, called after KV_Initialize.
+ *                 The handler is subscribed through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Group_Initialize(void);
+
+/* Function      : Group_Start
+ *
+ * Description   : Create the scan activity and start listening for command
+ *                 frames, called once the advertising activity is started.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Group_Start(void);
+
+/* Function      : Group_CheckMac
+ *
+ * Description   : Check the MAC of a command frame against the group key.
+ *
+ * Parameters    : const uint8_t *frame : command frame from its type byte
+ *
+ * Returns       : bool : true if a key is set and the MAC matches
+ */
+bool Group_CheckMac(const uint8_t *frame);
+
+/* Function      : Group_SetZone
+ *
+ * Description   : Set the zone of the vent (ZONE_ID write) and save it.
+ *
+ * Parameters    : uint8_t zone : zone ID
+ *
+ * Returns       : None
+ */
+void Group_SetZone(uint8_t zone);
+
+/* Function      : Group_GetZone
+ *
+ * Description   : Returns the zone of the vent.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint8_t : zone ID
+ */
+uint8_t Group_GetZone(void);
+
+/* Function      : Group_SetKey
+ *
+ * Description   : Set and save the group key (GROUP_KEY write). Command
+ *                 frames are ignored until a key is set, and refused at or
+ *                 below the sequence floor. Setting the same key again
+ *                 never lowers the last sequence number taken.
+ *
+ * Parameters    : const uint8_t *key  : GROUP_KEY_LENGTH bytes
+ *                 uint32_t seq_floor : highest sequence number to refuse
+ *
+ * Returns       : None
+ */
+void Group_SetKey(const uint8_t *key, uint32_t seq_floor);
+
+/* Function      : Group_PackTelemetry
+ *
+ * Description   : Write the telemetry frame.
+ *
+ * Parameters    : uint8_t *data : GROUP_TELEMETRY_LENGTH bytes
+ *
+ * Returns       : None
+ */
+void Group_PackTelemetry(uint8_t *data);
+
+/* Function      : Group_RefreshTelemetry
+ *
+ * Description   : Rebuild the advertising data after the vent state or the
+ *                 zone changed and hand it to the advertising activity.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Group_RefreshTelemetry(void);
+
+/* Function      : Group_MsgHandler
+ *
+ * Description   : Run the scan activity and apply the command frames found
+ *                 in the advertising reports.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Group_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_GROUP_H */
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * File Name        : app_history.h
+ * Description      : This header module contains the constants, sample
+ *                    format and function prototypes of the on-device sample
+ *                    log. The log keeps the last day of readings in RAM and
+ *                    is downloaded through the stream endpoint.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_HISTORY_H
+#define APP_HISTORY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Sampling period and depth, one day at one sample per minute
+#define HISTORY_INTERVAL_S              (60)
+#define HISTORY_DEPTH                   (1440)
+
+// Sample record, the byte offset of a record in the stream is its absolute
+// index since boot times HISTORY_SAMPLE_SIZE, so the age of a record is
+// (end - offset) / HISTORY_SAMPLE_SIZE * HISTORY_INTERVAL_S.
+struct history_sample_t
+{
+    int16_t temperature;    // 0.01 degC
+    uint16_t humidity;      // 0.01 %RH
+    uint8_t battery;        // %
+    uint8_t vent_state;     // VENT_OPEN_STATE / VENT_CLOSED_STATE
+};
+
+#define HISTORY_SAMPLE_SIZE             (sizeof(struct history_sample_t))
+
+enum history_msg_id
+{
+    HISTORY_SAMPLE_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 80,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : History_Initialize
+ *
+ * Description   : Clear the sample log, register it as a stream source and
+ *                 start the sampling timer.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void History_Initialize(void);
+
+/* Function      : History_Append
+ *
+ * Description   : Add a sample to the log, overwriting the oldest one when
+ *                 the log is full.
+ *
+ * Parameters    : const struct history_sample_t *sample : sample to add
+ *
+ * Returns       : None
+ */
+void History_Append(const struct history_sample_t *sample);
+
+/* Function      : History_MsgHandler
+ *
+ * Description   : Record a reading every HISTORY_INTERVAL_S, taking a new
+ *                 sample first if the last one is older than the maximum
+ *                 sample age.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void History_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                        ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_HISTORY_H */
@@ -39,6 +39,25 @@ extern "C"
  */
 void DeviceInit(void);
 
+/**
+ * @brief Configure the application GPIOs.
+ *
+ * This function configures the LED outputs and the button interrupt. It is
+ * also called on wakeup from sleep.
+ */
+void DeviceGPIOInit(void);
+
+/**
+ * @brief Start the clocks and load the trim values.
+ *
+ * This function loads the trims, starts the 48 MHz XTAL, configures the
+ * system clock, the dividers and the flash access. It is also called on
+ * wakeup from sleep.
+ *
+ * @return Trim error flags, see SYS_TRIM_LOAD_DEFAULT
+ */
+uint32_t DeviceClockInit(void);
+
 /**
  * @brief Initialize swmTrace.
  *
@@ -54,6 +73,14 @@ void SWMTraceInit(void);
  */
 void BLESystemInit(void);
 
+/**
+ * @brief Configure the radio front end and the baseband clock.
+ *
+ * This function sets the RF trim and TX power and enables the baseband
+ * controller clock. It is also called on wakeup from sleep.
+ */
+void BLERadioInit(void);
+
 /**
  * @brief Enable application BLE interrupts.
  *
@@ -0,0 +1,172 @@
+/******************************************************************************
+ * File Name        : app_kv.h
+ * Description      : This header module contains the key table, layout and
+ *                    function prototypes of the flash key-value store.
+ *
+ *                    The configuration of KV_KEY_TABLE is kept in the
+ *                    FLASH_KV region of sections.ld (top of the data
+ *                    flash), a ring of KV_SECTORS erase sectors of which
+ *                    one is active. A change is appended to the active
+ *                    sector as a new record, the old one is left in place;
+ *                    a RAM index built at boot points at the latest record
+ *                    of each key, so a lookup reads it directly.
+ *
+ *                    When the active sector is full, the latest record of
+ *                    each key is copied into the next sector of the ring,
+ *                    which becomes active once its header is written. The
+ *                    sectors are erased in turn, one per compaction, so
+ *                    they wear evenly; a reset during a compaction leaves
+ *                    the old sector active. Changes are written
+ *                    KV_FLUSH_DELAY_MS after the first one, a burst of
+ *                    writes from the hub costs one record per key.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_KV_H
+#define APP_KV_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// FLASH_KV region of sections.ld, KV_SECTORS erase sectors
+#define KV_FLASH_BASE                   (0x0017E000)
+#define KV_SECTOR_SIZE                  (2048)
+#define KV_SECTORS                      (4)
+
+// Delay from the first change to the write of all the pending ones
+#define KV_FLUSH_DELAY_MS               (2000)
+
+// Longest delay between the retries of a failed flush, doubled from
+// KV_FLUSH_DELAY_MS
+#define KV_FLUSH_RETRY_MAX_MS           (300000)
+
+// Largest value of KV_KEY_TABLE
+#define KV_VALUE_MAX                    (16)
+
+/* Keys:
+ *   X(name, id, length)
+ *   name   : KV_<name> index, passed to KV_Get and KV_Set
+ *   id     : stored in flash, never reused for another value (0xFF free)
+ *   length : value bytes, at most KV_VALUE_MAX
+ */
+#define KV_KEY_TABLE(X)                                                        \
+    X(UPPER_THRESHOLD,  0x01,   4)      /* temperature_upper_threshold */      \
+    X(LOWER_THRESHOLD,  0x02,   4)      /* temperature_lower_threshold */      \
+    X(VENT_STATE,       0x03,   1)      /* *vent_state */                      \
+    X(NTF_INTERVAL,     0x04,   4)      /* CUSTOMSS_NotifyOnTimeout, save */   \
+    X(GROUP_ZONE,       0x05,   1)      /* Group_SetZone */                    \
+    X(GROUP_KEY,        0x06,   16)     /* Group_SetKey */                     \
+    X(GROUP_SEQ,        0x07,   4)      /* last group command applied */
+
+#define KV_KEY_ENUM(name, id, length)   KV_##name,
+
+enum kv_key
+{
+    KV_KEY_TABLE(KV_KEY_ENUM)
+    KV_KEY_COUNT
+};
+
+/* Flash layout (little endian words, written in word pairs):
+ *   sector header : KV_MAGIC, sequence (the highest valid one is active),
+ *                   written last by a compaction
+ *   record        : id | length << 8 | check << 16, with check the one's
+ *                   complement of the low half; CRC-32 of id, length and
+ *                   value; value padded with 0xFF to a word pair
+ */
+#define KV_MAGIC                        (0x3156564BUL)
+#define KV_HEADER_LENGTH                (8)
+#define KV_RECORD_LENGTH(length)        (8 + (((length) + 7) & ~7))
+
+// Key-value store messages
+enum kv_msg_id
+{
+    // Write the pending changes
+    KV_FLUSH_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 150,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : KV_Initialize
+ *
+ * Description   : Find the active sector and index the latest valid record
+ *                 of each key. Records that fail their check are skipped,
+ *                 a damaged sector is compacted on the next write. Called
+ *                 from main() before the configuration is used; the flush
+ *                 is subscribed through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void KV_Initialize(void);
+
+/* Function      : KV_Get
+ *
+ * Description   : Copy the current value of a key, pending changes
+ *                 included.
+ *
+ * Parameters    : uint8_t key  : enum kv_key
+ *                 void *value  : destination, the key length
+ *
+ * Returns       : bool : false if the key has no value (value untouched)
+ */
+bool KV_Get(uint8_t key, void *value);
+
+/* Function      : KV_Set
+ *
+ * Description   : Change the value of a key. Written to flash with the
+ *                 other changes KV_FLUSH_DELAY_MS after the first one; a
+ *                 value equal to the current one writes nothing.
+ *                 Application task only.
+ *
+ * Parameters    : uint8_t key        : enum kv_key
+ *                 const void *value  : value, the key length
+ *
+ * Returns       : None
+ */
+void KV_Set(uint8_t key, const void *value);
+
+/* Function      : KV_MsgHandler
+ *
+ * Description   : Write the pending changes, compacting the active sector
+ *                 if they do not fit. Changes left by a failed flash
+ *                 operation are retried with a doubling delay, up to
+ *                 KV_FLUSH_RETRY_MAX_MS.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void KV_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                   ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_KV_H */
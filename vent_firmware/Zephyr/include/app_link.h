@@ -0,0 +1,137 @@
+/******************************************************************************
+ * File Name        : app_link.h
+ * Description      : This header module contains the constants and function
+ *                    prototypes for the link optimization step run after a
+ *                    connection is established (MTU, data length and PHY).
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_LINK_H
+#define APP_LINK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Values every connection starts with
+#define LINK_DEFAULT_MTU                (23)
+#define LINK_DEFAULT_OCTETS             (27)
+
+// Largest ATT MTU / L2CAP MPS, a 247 byte PDU fills one 251 byte LL packet
+#define LINK_MAX_MTU                    (247)
+#define LINK_MAX_MPS                    (LINK_MAX_MTU)
+
+// Data length extension, largest LL payload and its air time on 1M (us)
+#define LINK_MAX_TX_OCTETS              (251)
+#define LINK_MAX_TX_TIME                (2120)
+
+// PHY selection from the connection RSSI (dBm)
+#define LINK_RSSI_2M_MIN                (-65)    // at or above: 2M PHY
+#define LINK_RSSI_CODED_MAX             (-85)    // at or below: coded PHY
+#define LINK_RSSI_UNKNOWN               (127)    // HCI: RSSI not available
+
+// Based on enum gapc_phy_option
+#define LINK_CODED_PHY_RATE             GAPC_PHY_OPT_LE_CODED_125K_RATE
+
+// Link info characteristic layout (little endian)
+//   [0..1] ATT MTU, [2..3] max TX octets, [4..5] max RX octets,
+//   [6] TX PHY, [7] RX PHY, [8] last RSSI (dBm, signed)
+#define LINK_INFO_LENGTH                (9)
+
+struct link_info_t
+{
+    uint16_t mtu;
+    uint16_t tx_octets;
+    uint16_t rx_octets;
+    uint8_t tx_phy;
+    uint8_t rx_phy;
+    int8_t rssi;
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Link_Initialize
+ *
+ * Description   : Reset the per-connection link information. The handler
+ *                 is subscribed through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Link_Initialize(void);
+
+/* Function      : Link_Optimize
+ *
+ * Description   : Start the link optimization of a new connection: MTU
+ *                 exchange, data length update and an RSSI read which
+ *                 selects the PHY once it completes.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : None
+ */
+void Link_Optimize(uint8_t conidx);
+
+/* Function      : Link_GetInfo
+ *
+ * Description   : Returns the negotiated values of a connection.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : const struct link_info_t * : link information, NULL if
+ *                                              conidx is out of range
+ */
+const struct link_info_t * Link_GetInfo(uint8_t conidx);
+
+/* Function      : Link_PackInfo
+ *
+ * Description   : Serialize the link information of a connection in the
+ *                 characteristic layout.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *                 uint8_t *buf   : destination, LINK_INFO_LENGTH bytes
+ *
+ * Returns       : None
+ */
+void Link_PackInfo(uint8_t conidx, uint8_t *buf);
+
+/* Function      : Link_MsgHandler
+ *
+ * Description   : Handle the MTU, data length, PHY and RSSI events.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Link_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                     ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_LINK_H */
@@ -0,0 +1,237 @@
+/******************************************************************************
+ * File Name        : app_log.h
+ * Description      : This header module contains the levels, macros and
+ *                    function prototypes of the tokenized binary log.
+ *
+ *                    A log call does not format anything. The format string
+ *                    is placed in the .applog_fmt section, which the linker
+ *                    keeps in the ELF but never loads to flash, and its
+ *                    address is used as the token. The call only copies the
+ *                    token and the raw 32-bit arguments into a RAM ring,
+ *                    which AppLog_Drain empties from the main loop when the
+ *                    BLE kernel is idle. The host renders the records with
+ *                    hub_software/src/log_decoder.py and the firmware ELF.
+ *
+ *                    Record layout (32-bit words, little endian):
+ *                      word 0   : token << 8 | level << 5 | buffer << 4 | n
+ *                      word 1.. : n argument words
+ *                    A buffer record carries the byte count in its first
+ *                    argument word followed by the bytes themselves.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Log levels, a record header is never zero since level is at least 1
+#define APP_LOG_LEVEL_NONE              (0)
+#define APP_LOG_LEVEL_ERROR             (1)
+#define APP_LOG_LEVEL_WARN              (2)
+#define APP_LOG_LEVEL_INFO              (3)
+#define APP_LOG_LEVEL_DEBUG             (4)
+
+// Highest level compiled in, calls above it generate no code
+#ifndef APP_LOG_LEVEL
+#define APP_LOG_LEVEL                   APP_LOG_LEVEL_INFO
+#endif
+
+// Ring size in 32-bit words (power of two)
+#define APP_LOG_RING_WORDS              (256)
+
+// Drained records kept for the STREAM_SRC_LOG stream source (bytes)
+#define APP_LOG_STORE_SIZE              (2048)
+
+// Records drained per AppLog_Drain call, bounds the time spent per idle pass
+#define APP_LOG_DRAIN_MAX               (8)
+
+// Argument words per record (header field is 4 bits)
+#define APP_LOG_ARGS_MAX                (15)
+
+// Bytes carried by a buffer record (one argument word holds the count)
+#define APP_LOG_BUFFER_MAX              ((APP_LOG_ARGS_MAX - 1) * 4)
+
+// Record header fields
+#define APP_LOG_HDR_TOKEN_SHIFT         (8)
+#define APP_LOG_HDR_LEVEL_SHIFT         (5)
+#define APP_LOG_HDR_LEVEL_MASK          (0x7)
+#define APP_LOG_HDR_BUFFER              (1U << 4)
+#define APP_LOG_HDR_NARGS_MASK          (0xF)
+
+// Format strings are kept out of the loaded image (see sections.ld)
+#define APP_LOG_SECTION                 __attribute__((section(".applog_fmt")))
+
+// Pass a float argument as its IEEE-754 bits (decoded with %f)
+#define APP_LOG_FLOAT(x)                AppLog_Float(x)
+
+// Pass a string argument (%s), it must be a constant string in flash since
+// the decoder reads it from the ELF
+#define APP_LOG_STR(s)                  ((uint32_t)(uintptr_t)(s))
+
+// Log a record at a level, arguments are converted to uint32_t
+#define APP_LOG(level, fmt, ...)                                               \
+    do                                                                         \
+    {                                                                          \
+        static const char app_log_fmt[] APP_LOG_SECTION = fmt;                 \
+        const uint32_t app_log_args[] = { 0, ##__VA_ARGS__ };                  \
+        AppLog_Write((level), app_log_fmt, &app_log_args[1],                   \
+                     (uint8_t)((sizeof(app_log_args) / sizeof(uint32_t)) - 1)); \
+    } while (0)
+
+// Log up to APP_LOG_BUFFER_MAX raw bytes, the decoder renders fmt with the
+// byte count as its only argument and prints the bytes in hex after it
+#define APP_LOG_BUFFER(level, fmt, data, length)                               \
+    do                                                                         \
+    {                                                                          \
+        static const char app_log_fmt[] APP_LOG_SECTION = fmt;                 \
+        AppLog_WriteBuffer((level), app_log_fmt, (data), (length));            \
+    } while (0)
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_ERROR)
+#define APP_LOG_ERROR(fmt, ...)         APP_LOG(APP_LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define APP_LOG_ERROR(fmt, ...)         do { } while (0)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_WARN)
+#define APP_LOG_WARN(fmt, ...)          APP_LOG(APP_LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define APP_LOG_WARN(fmt, ...)          do { } while (0)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+#define APP_LOG_INFO(fmt, ...)          APP_LOG(APP_LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define APP_LOG_INFO_BUFFER(fmt, d, l)  APP_LOG_BUFFER(APP_LOG_LEVEL_INFO, fmt, d, l)
+#else
+#define APP_LOG_INFO(fmt, ...)          do { } while (0)
+#define APP_LOG_INFO_BUFFER(fmt, d, l)  do { } while (0)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_DEBUG)
+#define APP_LOG_DEBUG(fmt, ...)         APP_LOG(APP_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define APP_LOG_DEBUG(fmt, ...)         do { } while (0)
+#endif
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : AppLog_Initialize
+ *
+ * Description   : Clear the ring and the store and register the
+ *                 STREAM_SRC_LOG stream source.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void AppLog_Initialize(void);
+
+/* Function      : AppLog_Write
+ *
+ * Description   : Append a record to the ring. Safe from any context,
+ *                 including interrupts; a record that does not fit is
+ *                 dropped and counted. Use the APP_LOG_* macros.
+ *
+ * Parameters    : uint8_t level        : APP_LOG_LEVEL_ERROR ... DEBUG
+ *                 const char *fmt      : format string in .applog_fmt
+ *                 const uint32_t *args : argument words
+ *                 uint8_t nargs        : number of arguments
+ *
+ * Returns       : None
+ */
+void AppLog_Write(uint8_t level, const char *fmt, const uint32_t *args, uint8_t nargs);
+
+/* Function      : AppLog_WriteBuffer
+ *
+ * Description   : Append a record carrying raw bytes, truncated to
+ *                 APP_LOG_BUFFER_MAX. Use APP_LOG_BUFFER.
+ *
+ * Parameters    : uint8_t level       : APP_LOG_LEVEL_ERROR ... DEBUG
+ *                 const char *fmt     : format string in .applog_fmt
+ *                 const uint8_t *data : bytes to log
+ *                 uint16_t length     : number of bytes
+ *
+ * Returns       : None
+ */
+void AppLog_WriteBuffer(uint8_t level, const char *fmt, const uint8_t *data, uint16_t length);
+
+/* Function      : AppLog_Drain
+ *
+ * Description   : Move committed records from the ring to the store (and to
+ *                 the UART when APP_LOG_UART is defined). Called from the
+ *                 main loop once the BLE kernel has no more work.
+ *
+ * Parameters    : None
+ *
+ * Returns       : bool : true if records are left in the ring
+ */
+bool AppLog_Drain(void);
+
+/* Function      : AppLog_IsBusy
+ *
+ * Description   : Returns true while records are waiting in the ring.
+ *
+ * Parameters    : None
+ *
+ * Returns       : bool : true if AppLog_Drain has work left
+ */
+bool AppLog_IsBusy(void);
+
+/* Function      : AppLog_GetDropped
+ *
+ * Description   : Returns the number of records dropped because the ring was
+ *                 full.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint32_t : dropped record count
+ */
+uint32_t AppLog_GetDropped(void);
+
+/* Function      : AppLog_Float
+ *
+ * Description   : Returns the bits of a float as an argument word.
+ *
+ * Parameters    : float value : value to log
+ *
+ * Returns       : uint32_t : IEEE-754 bits
+ */
+static inline uint32_t AppLog_Float(float value)
+{
+    union
+    {
+        float f;
+        uint32_t u;
+    } bits = { .f = value };
+
+    return bits.u;
+}
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_LOG_H */
@@ -25,6 +25,15 @@ extern "C"
 
 #include <ke_msg.h>
 
+/* Device configuration, holds the own address (see app_relay.c) */
+extern struct gapm_set_dev_config_cmd devConfigCmd;
+
+/* Advertising and scan response data, see PrepareAdvScanData */
+extern uint8_t app_adv_data[];
+extern uint8_t app_scan_rsp_data[];
+extern uint8_t app_adv_data_len;
+extern uint8_t app_scan_rsp_data_len;
+
 /**
  * @brief Callback handler for BLE configuration events
  *
@@ -40,21 +49,6 @@ void BLE_ConfigHandler(ke_msg_id_t const msg_id, void const *param,
                        ke_task_id_t const dest_id,
                        ke_task_id_t const src_id);
 
-/**
- * @brief Callback handler for BLE activity events
- *
- * Callback Function handler for BLE activities request and related events.
- * When received from BLE stack.
- *
- * @param [in] msg_id   Kernel message identifier
- * @param [in] param    Pointer to constant parameter
- * @param [in] dest_id  Destination identifier
- * @param [in] src_id   Source identifier
- */
-void BLE_ActivityHandler(ke_msg_id_t const msg_id, void const *param,
-                         ke_task_id_t const dest_id,
-                         ke_task_id_t const src_id);
-
 /**
  * @brief Callback handler for BLE connection events
  *
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * File Name        : app_ntf_queue.h
+ * Description      : This header module contains the constants and function
+ *                    prototypes of the per-connection notification queue.
+ *
+ *                    Notifications and indications are copied into a small
+ *                    bounded queue and handed to the stack at most
+ *                    NTF_QUEUE_MAX_IN_FLIGHT at a time, the next one going
+ *                    out when GATTC_CMP_EVT reports a completion. A value
+ *                    queued for an attribute that already has a pending
+ *                    value replaces it, so a congested link sends the
+ *                    freshest data instead of a backlog.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_NTF_QUEUE_H
+#define APP_NTF_QUEUE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Pending values per connection, the oldest is dropped when full
+#define NTF_QUEUE_SLOTS                 (8)
+
+// Notifications handed to the stack and not yet completed
+#define NTF_QUEUE_MAX_IN_FLIGHT         (2)
+
+// Largest queued value (RX characteristic)
+#define NTF_QUEUE_VALUE_MAX             (20)
+
+// Sequence numbers used by the queue, kept apart from other senders
+#define NTF_QUEUE_SEQ_FLAG              (0x8000)
+
+// Queue counters of a connection, latencies in kernel time units (ke_time)
+struct ntf_queue_stats_t
+{
+    uint8_t depth;              // pending values now
+    uint8_t depth_max;          // highest pending count seen
+    uint32_t queued;            // values accepted
+    uint32_t replaced;          // pending values overwritten by a newer one
+    uint32_t dropped;           // pending values dropped because the queue was full
+    uint32_t completed;         // completions reported by the stack
+    uint32_t failed;            // completions with an error status
+    uint32_t latency_max;       // longest queue to completion time
+    uint32_t latency_sum;       // sum of queue to completion times
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : NtfQueue_Initialize
+ *
+ * Description   : Clear all queues and counters. The handler is
+ *                 subscribed through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void NtfQueue_Initialize(void);
+
+/* Function      : NtfQueue_Push
+ *
+ * Description   : Queue a notification or indication. The value is copied.
+ *                 A pending value for the same handle is replaced in
+ *                 place; if the queue is full the oldest pending value is
+ *                 dropped.
+ *
+ * Parameters    : uint8_t conidx       : connection index
+ *                 uint8_t operation    : GATTC_NOTIFY or GATTC_INDICATE
+ *                 uint16_t handle      : attribute handle
+ *                 uint16_t length      : value length
+ *                 const uint8_t *value : value
+ *
+ * Returns       : bool : false if the value could not be queued (bad
+ *                        connection or length)
+ */
+bool NtfQueue_Push(uint8_t conidx, uint8_t operation, uint16_t handle,
+                   uint16_t length, const uint8_t *value);
+
+/* Function      : NtfQueue_GetStats
+ *
+ * Description   : Returns the queue counters of a connection.
+ *
+ * Parameters    : uint8_t conidx : connection index
+ *
+ * Returns       : const struct ntf_queue_stats_t * : counters, NULL if
+ *                                                    conidx is out of range
+ */
+const struct ntf_queue_stats_t * NtfQueue_GetStats(uint8_t conidx);
+
+/* Function      : NtfQueue_MsgHandler
+ *
+ * Description   : Track completions (GATTC_CMP_EVT) and reset the queue of
+ *                 a connection when it drops.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void NtfQueue_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                         ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_NTF_QUEUE_H */
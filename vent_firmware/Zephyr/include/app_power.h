@@ -0,0 +1,194 @@
+/******************************************************************************
+ * File Name        : app_power.h
+ * Description      : This header module contains the constants and function
+ *                    prototypes of the power manager.
+ *
+ *                    Once the BLE kernel and the scheduler have no more
+ *                    work, the main loop hands over to Power_Idle. It asks every subsystem of
+ *                    POWER_BUSY_TABLE whether it is busy; if none is, it
+ *                    offers sleep with retention to the stack, which takes
+ *                    it only when the next radio event and the next kernel
+ *                    timer (both run on the baseband timer) are far enough
+ *                    away to cover the wakeup, and programs the baseband
+ *                    timer to wake the chip for them. Otherwise, or while a
+ *                    subsystem is busy, the core waits for an interrupt in
+ *                    run mode.
+ *
+ *                    RAM is retained in sleep but the digital core is not:
+ *                    the chip restarts from Power_WakeupFromSleep, which
+ *                    restores the clocks, the GPIOs, the LSAD, the I2C,
+ *                    the PWM and the cycle counter before it reenters the
+ *                    main loop.
+ *
+ *                    The time spent running, idling and sleeping is counted
+ *                    on the baseband clock (312.5 us half slots) and
+ *                    logged every POWER_REPORT_S.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_POWER_H
+#define APP_POWER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Set to 0 to keep the core in run mode between events (debugging)
+#ifndef POWER_SLEEP_ENABLE
+#define POWER_SLEEP_ENABLE              (1)
+#endif /* ifndef POWER_SLEEP_ENABLE */
+
+// Memories kept powered in sleep: data RAM (application, kernel heap) and
+// baseband RAM (exchange memory)
+#define POWER_SLEEP_MEM_RETENTION       (DRAM0_POWER_ENABLE | DRAM1_POWER_ENABLE | \
+                                         DRAM2_POWER_ENABLE | BB_DRAM0_POWER_ENABLE | \
+                                         BB_DRAM1_POWER_ENABLE)
+
+// Residency report period (s)
+#define POWER_REPORT_S                  (60)
+
+/* Subsystems asked before sleeping, in order:
+ *   X(name, query)
+ *   name  : POWER_BUSY_<name> index, used in the veto counters
+ *   query : bool (*)(void), true while the subsystem needs its clocks
+ */
+#define POWER_BUSY_TABLE(X)                                                    \
+    X(I2C,      i2c_is_busy)            /* HDC2080 transfer */                 \
+    X(SERVO,    servo_is_busy)          /* PWM pulse train */                  \
+    X(LOG,      AppLog_IsBusy)          /* records left in the ring */         \
+    X(LSAD,     APP_BASS_IsReading)     /* battery measurement burst */        \
+    X(TRACE,    Power_TraceBusy)        /* swmTrace UART transmit */
+
+#define POWER_BUSY_ENUM(name, query)    POWER_BUSY_##name,
+
+enum power_busy
+{
+    POWER_BUSY_TABLE(POWER_BUSY_ENUM)
+    POWER_BUSY_COUNT
+};
+
+// Power states counted by the residency
+enum power_state
+{
+    POWER_STATE_RUN,            // kernel and application work
+    POWER_STATE_IDLE,           // WFI in run mode, clocks on
+    POWER_STATE_SLEEP,          // sleep with retention
+    POWER_STATE_COUNT
+};
+
+// Power manager messages
+enum power_msg_id
+{
+    // Residency report
+    POWER_REPORT_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 130,
+};
+
+struct power_stats_t
+{
+    uint64_t residency[POWER_STATE_COUNT];  // half slots
+    uint32_t sleeps;                        // sleeps entered
+    uint32_t refused;                       // sleeps refused by the stack
+    uint32_t vetoes[POWER_BUSY_COUNT];      // sleeps prevented per subsystem
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Power_Initialize
+ *
+ * Description   : Configure the sleep mode (retention, wakeup sources,
+ *                 wakeup vector), reset the statistics and start the
+ *                 residency report. The handler is subscribed through
+ *                 APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Power_Initialize(void);
+
+/* Function      : Power_Idle
+ *
+ * Description   : Sleep with retention if no subsystem is busy and the
+ *                 stack allows it, otherwise wait for an interrupt; return
+ *                 at once if a scheduler event is pending. Called from the
+ *                 main loop once the kernel has no more work; does not
+ *                 return when the chip sleeps.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Power_Idle(void);
+
+/* Function      : Power_WakeupFromSleep
+ *
+ * Description   : Wakeup vector: restore the clocks and the peripherals,
+ *                 then run the main loop again.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Power_WakeupFromSleep(void);
+
+/* Function      : Power_TraceBusy
+ *
+ * Description   : Returns true while the swmTrace UART is transmitting.
+ *
+ * Parameters    : None
+ *
+ * Returns       : bool : true if the UART is busy
+ */
+bool Power_TraceBusy(void);
+
+/* Function      : Power_GetStats
+ *
+ * Description   : Returns the residency and the sleep counters, the current
+ *                 state counted up to now.
+ *
+ * Parameters    : None
+ *
+ * Returns       : const struct power_stats_t * : statistics
+ */
+const struct power_stats_t *Power_GetStats(void);
+
+/* Function      : Power_MsgHandler
+ *
+ * Description   : Log the residency report.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Power_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_POWER_H */
@@ -0,0 +1,209 @@
+/******************************************************************************
+ * File Name        : app_profile.h
+ * Description      : This header module contains the probe table, markers,
+ *                    types and function prototypes of the cycle profiler.
+ *
+ *                    Each probe of APP_PROFILE_PROBE_TABLE times a hot path
+ *                    on the DWT cycle counter (app_cycles.h) between a
+ *                    PROFILE_BEGIN / PROFILE_END pair, or from a
+ *                    PROFILE_SCOPE marker to the end of the enclosing block
+ *                    (every return included). The message handlers are
+ *                    timed by the dispatcher, one entry per row of
+ *                    APP_DISPATCH_TABLE, with the same statistics.
+ *
+ *                    The count, minimum, maximum, mean and histogram of
+ *                    every probe called since the last report are logged
+ *                    on the trace UART when a connection ends. The probes
+ *                    and the dispatch rows are served together on the
+ *                    STREAM_SRC_DIAG stream source (decoded by
+ *                    hub_software/src/profile_decoder.py).
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_PROFILE_H
+#define APP_PROFILE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+#include <app_cycles.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Set to 0 for a release build, the markers then compile to nothing
+#ifndef APP_PROFILE_ENABLE
+#define APP_PROFILE_ENABLE              (1)
+#endif /* ifndef APP_PROFILE_ENABLE */
+
+/* Probes, in stream order:
+ *   X(name)
+ *   name : PROFILE_<name> index, passed to the markers
+ */
+#define APP_PROFILE_PROBE_TABLE(X)                                             \
+    X(SENSOR_MEASUREMENT)       /* HDC2080 result read, Sensor_Publish */      \
+    X(SET_POSITION)             /* servo move setup */                         \
+    X(BLE_KERNEL_PROCESS)       /* one kernel pass of the main loop */         \
+    X(CUSTOMSS_RX)              /* CUSTOMSS_*CharCallback ... */               \
+    X(CUSTOMSS_LED)                                                            \
+    X(CUSTOMSS_TEMP_UTHR)                                                      \
+    X(CUSTOMSS_TEMP_LTHR)                                                      \
+    X(CUSTOMSS_VENT)                                                           \
+    X(CUSTOMSS_LINK_INFO)                                                      \
+    X(CUSTOMSS_BATT_HEALTH)                                                    \
+    X(CUSTOMSS_ENERGY)                                                         \
+    X(CUSTOMSS_ZONE_ID)                                                        \
+    X(CUSTOMSS_GROUP_KEY)                                                      \
+    X(CUSTOMSS_BENCH_CTRL)                                                     \
+    X(CUSTOMSS_BENCH_RESULT)                                                   \
+    X(CUSTOMSS_SNAPSHOT)                                                       \
+    X(CUSTOMSS_MAX_AGE)
+
+#define APP_PROFILE_PROBE_ENUM(name)    PROFILE_##name,
+
+enum profile_probe
+{
+    APP_PROFILE_PROBE_TABLE(APP_PROFILE_PROBE_ENUM)
+    PROFILE_PROBE_COUNT
+};
+
+// Histogram buckets, x4 apart: bucket i counts the calls shorter than
+// 2^(6 + 2i) cycles (64, 256, 1 k ... 256 k), the last one the longer ones
+#define PROFILE_BUCKETS                 (8)
+#define PROFILE_BUCKET_SHIFT(i)         (6 + (2 * (i)))
+
+// STREAM_SRC_DIAG layout (little endian)
+//   [0] PROFILE_PROBE_COUNT, [1] dispatch rows, [2..3] core clock (MHz),
+//   then one record per probe in table order and per dispatch row in
+//   APP_DISPATCH_TABLE order: count, min, max, mean (cycles, uint32),
+//   histogram (PROFILE_BUCKETS x uint16)
+#define PROFILE_HEADER_LENGTH           (4)
+#define PROFILE_RECORD_LENGTH           (16 + (2 * PROFILE_BUCKETS))
+
+struct profile_stats_t
+{
+    uint32_t count;             // calls
+    uint32_t min_cycles;        // best case
+    uint32_t max_cycles;        // worst case
+    uint64_t total_cycles;      // sum, for the mean
+    uint16_t histogram[PROFILE_BUCKETS];    // saturate at 0xFFFF
+};
+
+// Open marker of a PROFILE_SCOPE, closed by the cleanup attribute
+struct profile_scope_t
+{
+    uint8_t probe;
+    uint32_t start;
+};
+
+#if APP_PROFILE_ENABLE
+#define PROFILE_BEGIN(name)             uint32_t profile_start_##name = Cycles_Now()
+#define PROFILE_END(name)               Profile_Record(PROFILE_##name, \
+                                                       Cycles_Since(profile_start_##name))
+#define PROFILE_SCOPE(name)                                                    \
+    struct profile_scope_t profile_scope_##name                                \
+        __attribute__((cleanup(Profile_ScopeEnd))) = { PROFILE_##name, Cycles_Now() }
+#else  /* if APP_PROFILE_ENABLE */
+#define PROFILE_BEGIN(name)             do { } while (0)
+#define PROFILE_END(name)               do { } while (0)
+#define PROFILE_SCOPE(name)             do { } while (0)
+#endif /* if APP_PROFILE_ENABLE */
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Profile_Initialize
+ *
+ * Description   : Reset the probes and register the STREAM_SRC_DIAG stream
+ *                 source. The report is logged when a connection ends
+ *                 through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Profile_Initialize(void);
+
+/* Function      : Profile_Update
+ *
+ * Description   : Add one timed call to a set of statistics.
+ *
+ * Parameters    : struct profile_stats_t *stats : statistics to update
+ *                 uint32_t cycles               : duration of the call
+ *
+ * Returns       : None
+ */
+void Profile_Update(struct profile_stats_t *stats, uint32_t cycles);
+
+/* Function      : Profile_Record
+ *
+ * Description   : Add one timed call to a probe.
+ *
+ * Parameters    : uint8_t probe   : enum profile_probe
+ *                 uint32_t cycles : duration of the call
+ *
+ * Returns       : None
+ */
+void Profile_Record(uint8_t probe, uint32_t cycles);
+
+/* Function      : Profile_ScopeEnd
+ *
+ * Description   : Close a PROFILE_SCOPE marker when it goes out of scope.
+ *
+ * Parameters    : struct profile_scope_t *scope : marker
+ *
+ * Returns       : None
+ */
+static inline void Profile_ScopeEnd(struct profile_scope_t *scope)
+{
+    Profile_Record(scope->probe, Cycles_Since(scope->start));
+}
+
+/* Function      : Profile_GetStats
+ *
+ * Description   : Returns the statistics of a probe.
+ *
+ * Parameters    : uint8_t probe : enum profile_probe
+ *
+ * Returns       : const struct profile_stats_t * : statistics, NULL if probe
+ *                                                  is out of range
+ */
+const struct profile_stats_t *Profile_GetStats(uint8_t probe);
+
+/* Function      : Profile_MsgHandler
+ *
+ * Description   : Log the statistics of every probe called since the last
+ *                 report when a connection ends.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Profile_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                        ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_PROFILE_H */
@@ -0,0 +1,169 @@
+/******************************************************************************
+ * File Name        : app_relay.h
+ * Description      : This header module contains the constants and function
+ *                    prototypes of the vent-to-vent relay.
+ *
+ *                    A vent built with RELAY_ENABLE rebroadcasts the group
+ *                    frames it hears (app_group.h): its neighbours'
+ *                    telemetry toward the hub, the hub's commands toward
+ *                    far vents and the frames of other relays, each wrapped
+ *                    in a relay frame with a hop count and a TTL. A frame is
+ *                    forwarded once per (origin address, frame content)
+ *                    within RELAY_DEDUPE_TICKS, commands only with a valid
+ *                    MAC, and a token bucket caps the bursts each relay
+ *                    sends.
+ *
+ *                    Relay frame (manufacturer specific data):
+ *                      [0..1]   company ID (APP_COMPANY_ID)
+ *                      [2]      GROUP_FRAME_RELAY
+ *                      [3]      hops so far, including this relay
+ *                      [4]      TTL, largest hop count forwarded
+ *                      [5..10]  origin address (little endian)
+ *                      [11..]   relayed frame from its type byte
+ *
+ *                    Airtime: one burst is RELAY_BURST_EVENTS legacy
+ *                    non-connectable events of ~1.2 ms (3 channels, 29 byte
+ *                    payload); the default budget averages 12 bursts per
+ *                    minute, ~0.07 % of the channel per relay.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_RELAY_H
+#define APP_RELAY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Set to 1 to build the relay role in. A relay scans with a wider window
+// (GROUP_SCAN_WINDOW), so it is meant for vents on mains power.
+#ifndef RELAY_ENABLE
+#define RELAY_ENABLE                    (0)
+#endif /* ifndef RELAY_ENABLE */
+
+// Largest hop count of a relayed frame
+#define RELAY_TTL                       (3)
+
+// Relay frame header, offsets from the frame type byte
+#define RELAY_HOP_OFFSET                (1)
+#define RELAY_TTL_OFFSET                (2)
+#define RELAY_ORIGIN_OFFSET             (3)
+#define RELAY_HEADER_LENGTH             (9)
+
+// Largest relayed frame (a command frame without the company ID)
+#define RELAY_INNER_MAX                 (16)
+
+// Burst of one frame: non-connectable events at 100 ms (0.625 ms units)
+#define RELAY_ADV_INTV                  (160)
+#define RELAY_BURST_EVENTS              (3)
+
+// Frames waiting for their burst
+#define RELAY_QUEUE_LENGTH              (4)
+
+// Forwarded frames remembered for deduplication
+#define RELAY_CACHE_LENGTH              (32)
+
+// Budget tick: refill and cache ageing
+#define RELAY_TICK_S                    (5)
+
+// Token bucket, one token per burst: RELAY_BUCKET_SIZE back to back, then
+// RELAY_REFILL_TOKENS per tick (12 bursts per minute)
+#define RELAY_BUCKET_SIZE               (8)
+#define RELAY_REFILL_TOKENS             (1)
+
+// Ticks before the same frame from the same origin is forwarded again, so
+// the hub keeps seeing vents whose telemetry does not change (5 min)
+#define RELAY_DEDUPE_TICKS              (60)
+
+// Application task instance the relay advertising is requested from (see
+// GROUP_TASK)
+#define RELAY_TASK                      KE_BUILD_ID(TASK_APP, 2)
+
+// Relay messages
+enum relay_msg_id
+{
+    // Budget tick
+    RELAY_TICK_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 120,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Relay_Initialize
+ *
+ * Description   : Reset the queue, the cache and the budget. The handler is
+ *                 subscribed through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Relay_Initialize(void);
+
+/* Function      : Relay_Start
+ *
+ * Description   : Create the relay advertising activity and start the
+ *                 budget tick. Does nothing unless RELAY_ENABLE is set.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Relay_Start(void);
+
+/* Function      : Relay_Forward
+ *
+ * Description   : Queue a group frame for rebroadcast unless it is this
+ *                 vent's own, was forwarded recently, has reached its TTL or
+ *                 is a command with a bad MAC.
+ *
+ * Parameters    : const uint8_t *origin : address of the frame's originator
+ *                 const uint8_t *frame  : frame from its type byte
+ *                 uint8_t length        : frame length
+ *                 uint8_t hops          : hops so far, 0 if heard directly
+ *                 uint8_t ttl           : largest hop count
+ *
+ * Returns       : None
+ */
+void Relay_Forward(const uint8_t *origin, const uint8_t *frame, uint8_t length,
+                   uint8_t hops, uint8_t ttl);
+
+/* Function      : Relay_MsgHandler
+ *
+ * Description   : Run the relay advertising activity and the budget tick.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Relay_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                      ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_RELAY_H */
@@ -0,0 +1,180 @@
+/******************************************************************************
+ * File Name        : app_sched.h
+ * Description      : This header module contains the task table, types and
+ *                    function prototypes of the application scheduler.
+ *
+ *                    Interrupts and application code hand work to the main
+ *                    loop by posting an event (a task and a 32-bit argument)
+ *                    instead of setting a flag for the loop to poll. Each
+ *                    task has its own event ring, written by a single
+ *                    producer (one interrupt, or the application task) and
+ *                    read by the main loop, so posting takes no lock and
+ *                    is safe from any interrupt priority.
+ *
+ *                    After each BLE_Kernel_Process the main loop runs the
+ *                    pending events to completion, the oldest event of the
+ *                    highest priority task first, and does not sleep while
+ *                    any is pending. Each task has a deadline from post to
+ *                    run; the ring depth, the latency, the run time and the
+ *                    missed deadlines are counted per task and reported
+ *                    when a connection ends.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_SCHED_H
+#define APP_SCHED_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Events per task ring (power of two); a post to a full ring is dropped
+#define APP_SCHED_QUEUE_LENGTH          (8)
+
+// Events run per call of AppSched_Run, the kernel gets its turn in between
+#define APP_SCHED_BATCH                 (8)
+
+/* Application tasks:
+ *   X(name, priority, deadline_us, handler)
+ *   name        : APP_SCHED_<name> index, passed to AppSched_Post
+ *   priority    : enum app_sched_prio
+ *   deadline_us : longest expected time from post to run
+ *   handler     : void (*)(uint32_t arg), run in the main loop
+ * Each task must be posted to from one context only (one interrupt, or
+ * the application task).
+ */
+#define APP_SCHED_TASK_TABLE(X)                                                \
+    X(BUTTON,        APP_SCHED_PRIO_HIGH,    5000,   CUSTOMSS_ButtonTask)      \
+    X(SENSOR_CONFIG, APP_SCHED_PRIO_NORMAL,  5000,   Boot_SensorTask)
+
+#define APP_SCHED_TASK_ENUM(name, priority, deadline_us, handler)   APP_SCHED_##name,
+
+enum app_sched_task
+{
+    APP_SCHED_TASK_TABLE(APP_SCHED_TASK_ENUM)
+    APP_SCHED_TASK_COUNT
+};
+
+// Task priorities, highest first
+enum app_sched_prio
+{
+    APP_SCHED_PRIO_HIGH,
+    APP_SCHED_PRIO_NORMAL,
+    APP_SCHED_PRIO_LOW,
+    APP_SCHED_PRIO_COUNT
+};
+
+typedef void (*app_sched_handler_t)(uint32_t arg);
+
+// Statistics of one task
+struct app_sched_stats_t
+{
+    uint32_t posted;            // events posted (producer side)
+    uint32_t dropped;           // posts to a full ring (producer side)
+    uint8_t max_depth;          // deepest ring seen at a post
+    uint32_t run;               // events run
+    uint32_t missed;            // events run after their deadline
+    uint32_t max_latency;       // worst post to run (cycles)
+    uint32_t max_cycles;        // worst handler run time
+    uint32_t total_cycles;      // sum, wraps after ~179 s of handler time
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : AppSched_Initialize
+ *
+ * Description   : Clear the statistics. Called before the interrupts are
+ *                 enabled; the statistics are reported through
+ *                 APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void AppSched_Initialize(void);
+
+/* Function      : AppSched_Post
+ *
+ * Description   : Queue an event for a task. Interrupt safe, from the
+ *                 task's single producer context only.
+ *
+ * Parameters    : uint8_t task   : enum app_sched_task
+ *                 uint32_t arg   : passed to the task handler
+ *
+ * Returns       : bool : false if the task ring is full (event dropped)
+ */
+bool AppSched_Post(uint8_t task, uint32_t arg);
+
+/* Function      : AppSched_Run
+ *
+ * Description   : Run up to APP_SCHED_BATCH pending events, highest priority
+ *                 first. Called from the main loop.
+ *
+ * Parameters    : None
+ *
+ * Returns       : bool : true if events are still pending
+ */
+bool AppSched_Run(void);
+
+/* Function      : AppSched_IsPending
+ *
+ * Description   : Returns true if any event is pending. Checked by the power
+ *                 manager with interrupts masked before the core waits.
+ *
+ * Parameters    : None
+ *
+ * Returns       : bool : true if an event is pending
+ */
+bool AppSched_IsPending(void);
+
+/* Function      : AppSched_GetStats
+ *
+ * Description   : Returns the statistics of a task.
+ *
+ * Parameters    : uint8_t task : enum app_sched_task
+ *
+ * Returns       : const struct app_sched_stats_t * : statistics, NULL if
+ *                                                    task is out of range
+ */
+const struct app_sched_stats_t *AppSched_GetStats(uint8_t task);
+
+/* Function      : AppSched_MsgHandler
+ *
+ * Description   : Log the statistics of the tasks run since the last report.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void AppSched_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                         ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_SCHED_H */
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * File Name        : app_sensor.h
+ * Description      : This header module contains the constants, messages and
+ *                    function prototypes of the sensor sampler.
+ *
+ *                    Samples are taken on demand only, always
+ *                    asynchronously: when a subscriber or the history log
+ *                    needs one, and when a characteristic is read and the
+ *                    last sample is older than the client-configured
+ *                    maximum age. That read is confirmed once the new
+ *                    sample is published (see CUSTOMSS_MsgHandler).
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_SENSOR_H
+#define APP_SENSOR_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// HDC2080 temperature + humidity conversion at 14 bits takes ~1.3 ms
+#define SENSOR_CONVERSION_MS            (2)
+
+// Maximum sample age (s), default matches the notification period, 0 means
+// every read takes a new sample
+#define SENSOR_MAX_AGE_DEFAULT_S        (10)
+#define SENSOR_MAX_AGE_LIMIT_S          (3600)
+
+// Sensor sampler messages
+enum sensor_msg_id
+{
+    // Conversion started by Sensor_Request is complete
+    SENSOR_CONVERSION_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 90,
+
+    // The last sample reached its maximum age
+    SENSOR_STALE_TIMEOUT,
+
+    // A new snapshot was published, sent to TASK_APP after every sample,
+    // any module may subscribe in APP_DISPATCH_TABLE
+    SENSOR_SAMPLE_IND,
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Sensor_Initialize
+ *
+ * Description   : Reset the sampler state.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Sensor_Initialize(void);
+
+/* Function      : Sensor_Start
+ *
+ * Description   : Accept requests and take the first sample. Called by the
+ *                 boot sequencer once the HDC2080 is configured, requests
+ *                 made before are dropped (the first sample follows).
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Sensor_Start(void);
+
+/* Function      : Sensor_Request
+ *
+ * Description   : Start a conversion and return. The sample is read and
+ *                 published once the conversion time has passed, then
+ *                 SENSOR_SAMPLE_IND is sent. A request made while a
+ *                 conversion is running joins it.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Sensor_Request(void);
+
+/* Function      : Sensor_IsFresh
+ *
+ * Description   : Returns whether the last sample is within the maximum age.
+ *
+ * Parameters    : None
+ *
+ * Returns       : bool : true if fresh
+ */
+bool Sensor_IsFresh(void);
+
+/* Function      : Sensor_SetMaxAge
+ *
+ * Description   : Set the maximum sample age. The last sample is judged
+ *                 against it right away: stale if already older, otherwise
+ *                 the age timer is re-armed for the time it has left.
+ *
+ * Parameters    : uint16_t max_age_s : maximum age (s), at most
+ *                                      SENSOR_MAX_AGE_LIMIT_S
+ *
+ * Returns       : None
+ */
+void Sensor_SetMaxAge(uint16_t max_age_s);
+
+/* Function      : Sensor_MsgHandler
+ *
+ * Description   : Complete asynchronous conversions and track sample age.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Sensor_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                       ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_SENSOR_H */
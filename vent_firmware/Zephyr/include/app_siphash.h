@@ -0,0 +1,58 @@
+/******************************************************************************
+ * File Name        : app_siphash.h
+ * Description      : This header module contains the function prototypes for
+ *                    SipHash-2-4, the keyed 64-bit MAC that authenticates
+ *                    hub command advertisements (see app_group.h).
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_SIPHASH_H
+#define APP_SIPHASH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+#define SIPHASH_KEY_LENGTH              (16)
+#define SIPHASH_MAC_LENGTH              (8)
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : SipHash24
+ *
+ * Description   : Compute the SipHash-2-4 MAC of a message. The result
+ *                 matches the reference implementation; it is returned as
+ *                 the little endian 64-bit value.
+ *
+ * Parameters    : const uint8_t *key  : SIPHASH_KEY_LENGTH byte key
+ *                 const uint8_t *data : message
+ *                 uint32_t length     : number of bytes
+ *
+ * Returns       : uint64_t : MAC
+ */
+uint64_t SipHash24(const uint8_t *key, const uint8_t *data, uint32_t length);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_SIPHASH_H */
@@ -0,0 +1,126 @@
+/******************************************************************************
+ * File Name        : app_snapshot.h
+ * Description      : This header module contains the sensor snapshot type and
+ *                    the function prototypes of the double-buffered snapshot.
+ *
+ *                    The latest temperature, humidity and battery readings
+ *                    are kept in one of two buffers. A new sample is written
+ *                    to the back buffer and published by flipping the active
+ *                    index, so the attribute database and the notifications
+ *                    are served straight from the snapshot and a reader never
+ *                    sees half of an update.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_SNAPSHOT_H
+#define APP_SNAPSHOT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Sequence number of a buffer that is being written
+#define SNAPSHOT_SEQ_WRITING            (0)
+
+// One sensor sample, the float fields are sent over the air as they are
+// stored (IEEE-754, little endian)
+struct sensor_snapshot_t
+{
+    uint32_t seq;               // publish count, SNAPSHOT_SEQ_WRITING while written
+    float temperature;          // degC
+    float humidity;             // %RH
+    uint8_t battery;            // %
+};
+
+// Byte offsets of the attribute values in a snapshot (see Snapshot_Read)
+#define SNAPSHOT_TEMPERATURE            (offsetof(struct sensor_snapshot_t, temperature))
+#define SNAPSHOT_HUMIDITY               (offsetof(struct sensor_snapshot_t, humidity))
+#define SNAPSHOT_BATTERY                (offsetof(struct sensor_snapshot_t, battery))
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Snapshot_Initialize
+ *
+ * Description   : Clear both buffers and publish an all-zero snapshot.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Snapshot_Initialize(void);
+
+/* Function      : Snapshot_BeginUpdate
+ *
+ * Description   : Returns the back buffer, marked as being written, with the
+ *                 current values copied in so a partial update keeps the
+ *                 other fields. Only the application task may update.
+ *
+ * Parameters    : None
+ *
+ * Returns       : struct sensor_snapshot_t * : buffer to fill
+ */
+struct sensor_snapshot_t * Snapshot_BeginUpdate(void);
+
+/* Function      : Snapshot_Publish
+ *
+ * Description   : Make the buffer returned by Snapshot_BeginUpdate the
+ *                 active snapshot.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Snapshot_Publish(void);
+
+/* Function      : Snapshot_Get
+ *
+ * Description   : Returns the active snapshot. The pointer is stable until
+ *                 the next Snapshot_Publish, so it may be used directly from
+ *                 the application task (the only writer), e.g. to queue a
+ *                 notification.
+ *
+ * Parameters    : None
+ *
+ * Returns       : const struct sensor_snapshot_t * : active snapshot
+ */
+const struct sensor_snapshot_t * Snapshot_Get(void);
+
+/* Function      : Snapshot_Read
+ *
+ * Description   : Copy bytes of the active snapshot from any context. The
+ *                 copy is retried if the buffer was rewritten meanwhile, so
+ *                 it never mixes two samples.
+ *
+ * Parameters    : uint16_t offset : byte offset (SNAPSHOT_TEMPERATURE, ...)
+ *                 uint8_t *to     : destination
+ *                 uint16_t length : bytes to copy
+ *
+ * Returns       : uint32_t : sequence number of the sample copied
+ */
+uint32_t Snapshot_Read(uint16_t offset, uint8_t *to, uint16_t length);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_SNAPSHOT_H */
@@ -0,0 +1,147 @@
+/******************************************************************************
+ * File Name        : app_stream.h
+ * Description      : This header module contains the constants, frame format
+ *                    and function prototypes of the bulk stream endpoint.
+ *
+ *                    The endpoint is an LE credit based L2CAP channel. The
+ *                    client opens the channel on STREAM_LE_PSM and sends a
+ *                    request frame naming a source and a start offset. The
+ *                    device answers with data frames until the end of the
+ *                    source, then an end frame carrying the CRC-32 of the
+ *                    bytes sent since the request. An interrupted download
+ *                    is resumed by requesting again from the last offset
+ *                    received.
+ *
+ *                    Frames (little endian):
+ *                      REQUEST : 0x01, source (1), offset (4)
+ *                      DATA    : 0x02, offset (4), payload (n)
+ *                      END     : 0x03, end offset (4), CRC-32 (4)
+ *                      ERROR   : 0x04, source (1), error code (1)
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_STREAM_H
+#define APP_STREAM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// LE protocol/service multiplexer of the stream endpoint (dynamic range)
+#define STREAM_LE_PSM                   (0x0080)
+
+// Number of simultaneous stream channels
+#define STREAM_MAX_CHANNELS             (1)
+
+// Receive side: only request frames are received, keep it small
+#define STREAM_LOCAL_MTU                (64)
+#define STREAM_LOCAL_MPS                (64)
+#define STREAM_LOCAL_CREDITS            (4)
+
+// Largest SDU sent, the peer MTU may lower it
+#define STREAM_SDU_MAX                  (512)
+
+// Number of registered stream sources
+#define STREAM_MAX_SOURCES              (3)
+
+// Frame types and sizes
+#define STREAM_FRAME_REQUEST            (0x01)
+#define STREAM_FRAME_DATA               (0x02)
+#define STREAM_FRAME_END                (0x03)
+#define STREAM_FRAME_ERROR              (0x04)
+
+#define STREAM_REQUEST_LENGTH           (6)
+#define STREAM_DATA_HEADER_LENGTH       (5)
+#define STREAM_END_LENGTH               (9)
+#define STREAM_ERROR_LENGTH             (3)
+
+// Error codes of the ERROR frame
+enum stream_error
+{
+    STREAM_ERR_BAD_REQUEST = 1,
+    STREAM_ERR_UNKNOWN_SOURCE,
+    STREAM_ERR_BAD_OFFSET,
+};
+
+// Stream source identifiers
+enum stream_source_id
+{
+    STREAM_SRC_HISTORY = 1,
+    STREAM_SRC_LOG,
+    STREAM_SRC_DIAG,
+};
+
+// Stream source, offsets are absolute and only grow so that a download can
+// be resumed. Bytes below begin() have been overwritten.
+struct stream_source_t
+{
+    uint32_t (*begin)(void);
+    uint32_t (*end)(void);
+    uint16_t (*read)(uint32_t offset, uint8_t *buf, uint16_t length);
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Stream_Initialize
+ *
+ * Description   : Reset the stream endpoint. The LE PSM is registered once
+ *                 the device configuration completes (GAPM_CMP_EVT, see
+ *                 APP_DISPATCH_TABLE).
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void Stream_Initialize(void);
+
+/* Function      : Stream_RegisterSource
+ *
+ * Description   : Make a source available for download.
+ *
+ * Parameters    : uint8_t id                           : enum stream_source_id
+ *                 const struct stream_source_t *source : source accessors
+ *
+ * Returns       : bool : true if registered, false if the id is invalid
+ */
+bool Stream_RegisterSource(uint8_t id, const struct stream_source_t *source);
+
+/* Function      : Stream_MsgHandler
+ *
+ * Description   : Handle the L2CAP channel events of the stream endpoint.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void Stream_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                       ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_STREAM_H */
@@ -0,0 +1,183 @@
+/******************************************************************************
+ * File Name        : app_timer.h
+ * Description      : This header module contains the types and function
+ *                    prototypes of the application timer service.
+ *
+ *                    Any number of one-shot and periodic timers share one
+ *                    kernel timer (APP_TIMER_EXPIRY_TIMEOUT). Deadlines are
+ *                    kept in microseconds from the baseband clock in a
+ *                    min-heap, the kernel timer is armed for the earliest
+ *                    one in whole milliseconds, rounded up, so a callback
+ *                    never runs early and runs at most ~1 ms late.
+ *                    Callbacks run in the application task, they may start
+ *                    or cancel any timer, their own included.
+ *
+ *                    The timer structures belong to the caller (usually
+ *                    static in the module that owns them); a cancelled or
+ *                    expired one-shot timer can be started again at once.
+ *
+ *                    Built with APP_TIMER_HOST defined, the service runs on
+ *                    a virtual clock moved by AppTimer_HostAdvance, so
+ *                    timing dependent code can be run on a host
+ *                    deterministically.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef APP_TIMER_H
+#define APP_TIMER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#ifndef APP_TIMER_HOST
+#include <ke_msg.h>
+#endif /* ifndef APP_TIMER_HOST */
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Timers running at the same time
+#define APP_TIMER_MAX                   (16)
+
+// Longest kernel timer armed at once (ms), later deadlines are reached in
+// several steps
+#define APP_TIMER_ARM_MAX_MS            (3600000)
+
+// Duration helpers (us)
+#define APP_TIMER_US(us)                ((uint32_t)(us))
+#define APP_TIMER_MS(ms)                ((uint32_t)(ms) * 1000U)
+#define APP_TIMER_S(s)                  ((uint32_t)(s) * 1000000U)
+
+#ifndef APP_TIMER_HOST
+// Timer service messages
+enum app_timer_msg_id
+{
+    // Earliest deadline reached
+    APP_TIMER_EXPIRY_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 140,
+};
+#endif /* ifndef APP_TIMER_HOST */
+
+typedef void (*app_timer_cb_t)(void *context);
+
+struct app_timer_t
+{
+    app_timer_cb_t callback;
+    void *context;
+    uint64_t deadline;          // us
+    uint32_t period;            // us, 0 for one-shot
+    uint8_t slot;               // heap index + 1, 0 when not running
+};
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : AppTimer_Initialize
+ *
+ * Description   : Arm the kernel timer for the timers started so far. Timers
+ *                 may be started before (during the peripheral setup), they
+ *                 run once the kernel is up. The handler is subscribed
+ *                 through APP_DISPATCH_TABLE.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+void AppTimer_Initialize(void);
+
+/* Function      : AppTimer_Start
+ *
+ * Description   : Start (or restart) a timer. Application task only.
+ *
+ * Parameters    : struct app_timer_t *timer : timer, owned by the caller
+ *                 uint32_t delay            : first expiry (us)
+ *                 uint32_t period           : then every period (us), 0 for
+ *                                             a one-shot timer
+ *                 app_timer_cb_t callback   : called on expiry
+ *                 void *context             : passed to the callback
+ *
+ * Returns       : bool : false if APP_TIMER_MAX timers are running
+ */
+bool AppTimer_Start(struct app_timer_t *timer, uint32_t delay, uint32_t period,
+                    app_timer_cb_t callback, void *context);
+
+/* Function      : AppTimer_Cancel
+ *
+ * Description   : Stop a timer; its callback will not run. Does nothing if
+ *                 the timer is not running.
+ *
+ * Parameters    : struct app_timer_t *timer : timer
+ *
+ * Returns       : None
+ */
+void AppTimer_Cancel(struct app_timer_t *timer);
+
+/* Function      : AppTimer_IsRunning
+ *
+ * Description   : Returns true while a timer is started and not expired (a
+ *                 periodic timer runs until cancelled).
+ *
+ * Parameters    : const struct app_timer_t *timer : timer
+ *
+ * Returns       : bool : true if running
+ */
+bool AppTimer_IsRunning(const struct app_timer_t *timer);
+
+/* Function      : AppTimer_Now
+ *
+ * Description   : Returns the time since start up.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint64_t : time (us)
+ */
+uint64_t AppTimer_Now(void);
+
+#ifdef APP_TIMER_HOST
+/* Function      : AppTimer_HostAdvance
+ *
+ * Description   : Move the virtual clock forward, running the callbacks of
+ *                 every deadline passed in order.
+ *
+ * Parameters    : uint64_t us : time to advance (us)
+ *
+ * Returns       : None
+ */
+void AppTimer_HostAdvance(uint64_t us);
+#else  /* ifdef APP_TIMER_HOST */
+/* Function      : AppTimer_MsgHandler
+ *
+ * Description   : Run the callbacks of the expired timers and arm the
+ *                 kernel timer for the next deadline.
+ *
+ * Parameters    : ke_msg_id_t const msg_id   : Kernel message ID number
+ *                 void const *param          : Message parameter
+ *                 ke_task_id_t const dest_id : Destination task ID number
+ *                 ke_task_id_t const src_id  : Source task ID number
+ *
+ * Returns       : None
+ */
+void AppTimer_MsgHandler(ke_msg_id_t const msg_id, void const *param,
+                         ke_task_id_t const dest_id, ke_task_id_t const src_id);
+#endif /* ifdef APP_TIMER_HOST */
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* APP_TIMER_H */
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * File Name        : app.h
+ * Description      : Host stand-in for the application header. Found before
+ *                    Zephyr/include/app.h on the host include path, it gives
+ *                    the modules built for the host tests the declarations
+ *                    they use from the SDK and from the other modules; the
+ *                    tests define whatever they call.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef HOST_APP_H
+#define HOST_APP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <hw.h>
+#include <ke_msg.h>
+#include <ble_abstraction.h>
+#include <swmTrace_api.h>
+
+#include <app_clock.h>
+#include <app_energy.h>
+#include <app_stream.h>
+#include <app_log.h>
+#include <app_dispatch.h>
+#include <app_customss.h>
+#include <app_conn_policy.h>
+#include <app_history.h>
+#include <app_snapshot.h>
+#include <app_sensor.h>
+#include <app_ntf_queue.h>
+#include <app_adv.h>
+#include <app_power.h>
+#include <app_timer.h>
+#include <app_sched.h>
+#include <app_boot.h>
+#include <app_kv.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Typedef
+ * --------------------------------------------------------------------------*/
+typedef union {
+    float value;
+    uint8_t bytes[CS_TEMPERATURE_MAX_LENGTH];
+} EncodedFloat;
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Application messages of app.h, the module messages come with their header
+enum host_app_msg_id
+{
+    APP_LED_TIMEOUT = TASK_FIRST_MSG(TASK_ID_APP) + 1,
+    APP_BATT_LEVEL_READ_TIMEOUT,
+    APP_SW1_TIMEOUT,
+    APP_SW1LED_TIMEOUT,
+};
+
+#define THRESHOLD_OFF_LIMIT             (100)
+#define THRESHOLD_OFF_DELTA             (1.1)
+
+// Servo.h values (it includes the firmware app.h)
+#define SERVO_TRAVEL_MS                 (500)
+#define VENT_OPEN_STATE                 (0)
+#define VENT_CLOSED_STATE               (1)
+
+#define LED_STATE_GPIO                  (6)
+#define BUTTON_GPIO                     (0)
+#define CLR_BONDLIST_HOLD_DURATION_S    (5)
+
+#define TIMER_SETTING_MS(MS)            MS
+#define TIMER_SETTING_S(S)              (S * 1000)
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+extern EncodedFloat temperature_upper_threshold;
+extern EncodedFloat temperature_lower_threshold;
+extern uint8_t *vent_state;
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+void set_vent_state(uint8_t state);
+void vent_update(void);
+void vent_threshold_check(void);
+void Sys_GPIO_Set_High(uint32_t gpio);
+void Sys_GPIO_Set_Low(uint32_t gpio);
+uint32_t Sys_GPIO_Read(uint32_t gpio);
+
+// Handlers of APP_DISPATCH_TABLE, defined by the test that dispatches
+#define HOST_HANDLER_DECLARE(id, handler)                                      \
+    void handler(ke_msg_id_t const msg_id, void const *param,                  \
+                 ke_task_id_t const dest_id, ke_task_id_t const src_id);
+
+APP_DISPATCH_TABLE(HOST_HANDLER_DECLARE)
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* HOST_APP_H */
@@ -0,0 +1,157 @@
+/******************************************************************************
+ * File Name        : ble_abstraction.h
+ * Description      : Host stand-in for the BLE abstraction header: the stack
+ *                    messages subscribed in APP_DISPATCH_TABLE. They are
+ *                    numbered from the base of their task, in no particular
+ *                    order; only the application message IDs (app.h) keep
+ *                    their firmware values. Also the attribute database
+ *                    declarations and the connection queries the custom
+ *                    service uses; the tests define whatever they call.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef HOST_BLE_ABSTRACTION_H
+#define HOST_BLE_ABSTRACTION_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <ke_msg.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+enum host_stack_msg_id
+{
+    L2CC_CMP_EVT = TASK_FIRST_MSG(TASK_ID_L2CC),
+    L2CC_LECB_CONNECT_REQ_IND,
+    L2CC_LECB_CONNECT_IND,
+    L2CC_LECB_ADD_IND,
+    L2CC_LECB_SDU_RECV_IND,
+    L2CC_LECB_DISCONNECT_IND,
+
+    GATTM_ADD_SVC_RSP = TASK_FIRST_MSG(TASK_ID_GATTM),
+
+    GATTC_CMP_EVT = TASK_FIRST_MSG(TASK_ID_GATTC),
+    GATTC_MTU_CHANGED_IND,
+    GATTC_READ_REQ_IND,
+    GATTC_READ_CFM,
+    GATTC_WRITE_REQ_IND,
+
+    GAPM_CMP_EVT = TASK_FIRST_MSG(TASK_ID_GAPM),
+    GAPM_PROFILE_ADDED_IND,
+    GAPM_ACTIVITY_CREATED_IND,
+    GAPM_ACTIVITY_STOPPED_IND,
+    GAPM_EXT_ADV_REPORT_IND,
+    GAPM_ADDR_SOLVED_IND,
+
+    GAPC_CONNECTION_REQ_IND = TASK_FIRST_MSG(TASK_ID_GAPC),
+    GAPC_DISCONNECT_IND,
+    GAPC_GET_DEV_INFO_REQ_IND,
+    GAPC_PARAM_UPDATE_REQ_IND,
+    GAPC_PARAM_UPDATED_IND,
+    GAPC_LE_PKT_SIZE_IND,
+    GAPC_LE_PHY_IND,
+    GAPC_CON_RSSI_IND,
+    GAPC_BOND_REQ_IND,
+    GAPC_BOND_IND,
+    GAPC_ENCRYPT_REQ_IND,
+    GAPC_ENCRYPT_IND,
+};
+
+#define BLE_CONNECTION_MAX              (10)
+
+#define GAP_ERR_NO_ERROR                (0x00)
+#define ATT_ERR_NO_ERROR                (0x00)
+#define ATT_ERR_READ_NOT_PERMITTED      (0x02)
+#define ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN (0x0D)
+#define ATT_ERR_APP_ERROR               (0x80)
+
+#define ATT_CCC_START_NTF               (0x01)
+
+// Attribute permissions, one bit per name (the values are not checked)
+#define PERM(access, right)             (PERM_##access)
+#define PERM_RD                         (1U << 0)
+#define PERM_WRITE_REQ                  (1U << 1)
+#define PERM_WRITE_COMMAND              (1U << 2)
+#define PERM_NTF                        (1U << 3)
+#define PERM_RP                         (1U << 4)
+#define PERM_WP                         (1U << 5)
+
+typedef uint8_t (*GATT_AttCallback_t)(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                      uint8_t *to, const uint8_t *from,
+                                      uint16_t length, uint16_t operation,
+                                      uint8_t hl_status);
+
+// Attribute database entry, built by the CS_* macros below
+struct att_db_desc
+{
+    uint16_t att_idx;
+    uint8_t uuid[16];
+    uint32_t perm;
+    uint16_t length;
+    void *data;
+    GATT_AttCallback_t callback;
+};
+
+#define CS_SERVICE_UUID_128(idx, uuid)                                         \
+    { (idx), uuid, PERM(RD, ENABLE), 0, NULL, NULL }
+#define CS_CHAR_UUID_128(char_idx, val_idx, uuid, perm, length, data, callback) \
+    { (char_idx), { 0 }, PERM(RD, ENABLE), 0, NULL, NULL },                    \
+    { (val_idx), uuid, (perm), (length), (data), (callback) }
+#define CS_CHAR_CCC(idx, data, callback)                                       \
+    { (idx), { 0 }, PERM(RD, ENABLE), 2, (data), (callback) }
+#define CS_CHAR_USER_DESC(idx, length, data, callback)                         \
+    { (idx), { 0 }, PERM(RD, ENABLE), (length), (data), (callback) }
+
+struct gattm_add_svc_rsp
+{
+    uint16_t start_hdl;
+    uint8_t status;
+};
+
+// Custom service database of the GATT environment (GATT_GetEnv)
+struct gatt_cust_svc_db_t
+{
+    uint16_t cust_svc_start_hdl;
+};
+
+struct gatt_env_tag
+{
+    struct gatt_cust_svc_db_t cust_svc_db[2];
+};
+
+// Bond of a connection (Adv_GetBondInfo)
+typedef struct
+{
+    uint8_t addr[6];
+    uint8_t addr_type;
+} BondInfo_t;
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+bool GAPC_IsConnectionActive(uint8_t conidx);
+struct gatt_env_tag * GATT_GetEnv(void);
+uint16_t GATTM_GetHandle(uint8_t svcidx, uint16_t attidx);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* HOST_BLE_ABSTRACTION_H */
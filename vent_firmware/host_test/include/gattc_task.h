@@ -0,0 +1,57 @@
+/******************************************************************************
+ * File Name        : gattc_task.h
+ * Description      : Host stand-in for the GATT client task header: the
+ *                    read and write request messages and their operation
+ *                    codes, as used by the custom service.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef HOST_GATTC_TASK_H
+#define HOST_GATTC_TASK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <ble_abstraction.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+// Operation codes passed to the attribute callbacks and the notifications
+enum host_gattc_operation
+{
+    GATTC_NOTIFY = 0x12,
+    GATTC_INDICATE,
+};
+
+struct gattc_read_req_ind
+{
+    uint16_t handle;
+};
+
+struct gattc_read_cfm
+{
+    uint16_t handle;
+    uint16_t length;
+    uint8_t status;
+    uint8_t value[];
+};
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* HOST_GATTC_TASK_H */
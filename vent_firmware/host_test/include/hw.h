@@ -0,0 +1,95 @@
+/******************************************************************************
+ * File Name        : hw.h
+ * Description      : Host stand-in for the RSL15 device header. Provides the
+ *                    core intrinsics and the cycle counter registers used by
+ *                    the modules built for the host tests.
+ *
+ *                    The barriers are full fences, so code that relies on
+ *                    them between the application task and an interrupt is
+ *                    run between threads. The exclusive load/store pair has
+ *                    no reservation: the host tests have one producer.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef HOST_HW_H
+#define HOST_HW_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL)
+
+// One counter per translation unit, it does not run on the host
+static CoreDebug_Type host_core_debug __attribute__((unused));
+static DWT_Type host_dwt __attribute__((unused));
+
+#define CoreDebug                       (&host_core_debug)
+#define DWT                             (&host_dwt)
+
+static inline void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t __LDREXW(volatile uint32_t *addr)
+{
+    return *addr;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+    *addr = value;
+    return 0;
+}
+
+static inline void __CLREX(void)
+{
+}
+
+static inline void __WFI(void)
+{
+}
+
+static inline void __disable_irq(void)
+{
+}
+
+static inline void __enable_irq(void)
+{
+}
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* HOST_HW_H */
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * File Name        : ke_msg.h
+ * Description      : Host stand-in for the BLE kernel message header: the
+ *                    message and task identifier types, the message ID
+ *                    bases, the application message handler registry and
+ *                    the message and timer calls, which the tests define.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef HOST_KE_MSG_H
+#define HOST_KE_MSG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+typedef uint16_t ke_msg_id_t;
+typedef uint16_t ke_task_id_t;
+
+// Task types of the stack, message IDs are numbered from their base
+#define TASK_ID_L2CC                    (10)
+#define TASK_ID_GATTM                   (11)
+#define TASK_ID_GATTC                   (12)
+#define TASK_ID_GAPM                    (13)
+#define TASK_ID_GAPC                    (14)
+#define TASK_ID_APP                     (15)
+
+#define TASK_FIRST_MSG(task)            ((ke_msg_id_t)((task) << 8))
+
+#define TASK_APP                        (TASK_ID_APP)
+#define TASK_GATTC                      (TASK_ID_GATTC)
+
+// Task instance (connection index) in the upper byte
+#define KE_BUILD_ID(type, index)        ((ke_task_id_t)(((index) << 8) | (type)))
+#define KE_IDX_GET(task_id)             (((task_id) >> 8) & 0xFF)
+
+#define KE_MSG_ALLOC(id, dest, src, param_str)                                 \
+    ((struct param_str *)ke_msg_alloc((id), (dest), (src), sizeof(struct param_str)))
+#define KE_MSG_ALLOC_DYN(id, dest, src, param_str, length)                     \
+    ((struct param_str *)ke_msg_alloc((id), (dest), (src),                     \
+                                      sizeof(struct param_str) + (length)))
+
+typedef void (*MsgHandlerCallback_t)(ke_msg_id_t const msg_id, void const *param,
+                                     ke_task_id_t const dest_id,
+                                     ke_task_id_t const src_id);
+
+
+/* ----------------------------------------------------------------------------
+ * Function prototypes
+ * --------------------------------------------------------------------------*/
+
+/* Function      : MsgHandler_Add
+ *
+ * Description   : Subscribe a handler to a message ID of the application
+ *                 task. Defined by the test that needs it.
+ *
+ * Parameters    : ke_msg_id_t msg_id           : Kernel message ID number
+ *                 MsgHandlerCallback_t callback : handler
+ *
+ * Returns       : None
+ */
+void MsgHandler_Add(ke_msg_id_t msg_id, MsgHandlerCallback_t callback);
+
+void * ke_msg_alloc(ke_msg_id_t id, ke_task_id_t dest_id, ke_task_id_t src_id,
+                    uint16_t param_len);
+void ke_msg_send(void const *param);
+void ke_msg_send_basic(ke_msg_id_t id, ke_task_id_t dest_id, ke_task_id_t src_id);
+void ke_timer_set(ke_msg_id_t timer_id, ke_task_id_t task, uint32_t delay);
+void ke_timer_clear(ke_msg_id_t timer_id, ke_task_id_t task);
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* HOST_KE_MSG_H */
@@ -0,0 +1,37 @@
+/******************************************************************************
+ * File Name        : swmTrace_api.h
+ * Description      : Host stand-in for the swmTrace library header. The
+ *                    trace output goes to stdout.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+#ifndef HOST_SWMTRACE_API_H
+#define HOST_SWMTRACE_API_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    /* ifdef __cplusplus */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdio.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Defines
+ * --------------------------------------------------------------------------*/
+#define swmLogInfo(...)                 printf(__VA_ARGS__)
+
+
+#ifdef __cplusplus
+}
+#endif    /* ifdef __cplusplus */
+
+#endif    /* HOST_SWMTRACE_API_H */
@@ -0,0 +1,206 @@
+/******************************************************************************
+ * File Name        : log_capture.c
+ * Description      : Host capture of the tokenized log (app_log.c) for the
+ *                    round trip test of log_decoder.py. Logs a set of
+ *                    records through the firmware macros, drains them as
+ *                    "#L" lines (APP_LOG_UART) and prints after each one
+ *                    the text printf renders from the same format and
+ *                    arguments:
+ *
+ *                      #L <hex words>          record, as on the UART
+ *                      #E <level> <text>       expected decoding
+ *                      #C <name> <value>       record header layout
+ *
+ *                    Built with .applog_fmt placed low so the format string
+ *                    addresses fit in the 24 bits of the token, as they do
+ *                    in the flash of the RSL15.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdarg.h>
+#include <stdlib.h>
+#include <app.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define UNPAREN(...)                    __VA_ARGS__
+
+// Log a record and the text it must decode to. The argument lists are
+// given in parentheses, as logged (words) and as printf takes them
+#define CAPTURE(level, fmt, words, values)                                     \
+    do                                                                         \
+    {                                                                          \
+        APP_LOG(level, fmt, UNPAREN words);                                    \
+        Capture_Drain();                                                       \
+        Capture_Expect(level, fmt, UNPAREN values);                            \
+    } while (0)
+
+static const char *const level_name[] = { "?", "ERROR", "WARN", "INFO", "DEBUG" };
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+void Clock_Request(uint8_t client, uint8_t level)
+{
+    (void)client;
+    (void)level;
+}
+
+void Energy_Begin(uint8_t account)
+{
+    (void)account;
+}
+
+void Energy_End(uint8_t account)
+{
+    (void)account;
+}
+
+bool Stream_RegisterSource(uint8_t id, const struct stream_source_t *source)
+{
+    (void)id;
+    (void)source;
+    return true;
+}
+
+/* Function      : Capture_Drain
+ *
+ * Description   : Print every committed record.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Capture_Drain(void)
+{
+    while (AppLog_Drain())
+    {
+    }
+}
+
+/* Function      : Capture_Print
+ *
+ * Description   : Print an expected line, with the line ending of the
+ *                 format string removed (the decoder strips it).
+ *
+ * Parameters    : uint8_t level    : log level
+ *                 const char *text : rendered text
+ *
+ * Returns       : None
+ */
+static void Capture_Print(uint8_t level, const char *text)
+{
+    size_t length = strlen(text);
+
+    while ((length > 0) && ((text[length - 1] == '\r') || (text[length - 1] == '\n') ||
+                            (text[length - 1] == ' ')))
+    {
+        length--;
+    }
+
+    printf("#E %s %.*s\n", level_name[level], (int)length, text);
+}
+
+/* Function      : Capture_Expect
+ *
+ * Description   : Print the text of a record rendered by printf.
+ *
+ * Parameters    : uint8_t level   : log level
+ *                 const char *fmt : format string
+ *                 ...             : arguments, as printf takes them
+ *
+ * Returns       : None
+ */
+static void Capture_Expect(uint8_t level, const char *fmt, ...)
+{
+    char text[256];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+
+    Capture_Print(level, text);
+}
+
+/* Function      : Capture_ExpectBuffer
+ *
+ * Description   : Print the text of a buffer record: the format rendered
+ *                 with the byte count, then the bytes in hex.
+ *
+ * Parameters    : uint8_t level        : log level
+ *                 const char *fmt      : format string
+ *                 const uint8_t *data  : bytes logged
+ *                 uint16_t length      : byte count
+ *
+ * Returns       : None
+ */
+static void Capture_ExpectBuffer(uint8_t level, const char *fmt,
+                                 const uint8_t *data, uint16_t length)
+{
+    char text[256];
+    int n = snprintf(text, sizeof(text), fmt, (unsigned int)length);
+
+    // The decoder strips the rendered format before the bytes
+    while ((n > 0) && ((text[n - 1] == '\r') || (text[n - 1] == '\n')))
+    {
+        n--;
+    }
+
+    n += snprintf(&text[n], sizeof(text) - n, " ");
+    for (uint16_t i = 0; i < length; i++)
+    {
+        n += snprintf(&text[n], sizeof(text) - n, (i == 0) ? "%02x" : " %02x", data[i]);
+    }
+
+    Capture_Print(level, text);
+}
+
+int main(void)
+{
+    static const uint8_t bytes[] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd };
+    static const char name[] = "vent";
+
+    AppLog_Initialize();
+
+    printf("#C HDR_TOKEN_SHIFT %u\n", APP_LOG_HDR_TOKEN_SHIFT);
+    printf("#C HDR_LEVEL_SHIFT %u\n", APP_LOG_HDR_LEVEL_SHIFT);
+    printf("#C HDR_LEVEL_MASK %u\n", APP_LOG_HDR_LEVEL_MASK);
+    printf("#C HDR_BUFFER %u\n", APP_LOG_HDR_BUFFER);
+    printf("#C HDR_NARGS_MASK %u\n", APP_LOG_HDR_NARGS_MASK);
+
+    APP_LOG_INFO("__TEST no arguments\r\n");
+    Capture_Drain();
+    Capture_Expect(APP_LOG_LEVEL_INFO, "__TEST no arguments\r\n");
+    CAPTURE(APP_LOG_LEVEL_WARN, "__TEST signed %d, unsigned %u\r\n",
+            (-42, 3000000000U), (-42, 3000000000U));
+    CAPTURE(APP_LOG_LEVEL_ERROR, "__TEST hex 0x%08lx %x %02X\r\n",
+            (0xdeadbeefUL, 0x1f, 0xa), (0xdeadbeefUL, 0x1f, 0xa));
+    CAPTURE(APP_LOG_LEVEL_INFO, "__TEST float %.2f %f\r\n",
+            (APP_LOG_FLOAT(21.375f), APP_LOG_FLOAT(-0.5f)), (21.375f, -0.5f));
+    CAPTURE(APP_LOG_LEVEL_INFO, "__TEST string %s, char %c, 100%%\r\n",
+            (APP_LOG_STR(name), 'x'), (name, 'x'));
+    CAPTURE(APP_LOG_LEVEL_INFO, "__TEST width %5d|%-4u|\r\n", (7, 8), (7, 8));
+    CAPTURE(APP_LOG_LEVEL_INFO,
+            "__TEST %u %u %u %u %u %u %u %u %u %u %u %u %u %u %u\r\n",
+            (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+            (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+    APP_LOG_INFO_BUFFER("__TEST %u bytes:", bytes, sizeof(bytes));
+    Capture_Drain();
+    Capture_ExpectBuffer(APP_LOG_LEVEL_INFO, "__TEST %u bytes:", bytes, sizeof(bytes));
+
+    return (AppLog_GetDropped() == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,365 @@
+/******************************************************************************
+ * File Name        : test_dispatch.c
+ * Description      : Host replay test of the application message dispatcher
+ *                    (app_dispatch.c). MsgHandler_Add stands in for the
+ *                    kernel registry; a message trace is replayed through
+ *                    the callbacks registered there and the handlers each
+ *                    message reaches are compared, in order, with the ones
+ *                    listed in the trace. Checks along the way:
+ *
+ *                      - one registration per message ID of the table, all
+ *                        to AppDispatch_Handler
+ *                      - AppDispatch_FanOut of each message is the number
+ *                        of handlers it reaches
+ *                      - a message outside the table reaches no handler
+ *
+ *                    The handlers reached are taken from the statistics row
+ *                    the dispatcher updates after each call, so the
+ *                    handlers the dispatcher owns count too.
+ *
+ *                    Usage: test_dispatch trace...
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <app.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define TEST_REGISTRY_MAX               (64)
+#define TEST_CALLS_MAX                  (32)
+
+// Handler of each table row, in table order (same rows as the dispatcher)
+#define TEST_ROW_ENTRY(msg_id, handler)         { #msg_id, (msg_id), #handler },
+
+static const struct
+{
+    const char *msg_name;
+    ke_msg_id_t msg_id;
+    const char *handler;
+} test_row[] =
+{
+    APP_DISPATCH_TABLE(TEST_ROW_ENTRY)
+};
+
+#define TEST_ROWS                       (sizeof(test_row) / sizeof(test_row[0]))
+
+// Kernel registry of the application task
+static struct
+{
+    ke_msg_id_t msg_id;
+    MsgHandlerCallback_t callback;
+} registry[TEST_REGISTRY_MAX];
+static uint32_t registry_count;
+
+// Rows called by the message being replayed
+static uint8_t calls[TEST_CALLS_MAX];
+static uint32_t call_count;
+static ke_msg_id_t replayed_id;
+
+static int failures;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+void MsgHandler_Add(ke_msg_id_t msg_id, MsgHandlerCallback_t callback)
+{
+    if (registry_count < TEST_REGISTRY_MAX)
+    {
+        registry[registry_count].msg_id = msg_id;
+        registry[registry_count].callback = callback;
+    }
+    registry_count++;
+}
+
+void Profile_Update(struct profile_stats_t *stats, uint32_t cycles)
+{
+    for (uint8_t row = 0; row < AppDispatch_Rows(); row++)
+    {
+        if (AppDispatch_GetStats(row) == stats)
+        {
+            if (call_count < TEST_CALLS_MAX)
+            {
+                calls[call_count] = row;
+            }
+            call_count++;
+        }
+    }
+
+    stats->count++;
+    stats->total_cycles += cycles;
+}
+
+void AppLog_Write(uint8_t level, const char *fmt, const uint32_t *args, uint8_t nargs)
+{
+}
+
+// Handlers of the table, except the dispatcher's own, check what they get
+#define TEST_HANDLER_STUB(handler)                                             \
+    void handler(ke_msg_id_t const msg_id, void const *param,                  \
+                 ke_task_id_t const dest_id, ke_task_id_t const src_id)        \
+    {                                                                          \
+        if ((msg_id != replayed_id) || (dest_id != TASK_APP))                  \
+        {                                                                      \
+            printf("%s: got 0x%04x for 0x%04x\n", #handler, msg_id, replayed_id); \
+            failures++;                                                        \
+        }                                                                      \
+    }
+
+TEST_HANDLER_STUB(CUSTOMSS_MsgHandler)
+TEST_HANDLER_STUB(BLE_ConfigHandler)
+TEST_HANDLER_STUB(Adv_MsgHandler)
+TEST_HANDLER_STUB(Group_MsgHandler)
+TEST_HANDLER_STUB(Relay_MsgHandler)
+TEST_HANDLER_STUB(BLE_ConnectionHandler)
+TEST_HANDLER_STUB(ConnPolicy_MsgHandler)
+TEST_HANDLER_STUB(Link_MsgHandler)
+TEST_HANDLER_STUB(NtfQueue_MsgHandler)
+TEST_HANDLER_STUB(Bench_MsgHandler)
+TEST_HANDLER_STUB(Sensor_MsgHandler)
+TEST_HANDLER_STUB(Stream_MsgHandler)
+TEST_HANDLER_STUB(History_MsgHandler)
+TEST_HANDLER_STUB(BLE_PairingHandler)
+TEST_HANDLER_STUB(Clock_MsgHandler)
+TEST_HANDLER_STUB(LEDHandler)
+TEST_HANDLER_STUB(BattLevelReadHandler)
+TEST_HANDLER_STUB(SW1Handler)
+TEST_HANDLER_STUB(SW1LEDHandler)
+TEST_HANDLER_STUB(Power_MsgHandler)
+TEST_HANDLER_STUB(Energy_MsgHandler)
+TEST_HANDLER_STUB(AppTimer_MsgHandler)
+TEST_HANDLER_STUB(AppSched_MsgHandler)
+TEST_HANDLER_STUB(Boot_MsgHandler)
+TEST_HANDLER_STUB(KV_MsgHandler)
+TEST_HANDLER_STUB(Profile_MsgHandler)
+
+/* Function      : Test_Deliver
+ *
+ * Description   : Deliver a message to the application task as the kernel
+ *                 does, through every callback registered for its ID.
+ *
+ * Parameters    : ke_msg_id_t msg_id : Kernel message ID number
+ *
+ * Returns       : None
+ */
+static void Test_Deliver(ke_msg_id_t msg_id)
+{
+    replayed_id = msg_id;
+    call_count = 0;
+
+    for (uint32_t i = 0; (i < registry_count) && (i < TEST_REGISTRY_MAX); i++)
+    {
+        if (registry[i].msg_id == msg_id)
+        {
+            registry[i].callback(msg_id, NULL, TASK_APP, TASK_APP);
+        }
+    }
+}
+
+/* Function      : Test_Registrations
+ *
+ * Description   : Check that every message ID of the table is registered
+ *                 once, to the dispatcher.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Test_Registrations(void)
+{
+    uint32_t ids = 0;
+
+    for (uint32_t row = 0; row < TEST_ROWS; row++)
+    {
+        uint32_t found = 0;
+        bool first = true;
+
+        for (uint32_t before = 0; before < row; before++)
+        {
+            first = first && (test_row[before].msg_id != test_row[row].msg_id);
+        }
+
+        if (!first)
+        {
+            continue;
+        }
+        ids++;
+
+        for (uint32_t i = 0; (i < registry_count) && (i < TEST_REGISTRY_MAX); i++)
+        {
+            if (registry[i].msg_id == test_row[row].msg_id)
+            {
+                found++;
+                if (registry[i].callback != AppDispatch_Handler)
+                {
+                    printf("%s: registered to another callback\n", test_row[row].msg_name);
+                    failures++;
+                }
+            }
+        }
+
+        if (found != 1)
+        {
+            printf("%s: registered %u times\n", test_row[row].msg_name, found);
+            failures++;
+        }
+    }
+
+    if ((registry_count != ids) || (AppDispatch_Rows() != TEST_ROWS))
+    {
+        printf("%u registrations for %u message IDs, %u rows for %u\n",
+               registry_count, ids, AppDispatch_Rows(), (uint32_t)TEST_ROWS);
+        failures++;
+    }
+}
+
+/* Function      : Test_Outside
+ *
+ * Description   : Check that a message ID outside the table reaches no
+ *                 handler.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Test_Outside(void)
+{
+    ke_msg_id_t msg_id = TASK_FIRST_MSG(TASK_ID_APP);
+
+    AppDispatch_Handler(msg_id, NULL, TASK_APP, TASK_APP);
+
+    if ((AppDispatch_FanOut(msg_id) != 0) || (call_count != 0))
+    {
+        printf("0x%04x: outside the table but dispatched\n", msg_id);
+        failures++;
+    }
+}
+
+/* Function      : Test_Replay
+ *
+ * Description   : Replay a trace file, one message per line followed by
+ *                 the handlers it must reach ('#' starts a comment).
+ *
+ * Parameters    : const char *path : trace file
+ *
+ * Returns       : uint32_t : messages replayed
+ */
+static uint32_t Test_Replay(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[512];
+    uint32_t number = 0;
+    uint32_t messages = 0;
+
+    if (file == NULL)
+    {
+        printf("%s: cannot open\n", path);
+        failures++;
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        char *name = strtok(line, " \t\r\n");
+        char *handler;
+        ke_msg_id_t msg_id = 0;
+        bool known = false;
+        uint32_t expected = 0;
+
+        number++;
+        if ((name == NULL) || (name[0] == '#'))
+        {
+            continue;
+        }
+
+        for (uint32_t row = 0; row < TEST_ROWS; row++)
+        {
+            if (strcmp(test_row[row].msg_name, name) == 0)
+            {
+                msg_id = test_row[row].msg_id;
+                known = true;
+            }
+        }
+
+        if (!known)
+        {
+            printf("%s:%u: %s is not in APP_DISPATCH_TABLE\n", path, number, name);
+            failures++;
+            continue;
+        }
+
+        Test_Deliver(msg_id);
+        messages++;
+
+        while ((handler = strtok(NULL, " \t\r\n")) != NULL)
+        {
+            if ((expected >= call_count) || (expected >= TEST_CALLS_MAX) ||
+                (strcmp(test_row[calls[expected]].handler, handler) != 0))
+            {
+                printf("%s:%u: %s: handler %u is %s, expected %s\n", path, number, name,
+                       expected + 1, (expected < call_count) ?
+                       test_row[calls[expected]].handler : "missing", handler);
+                failures++;
+            }
+            expected++;
+        }
+
+        if (call_count != expected)
+        {
+            printf("%s:%u: %s reached %u handlers, expected %u\n",
+                   path, number, name, call_count, expected);
+            failures++;
+        }
+
+        if (AppDispatch_FanOut(msg_id) != call_count)
+        {
+            printf("%s:%u: %s fan-out %u, %u handlers reached\n",
+                   path, number, name, AppDispatch_FanOut(msg_id), call_count);
+            failures++;
+        }
+    }
+
+    fclose(file);
+
+    return messages;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t messages = 0;
+
+    AppDispatch_Initialize();
+    Test_Registrations();
+    Test_Outside();
+
+    for (int i = 1; i < argc; i++)
+    {
+        messages += Test_Replay(argv[i]);
+    }
+
+    if (messages == 0)
+    {
+        printf("no message replayed\n");
+        failures++;
+    }
+
+    // The statistics report walks every row
+    AppDispatch_MsgHandler(GAPC_DISCONNECT_IND, NULL, TASK_APP, TASK_APP);
+
+    printf("test_dispatch: %u messages replayed, %s\n", messages,
+           (failures == 0) ? "PASS" : "FAIL");
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
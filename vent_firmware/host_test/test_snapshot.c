@@ -0,0 +1,172 @@
+/******************************************************************************
+ * File Name        : test_snapshot.c
+ * Description      : Host hammer test of the double-buffered sensor snapshot
+ *                    (app_snapshot.c). A writer thread publishes samples as
+ *                    fast as it can while reader threads copy the whole
+ *                    snapshot with Snapshot_Read, standing in for the
+ *                    attribute reads served from the BLE interrupt.
+ *
+ *                    Every sample the writer publishes is self-consistent
+ *                    (humidity and battery derived from the temperature),
+ *                    so a copy that mixes two samples, or one taken from a
+ *                    buffer being written, is detected. The sequence number
+ *                    a reader sees must never go backwards.
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <app.h>
+#include <app_snapshot.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+// Samples published, temperatures stay exact in a float below 2^24
+#define TEST_SAMPLES                    (2000000)
+#define TEST_READERS                    (3)
+
+struct reader_result_t
+{
+    uint32_t reads;
+    uint32_t torn;                      // copies mixing two samples
+    uint32_t backwards;                 // sequence number went backwards
+    uint32_t mismatched;                // returned and copied seq differ
+};
+
+static volatile bool writer_done;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : writer
+ *
+ * Description   : Publish TEST_SAMPLES consistent samples.
+ *
+ * Parameters    : void *arg : unused
+ *
+ * Returns       : void * : NULL
+ */
+static void *writer(void *arg)
+{
+    (void)arg;
+
+    for (uint32_t i = 1; i <= TEST_SAMPLES; i++)
+    {
+        struct sensor_snapshot_t *back = Snapshot_BeginUpdate();
+
+        back->temperature = (float)i;
+        back->humidity = (float)i + 0.5f;
+        back->battery = (uint8_t)i;
+        Snapshot_Publish();
+    }
+
+    __atomic_store_n(&writer_done, true, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+/* Function      : reader
+ *
+ * Description   : Copy the whole snapshot until the writer is done and
+ *                 check every copy.
+ *
+ * Parameters    : void *arg : struct reader_result_t to fill
+ *
+ * Returns       : void * : NULL
+ */
+static void *reader(void *arg)
+{
+    struct reader_result_t *result = arg;
+    struct sensor_snapshot_t copy;
+    uint32_t last = 0;
+
+    while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE))
+    {
+        uint32_t seq = Snapshot_Read(0, (uint8_t *)&copy, sizeof(copy));
+
+        result->reads++;
+
+        if (seq != copy.seq)
+        {
+            result->mismatched++;
+        }
+
+        if (seq < last)
+        {
+            result->backwards++;
+        }
+        last = seq;
+
+        // The initial snapshot is all zero
+        if ((copy.temperature != 0.0f) &&
+            ((copy.humidity != (copy.temperature + 0.5f)) ||
+             (copy.battery != (uint8_t)(uint32_t)copy.temperature)))
+        {
+            result->torn++;
+        }
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t writer_thread;
+    pthread_t reader_thread[TEST_READERS];
+    struct reader_result_t result[TEST_READERS];
+    struct sensor_snapshot_t last;
+    int failures = 0;
+
+    memset(result, 0, sizeof(result));
+    Snapshot_Initialize();
+
+    for (int i = 0; i < TEST_READERS; i++)
+    {
+        pthread_create(&reader_thread[i], NULL, reader, &result[i]);
+    }
+    pthread_create(&writer_thread, NULL, writer, NULL);
+
+    pthread_join(writer_thread, NULL);
+    for (int i = 0; i < TEST_READERS; i++)
+    {
+        pthread_join(reader_thread[i], NULL);
+    }
+
+    for (int i = 0; i < TEST_READERS; i++)
+    {
+        printf("reader %d: %u reads, %u torn, %u backwards, %u mismatched\n",
+               i, result[i].reads, result[i].torn, result[i].backwards,
+               result[i].mismatched);
+
+        if ((result[i].reads == 0) || (result[i].torn != 0) ||
+            (result[i].backwards != 0) || (result[i].mismatched != 0))
+        {
+            failures++;
+        }
+    }
+
+    // The last sample published is the one read back
+    Snapshot_Read(0, (uint8_t *)&last, sizeof(last));
+    if ((last.seq != (TEST_SAMPLES + 1)) || (last.temperature != (float)TEST_SAMPLES))
+    {
+        printf("last snapshot: seq %u, temperature %.1f\n", last.seq, last.temperature);
+        failures++;
+    }
+
+    printf("test_snapshot: %s\n", (failures == 0) ? "PASS" : "FAIL");
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,344 @@
+/******************************************************************************
+ * File Name        : test_timer.c
+ * Description      : Host test of the application timer service
+ *                    (app_timer.c), built with APP_TIMER_HOST so the
+ *                    expiries run on the virtual clock moved by
+ *                    AppTimer_HostAdvance. Each callback records the time
+ *                    it ran at; the cases check:
+ *
+ *                      - a one-shot timer runs once, at its deadline
+ *                      - a periodic timer runs every period until cancelled
+ *                      - a callback cancelling its own periodic timer, or
+ *                        restarting its own one-shot timer
+ *                      - a callback cancelling another timer before it is
+ *                        due, and restarting one that is
+ *                      - APP_TIMER_MAX timers running: one more is refused
+ *                        and left stopped, a running one still restarts
+ *                      - timers started in a scrambled order run in
+ *                        deadline order
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <app_timer.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define TEST_RUNS_MAX                   (64)
+
+#define TEST_CHECK(cond)                                                       \
+    do                                                                         \
+    {                                                                          \
+        if (!(cond))                                                           \
+        {                                                                      \
+            printf("%s:%d: %s\n", __func__, __LINE__, #cond);                  \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+struct test_timer_t
+{
+    struct app_timer_t timer;
+    uint32_t runs;
+    uint64_t at[TEST_RUNS_MAX];     // AppTimer_Now() of each run
+    uint32_t stop_after;            // cancel (or stop restarting) after
+    struct test_timer_t *other;     // cancelled by Test_CancelOther
+};
+
+// Order the callbacks ran in, by timer
+static struct test_timer_t *order[TEST_RUNS_MAX];
+static uint32_t order_count;
+
+static int failures;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Test_Record
+ *
+ * Description   : Record a run of a test timer.
+ *
+ * Parameters    : struct test_timer_t *t : test timer
+ *
+ * Returns       : None
+ */
+static void Test_Record(struct test_timer_t *t)
+{
+    if (t->runs < TEST_RUNS_MAX)
+    {
+        t->at[t->runs] = AppTimer_Now();
+    }
+    t->runs++;
+
+    if (order_count < TEST_RUNS_MAX)
+    {
+        order[order_count] = t;
+    }
+    order_count++;
+}
+
+static void Test_Count(void *context)
+{
+    Test_Record(context);
+}
+
+static void Test_CancelSelf(void *context)
+{
+    struct test_timer_t *t = context;
+
+    Test_Record(t);
+    if (t->runs == t->stop_after)
+    {
+        AppTimer_Cancel(&t->timer);
+    }
+}
+
+static void Test_RestartSelf(void *context)
+{
+    struct test_timer_t *t = context;
+
+    Test_Record(t);
+    if (t->runs < t->stop_after)
+    {
+        TEST_CHECK(AppTimer_Start(&t->timer, APP_TIMER_MS(3), 0, Test_RestartSelf, t));
+    }
+}
+
+static void Test_CancelOther(void *context)
+{
+    struct test_timer_t *t = context;
+
+    Test_Record(t);
+    AppTimer_Cancel(&t->other->timer);
+}
+
+static void Test_RestartOther(void *context)
+{
+    struct test_timer_t *t = context;
+
+    Test_Record(t);
+    TEST_CHECK(AppTimer_Start(&t->other->timer, APP_TIMER_MS(10), 0, Test_Count, t->other));
+}
+
+/* Function      : Test_Clear
+ *
+ * Description   : Stop and clear test timers.
+ *
+ * Parameters    : struct test_timer_t *t : test timers
+ *                 uint32_t count         : number of timers
+ *
+ * Returns       : None
+ */
+static void Test_Clear(struct test_timer_t *t, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        AppTimer_Cancel(&t[i].timer);
+        memset(&t[i], 0, sizeof(t[i]));
+    }
+
+    order_count = 0;
+}
+
+static void Test_OneShot(void)
+{
+    struct test_timer_t t = { 0 };
+    uint64_t start = AppTimer_Now();
+
+    TEST_CHECK(AppTimer_Start(&t.timer, APP_TIMER_US(1500), 0, Test_Count, &t));
+    TEST_CHECK(AppTimer_IsRunning(&t.timer));
+
+    AppTimer_HostAdvance(1499);
+    TEST_CHECK(t.runs == 0);
+
+    AppTimer_HostAdvance(1);
+    TEST_CHECK(t.runs == 1);
+    TEST_CHECK(t.at[0] == start + 1500);
+    TEST_CHECK(!AppTimer_IsRunning(&t.timer));
+
+    AppTimer_HostAdvance(APP_TIMER_S(10));
+    TEST_CHECK(t.runs == 1);
+
+    // A zero delay runs on the next advance, not from AppTimer_Start
+    TEST_CHECK(AppTimer_Start(&t.timer, 0, 0, Test_Count, &t));
+    TEST_CHECK(t.runs == 1);
+    AppTimer_HostAdvance(0);
+    TEST_CHECK(t.runs == 2);
+}
+
+static void Test_Periodic(void)
+{
+    struct test_timer_t t = { 0 };
+    uint64_t start = AppTimer_Now();
+
+    TEST_CHECK(AppTimer_Start(&t.timer, APP_TIMER_MS(1), APP_TIMER_US(250), Test_Count, &t));
+
+    AppTimer_HostAdvance(2000);
+    TEST_CHECK(t.runs == 5);
+    for (uint32_t i = 0; (i < t.runs) && (i < TEST_RUNS_MAX); i++)
+    {
+        TEST_CHECK(t.at[i] == start + 1000 + i * 250);
+    }
+    TEST_CHECK(AppTimer_IsRunning(&t.timer));
+
+    AppTimer_Cancel(&t.timer);
+    TEST_CHECK(!AppTimer_IsRunning(&t.timer));
+    AppTimer_HostAdvance(APP_TIMER_S(1));
+    TEST_CHECK(t.runs == 5);
+
+    // Cancelling a stopped timer does nothing
+    AppTimer_Cancel(&t.timer);
+    TEST_CHECK(!AppTimer_IsRunning(&t.timer));
+}
+
+static void Test_FromCallback(void)
+{
+    struct test_timer_t t[2];
+    uint64_t start = AppTimer_Now();
+
+    memset(t, 0, sizeof(t));
+
+    t[0].stop_after = 3;
+    TEST_CHECK(AppTimer_Start(&t[0].timer, APP_TIMER_MS(1), APP_TIMER_MS(1),
+                              Test_CancelSelf, &t[0]));
+    t[1].stop_after = 4;
+    TEST_CHECK(AppTimer_Start(&t[1].timer, APP_TIMER_MS(3), 0, Test_RestartSelf, &t[1]));
+
+    AppTimer_HostAdvance(APP_TIMER_MS(100));
+
+    TEST_CHECK(t[0].runs == 3);
+    TEST_CHECK(!AppTimer_IsRunning(&t[0].timer));
+    TEST_CHECK(t[1].runs == 4);
+    TEST_CHECK(!AppTimer_IsRunning(&t[1].timer));
+    TEST_CHECK(t[1].at[3] == start + APP_TIMER_MS(12));
+
+    Test_Clear(t, 2);
+}
+
+static void Test_Other(void)
+{
+    struct test_timer_t t[4];
+    uint64_t start = AppTimer_Now();
+
+    memset(t, 0, sizeof(t));
+
+    // t[0] cancels t[1] before it is due
+    t[0].other = &t[1];
+    TEST_CHECK(AppTimer_Start(&t[0].timer, APP_TIMER_MS(1), 0, Test_CancelOther, &t[0]));
+    TEST_CHECK(AppTimer_Start(&t[1].timer, APP_TIMER_MS(2), 0, Test_Count, &t[1]));
+
+    // t[2] pushes t[3], due at the same time, 10 ms later
+    t[2].other = &t[3];
+    TEST_CHECK(AppTimer_Start(&t[2].timer, APP_TIMER_MS(5), 0, Test_RestartOther, &t[2]));
+    TEST_CHECK(AppTimer_Start(&t[3].timer, APP_TIMER_MS(6), 0, Test_Count, &t[3]));
+
+    AppTimer_HostAdvance(APP_TIMER_MS(100));
+
+    TEST_CHECK(t[0].runs == 1);
+    TEST_CHECK(t[1].runs == 0);
+    TEST_CHECK(t[2].runs == 1);
+    TEST_CHECK(t[3].runs == 1);
+    TEST_CHECK(t[3].at[0] == start + APP_TIMER_MS(15));
+
+    Test_Clear(t, 4);
+}
+
+static void Test_Overflow(void)
+{
+    struct test_timer_t t[APP_TIMER_MAX + 1];
+    uint64_t start = AppTimer_Now();
+
+    memset(t, 0, sizeof(t));
+
+    for (uint32_t i = 0; i < APP_TIMER_MAX; i++)
+    {
+        TEST_CHECK(AppTimer_Start(&t[i].timer, APP_TIMER_MS(1 + i), 0, Test_Count, &t[i]));
+    }
+
+    // Full: refused and left stopped
+    TEST_CHECK(!AppTimer_Start(&t[APP_TIMER_MAX].timer, APP_TIMER_MS(1), 0,
+                               Test_Count, &t[APP_TIMER_MAX]));
+    TEST_CHECK(!AppTimer_IsRunning(&t[APP_TIMER_MAX].timer));
+
+    // A running timer takes no new place, it still restarts
+    TEST_CHECK(AppTimer_Start(&t[0].timer, APP_TIMER_MS(50), 0, Test_Count, &t[0]));
+
+    // Place freed by a cancel
+    AppTimer_Cancel(&t[1].timer);
+    TEST_CHECK(AppTimer_Start(&t[APP_TIMER_MAX].timer, APP_TIMER_MS(20), 0,
+                              Test_Count, &t[APP_TIMER_MAX]));
+
+    AppTimer_HostAdvance(APP_TIMER_MS(100));
+
+    TEST_CHECK(t[0].runs == 1);
+    TEST_CHECK(t[0].at[0] == start + APP_TIMER_MS(50));
+    TEST_CHECK(t[1].runs == 0);
+    for (uint32_t i = 2; i <= APP_TIMER_MAX; i++)
+    {
+        TEST_CHECK(t[i].runs == 1);
+    }
+
+    // Every place free again
+    for (uint32_t i = 0; i < APP_TIMER_MAX; i++)
+    {
+        TEST_CHECK(AppTimer_Start(&t[i].timer, APP_TIMER_MS(1), 0, Test_Count, &t[i]));
+    }
+    TEST_CHECK(!AppTimer_Start(&t[APP_TIMER_MAX].timer, APP_TIMER_MS(1), 0,
+                               Test_Count, &t[APP_TIMER_MAX]));
+
+    Test_Clear(t, APP_TIMER_MAX + 1);
+}
+
+static void Test_Order(void)
+{
+    struct test_timer_t t[APP_TIMER_MAX];
+    uint64_t start = AppTimer_Now();
+
+    memset(t, 0, sizeof(t));
+
+    // 7 is coprime with APP_TIMER_MAX: every delay once, scrambled
+    for (uint32_t i = 0; i < APP_TIMER_MAX; i++)
+    {
+        uint32_t delay = APP_TIMER_US(100 + ((i * 7) % APP_TIMER_MAX) * 100);
+
+        TEST_CHECK(AppTimer_Start(&t[i].timer, delay, 0, Test_Count, &t[i]));
+    }
+
+    AppTimer_HostAdvance(APP_TIMER_S(1));
+
+    TEST_CHECK(order_count == APP_TIMER_MAX);
+    for (uint32_t i = 0; (i < order_count) && (i < TEST_RUNS_MAX); i++)
+    {
+        TEST_CHECK(order[i]->at[0] == start + 100 + i * 100);
+    }
+
+    Test_Clear(t, APP_TIMER_MAX);
+}
+
+int main(void)
+{
+    Test_OneShot();
+    Test_Periodic();
+    Test_FromCallback();
+    Test_Other();
+    Test_Overflow();
+    Test_Order();
+
+    printf("test_timer: %s\n", (failures == 0) ? "PASS" : "FAIL");
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,358 @@
+/******************************************************************************
+ * File Name        : test_write_latency.c
+ * Description      : Host test of the write to response latency of the
+ *                    custom service (app_customss.c). The attribute write
+ *                    callbacks of the vent state, LED and temperature
+ *                    thresholds are called directly and timed with the host
+ *                    clock, in two forms:
+ *
+ *                      - inline: the callback, then its deferred message
+ *                        handled before returning, as the write was applied
+ *                        before the write response until c5971b1
+ *                      - deferred: the callback alone, the write response
+ *                        follows its return; the message is handled after
+ *
+ *                    In the inline form set_vent_state is stubbed with the
+ *                    blocking servo move the firmware had then
+ *                    (SERVO_TRAVEL_MS); the servo now moves on a timer and
+ *                    the stub returns at once. Checks along the way:
+ *
+ *                      - a deferred write returns before its side effect,
+ *                        which runs once from the posted message
+ *                      - invalid writes are refused and post nothing
+ *                      - the deferred form stays below
+ *                        TEST_DEFERRED_MAX_US
+ *
+ *                    The figures are printed per characteristic (median and
+ *                    maximum over TEST_RUNS writes).
+ *
+ * Author           : Pierino Zindel
+ * Version          : 1.0.0
+ * Last Rev. Date   : October 19, 2026
+ ******************************************************************************
+ */
+
+
+/* ----------------------------------------------------------------------------
+ * Include files
+ * --------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include <app.h>
+
+
+/* ----------------------------------------------------------------------------
+ * Global variables and types
+ * --------------------------------------------------------------------------*/
+#define TEST_RUNS                       (3)
+#define TEST_MSG_MAX                    (8)
+#define TEST_MSG_PARAM_MAX              (32)
+
+// Deferred form bound, far above the few microseconds it takes, so a busy
+// host does not fail the test
+#define TEST_DEFERRED_MAX_US            (1000)
+
+#define TEST_CHECK(cond)                                                       \
+    do                                                                         \
+    {                                                                          \
+        if (!(cond))                                                           \
+        {                                                                      \
+            printf("%s:%d: %s\n", __func__, __LINE__, #cond);                  \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+typedef uint8_t (*test_callback_t)(uint8_t conidx, uint16_t attidx, uint16_t handle,
+                                   uint8_t *to, const uint8_t *from,
+                                   uint16_t length, uint16_t operation,
+                                   uint8_t hl_status);
+
+// Messages sent by the module, handled by Test_RunMessages
+static struct
+{
+    ke_msg_id_t id;
+    ke_task_id_t dest_id;
+    ke_task_id_t src_id;
+    uint8_t param[TEST_MSG_PARAM_MAX];
+} msg_pool[TEST_MSG_MAX];
+static uint32_t msg_alloc_count;
+static void *msg_queue[TEST_MSG_MAX];
+static uint32_t msg_queue_count;
+
+// Calls of the stubbed servo, blocking for the inline form
+static uint32_t servo_calls;
+static uint8_t servo_state;
+static bool servo_blocking;
+
+static int failures;
+
+EncodedFloat temperature_upper_threshold;
+EncodedFloat temperature_lower_threshold;
+static uint8_t vent_state_var;
+uint8_t *vent_state = &vent_state_var;
+
+
+/* ----------------------------------------------------------------------------
+ * Function definitions
+ * --------------------------------------------------------------------------*/
+
+/* Function      : Test_NowNs
+ *
+ * Description   : Returns the host monotonic clock.
+ *
+ * Parameters    : None
+ *
+ * Returns       : uint64_t : time (ns)
+ */
+static uint64_t Test_NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+void set_vent_state(uint8_t state)
+{
+    uint64_t end = Test_NowNs() + ((uint64_t)SERVO_TRAVEL_MS * 1000000U);
+
+    servo_calls++;
+    servo_state = state;
+
+    // The former servo move blocked for its travel time
+    while (servo_blocking && (Test_NowNs() < end))
+    {
+    }
+}
+
+void vent_update(void)
+{
+    set_vent_state(*vent_state);
+}
+
+void vent_threshold_check(void)
+{
+}
+
+void * ke_msg_alloc(ke_msg_id_t id, ke_task_id_t dest_id, ke_task_id_t src_id,
+                    uint16_t param_len)
+{
+    uint32_t index = msg_alloc_count++ % TEST_MSG_MAX;
+
+    TEST_CHECK(param_len <= TEST_MSG_PARAM_MAX);
+
+    msg_pool[index].id = id;
+    msg_pool[index].dest_id = dest_id;
+    msg_pool[index].src_id = src_id;
+    return msg_pool[index].param;
+}
+
+void ke_msg_send(void const *param)
+{
+    if (msg_queue_count < TEST_MSG_MAX)
+    {
+        msg_queue[msg_queue_count] = (void *)param;
+    }
+    msg_queue_count++;
+}
+
+/* Function      : Test_RunMessages
+ *
+ * Description   : Handle the messages sent so far, as the app task does.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Test_RunMessages(void)
+{
+    for (uint32_t i = 0; (i < msg_queue_count) && (i < TEST_MSG_MAX); i++)
+    {
+        for (uint32_t m = 0; m < TEST_MSG_MAX; m++)
+        {
+            if (msg_pool[m].param == msg_queue[i])
+            {
+                CUSTOMSS_MsgHandler(msg_pool[m].id, msg_pool[m].param,
+                                    msg_pool[m].dest_id, msg_pool[m].src_id);
+            }
+        }
+    }
+
+    msg_queue_count = 0;
+}
+
+// Calls of the module outside the write path
+void ke_msg_send_basic(ke_msg_id_t id, ke_task_id_t dest_id, ke_task_id_t src_id) {}
+void ke_timer_set(ke_msg_id_t timer_id, ke_task_id_t task, uint32_t delay) {}
+void ke_timer_clear(ke_msg_id_t timer_id, ke_task_id_t task) {}
+bool GAPC_IsConnectionActive(uint8_t conidx) { return true; }
+struct gatt_env_tag * GATT_GetEnv(void) { static struct gatt_env_tag env; return &env; }
+uint16_t GATTM_GetHandle(uint8_t svcidx, uint16_t attidx) { return (uint16_t)((svcidx << 8) | attidx); }
+void Sys_GPIO_Set_High(uint32_t gpio) {}
+void Sys_GPIO_Set_Low(uint32_t gpio) {}
+uint32_t Sys_GPIO_Read(uint32_t gpio) { return 1; }
+void AppLog_Write(uint8_t level, const char *fmt, const uint32_t *args, uint8_t nargs) {}
+void AppLog_WriteBuffer(uint8_t level, const char *fmt, const uint8_t *data, uint16_t length) {}
+void Profile_Record(uint8_t probe, uint32_t cycles) {}
+void ConnPolicy_RequestActive(uint8_t conidx) {}
+void Adv_Kick(void) {}
+void KV_Set(uint8_t key, const void *value) {}
+void Group_SetZone(uint8_t zone) {}
+void Group_SetKey(const uint8_t *key, uint32_t seq_floor) {}
+void Link_PackInfo(uint8_t conidx, uint8_t *out) {}
+void Battery_PackHealth(uint8_t *out) {}
+void Energy_PackInfo(uint8_t *out) {}
+bool Bench_ValidateCommand(const uint8_t *value, uint16_t length) { return true; }
+void Bench_Post(uint8_t conidx, const uint8_t *value) {}
+void Bench_PackResult(uint8_t *out) {}
+bool NtfQueue_Push(uint8_t conidx, uint8_t operation, uint16_t handle,
+                   uint16_t length, const uint8_t *value) { return true; }
+const struct sensor_snapshot_t * Snapshot_Get(void) { return NULL; }
+uint32_t Snapshot_Read(uint16_t offset, uint8_t *to, uint16_t length) { return 0; }
+bool Sensor_IsFresh(void) { return true; }
+void Sensor_Request(void) {}
+void Sensor_SetMaxAge(uint16_t max_age_s) {}
+bool AppSched_Post(uint8_t task, uint32_t arg) { return true; }
+
+static int Test_CompareNs(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Function      : Test_Write
+ *
+ * Description   : Time TEST_RUNS writes of a characteristic in both forms
+ *                 and print the figures.
+ *
+ * Parameters    : const char *name          : characteristic name
+ *                 test_callback_t callback  : attribute write callback
+ *                 const uint8_t *value      : values written, in turn
+ *                 uint16_t length           : length of each value
+ *                 uint32_t servo_moves      : servo calls per write
+ *                 uint64_t *deferred_max_ns : worst deferred form, updated
+ *
+ * Returns       : None
+ */
+static void Test_Write(const char *name, test_callback_t callback,
+                       const uint8_t *value, uint16_t length,
+                       uint32_t servo_moves, uint64_t *deferred_max_ns)
+{
+    uint64_t inline_ns[TEST_RUNS];
+    uint64_t deferred_ns[TEST_RUNS];
+    uint8_t to[CS_TEMPERATURE_MAX_LENGTH];
+
+    for (uint32_t i = 0; i < TEST_RUNS; i++)
+    {
+        const uint8_t *from = &value[(i % 2) * length];
+        uint64_t start;
+        uint8_t status;
+
+        // Inline: applied before the response
+        servo_calls = 0;
+        servo_blocking = true;
+        start = Test_NowNs();
+        status = callback(0, 0, 0, to, from, length, GATTC_WRITE_REQ_IND, GAP_ERR_NO_ERROR);
+        Test_RunMessages();
+        inline_ns[i] = Test_NowNs() - start;
+        servo_blocking = false;
+
+        TEST_CHECK(status == ATT_ERR_NO_ERROR);
+        TEST_CHECK(servo_calls == servo_moves);
+
+        // Deferred: the response follows the callback
+        servo_calls = 0;
+        start = Test_NowNs();
+        status = callback(0, 0, 0, to, from, length, GATTC_WRITE_REQ_IND, GAP_ERR_NO_ERROR);
+        deferred_ns[i] = Test_NowNs() - start;
+
+        TEST_CHECK(status == ATT_ERR_NO_ERROR);
+        TEST_CHECK(servo_calls == 0);
+        TEST_CHECK(msg_queue_count == 1);
+        Test_RunMessages();
+        TEST_CHECK(servo_calls == servo_moves);
+    }
+
+    qsort(inline_ns, TEST_RUNS, sizeof(inline_ns[0]), Test_CompareNs);
+    qsort(deferred_ns, TEST_RUNS, sizeof(deferred_ns[0]), Test_CompareNs);
+
+    printf("test_write_latency: %-9s inline %10.1f us (max %10.1f), "
+           "deferred %5.1f us (max %5.1f)\n", name,
+           inline_ns[TEST_RUNS / 2] / 1000.0, inline_ns[TEST_RUNS - 1] / 1000.0,
+           deferred_ns[TEST_RUNS / 2] / 1000.0, deferred_ns[TEST_RUNS - 1] / 1000.0);
+
+    if (servo_moves != 0)
+    {
+        TEST_CHECK(inline_ns[0] >= (uint64_t)SERVO_TRAVEL_MS * 1000000U);
+    }
+
+    if (deferred_ns[TEST_RUNS - 1] > *deferred_max_ns)
+    {
+        *deferred_max_ns = deferred_ns[TEST_RUNS - 1];
+    }
+}
+
+/* Function      : Test_Refused
+ *
+ * Description   : Check that invalid writes are refused and post nothing.
+ *
+ * Parameters    : None
+ *
+ * Returns       : None
+ */
+static void Test_Refused(void)
+{
+    uint8_t to[CS_TEMPERATURE_MAX_LENGTH];
+    uint8_t state[2] = { 2, 0 };
+    EncodedFloat threshold = { .value = NAN };
+
+    msg_queue_count = 0;
+
+    TEST_CHECK(CUSTOMSS_VentCharCallback(0, 0, 0, to, state, 1, GATTC_WRITE_REQ_IND,
+                                         GAP_ERR_NO_ERROR) == ATT_ERR_APP_ERROR);
+    TEST_CHECK(CUSTOMSS_VentCharCallback(0, 0, 0, to, state, 2, GATTC_WRITE_REQ_IND,
+                                         GAP_ERR_NO_ERROR) == ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN);
+    TEST_CHECK(CUSTOMSS_LEDCharCallback(0, 0, 0, to, state, 1, GATTC_WRITE_REQ_IND,
+                                        GAP_ERR_NO_ERROR) == ATT_ERR_APP_ERROR);
+    TEST_CHECK(CUSTOMSS_TempUTHRCharCallback(0, 0, 0, to, threshold.bytes,
+                                             CS_TEMPERATURE_MAX_LENGTH, GATTC_WRITE_REQ_IND,
+                                             GAP_ERR_NO_ERROR) == ATT_ERR_APP_ERROR);
+    TEST_CHECK(CUSTOMSS_TempLTHRCharCallback(0, 0, 0, to, threshold.bytes, 2,
+                                             GATTC_WRITE_REQ_IND,
+                                             GAP_ERR_NO_ERROR) == ATT_ERR_INVALID_ATTRIBUTE_VAL_LEN);
+
+    TEST_CHECK(msg_queue_count == 0);
+}
+
+int main(void)
+{
+    static const uint8_t states[2] = { VENT_CLOSED_STATE, VENT_OPEN_STATE };
+    EncodedFloat thresholds[2] = { { .value = 27.5f }, { .value = 18.0f } };
+    uint64_t deferred_max_ns = 0;
+
+    CUSTOMSS_Initialize();
+
+    Test_Write("VENT", CUSTOMSS_VentCharCallback, states, 1, 1, &deferred_max_ns);
+    TEST_CHECK(servo_state == states[(TEST_RUNS - 1) % 2]);
+
+    Test_Write("LED", CUSTOMSS_LEDCharCallback, states, 1, 1, &deferred_max_ns);
+
+    Test_Write("TEMP_UTHR", CUSTOMSS_TempUTHRCharCallback, thresholds[0].bytes,
+               CS_TEMPERATURE_MAX_LENGTH, 0, &deferred_max_ns);
+    TEST_CHECK(temperature_upper_threshold.value == thresholds[(TEST_RUNS - 1) % 2].value);
+
+    Test_Write("TEMP_LTHR", CUSTOMSS_TempLTHRCharCallback, thresholds[0].bytes,
+               CS_TEMPERATURE_MAX_LENGTH, 0, &deferred_max_ns);
+    TEST_CHECK(temperature_lower_threshold.value == thresholds[(TEST_RUNS - 1) % 2].value);
+
+    Test_Refused();
+
+    TEST_CHECK(deferred_max_ns <= (uint64_t)TEST_DEFERRED_MAX_US * 1000U);
+
+    printf("test_write_latency: %s\n", (failures == 0) ? "PASS" : "FAIL");
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}